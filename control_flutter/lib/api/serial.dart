@@ -58,12 +58,19 @@ class SerialApi {
       StreamController<Uint8List>.broadcast();
   static Stream<Uint8List> get dataStream => _dataStreamController.stream;
 
+  // 短时频谱行 (命令 0x34 开启后设备持续发送, 不需要等待)
+  static final StreamController<StftRow> _stftRowController =
+      StreamController<StftRow>.broadcast();
+  static Stream<StftRow> get stftRowStream => _stftRowController.stream;
+
   // 临时数据缓冲区
   static final List<int> _buffer = [];
 
   // 标记是否正在等待命令响应
   static bool _waitingForResponse = false;
   static Completer<CommandResponse>? _responseCompleter;
+  // 正在等待响应的命令码, 响应包回显该命令码
+  static int _pendingCommand = 0;
 
   // 标记是否正在等待数据包
   static bool _waitingForDataPacket = false;
@@ -191,6 +198,9 @@ class SerialApi {
     // 添加到缓冲区
     _buffer.addAll(data);
 
+    // 短时频谱行随时可能到达, 先取出, 不留在缓冲区中
+    _extractStftRows();
+
     // 如果正在等待命令响应，尝试解析
     if (_waitingForResponse &&
         _responseCompleter != null &&
@@ -206,14 +216,46 @@ class SerialApi {
     }
   }
 
+  /// 从缓冲区取出完整的短时频谱行并发布到 [stftRowStream]
+  ///
+  /// 只移除行本身的字节, 其前后的命令响应或数据包不受影响; 包尾不符的
+  /// 包头视为误匹配, 丢弃这 5 个字节后继续查找. 取完后缓冲区中最多剩下
+  /// 末尾一行尚未收全的数据
+  static void _extractStftRows() {
+    int from = 0;
+    while (true) {
+      final index = _findSequence(_buffer, stftRowStart, from);
+      if (index < 0 || index + stftRowLen > _buffer.length) {
+        return;
+      }
+      final row = _buffer.sublist(index, index + stftRowLen);
+      try {
+        _stftRowController.add(StftRow.fromBytes(row));
+        _buffer.removeRange(index, index + stftRowLen);
+      } catch (e) {
+        _buffer.removeRange(index, index + stftRowStart.length);
+      }
+      from = index;
+    }
+  }
+
   /// 尝试从缓冲区解析命令响应
+  ///
+  /// 停止短时频谱流的命令发出时, 设备可能还在发送行, 缓冲区中会留有行的
+  /// 片段 (发送命令前清空缓冲区时截断的行尾, 或尚未收全的行), 其中同样
+  /// 可能出现 0xAA ... 0x55 的 8 字节窗口. 因此只在尚未收全的行之前查找,
+  /// 并要求回显的命令码与发出的一致、状态码有效
   static void _tryParseCommandResponse() {
     // 命令响应包固定为8字节
-    if (_buffer.length >= SerialCommand.uartPacketSize) {
+    final rowIndex = _findSequence(_buffer, stftRowStart);
+    final end = rowIndex >= 0 ? rowIndex : _buffer.length;
+    if (end >= SerialCommand.uartPacketSize) {
       // 查找包头
       int startIndex = -1;
-      for (int i = 0; i <= _buffer.length - SerialCommand.uartPacketSize; i++) {
+      for (int i = 0; i <= end - SerialCommand.uartPacketSize; i++) {
         if (_buffer[i] == SerialCommand.packetHeader &&
+            _buffer[i + 1] == _pendingCommand &&
+            _buffer[i + 2] <= SerialCommand.respBusy &&
             _buffer[i + SerialCommand.uartPacketSize - 1] ==
                 SerialCommand.packetFooter) {
           startIndex = i;
@@ -341,6 +383,7 @@ class SerialApi {
     // 准备等待响应
     _responseCompleter = Completer<CommandResponse>();
     _waitingForResponse = true;
+    _pendingCommand = cmd;
 
     // 清空输入缓冲区
     _port!.flush(SerialPortBuffer.input);
@@ -407,6 +450,23 @@ class SerialApi {
     }
   }
 
+  /// 设置短时频谱流
+  ///
+  /// [hop] 为相邻两行起点相差的采样数 (0 关闭, 或 8~128), [rows] 为每次
+  /// 采集输出的行数 (0 表示一直输出). 开启后各行由 [stftRowStream] 发布.
+  /// 设备收到任何命令都会结束当前的输出, 在途的行由接收时取出,
+  /// 不会被当作命令响应
+  static Future<void> setStftStream(int hop, int rows) async {
+    final response = await sendCommandAndWaitResponse(
+      SerialCommand.cmdSetStftStream,
+      [hop, rows & 0xFF, (rows >> 8) & 0xFF],
+    );
+
+    if (response.status != SerialCommand.respOk) {
+      throw "设置短时频谱流失败: 状态=${response.status}";
+    }
+  }
+
   /// 设置为触发模式
   static Future<void> setTriggerMode() async {
     final response = await sendCommandAndWaitResponse(
@@ -74,7 +74,14 @@ class AnalysisResult {
       hasDcOffset = false;
 
   /// 从字节数组构造分析结果
-  factory AnalysisResult.fromBytes(List<int> data, int numHarmonics) {
+  ///
+  /// [fixedFormat] 为 true 时, THD 和归一化谐波幅度是以 0.001% 为单位的整数,
+  /// 否则为兼容格式的 float32
+  factory AnalysisResult.fromBytes(
+    List<int> data,
+    int numHarmonics, {
+    bool fixedFormat = false,
+  }) {
     int expectedLen = 4 + 4 * numHarmonics + 4 * numHarmonics + 4 + 1 + 1;
     if (data.length < expectedLen) {
       throw Exception("数据长度不足: 实际数据长度 ${data.length} vs 预期数据长度 $expectedLen");
@@ -83,13 +90,17 @@ class AnalysisResult {
     int offset = 0;
 
     // 解析 thd (4字节)
-    double thd = _bytesToFloat32(data.sublist(offset, offset + 4));
+    double thd = fixedFormat
+        ? _bytesToInt32(data.sublist(offset, offset + 4)) / 1000.0
+        : _bytesToFloat32(data.sublist(offset, offset + 4));
     offset += 4;
 
     // 解析 normalized_harmonics (4 * num_harmonics 字节)
     List<double> normalizedHarmonics = [];
     for (int i = 0; i < numHarmonics; i++) {
-      double value = _bytesToFloat32(data.sublist(offset, offset + 4));
+      double value = fixedFormat
+          ? _bytesToUint32(data.sublist(offset, offset + 4)) / ratioScale
+          : _bytesToFloat32(data.sublist(offset, offset + 4));
       normalizedHarmonics.add(value);
       offset += 4;
     }
@@ -156,28 +167,270 @@ class AnalysisResult {
   static int _bytesToUint32(List<int> bytes) {
     return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
   }
+
+  /// 辅助函数：字节数组转int32
+  static int _bytesToInt32(List<int> bytes) {
+    return _bytesToUint32(bytes).toSigned(32);
+  }
+}
+
+/// 扩展记录中的时域指标, 码值为 12 位 ADC 码值
+class TimeDomainMetrics {
+  double mean; // 均值 (码值)
+  double acRms; // 交流有效值 (码值)
+  int min; // 最小码值
+  int max; // 最大码值
+  double crestFactor; // 峰值因数
+  double dutyCycle; // 高于中值的点数占比 (0~1)
+  int zeroCrossings; // 穿越中值的次数
+  int clipped; // 落在满量程两端的点数
+
+  TimeDomainMetrics({
+    required this.mean,
+    required this.acRms,
+    required this.min,
+    required this.max,
+    required this.crestFactor,
+    required this.dutyCycle,
+    required this.zeroCrossings,
+    required this.clipped,
+  });
+
+  /// 峰峰值 (码值)
+  int get peakToPeak => max - min;
+
+  /// 从一条 [timeDomainRecordLen] 字节的记录构造
+  factory TimeDomainMetrics.fromBytes(List<int> data) {
+    if (data.length < timeDomainRecordLen) {
+      throw Exception(
+        "数据长度不足: 实际数据长度 ${data.length} vs 预期数据长度 $timeDomainRecordLen",
+      );
+    }
+    int u32(int offset) => AnalysisResult._bytesToUint32(
+      data.sublist(offset, offset + 4),
+    );
+    int u16(int offset) => data[offset] | (data[offset + 1] << 8);
+
+    return TimeDomainMetrics(
+      mean: u32(0) / 1000.0,
+      acRms: u32(4) / 1000.0,
+      min: u16(8),
+      max: u16(10),
+      crestFactor: u32(12) / ratioScale,
+      dutyCycle: u32(16) / ratioScale,
+      zeroCrossings: u16(20),
+      clipped: u16(22),
+    );
+  }
+}
+
+/// 扩展记录中的频谱指标, 未找到基波时全为 0
+class SpectralMetrics {
+  double thdN; // 总谐波失真加噪声 (%)
+  double sinad; // 信纳比 (dB)
+  double snr; // 信噪比 (dB)
+  double enob; // 有效位数
+
+  SpectralMetrics({
+    required this.thdN,
+    required this.sinad,
+    required this.snr,
+    required this.enob,
+  });
+
+  /// 从一条 [spectralRecordLen] 字节的记录构造
+  factory SpectralMetrics.fromBytes(List<int> data) {
+    if (data.length < spectralRecordLen) {
+      throw Exception(
+        "数据长度不足: 实际数据长度 ${data.length} vs 预期数据长度 $spectralRecordLen",
+      );
+    }
+    int i32(int offset) =>
+        AnalysisResult._bytesToInt32(data.sublist(offset, offset + 4));
+
+    return SpectralMetrics(
+      thdN: AnalysisResult._bytesToUint32(data.sublist(0, 4)) / 1000.0,
+      sinad: i32(4) / 100.0,
+      snr: i32(8) / 100.0,
+      enob: i32(12) / 100.0,
+    );
+  }
+}
+
+/// 扩展记录中的一个非谐波峰值
+class SpectralPeak {
+  int index; // 频点序号
+  double frequency; // 插值后的频率 (Hz)
+  double level; // 相对基波的幅度 (dBc)
+
+  SpectralPeak({
+    required this.index,
+    required this.frequency,
+    required this.level,
+  });
+
+  /// 从一个 [spectralPeakRecordLen] 字节的峰值构造
+  factory SpectralPeak.fromBytes(List<int> data) {
+    if (data.length < spectralPeakRecordLen) {
+      throw Exception(
+        "数据长度不足: 实际数据长度 ${data.length} vs 预期数据长度 $spectralPeakRecordLen",
+      );
+    }
+    int level = data[6] | (data[7] << 8);
+
+    return SpectralPeak(
+      index: data[0] | (data[1] << 8),
+      frequency: AnalysisResult._bytesToUint32(data.sublist(2, 6)) / 1000.0,
+      level: ((level ^ 0x8000) - 0x8000) / 100.0,
+    );
+  }
+
+  /// 解析从 [start] 开始的一个峰值表: [个数 1B][各峰值]
+  static List<SpectralPeak> listFromBytes(List<int> data, int start) {
+    int count = data[start];
+    return [
+      for (int i = 0; i < count; i++)
+        SpectralPeak.fromBytes(
+          data.sublist(
+            start + 1 + i * spectralPeakRecordLen,
+            start + 1 + (i + 1) * spectralPeakRecordLen,
+          ),
+        ),
+    ];
+  }
+}
+
+/// 一行短时频谱 (命令 0x34 开启的短时频谱流)
+///
+/// 行中的 THD 以 0.01% 为单位, 不用分析结果的 [ratioScale] (0.001%):
+/// 128 点频谱的每个谐波窗口内都含有噪声, 行 THD 只用于观察变化趋势,
+/// 实际精度远不到 0.01%; 16 位即可表示到 655.34%, 每行少发 2 字节
+class StftRow {
+  int seq; // 行号, 每次开始采集从 0 计, 丢行时跳号
+  int sampleRateHz; // 采样率 (Hz), 同一次采集中不变
+  double? fundamentalBin; // 基波位置 (128 点 FFT 的小数频点), 未找到时为 null
+  double? thd; // 总谐波失真 (%), 未找到基波时为 null
+  List<double> levels; // 第 0 ~ 63 频点的幅度 (dBFS), 最低 -127.5
+
+  StftRow({
+    required this.seq,
+    required this.sampleRateHz,
+    required this.fundamentalBin,
+    required this.thd,
+    required this.levels,
+  });
+
+  /// 基波频率 (Hz), 未找到基波时为 null
+  double? get fundamentalFreq => fundamentalBin == null
+      ? null
+      : fundamentalBin! * sampleRateHz / stftFftLen;
+
+  /// 从一行完整的 [stftRowLen] 字节 (含包头包尾) 构造
+  factory StftRow.fromBytes(List<int> row) {
+    if (row.length != stftRowLen ||
+        !_listStartsWith(row, stftRowStart) ||
+        !_listEndsWith(row, analysisPacketEnd)) {
+      throw Exception("短时频谱行格式错误: 长度、包头或包尾不匹配");
+    }
+    int u16(int offset) => row[offset] | (row[offset + 1] << 8);
+    int fundamentalQ8 = u16(11);
+    int thd = u16(13);
+
+    return StftRow(
+      seq: u16(5),
+      sampleRateHz: AnalysisResult._bytesToUint32(row.sublist(7, 11)),
+      fundamentalBin: fundamentalQ8 == 0 ? null : fundamentalQ8 / 256.0,
+      thd: thd == stftThdNone ? null : thd / 100.0,
+      // 0.5dB 一档, 255 为 0dBFS
+      levels: [for (int i = 0; i < stftBins; i++) (row[15 + i] - 255) / 2.0],
+    );
+  }
 }
 
 /// 组合类型，对应Rust中的AdcDataAndAnalysisResult
 class AdcDataAndAnalysisResult {
   AdcData adcData;
   AnalysisResult harmonicsAnalysis;
+  int? channelId; // 多通道扫描时的 ADC0 输入通道号, 否则为 null
+  // 扩展记录中的时域/频谱指标与峰值表 (双通道时为电压通道), 未开启时为 null
+  TimeDomainMetrics? timeMetrics;
+  SpectralMetrics? spectralMetrics;
+  List<SpectralPeak>? spectralPeaks;
 
   AdcDataAndAnalysisResult({
     required this.adcData,
     required this.harmonicsAnalysis,
+    this.channelId,
+    this.timeMetrics,
+    this.spectralMetrics,
+    this.spectralPeaks,
   });
 
   /// 默认构造函数
   AdcDataAndAnalysisResult.empty()
     : adcData = AdcData.empty(),
-      harmonicsAnalysis = AnalysisResult.empty();
+      harmonicsAnalysis = AnalysisResult.empty(),
+      channelId = null,
+      timeMetrics = null,
+      spectralMetrics = null,
+      spectralPeaks = null;
 }
 
 /// 数据包标识常量
 const List<int> analysisPacketStart = [0xAA, 0x55, 0xA5, 0x5A, 0xAA];
 const List<int> analysisPacketEnd = [0xBB, 0x66, 0xB6, 0x6B, 0xBB];
 
+/// 短时频谱行的包头 (与分析结果数据包只差最后一字节), 包尾与之相同
+const List<int> stftRowStart = [0xAA, 0x55, 0xA5, 0x5A, 0x5A];
+
+/// 短时频谱每行 FFT 的点数与上报的频点数
+const int stftFftLen = 128;
+const int stftBins = stftFftLen ~/ 2;
+
+/// 一行短时频谱的字节数: 包头 5 + 行号 2 + 采样率 4 + 基波位置 2 + THD 2
+/// + 幅度 [stftBins] + 包尾 5
+const int stftRowLen = 20 + stftBins;
+
+/// 行中 THD 的取值: 未找到基波
+const int stftThdNone = 0xFFFF;
+
+/// 包头谐波数量字节中的定点格式标志
+const int resultFormatFixedFlag = 0x80;
+
+/// 包头谐波数量字节中的双通道 (电压/电流) 标志
+const int resultDualChannelFlag = 0x40;
+
+/// 包头样本大小高字节中的多通道扫描标志, 置位时包头后紧跟 1 字节输入通道号
+const int resultScanChannelFlag = 0x80;
+
+/// 包头样本大小高字节中的扩展记录标志, 置位时包尾前追加扩展块:
+/// [开启的部分 1B][其后长度 2B][各部分]
+const int resultExtendedFlag = 0x40;
+
+/// 扩展块中的时域指标部分
+const int resultExtTimeDomain = 0x01;
+
+/// 扩展块中的频谱指标部分
+const int resultExtSpectral = 0x02;
+
+/// 扩展块中的非谐波峰值表部分
+const int resultExtPeaks = 0x04;
+
+/// 一条时域指标记录的长度
+const int timeDomainRecordLen = 24;
+
+/// 一条频谱指标记录的长度
+const int spectralRecordLen = 16;
+
+/// 峰值表中一个峰值的长度 (表头另有 1 字节个数)
+const int spectralPeakRecordLen = 8;
+
+/// 双通道数据包末尾功率参数的长度: 4 个 32 位数值 + 有效标志
+const int powerAnalysisLen = 4 * 4 + 1;
+
+/// 定点格式比值刻度: 100000 表示 1.0 (1 LSB = 0.001%)
+const double ratioScale = 100000.0;
+
 /// 处理分析数据包，对应Rust中的process_analysis_packet函数
 AdcDataAndAnalysisResult processAnalysisPacket(List<int> packet) {
   // 确认包头和包尾
@@ -193,12 +446,31 @@ AdcDataAndAnalysisResult processAnalysisPacket(List<int> packet) {
 
   int sampleSizeLow = packet[analysisPacketStart.length];
   int sampleSizeHigh = packet[analysisPacketStart.length + 1];
-  int sampleSize = (sampleSizeHigh << 8) | sampleSizeLow;
-  int numHarmonics = packet[analysisPacketStart.length + 2];
+  int sampleSize =
+      ((sampleSizeHigh & ~(resultScanChannelFlag | resultExtendedFlag)) << 8) |
+      sampleSizeLow;
+  bool scanChannel = (sampleSizeHigh & resultScanChannelFlag) != 0;
+  bool extended = (sampleSizeHigh & resultExtendedFlag) != 0;
+  int harmonicsByte = packet[analysisPacketStart.length + 2];
+  int numHarmonics =
+      harmonicsByte & ~(resultFormatFixedFlag | resultDualChannelFlag);
+  bool fixedFormat = (harmonicsByte & resultFormatFixedFlag) != 0;
+  bool dualChannel = (harmonicsByte & resultDualChannelFlag) != 0;
+
+  // 多通道扫描时包头后紧跟输入通道号
+  int dataStart = analysisPacketStart.length + 3;
+  int? channelId;
+  if (scanChannel) {
+    if (packet.length < dataStart + 1 + analysisPacketEnd.length) {
+      throw Exception("数据包太短，无法提取通道号");
+    }
+    channelId = packet[dataStart];
+    dataStart += 1;
+  }
 
-  // 提取数据部分（不包括包头、大小参数和包尾）
+  // 提取数据部分（不包括包头、大小参数、通道号和包尾）
   List<int> data = packet.sublist(
-    analysisPacketStart.length + 3,
+    dataStart,
     packet.length - analysisPacketEnd.length,
   );
 
@@ -219,7 +491,22 @@ AdcDataAndAnalysisResult processAnalysisPacket(List<int> packet) {
       +
       1; // has_dc_offset
 
-  int expectedTotalDataLen = expectedAdcLen + expectedResultLen;
+  // 双通道数据包: 电压/电流采样、电压/电流结果和功率参数, 目前只显示电压通道
+  int expectedTotalDataLen = dualChannel
+      ? 2 * (expectedAdcLen + expectedResultLen) + powerAnalysisLen
+      : expectedAdcLen + expectedResultLen;
+
+  // 扩展块: 开启的部分与其后长度
+  int extensionMask = 0;
+  if (extended) {
+    if (data.length < expectedTotalDataLen + 3) {
+      throw Exception("数据包太短，无法提取扩展块");
+    }
+    extensionMask = data[expectedTotalDataLen];
+    int extensionLen =
+        data[expectedTotalDataLen + 1] | (data[expectedTotalDataLen + 2] << 8);
+    expectedTotalDataLen += 3 + extensionLen;
+  }
 
   if (data.length != expectedTotalDataLen) {
     throw Exception(
@@ -231,15 +518,47 @@ AdcDataAndAnalysisResult processAnalysisPacket(List<int> packet) {
   AdcData adcData = AdcData.fromBytes(data.sublist(0, expectedAdcLen));
 
   // 解析谐波分析结果
+  int resultStart = dualChannel ? 2 * expectedAdcLen : expectedAdcLen;
   AnalysisResult harmonicsAnalysis = AnalysisResult.fromBytes(
-    data.sublist(expectedAdcLen),
+    data.sublist(resultStart, resultStart + expectedResultLen),
     numHarmonics,
+    fixedFormat: fixedFormat,
   );
 
+  // 解析扩展块中的各部分 (每部分第一条记录为单通道或电压通道)
+  TimeDomainMetrics? timeMetrics;
+  SpectralMetrics? spectralMetrics;
+  List<SpectralPeak>? spectralPeaks;
+  if (extended) {
+    int records = dualChannel ? 2 : 1;
+    int sectionStart = dualChannel
+        ? 2 * (expectedAdcLen + expectedResultLen) + powerAnalysisLen + 3
+        : expectedAdcLen + expectedResultLen + 3;
+    if ((extensionMask & resultExtTimeDomain) != 0) {
+      timeMetrics = TimeDomainMetrics.fromBytes(
+        data.sublist(sectionStart, sectionStart + timeDomainRecordLen),
+      );
+      sectionStart += records * timeDomainRecordLen;
+    }
+    if ((extensionMask & resultExtSpectral) != 0) {
+      spectralMetrics = SpectralMetrics.fromBytes(
+        data.sublist(sectionStart, sectionStart + spectralRecordLen),
+      );
+      sectionStart += records * spectralRecordLen;
+    }
+    if ((extensionMask & resultExtPeaks) != 0) {
+      spectralPeaks = SpectralPeak.listFromBytes(data, sectionStart);
+    }
+  }
+
   // 返回组合结果
   return AdcDataAndAnalysisResult(
     adcData: adcData,
     harmonicsAnalysis: harmonicsAnalysis,
+    channelId: channelId,
+    timeMetrics: timeMetrics,
+    spectralMetrics: spectralMetrics,
+    spectralPeaks: spectralPeaks,
   );
 }
 
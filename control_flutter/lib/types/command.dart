@@ -10,6 +10,7 @@ class SerialCommand {
   static const int cmdSetTriggerMode = 0x02;
   static const int cmdGetModeStatus = 0x03;
   static const int cmdTriggerOnce = 0x04;
+  static const int cmdSetStftStream = 0x34;
 
   // 响应状态码
   static const int respOk = 0x00;
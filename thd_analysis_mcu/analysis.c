@@ -1,178 +1,920 @@
 #include "analysis.h"
 #include "arm_const_structs.h"
 #include "arm_math.h"
-#include "consts.h" // 假设包含 SAMPLE_SIZE 和 NUM_HARMONICS
+#include "capture_stats.h"
+#include "consts.h" // 假设包含 SAMPLE_SIZE 和 MAX_HARMONICS
+#include "decimate.h"
+#include "ets.h"
+#include "fft.h"
+#include "resample.h"
+#include "sampling.h"
 #include "uart_comm.h"
+#include "utils.h"
+#include "zoom.h"
 #include <math.h> // 用于 fabsf
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/cdefs.h>
-#include <ti/iqmath/include/IQmathLib.h>
 
 // --- 常量 ---
-#define ADC_MIDPOINT 2048 // ADC 中点值 (12 位 ADC, u12)
-#define PRE_FFT_SCALE 16  // 预处理缩放因子 u12 -> u16 (4096 -> 65536)
 #define HARMONIC_SEARCH_WINDOW_HALF_WIDTH 2
-#define MIN_HARMONIC_THRESHOLD_Q15 100 // 需要根据实际信号调整 (Q15)
+// 幅度谱统一刻度: Q15 路径 X/N 幅度的 2^MAG_FRAC_BITS 倍,
+// 使 Q31 路径的低电平谐波不被截断, 两种精度共用同一套阈值与平均累加器
+#define MAG_FRAC_BITS 8
+// 噪声底估计: 取幅度谱的该百分位数 (%), 低百分位数不受基波、谐波及其泄漏
+// 占用的少数频点影响
+#define NOISE_FLOOR_PERCENTILE 25
+// 纯噪声频点的幅度服从瑞利分布, p 分位数 r_p 满足 r_p^2 = -ln(1-p) * rms^2,
+// 按此换算为单个频点噪声幅度的有效值: 1 / sqrt(-ln(0.75))
+#define NOISE_FLOOR_RMS_RATIO 1.8644
+// Q15 路径的噪声底下限 (统一刻度): FFT 输出的一个量化步长, 噪声低于它时
+// 量化后的噪声频点多为 0, 百分位数不再反映噪声. Q31 路径的量化噪声远低于
+// ADC 本身的噪声, 不设下限
+#define NOISE_FLOOR_MIN_Q15 (1 << MAG_FRAC_BITS)
+// Q31 路径输入相对 Q15 路径多出的位数 (等于窗系数的小数位数)
+#define Q31_EXTRA_BITS 15
 #define FFT_MAG_SPECTRUM_VALID_LEN (SAMPLE_SIZE / 2 - 1)
 #define MIN_FUNDAMENTAL_IDX 3  // 基波索引最小值，小于此值视为直流信号
+#define POWER_ACC_BINS (SAMPLE_SIZE / 2)
+// 奈奎斯特频率以下可能出现的最高谐波次数 (基波取最小索引时)
+#define MAX_HARMONIC_ORDER (FFT_MAG_SPECTRUM_VALID_LEN / MIN_FUNDAMENTAL_IDX)
+// 频谱指标: 噪声功率为 0 时信噪比与信纳比的上限 (0.01dB)
+#define SPECTRAL_MAX_DB 20000
+
+// 频谱峰值: 峰值至少为两侧较高谷值的倍数 (6dB)
+#define SPECTRAL_PEAK_PROMINENCE 2
+// 频谱峰值: 基波与谐波中心两侧排除的频点数 (插值误差与噪声引起的峰值偏移)
+#define SPECTRAL_PEAK_GUARD 1
+
+// 计算频谱指标时单音 (直流、基波、各次谐波) 占用的半宽 (频点):
+// 非整周期时取到窗口外的泄漏低于约 -50dB (汉宁窗旁瓣衰减慢, 主瓣外还需
+// 4 个频点); 矩形窗只用于整周期的帧, 单音只占一个频点
+static const uint8_t tone_half_width[WINDOW_COUNT] = {
+    [WINDOW_HANN] = 6,
+    [WINDOW_BLACKMAN_HARRIS] = 6,
+    [WINDOW_FLAT_TOP] = 7,
+    [WINDOW_RECTANGULAR] = 1,
+};
+
+// 直流区、基波与各次谐波窗口的排列 (频点), 频谱指标与峰值列表共用
+typedef struct {
+  uint32_t step_q16;   // 基波的小数频点 (Q16), n 次谐波位于其 n 倍处
+  uint32_t f_lo;       // 基波窗口 [f_lo, f_hi]
+  uint32_t f_hi;
+  uint32_t dc_end;     // 直流区 [0, dc_end]
+  uint32_t half_width; // 谐波窗口半宽
+  uint32_t center_q16; // 遍历谐波窗口的游标 (上一个谐波的小数频点)
+  uint32_t next_free;  // 尚未被窗口占用的第一个频点
+} ToneLayout;
+
+// 细化 (zoom-FFT) 用到的本帧时域采样与预处理参数
+typedef struct {
+  const uint16_t *samples;
+  bool is_signed;
+  int32_t offset; // 预处理时减去的直流偏置 (scaled_mean)
+} ZoomFrame;
+
+// --- 功率谱平均累加器 ---
+// 采用块浮点格式: 实际功率 = power_acc[i] << power_acc_shift,
+// 所有频点共享一个指数, 在 RAM 固定为 4 * SAMPLE_SIZE / 2 字节的前提下
+// 覆盖 K 帧累加所需的动态范围
+static uint32_t power_acc[POWER_ACC_BINS];
+static uint8_t power_acc_shift = 0;
+static uint8_t power_acc_frames = 0;
+static bool power_acc_pending = false;
+
+// --- 阶次跟踪 ---
+// 重采样后一帧至少包含的基波周期数 (基波需高于直流判定频点)
+#define ORDER_TRACKING_MIN_CYCLES (MIN_FUNDAMENTAL_IDX + 1)
+// 尚无基波估计时测量重采样耗时所用的步长 (0.99, Q20)
+#define ORDER_TRACKING_BENCHMARK_STEP ((uint32_t)(0.99 * RESAMPLE_STEP_ONE))
+// 最近一次插值得到的基波频率 (mHz), 0 表示没有可用的估计
+static uint32_t tracked_freq_mhz = 0;
+// 本帧的重采样步长 (Q20), 0 表示本帧未重采样
+static uint32_t frame_step_q20 = 0;
+
+// --- 边采集边预处理 ---
+// 采集期间按上一帧的均值去直流; 分析时本帧均值与之相差不超过此值 (码值)
+// 就直接使用预处理的结果. 偏差是一个乘以窗函数的直流分量, 落在直流区内;
+// 非整周期的一帧, 均值本身就随起止相位有同样大小的起伏
+#define PIPELINE_MAX_DC_ERROR 8
+// 上一帧 (ADC0) 的直流偏置 (scaled_mean)
+static int32_t last_offset = 0;
+// 本帧采集期间预处理所用的偏置、窗函数与精度
+static int32_t pipeline_offset = 0;
+static WindowType pipeline_window = WINDOW_HANN;
+static FftPrecision pipeline_precision = FFT_PRECISION_Q15;
+
+#if SPECTRUM_IN_CAPTURE_BUFFER
+// FFT 工作区直接复用采集缓冲区 (见 consts.h 中的 RAM 复用说明),
+// 仅支持原地基4 Q15 FFT, 幅度谱以 q31 原地覆盖 FFT 输出
+#define WORKSPACE_BYTES 0
+static q15_t *const workspace_q15 =
+    (q15_t *)&gADCRealSamples[ADC_DISCARD_SAMPLES];
+static q31_t *const workspace_q31 =
+    (q31_t *)&gADCRealSamples[ADC_DISCARD_SAMPLES];
+#else
+// FFT 工作区, 按当前精度解释为 q15/q31, 幅度谱复用 q31 视图
+// arm_rfft_q31 的输出需要 2 * SAMPLE_SIZE 个 q31; 双通道时前半为
+// SAMPLE_SIZE 点复数 FFT, 后半存放两路幅度谱
+static union {
+  q15_t q15[SAMPLE_SIZE * 2];
+  q31_t q31[SAMPLE_SIZE * 2];
+} workspace;
+#define WORKSPACE_BYTES sizeof(workspace)
+static q15_t *const workspace_q15 = workspace.q15;
+static q31_t *const workspace_q31 = workspace.q31;
+#endif
+
+// 奈奎斯特频率以下的全部谐波幅度, 用于计算 THD
+static q31_t harmonic_magnitudes[MAX_HARMONIC_ORDER];
+
+// 细化的工作区在单通道幅度谱 (工作区前 SAMPLE_SIZE / 2 个 q31) 之后
+#define ZOOM_WORKSPACE_OFFSET (SAMPLE_SIZE / 2)
+// 细化的搜索范围 (频点): 插值后的基波与理论谐波位置误差在一个频点以内
+#define ZOOM_SEARCH_BINS 1.0
+#if ZOOM_SUPPORTED
+_Static_assert(ZOOM_WORKSPACE_OFFSET * sizeof(q31_t) + ZOOM_BUFFER_BYTES <=
+                   WORKSPACE_BYTES,
+               "zoom buffer must fit after the magnitude spectrum");
+#endif
+
+// 静态变量需给栈留出余量 (MSPM0G3507 共 32KB SRAM). 这里只能检查大块缓冲区;
+// 各模块文件内的 static 变量与全局变量一起由主机测试 ram_budget
+// (tests/ram_report.sh --check) 按目标文件的符号大小计入合计
+#define RAM_BUFFER_BUDGET (30 * 1024)
+_Static_assert(sizeof(gADCRealSamples) + sizeof(gCurrentSamples) +
+                       sizeof(power_acc) + sizeof(harmonic_magnitudes) +
+                       WORKSPACE_BYTES + ETS_RAM_BYTES + ZOOM_RAM_BYTES <=
+                   RAM_BUFFER_BUDGET,
+               "analysis buffers exceed the RAM budget, reduce SAMPLE_SIZE");
+
+// 双通道预处理时累加的加窗样本乘积和, 用于计算真功率因数
+typedef struct {
+  int64_t vv; // sum(v^2)
+  int64_t ii; // sum(i^2)
+  int64_t vi; // sum(v * i)
+} DualChannelSums;
 
 // --- 内部辅助函数声明 ---
-uint32_t calc_signal_freq(uint32_t adcclks, int16_t fundamental_idx);
+static void init_result(AnalysisResult *result);
+static q31_t harmonic_threshold(const q31_t *mag_spectrum, q31_t min_floor);
+static void analyze_spectrum(const q31_t *mag_spectrum, q31_t min_floor,
+                             WindowType window, const ZoomFrame *zoom,
+                             AnalysisResult *result);
+static WindowType active_window(void);
+static uint32_t order_tracking_step_q20(void);
+static q15_t *resample_buffer(FftPrecision precision);
+static double frame_sample_rate_hz(void);
+static int32_t scaled_mean(float adc_data_mean);
+static int32_t interpolate_peak_offset_q16(const q31_t *mag_spectrum,
+                                           uint32_t peak_idx,
+                                           WindowType window);
+static uint32_t calc_signal_freq_mhz(uint32_t fundamental_idx,
+                                     int32_t offset_q16);
 
 static void preprocess_and_prepare_fft(const uint16_t *adc_data,
-                                       float adc_data_mean, q15_t *fft_buffer);
-static void perform_fft(q15_t *fft_buffer);
+                                       bool is_signed, int32_t offset,
+                                       q15_t *fft_buffer);
+static void preprocess_and_prepare_fft_q31(const uint16_t *adc_data,
+                                           bool is_signed, int32_t offset,
+                                           q31_t *fft_buffer);
+static void preprocess_dual_channel(const uint16_t *voltage,
+                                    const uint16_t *current, bool is_signed,
+                                    int32_t v_offset, int32_t i_offset,
+                                    q15_t *fft_buffer, DualChannelSums *sums);
+static void split_dual_spectrum(const q15_t *fft_buffer, uint32_t fft_exponent,
+                                q31_t *v_spectrum, q31_t *i_spectrum);
+static void calculate_power(const q15_t *fft_buffer, uint32_t fundamental_idx,
+                            uint32_t fundamental_freq_mhz,
+                            const DualChannelSums *sums, PowerAnalysis *power);
+static uint32_t perform_fft(q15_t *fft_buffer, FftEngine engine);
+static void perform_fft_q31(q31_t *fft_buffer);
 static void calculate_magnitude_spectrum(const q15_t *fft_buffer,
+                                         uint32_t fft_exponent,
                                          q31_t *mag_spectrum);
-static bool find_peak_in_window(const q31_t *mag_spectrum,
-                                uint32_t search_start, uint32_t search_end,
-                                uint32_t *peak_idx, q15_t *peak_val);
-static void clear_spectrum_window(q31_t *mag_spectrum, uint32_t center_idx,
-                                  uint32_t half_width, uint32_t max_idx);
-static bool find_fundamental(const q31_t *mag_spectrum, q15_t threshold,
-                             uint32_t *fundamental_idx, q15_t *fundamental_val);
-static void find_harmonics(q31_t *mag_spectrum, uint32_t fundamental_idx,
-                           q15_t threshold, uint32_t *harmonic_indices,
-                           q15_t *harmonic_magnitudes);
-static void calculate_results(const q15_t *harmonic_magnitudes_q15,
-                              AnalysisResult *result);
+static void calculate_magnitude_spectrum_q31(const q31_t *fft_buffer,
+                                             q31_t *mag_spectrum);
+static bool average_power_spectrum(q31_t *mag_spectrum);
+static uint32_t scaled_magnitude(uint64_t sum_sq, int32_t shift);
+static uint32_t isqrt64(uint64_t value);
+static bool find_fundamental(const q31_t *mag_spectrum, q31_t threshold,
+                             uint32_t *fundamental_idx, q31_t *fundamental_val);
+static uint32_t find_harmonics(const q31_t *mag_spectrum,
+                               uint32_t fundamental_idx, q31_t threshold,
+                               uint32_t *harmonic_indices,
+                               uint8_t num_reported,
+                               q31_t *harmonic_magnitudes);
+static void compensate_decimation_droop(q31_t *harmonic_magnitudes,
+                                        uint32_t harmonic_count,
+                                        uint32_t fundamental_idx);
+static void zoom_harmonics(const ZoomFrame *zoom, WindowType window,
+                           uint32_t fundamental_idx, uint32_t harmonic_count,
+                           uint32_t num_reported, int32_t *offset_q16);
+static void calculate_results(const q31_t *harmonic_magnitudes,
+                              uint32_t harmonic_count, AnalysisResult *result);
+static void tone_layout(uint32_t fundamental_idx, int32_t offset_q16,
+                        uint32_t tone_width, ToneLayout *layout);
+static void calculate_spectral_metrics(const q31_t *mag_spectrum,
+                                       ToneLayout layout,
+                                       SpectralMetrics *metrics);
+static void find_spectral_peaks(const q31_t *mag_spectrum, ToneLayout layout,
+                                q31_t threshold, q31_t fundamental_val,
+                                WindowType window, SpectralPeakList *list);
 
 static void detect_dc_or_no_signal(const uint16_t *adc_data,
+                                   FrameChannel channel,
                                    WaveformType *waveform, float *mean_out,
-                                   bool *has_dc_offset_out);
+                                   bool *has_dc_offset_out,
+                                   TimeDomainMetrics *metrics);
 static WaveformType detect_waveform_type(const AnalysisResult *result);
 
 // --- 主要分析函数 ---
 AnalysisResult analyze_harmonics(const uint16_t *adc_data) {
-  AnalysisResult result = {0}; // 初始化结果结构体
-  result.thd = 0.0f;
-  result.waveform = WAVEFORM_UNKNOWN; // 默认未知
-  result.has_dc_offset = false;
-
-  for (int i = 0; i < NUM_HARMONICS; ++i) {
-    result.normalized_harmonics_amplitudes[i] = 0.0f;
-    result.harmonic_indices[i] = 0;
-  }
+  AnalysisResult result;
+  init_result(&result);
 
   // 首先检测是否为直流或者无信号
   WaveformType preliminary_detection = WAVEFORM_UNKNOWN;
   float mean_value = 0.0;
   bool has_dc_offset = false;
-  detect_dc_or_no_signal(adc_data, &preliminary_detection, &mean_value,
-                         &has_dc_offset);
+  detect_dc_or_no_signal(adc_data, FRAME_CHANNEL_MAIN, &preliminary_detection,
+                         &mean_value, &has_dc_offset, &result.time_metrics);
+  // 采集期间的预处理结果只能用于本帧; 本帧均值作为下一帧预处理的偏置
+  const bool preprocessed = capture_stats_take_preprocessed();
+  const int32_t frame_offset = scaled_mean(mean_value);
+  last_offset = frame_offset;
 
   result.has_dc_offset = has_dc_offset;
 
   if (preliminary_detection != WAVEFORM_UNKNOWN) {
     result.waveform = preliminary_detection;
-    result.thd = (preliminary_detection == WAVEFORM_NONE) ? -1.0f : 0.0f;
+    result.thd = (preliminary_detection == WAVEFORM_NONE) ? THD_ERROR_NO_SIGNAL : 0;
+    reset_spectrum_average(); // 信号中断, 已累加的频谱作废
+    tracked_freq_mhz = 0;
     return result; // 如果是直流或无信号，直接返回，不进行后续分析
   }
 
-  // --- 临时存储 ---
-  q15_t harmonic_magnitudes_q15[NUM_HARMONICS] = {0};
+  // --- 步骤 0.5: 阶次跟踪, 按上一帧的基波频率重采样到整周期 ---
+  const uint16_t *frame = adc_data;
+  bool frame_signed =
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  frame_step_q20 = order_tracking_step_q20();
+  if (frame_step_q20 != 0) {
+    q15_t *resampled = resample_buffer(gAnalysisProfile.fft_precision);
+    resample_frame(adc_data, frame_signed, frame_step_q20, resampled);
+    frame = (const uint16_t *)resampled;
+    frame_signed = true; // 重采样输出与有符号左对齐格式同一刻度
+  }
 
-  // --- 缓冲区 ---
-  static q15_t workspace_buffer[SAMPLE_SIZE * 2] = {0};
+  // --- 步骤 1~2: 数据预处理、FFT 和幅度谱 (两种精度输出同一刻度) ---
+  // 采集期间已按上一帧的均值预处理了整帧, 且与本帧均值相差不大时直接做 FFT
+  const WindowType window = active_window();
+  const FftPrecision precision = gAnalysisProfile.fft_precision;
+  int32_t offset = frame_offset;
+  const bool use_preprocessed =
+      preprocessed && frame == adc_data && pipeline_window == window &&
+      pipeline_precision == precision &&
+      abs(pipeline_offset - frame_offset) <=
+          PIPELINE_MAX_DC_ERROR * PRE_FFT_SCALE;
+  if (use_preprocessed) {
+    offset = pipeline_offset;
+  }
+  q31_t min_floor;
+  if (precision == FFT_PRECISION_Q31) {
+    min_floor = 0;
+    if (!use_preprocessed) {
+      preprocess_and_prepare_fft_q31(frame, frame_signed, offset,
+                                     workspace_q31);
+    }
+    perform_fft_q31(workspace_q31);
+    calculate_magnitude_spectrum_q31(workspace_q31, workspace_q31);
+  } else {
+    min_floor = NOISE_FLOOR_MIN_Q15;
+    if (!use_preprocessed) {
+      preprocess_and_prepare_fft(frame, frame_signed, offset, workspace_q15);
+    }
+    uint32_t fft_exponent =
+        perform_fft(workspace_q15, gAnalysisProfile.fft_engine);
+    calculate_magnitude_spectrum(workspace_q15, fft_exponent, workspace_q31);
+  }
+
+  // --- 步骤 2.5: 多帧功率谱平均 ---
+  // 平均未完成时只累加频谱, 由调用方继续采样
+  if (!average_power_spectrum(workspace_q31)) {
+    return result;
+  }
 
-  // --- 步骤 1: 数据预处理和 FFT ---
-  preprocess_and_prepare_fft(adc_data, mean_value, workspace_buffer);
+  // --- 步骤 3~9: 基波、谐波、THD、波形与基波频率 ---
+  // 细化需要原始时域采样: 阶次跟踪重采样与多帧平均时不做
+  const ZoomFrame zoom = {adc_data, frame_signed, offset};
+  const bool zoom_enabled = ZOOM_SUPPORTED &&
+                            gAnalysisProfile.zoom_factor != 0 &&
+                            frame == adc_data &&
+                            gAnalysisProfile.average_frames <= 1;
+  analyze_spectrum(workspace_q31, min_floor, window,
+                   zoom_enabled ? &zoom : NULL, &result);
+  tracked_freq_mhz = result.fundamental_freq_mhz;
 
-  perform_fft(workspace_buffer);
+  return result;
+}
 
-  // --- 步骤 2: 计算幅度谱 ---
-  calculate_magnitude_spectrum(workspace_buffer, (q31_t *)&workspace_buffer);
+AnalysisResult analyze_dual_channel(const uint16_t *voltage,
+                                    const uint16_t *current,
+                                    PowerAnalysis *power) {
+  AnalysisResult result;
+  init_result(&result);
+  init_result(&power->current);
+  power->valid = false;
+  power->power_factor = 0;
+  power->displacement_power_factor = 0;
+  power->displacement_angle = 0;
+  power->phase_offset_ns = 0;
+
+  // 双通道不做频谱平均与阶次跟踪, 每帧都给出结果
+  reset_spectrum_average();
+  tracked_freq_mhz = 0;
+  frame_step_q20 = 0;
+  if (!DUAL_CHANNEL_SUPPORTED) {
+    result.thd = THD_ERROR_NO_SIGNAL;
+    result.waveform = WAVEFORM_NONE;
+    return result;
+  }
+
+  // 两个通道分别做直流/无信号检测
+  WaveformType v_detection = WAVEFORM_UNKNOWN;
+  WaveformType i_detection = WAVEFORM_UNKNOWN;
+  float v_mean = 0.0f;
+  float i_mean = 0.0f;
+  TimeDomainMetrics v_metrics;
+  TimeDomainMetrics i_metrics;
+  detect_dc_or_no_signal(voltage, FRAME_CHANNEL_MAIN, &v_detection, &v_mean,
+                         &result.has_dc_offset, &v_metrics);
+  detect_dc_or_no_signal(current, FRAME_CHANNEL_CURRENT, &i_detection, &i_mean,
+                         &power->current.has_dc_offset, &i_metrics);
+
+  if (v_detection == WAVEFORM_UNKNOWN || i_detection == WAVEFORM_UNKNOWN) {
+    // --- 两路合成 z = v + j*i, 一次复数 FFT 后拆分出两路频谱 ---
+    const bool is_signed =
+        gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+    DualChannelSums sums;
+    preprocess_dual_channel(voltage, current, is_signed, scaled_mean(v_mean),
+                            scaled_mean(i_mean), workspace_q15, &sums);
+    uint32_t fft_exponent = cfft_q15_inplace(workspace_q15, SAMPLE_SIZE);
+    // FFT 输出占工作区前半, 两路幅度谱放在后半, 拆分后仍可读取基波相位
+    q31_t *v_spectrum = &workspace_q31[SAMPLE_SIZE];
+    q31_t *i_spectrum = &workspace_q31[SAMPLE_SIZE + SAMPLE_SIZE / 2];
+    split_dual_spectrum(workspace_q15, fft_exponent, v_spectrum, i_spectrum);
+
+    const WindowType window = active_window();
+    // 幅度谱占工作区后半, 不做细化
+    analyze_spectrum(v_spectrum, NOISE_FLOOR_MIN_Q15, window, NULL, &result);
+    analyze_spectrum(i_spectrum, NOISE_FLOOR_MIN_Q15, window, NULL,
+                     &power->current);
+
+    if (v_detection == WAVEFORM_UNKNOWN && i_detection == WAVEFORM_UNKNOWN &&
+        result.fundamental_freq_mhz != 0 &&
+        power->current.fundamental_freq_mhz != 0) {
+      calculate_power(workspace_q15, result.harmonic_indices[0],
+                      result.fundamental_freq_mhz, &sums, power);
+    }
+  }
+
+  // 直流/无信号的通道按检测结果上报 (频谱中只有噪声)
+  if (v_detection != WAVEFORM_UNKNOWN) {
+    init_result(&result);
+    result.has_dc_offset = v_detection == WAVEFORM_DC;
+    result.waveform = v_detection;
+    result.thd = v_detection == WAVEFORM_NONE ? THD_ERROR_NO_SIGNAL : 0;
+  }
+  if (i_detection != WAVEFORM_UNKNOWN) {
+    init_result(&power->current);
+    power->current.has_dc_offset = i_detection == WAVEFORM_DC;
+    power->current.waveform = i_detection;
+    power->current.thd = i_detection == WAVEFORM_NONE ? THD_ERROR_NO_SIGNAL : 0;
+  }
+  result.time_metrics = v_metrics;
+  power->current.time_metrics = i_metrics;
+  return result;
+}
+
+// --- 内部辅助函数实现 ---
+/**
+ * @brief 结果初始化为未分析状态 (波形未知, 谐波幅度与索引为 0)
+ */
+static void init_result(AnalysisResult *result) {
+  *result = (AnalysisResult){0};
+  result->thd = 0;
+  result->waveform = WAVEFORM_UNKNOWN; // 默认未知
+  result->has_dc_offset = false;
+  result->num_harmonics = gAnalysisProfile.num_harmonics;
+}
+
+// 有效位数 (0 的位数为 0)
+static uint32_t bit_length(uint32_t v) {
+  uint32_t n = 0;
+  if (v >= 1U << 16) {
+    v >>= 16;
+    n += 16;
+  }
+  if (v >= 1U << 8) {
+    v >>= 8;
+    n += 8;
+  }
+  if (v >= 1U << 4) {
+    v >>= 4;
+    n += 4;
+  }
+  if (v >= 1U << 2) {
+    v >>= 2;
+    n += 2;
+  }
+  if (v >= 1U << 1) {
+    v >>= 1;
+    n += 1;
+  }
+  return n + v;
+}
+
+/**
+ * @details 第一遍按有效位数计数, 找到所在的二进制数量级; 第二遍在该数量级内
+ * 按最高位以下 NOISE_FLOOR_SUB_BITS 位细分计数, 结果取所在档的中点
+ */
+q31_t select_magnitude(const q31_t *mag_spectrum, uint32_t begin,
+                              uint32_t end, uint32_t rank) {
+  // 两遍共用: q31_t 幅度非负, 有效位数 0~31
+  uint16_t counts[1U << NOISE_FLOOR_SUB_BITS];
+  _Static_assert((1U << NOISE_FLOOR_SUB_BITS) >= 32,
+                 "counts must cover every bit length of q31_t");
+
+  memset(counts, 0, sizeof(counts));
+  for (uint32_t k = begin; k <= end; k++) {
+    counts[bit_length((uint32_t)mag_spectrum[k])]++;
+  }
+  uint32_t length = 0;
+  while (rank >= counts[length]) {
+    rank -= counts[length];
+    length++;
+  }
+  if (length == 0) {
+    return 0;
+  }
+
+  // 数量级 [2^(length-1), 2^length) 内按最高位以下的位细分
+  const uint32_t shift = length - 1 > NOISE_FLOOR_SUB_BITS
+                             ? length - 1 - NOISE_FLOOR_SUB_BITS
+                             : 0;
+  const uint32_t lead = 1U << (length - 1 - shift);
+  memset(counts, 0, sizeof(counts));
+  for (uint32_t k = begin; k <= end; k++) {
+    const uint32_t v = (uint32_t)mag_spectrum[k];
+    if (bit_length(v) == length) {
+      counts[(v >> shift) - lead]++;
+    }
+  }
+  uint32_t sub = 0;
+  while (rank >= counts[sub]) {
+    rank -= counts[sub];
+    sub++;
+  }
+  return (q31_t)(((lead + sub) << shift) + ((1U << shift) >> 1));
+}
+
+/**
+ * @brief 由本帧幅度谱的噪声底得到基波、谐波与频谱峰值的检出阈值
+ * @details 直流区以上频点幅度的 NOISE_FLOOR_PERCENTILE 百分位数换算为
+ * 噪声有效值 (不低于 min_floor), 再乘以 gAnalysisProfile.noise_margin_db。
+ * 噪声底直接在加窗后的频谱上测得, 与窗函数无关; 频谱平均后噪声起伏变小,
+ * 百分位数接近有效值, 估计偏高 (最多约 5dB), 阈值偏于保守
+ * @param min_floor 噪声底下限, Q15 路径为 NOISE_FLOOR_MIN_Q15, Q31 路径为 0
+ * @return 至少为 1: 比较取 >=, 为 0 的频点 (无噪声的合成信号) 不能检出
+ */
+static q31_t harmonic_threshold(const q31_t *mag_spectrum, q31_t min_floor) {
+  const uint32_t bins = FFT_MAG_SPECTRUM_VALID_LEN - MIN_FUNDAMENTAL_IDX + 1;
+  const q31_t percentile =
+      select_magnitude(mag_spectrum, MIN_FUNDAMENTAL_IDX,
+                       FFT_MAG_SPECTRUM_VALID_LEN,
+                       bins * NOISE_FLOOR_PERCENTILE / 100);
+  double floor = percentile * NOISE_FLOOR_RMS_RATIO;
+  if (floor < min_floor) {
+    floor = min_floor;
+  }
+  const double threshold =
+      floor * pow(10.0, gAnalysisProfile.noise_margin_db / 20.0);
+  if (threshold < 1) {
+    return 1;
+  }
+  return threshold < INT32_MAX ? (q31_t)threshold : INT32_MAX;
+}
+
+/**
+ * @brief 由统一刻度的幅度谱查找基波与谐波, 计算 THD、波形类型和基波频率
+ * @param min_floor 噪声底下限, 见 harmonic_threshold
+ * @param zoom 本帧的时域采样, 非 NULL 时细化基波频率与上报谐波的幅度
+ * @param result 已初始化的结果, 未找到基波时 fundamental_freq_mhz 保持为 0
+ */
+static void analyze_spectrum(const q31_t *mag_spectrum, q31_t min_floor,
+                             WindowType window, const ZoomFrame *zoom,
+                             AnalysisResult *result) {
+  // --- 检出阈值: 由本帧的噪声底得到 ---
+  const q31_t threshold = harmonic_threshold(mag_spectrum, min_floor);
 
   // --- 步骤 3: 查找基波 ---
   uint32_t fundamental_idx = 0;
-  q15_t fundamental_val_q15 = 0;
+  q31_t fundamental_val = 0;
   bool fundamental_found =
-      find_fundamental((q31_t *)&workspace_buffer, MIN_HARMONIC_THRESHOLD_Q15,
-                       &fundamental_idx, &fundamental_val_q15);
+      find_fundamental(mag_spectrum, threshold,
+                       &fundamental_idx, &fundamental_val);
 
   if (!fundamental_found) {
-    result.thd = -1.0f;              // 错误码：未找到有效基波
-    result.waveform = WAVEFORM_NONE; // 明确标记为无波形
-    return result;
+    result->thd = THD_ERROR_NO_SIGNAL; // 错误码：未找到有效基波
+    result->waveform = WAVEFORM_NONE; // 明确标记为无波形
+    return;
   }
   
   // 判断是否为带噪声的直流信号（基波频率过低）
   if (fundamental_idx < MIN_FUNDAMENTAL_IDX) {
-    result.thd = 0.0f;               // 直流信号的THD为0
-    result.waveform = WAVEFORM_DC;   // 标记为直流波形
-    result.harmonic_indices[0] = fundamental_idx;  // 保留基波索引作为记录
+    result->thd = 0;                  // 直流信号的THD为0
+    result->waveform = WAVEFORM_DC;   // 标记为直流波形
+    result->harmonic_indices[0] = fundamental_idx;  // 保留基波索引作为记录
     
     // 将所有谐波分量设为0
-    for (int i = 0; i < NUM_HARMONICS; ++i) {
-      result.normalized_harmonics_amplitudes[i] = 0.0f;
-      if (i > 0) result.harmonic_indices[i] = 0;  // 二次及以上谐波索引置0
+    for (int i = 0; i < MAX_HARMONICS; ++i) {
+      result->normalized_harmonics_amplitudes[i] = 0;
+      if (i > 0) result->harmonic_indices[i] = 0;  // 二次及以上谐波索引置0
     }
     
-    return result;
+    return;
   }
 
-  // 存储基波信息 (Q15 和索引)
-  harmonic_magnitudes_q15[0] = fundamental_val_q15;
-  result.harmonic_indices[0] = fundamental_idx;
-
-  // --- 步骤 4: 清除基波峰值周围的窗口 ---
-  clear_spectrum_window((q31_t *)&workspace_buffer, fundamental_idx,
-                        HARMONIC_SEARCH_WINDOW_HALF_WIDTH,
-                        FFT_MAG_SPECTRUM_VALID_LEN);
-
-  // --- 步骤 5: 查找谐波 ---
-  find_harmonics((q31_t *)&workspace_buffer, fundamental_idx,
-                 MIN_HARMONIC_THRESHOLD_Q15, result.harmonic_indices,
-                 harmonic_magnitudes_q15);
+  // 存储基波信息 (幅度和索引)
+  harmonic_magnitudes[0] = fundamental_val;
+  result->harmonic_indices[0] = fundamental_idx;
+
+  // --- 步骤 4: 梳状查找全部谐波 ---
+  uint32_t harmonic_count = find_harmonics(
+      mag_spectrum, fundamental_idx, threshold,
+      result->harmonic_indices, result->num_harmonics, harmonic_magnitudes);
+  compensate_decimation_droop(harmonic_magnitudes, harmonic_count,
+                              fundamental_idx);
+
+  // --- 步骤 5: 基波的小数频点 (三点插值), 可选细化 ---
+  int32_t offset_q16 =
+      interpolate_peak_offset_q16(mag_spectrum, fundamental_idx, window);
+  if (zoom != NULL) {
+    zoom_harmonics(zoom, window, fundamental_idx, harmonic_count,
+                   result->num_harmonics, &offset_q16);
+  }
 
   // --- 步骤 6: 计算最终结果 (THD 和归一化幅度) ---
-  calculate_results(harmonic_magnitudes_q15, &result);
+  calculate_results(harmonic_magnitudes, harmonic_count, result);
+
+  // --- 步骤 7: THD+N、SINAD、SNR 与 ENOB, 谐波以外的频谱峰值 ---
+  ToneLayout layout;
+  tone_layout(fundamental_idx, offset_q16, tone_half_width[window], &layout);
+  calculate_spectral_metrics(mag_spectrum, layout, &result->spectral_metrics);
+  // 峰值查找只排除基波与谐波自身的峰值频点, 其主瓣与泄漏单调下降,
+  // 不构成局部最大值, 紧邻谐波的间谐波也能找出
+  tone_layout(fundamental_idx, offset_q16, SPECTRAL_PEAK_GUARD, &layout);
+  find_spectral_peaks(mag_spectrum, layout, threshold, harmonic_magnitudes[0],
+                      window, &result->spectral_peaks);
 
   // --- 步骤 8: 检测波形类型 ---
-  result.waveform = detect_waveform_type(&result);
+  result->waveform = detect_waveform_type(result);
 
   // --- 步骤 9：计算基波频率
-  result.fundamental_freq = calc_signal_freq(gADCCLKS, fundamental_idx);
+  result->fundamental_freq_mhz =
+      calc_signal_freq_mhz(fundamental_idx, offset_q16);
+  result->fundamental_freq = (result->fundamental_freq_mhz + 500) / 1000;
+}
 
-  return result;
+/**
+ * @brief 本帧实际使用的窗函数: 相干采样锁定、重采样或等效时间采样重建后
+ * 一帧为整周期, 使用矩形窗
+ */
+static WindowType active_window(void) {
+  return is_coherent_locked() || frame_step_q20 != 0 ||
+                 ets_frame_reconstructed()
+             ? WINDOW_RECTANGULAR
+             : gAnalysisProfile.window;
 }
 
-// --- 内部辅助函数实现 ---
-uint32_t calc_signal_freq(uint32_t adcclks, int16_t fundamental_idx) {
-  volatile double adcclks_double = adcclks;
-  volatile double sample_time_ns = (double)adcclks_double * CLK_CYCLE_NS;
-  volatile double total_time_ns = sample_time_ns + CONVERSION_TIME_NS;
-  volatile double fs = 1e9 / total_time_ns;
-  volatile double f_resolution = fs / SAMPLE_SIZE;
-  volatile double f = f_resolution * (double)fundamental_idx;
-  return (uint32_t)f;
+/**
+ * @brief 计算本帧的阶次跟踪重采样步长
+ * @return 步长 (Q20), 使 SAMPLE_SIZE 个输出点恰好覆盖 M = floor(一帧周期数)
+ * 个基波周期; 返回 0 表示本帧不重采样 (未开启、没有基波估计、
+ * 已相干采样、等效时间采样重建的帧或周期数太少)
+ */
+static uint32_t order_tracking_step_q20(void) {
+  if (!gAnalysisProfile.order_tracking || tracked_freq_mhz == 0 ||
+      is_coherent_locked() || ets_frame_reconstructed()) {
+    return 0;
+  }
+  double periods =
+      tracked_freq_mhz / 1000.0 * SAMPLE_SIZE / get_sample_rate_hz();
+  uint32_t cycles = (uint32_t)periods;
+  if (cycles < ORDER_TRACKING_MIN_CYCLES) {
+    return 0;
+  }
+  return (uint32_t)(cycles / periods * RESAMPLE_STEP_ONE);
+}
+
+/**
+ * @brief 重采样输出的存放位置: Q15 路径直接作为预处理的原地输入;
+ * Q31 路径放在工作区后半, 预处理写入前半时不会覆盖尚未读取的数据
+ */
+static q15_t *resample_buffer(FftPrecision precision) {
+#if SPECTRUM_IN_CAPTURE_BUFFER
+  (void)precision; // 原地重采样 (原始采样已在分析前上传)
+  return workspace_q15;
+#else
+  return precision == FFT_PRECISION_Q31 ? (q15_t *)&workspace_q31[SAMPLE_SIZE]
+                                        : workspace_q15;
+#endif
+}
+
+/**
+ * @brief 本帧频谱对应的采样率, 重采样后为实际采样率除以步长,
+ * 等效时间采样重建的帧为等效采样率
+ */
+static double frame_sample_rate_hz(void) {
+  if (ets_frame_reconstructed()) {
+    return ets_sample_rate_hz();
+  }
+  double fs = get_sample_rate_hz();
+  return frame_step_q20 != 0 ? fs * RESAMPLE_STEP_ONE / frame_step_q20 : fs;
+}
+
+/**
+ * @brief 由峰值频点及其左右相邻频点的幅度估计真实峰值的小数偏移
+ * @return 偏移量, Q16 格式, 范围 -0.5 ~ 0.5 频点
+ * @note 汉宁窗和矩形窗按主瓣形状的精确比值求解 (纯正弦时无偏),
+ * 其余窗用抛物线近似
+ */
+static int32_t interpolate_peak_offset_q16(const q31_t *mag_spectrum,
+                                           uint32_t peak_idx,
+                                           WindowType window) {
+  int64_t left = mag_spectrum[peak_idx - 1];
+  int64_t center = mag_spectrum[peak_idx];
+  int64_t right =
+      peak_idx + 1 < SAMPLE_SIZE / 2 ? mag_spectrum[peak_idx + 1] : 0;
+  bool to_right = right > left;
+  int64_t side = to_right ? right : left;
+  int64_t num, den;
+
+  if (window == WINDOW_HANN) {
+    // 较大一侧与峰值之比 a = (1 + d) / (2 - d), 解得 d = (2a - 1) / (a + 1)
+    num = 2 * side - center;
+    den = side + center;
+  } else if (window == WINDOW_RECTANGULAR) {
+    // a = d / (1 - d), 解得 d = a / (a + 1)
+    num = side;
+    den = side + center;
+  } else {
+    // 抛物线顶点 d = (r - l) / (2 * (2c - l - r)), 先取绝对值
+    num = to_right ? right - left : left - right;
+    den = 2 * (2 * center - left - right);
+  }
+  if (num <= 0 || den <= 0) {
+    return 0;
+  }
+
+  int32_t offset_q16 = (int32_t)((num << 16) / den);
+  if (offset_q16 > 32768) {
+    offset_q16 = 32768;
+  }
+  return to_right ? offset_q16 : -offset_q16;
+}
+
+/**
+ * @brief 由 (小数) 频点换算基波频率, 采样率取决于当前采样时钟与重采样步长
+ * @return 基波频率 (mHz)
+ */
+static uint32_t calc_signal_freq_mhz(uint32_t fundamental_idx,
+                                     int32_t offset_q16) {
+  double bins = (double)fundamental_idx + (double)offset_q16 / 65536.0;
+  double f = bins * frame_sample_rate_hz() / SAMPLE_SIZE;
+  return (uint32_t)(f * 1000.0 + 0.5);
+}
+
+/**
+ * @brief 将采样换算为以中点为零、乘以 PRE_FFT_SCALE 后的数值
+ * @note 有符号左对齐格式由 ADC 硬件完成换算, 只需符号扩展;
+ * is_signed 在循环内不变, 编译器会把判断提到循环外
+ */
+static inline int32_t centered_sample(uint16_t raw, bool is_signed) {
+  return is_signed ? (int32_t)(int16_t)raw
+                   : ((int32_t)raw - ADC_MIDPOINT) * PRE_FFT_SCALE;
+}
+
+/**
+ * @brief 饱和到 Q15 范围
+ */
+static inline q15_t saturate_q15(int32_t x) {
+  return (q15_t)(x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x));
+}
+
+/**
+ * @brief 将 ADC 均值换算为预处理时需减去的剩余直流偏置 (与 centered_sample
+ * 同一刻度)
+ */
+static int32_t scaled_mean(float adc_data_mean) {
+  return (int32_t)((adc_data_mean - ADC_MIDPOINT) * PRE_FFT_SCALE +
+                   (adc_data_mean >= ADC_MIDPOINT ? 0.5f : -0.5f));
 }
 
 /**
  * @brief 对 ADC 数据进行预处理、加窗，并准备 FFT 输入缓冲区。
+ * @param is_signed 输入为有符号左对齐 (Q15) 格式 (包括重采样的输出)
+ * @param offset 减去的直流偏置 (scaled_mean)
+ * @note 窗函数只存半表, 每次查表同时处理首尾对称的两个采样
  */
 static void preprocess_and_prepare_fft(const uint16_t *adc_data,
-                                       float adc_data_mean, q15_t *fft_buffer) {
-  const _iq16 scale_iq = _IQ16(PRE_FFT_SCALE);
-  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
-    // 1. 减去直流偏置 (ADC 中点) 并转换为 IQ
-    int32_t current = (float)adc_data[i] - adc_data_mean;
-    // 2. 缩放
-    _iq16 scaled = _IQ16mpy(_IQ16(current), scale_iq);
-    // 3. 加窗 (Hanning 窗) - 假设 gHanningWindow 是 _iq 格式
-    int16_t windowed =
-        (int16_t)_IQ16toF(_IQ16mpy(scaled, _IQ16(gHanningWindow[i])));
+                                       bool is_signed, int32_t offset,
+                                       q15_t *fft_buffer) {
+  const q15_t *window = gWindows[active_window()].half_table;
+  if (window == NULL) {
+    // 矩形窗: 只缩放并去直流, 满幅时饱和到 Q15
+    for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+      fft_buffer[i] =
+          saturate_q15(centered_sample(adc_data[i], is_signed) - offset);
+    }
+    return;
+  }
+  for (uint32_t i = 0, j = SAMPLE_SIZE - 1; i < SAMPLE_SIZE / 2; i++, j--) {
+    int32_t w = window[i];
+    // 1. 缩放并减去直流偏置
+    int32_t head = centered_sample(adc_data[i], is_signed) - offset;
+    int32_t tail = centered_sample(adc_data[j], is_signed) - offset;
+    // 2. 加窗 (Q15 乘法, 四舍五入), 纯实数FFT，直接存储实数数据
+    fft_buffer[i] = (q15_t)((head * w + 0x4000) >> 15);
+    fft_buffer[j] = (q15_t)((tail * w + 0x4000) >> 15);
+  }
+}
+
+/**
+ * @brief Q31 精度的预处理与加窗, 比 Q15 路径多保留 Q31_EXTRA_BITS 位
+ * (Q15 窗系数的乘积不再右移, 正好多出 15 位)
+ */
+static void preprocess_and_prepare_fft_q31(const uint16_t *adc_data,
+                                           bool is_signed, int32_t offset,
+                                           q31_t *fft_buffer) {
+  const q15_t *window = gWindows[active_window()].half_table;
+  if (window == NULL) {
+    // 矩形窗: 系数 1.0 即乘 2^15 (|x| < 2^16, 不会溢出)
+    for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+      fft_buffer[i] = (centered_sample(adc_data[i], is_signed) - offset) *
+                      (1 << Q31_EXTRA_BITS);
+    }
+    return;
+  }
+  for (uint32_t i = 0, j = SAMPLE_SIZE - 1; i < SAMPLE_SIZE / 2; i++, j--) {
+    int32_t w = window[i];
+    int32_t head = centered_sample(adc_data[i], is_signed) - offset;
+    int32_t tail = centered_sample(adc_data[j], is_signed) - offset;
+    fft_buffer[i] = head * w;
+    fft_buffer[j] = tail * w;
+  }
+}
+
+bool pipeline_preprocess_begin(void) {
+#if SPECTRUM_IN_CAPTURE_BUFFER
+  return false; // 工作区就是采集缓冲区
+#else
+  // 阶次跟踪时预处理的输入是重采样的输出
+  if (gAnalysisProfile.order_tracking) {
+    return false;
+  }
+  pipeline_offset = last_offset;
+  pipeline_window =
+      is_coherent_locked() ? WINDOW_RECTANGULAR : gAnalysisProfile.window;
+  pipeline_precision = gAnalysisProfile.fft_precision;
+  return true;
+#endif
+}
+
+void pipeline_preprocess_chunk(const uint16_t *adc_data, uint32_t start,
+                               uint32_t end) {
+  // 与 preprocess_and_prepare_fft(_q31) 逐点相同, 窗函数后半按对称取
+  const bool is_signed =
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  const q15_t *window = gWindows[pipeline_window].half_table;
+  for (uint32_t n = start; n < end; n++) {
+    const int32_t v = centered_sample(adc_data[n], is_signed) - pipeline_offset;
+    const int32_t w =
+        window != NULL ? window[n < SAMPLE_SIZE / 2 ? n : SAMPLE_SIZE - 1 - n]
+                       : 0;
+    if (pipeline_precision == FFT_PRECISION_Q31) {
+      workspace_q31[n] = window != NULL ? v * w : v * (1 << Q31_EXTRA_BITS);
+    } else {
+      workspace_q15[n] = window != NULL ? (q15_t)((v * w + 0x4000) >> 15)
+                                        : saturate_q15(v);
+    }
+  }
+}
+
+/**
+ * @brief 双通道预处理: 两路分别去直流、缩放与加窗后合成复数序列
+ * z[n] = v[n] + j*i[n], 同时累加计算真功率因数所需的乘积和
+ * @note 乘积和用加窗后的样本计算, 非整周期截断时比矩形截断误差小
+ */
+static void preprocess_dual_channel(const uint16_t *voltage,
+                                    const uint16_t *current, bool is_signed,
+                                    int32_t v_offset, int32_t i_offset,
+                                    q15_t *fft_buffer, DualChannelSums *sums) {
+  const q15_t *window = gWindows[active_window()].half_table;
+  int64_t vv = 0, ii = 0, vi = 0;
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    int32_t v = centered_sample(voltage[n], is_signed) - v_offset;
+    int32_t i = centered_sample(current[n], is_signed) - i_offset;
+    if (window == NULL) {
+      v = saturate_q15(v);
+      i = saturate_q15(i);
+    } else {
+      // 窗函数后半按对称取
+      int32_t w = window[n < SAMPLE_SIZE / 2 ? n : SAMPLE_SIZE - 1 - n];
+      v = (v * w + 0x4000) >> 15;
+      i = (i * w + 0x4000) >> 15;
+    }
+    fft_buffer[2 * n] = (q15_t)v;
+    fft_buffer[2 * n + 1] = (q15_t)i;
+    vv += v * v;
+    ii += i * i;
+    vi += v * i;
+  }
+  sums->vv = vv;
+  sums->ii = ii;
+  sums->vi = vi;
+}
+
+/**
+ * @brief 由 z = v + j*i 的复数 FFT 结果 Z 拆分出两路实数信号的频谱
+ * V[k] = (Z[k] + conj(Z[N-k])) / 2, I[k] = (Z[k] - conj(Z[N-k])) / (2j),
+ * 并换算为与单通道相同刻度的幅度谱
+ * @note 不写入 fft_buffer, 之后仍可从中取基波的复数值
+ */
+static void split_dual_spectrum(const q15_t *fft_buffer, uint32_t fft_exponent,
+                                q31_t *v_spectrum, q31_t *i_spectrum) {
+  // 拆分公式中的 1/2 并入缩放
+  const int32_t shift =
+      (int32_t)fft_exponent - SAMPLE_SIZE_LOG2 + MAG_FRAC_BITS - 1;
+  for (uint32_t k = 0; k < SAMPLE_SIZE / 2; k++) {
+    int32_t v[2], i[2];
+    cfft_split_real_q15(fft_buffer, SAMPLE_SIZE, k, v, i);
+    v_spectrum[k] = (q31_t)scaled_magnitude(
+        (uint64_t)((int64_t)v[0] * v[0] + (int64_t)v[1] * v[1]), shift);
+    i_spectrum[k] = (q31_t)scaled_magnitude(
+        (uint64_t)((int64_t)i[0] * i[0] + (int64_t)i[1] * i[1]), shift);
+  }
+}
 
-    fft_buffer[i] = windowed; // 纯实数FFT，直接存储实数数据
+/**
+ * @brief 计算功率因数、位移功率因数与基波相位差
+ * @param fft_buffer 双通道复数 FFT 结果
+ * @param fundamental_idx 电压基波频点, 两路基波同频, 在同一频点比较相位
+ * (加窗与非整周期引起的相位偏移两路相同, 相减后抵消)
+ */
+static void calculate_power(const q15_t *fft_buffer, uint32_t fundamental_idx,
+                            uint32_t fundamental_freq_mhz,
+                            const DualChannelSums *sums, PowerAnalysis *power) {
+  // 真功率因数 = sum(v*i) / sqrt(sum(v^2) * sum(i^2))
+  // 乘积和 < 2^41, 开方后 < 2^21, 两者之积 < 2^42
+  int64_t rms_product =
+      (int64_t)isqrt64((uint64_t)sums->vv) * isqrt64((uint64_t)sums->ii);
+  if (rms_product == 0) {
+    return;
   }
+  int64_t pf = sums->vi * RATIO_SCALE / rms_product;
+  power->power_factor = (int32_t)(pf > RATIO_SCALE
+                                      ? RATIO_SCALE
+                                      : (pf < -RATIO_SCALE ? -RATIO_SCALE : pf));
+
+  // 基波 V1 * conj(I1) 的辐角即位移角 (拆分公式的公共系数不影响辐角)
+  int32_t v[2], i[2];
+  cfft_split_real_q15(fft_buffer, SAMPLE_SIZE, fundamental_idx, v, i);
+  double cross_re = (double)((int64_t)v[0] * i[0] + (int64_t)v[1] * i[1]);
+  double cross_im = (double)((int64_t)v[1] * i[0] - (int64_t)v[0] * i[1]);
+  double phi = atan2(cross_im, cross_re);
+
+  power->displacement_angle = (int32_t)lround(phi * 18000.0 / PI);
+  power->displacement_power_factor = (int32_t)lround(cos(phi) * RATIO_SCALE);
+  // 时间偏移 = phi / (2 * pi * f0)
+  power->phase_offset_ns = (int32_t)lround(
+      phi / (2.0 * PI) * 1e12 / (double)fundamental_freq_mhz);
+  power->valid = true;
 }
 
 /**
  * @brief 执行 Q15 定点实数 FFT。
+ * @return 频谱指数 e, 真实频谱 X[k] = 输出 * 2^e
  */
-static void perform_fft(q15_t *fft_buffer) {
-  // 根据 SAMPLE_SIZE 选择合适的 CMSIS RFFT 实例
+static uint32_t perform_fft(q15_t *fft_buffer, FftEngine engine) {
+  if (engine == FFT_ENGINE_RADIX4) {
+    return rfft_q15_inplace(fft_buffer, SAMPLE_SIZE);
+  }
+
+  // 根据 SAMPLE_SIZE 选择合适的 CMSIS RFFT 实例, 输出为 X/N
 #if SAMPLE_SIZE == 1024
   arm_rfft_instance_q15 rfft_instance;
   arm_rfft_init_q15(&rfft_instance, SAMPLE_SIZE, 0, 1);
@@ -185,20 +927,37 @@ static void perform_fft(q15_t *fft_buffer) {
   arm_rfft_instance_q15 rfft_instance;
   arm_rfft_init_q15(&rfft_instance, SAMPLE_SIZE, 0, 1);
   arm_rfft_q15(&rfft_instance, fft_buffer, fft_buffer);
+#elif SPECTRUM_IN_CAPTURE_BUFFER
+  // 大点数只支持原地基4实现, 见 is_fft_config_supported
+  (void)fft_buffer;
 #else
 #error                                                                         \
     "Unsupported SAMPLE_SIZE for arm_rfft_q15. Check consts.h and CMSIS-DSP lib."
 #endif
+  return SAMPLE_SIZE_LOG2;
+}
+
+/**
+ * @brief 执行 Q31 定点实数 FFT (CMSIS-DSP), 输出为 X/N
+ */
+static void perform_fft_q31(q31_t *fft_buffer) {
+  arm_rfft_instance_q31 rfft_instance;
+  arm_rfft_init_q31(&rfft_instance, SAMPLE_SIZE, 0, 1);
+  arm_rfft_q31(&rfft_instance, fft_buffer, fft_buffer);
 }
 
 // --- 修改幅度谱计算函数 ---
 /**
  * @brief 计算实数FFT输出的幅度谱(Q31格式)
  * @param fft_buffer FFT输出缓冲区(q15_t格式)
+ * @param fft_exponent FFT 输出的频谱指数, 幅度统一换算到 X/N 的
+ * 2^MAG_FRAC_BITS 倍
  * @param mag_spectrum 输出的幅度谱(q31_t格式)
- * @note 手动计算以提高精度，使用32位运算避免溢出
+ * @note 手动计算以提高精度，使用32位运算避免溢出.
+ * 基4实现把奈奎斯特频点放在 [1], 因此第 0 点幅度无意义 (后续查找不使用)
  */
 static void calculate_magnitude_spectrum(const q15_t *fft_buffer,
+                                         uint32_t fft_exponent,
                                          q31_t *mag_spectrum) {
   // FFT输出是复数形式(实部+虚部交替存储)
   for (uint32_t i = 0; i < SAMPLE_SIZE / 2; i++) {
@@ -213,99 +972,178 @@ static void calculate_magnitude_spectrum(const q15_t *fft_buffer,
     int64_t sum_sq = real_sq + imag_sq;
     // __BKPT();
 
-    // 计算平方根(近似计算)
-    // 可以使用ARM的平方根函数或自定义近似算法
-    q31_t magnitude = (q31_t)sqrt(sum_sq);
+    // 计算平方根, 并按频谱指数换算到统一刻度
+    int32_t shift = (int32_t)fft_exponent - SAMPLE_SIZE_LOG2 + MAG_FRAC_BITS;
 
     // __BKPT();
     // 存储结果
-    mag_spectrum[i] = magnitude;
+    mag_spectrum[i] = (q31_t)scaled_magnitude((uint64_t)sum_sq, shift);
   }
 }
+
 /**
- * @brief 在幅度谱的指定窗口内查找最大峰值。
+ * @brief 计算 Q31 实数FFT输出的幅度谱, 换算到与 Q15 路径相同的刻度
+ * @note 可原地计算 (mag_spectrum 与 fft_buffer 相同)
  */
-static bool find_peak_in_window(const q31_t *mag_spectrum,
-                                uint32_t search_start, uint32_t search_end,
-                                uint32_t *peak_idx, q15_t *peak_val) {
-  // 确保窗口索引有效且不为 0 (跳过直流)
-  search_start = (search_start == 0) ? 1 : search_start;
-  if (search_start > search_end || search_start >= SAMPLE_SIZE / 2) {
-    *peak_idx = 0;
-    *peak_val = 0;
-    return false; // 无效窗口
+static void calculate_magnitude_spectrum_q31(const q31_t *fft_buffer,
+                                             q31_t *mag_spectrum) {
+  const uint32_t shift = Q31_EXTRA_BITS - MAG_FRAC_BITS;
+  for (uint32_t i = 0; i < SAMPLE_SIZE / 2; i++) {
+    int64_t real = fft_buffer[2 * i];
+    int64_t imag = fft_buffer[2 * i + 1];
+    // 平方和 < 2^63, 用无符号 64 位保存
+    uint64_t sum_sq = (uint64_t)(real * real) + (uint64_t)(imag * imag);
+    uint32_t magnitude = isqrt64(sum_sq);
+    mag_spectrum[i] = (q31_t)((magnitude + (1UL << (shift - 1))) >> shift);
   }
+}
 
-  // 限制搜索结束索引不超过有效范围 (最大索引是 SAMPLE_SIZE / 2 - 1)
-  if (search_end >= SAMPLE_SIZE / 2) {
-    search_end = SAMPLE_SIZE / 2 - 1;
+/**
+ * @brief 由实部/虚部平方和求幅度并乘以 2^shift
+ * @note 需要放大时先放大平方和再开方, 保留小数位
+ */
+static uint32_t scaled_magnitude(uint64_t sum_sq, int32_t shift) {
+  if (shift >= 0) {
+    return isqrt64(sum_sq << (2 * shift));
   }
+  return (isqrt64(sum_sq) + (1UL << (-shift - 1))) >> -shift;
+}
 
-  // 确保窗口至少有一个点
-  if (search_start > search_end) {
-    *peak_idx = 0;
-    *peak_val = 0;
-    return false;
+/**
+ * @brief 64 位整数开方 (逐位试商法, 结果向下取整)
+ */
+static uint32_t isqrt64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  // 跳过高位的 0, 减少迭代次数
+  while (bit > value) {
+    bit >>= 2;
   }
 
-  uint32_t window_len = search_end - search_start + 1;
-  uint32_t local_max_idx = 0; // arm_max_q15 返回的是窗口内的相对索引
-  q31_t max_val = 0;
-  arm_status status;
-
-  // 在指定窗口内查找最大值
-  arm_max_q31(mag_spectrum + search_start, // 指向窗口起始位置
-              window_len,                  // 窗口长度
-              &max_val,                    // 输出：最大值
-              &local_max_idx); // 输出：最大值在窗口内的索引 (0 to window_len-1)
-
-  // 如果找到的最大值大于 0 (意味着窗口内有非零值)
-  // 注意：阈值检查在调用此函数之后进行
-  if (max_val > 0) {
-    *peak_val = max_val;
-    *peak_idx = search_start + local_max_idx; // 计算绝对索引
-    return true;
-  } else {
-    *peak_idx = 0;
-    *peak_val = 0;
-    return false; // 窗口内没有找到峰值 (可能已被清零或全为零)
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
   }
+  return (uint32_t)root;
+}
+
+/**
+ * @brief 将累加器整体右移一位并增加块指数, 为新的累加腾出空间
+ */
+static void renormalize_power_acc(void) {
+  for (uint32_t i = 0; i < POWER_ACC_BINS; i++) {
+    power_acc[i] >>= 1;
+  }
+  power_acc_shift++;
+}
+
+void reset_spectrum_average(void) {
+  arm_fill_q31(0, (q31_t *)power_acc, POWER_ACC_BINS);
+  power_acc_shift = 0;
+  power_acc_frames = 0;
+  power_acc_pending = false;
+}
+
+void reset_order_tracking(void) { tracked_freq_mhz = 0; }
+
+bool is_spectrum_average_pending(void) { return power_acc_pending; }
+
+bool will_next_frame_report(void) {
+  uint8_t frames = gAnalysisProfile.average_frames;
+  return frames <= 1 || power_acc_frames + 1 >= frames;
+}
+
+bool is_fft_config_supported(FftEngine engine, FftPrecision precision) {
+#if SPECTRUM_IN_CAPTURE_BUFFER
+  return engine == FFT_ENGINE_RADIX4 && precision == FFT_PRECISION_Q15;
+#else
+  (void)engine;
+  (void)precision;
+  return true;
+#endif
 }
 
 /**
- * @brief 清除幅度谱中指定索引周围的一个窗口。
+ * @brief 将本帧幅度谱的平方(功率谱)并入平均累加器,
+ * 平均完成时把平均后的幅度谱写回 mag_spectrum
+ * @param mag_spectrum 输入本帧幅度谱, 平均完成时输出平均幅度谱
+ * @return true 表示 mag_spectrum 已是可用于谐波查找的平均幅度谱
+ * @note 线性平均每 K 帧输出一次; 指数平均使用 1/K 的平滑系数,
+ * 前 K 帧为预热, 之后每帧输出一次
  */
-static void clear_spectrum_window(q31_t *mag_spectrum, uint32_t center_idx,
-                                  uint32_t half_width, uint32_t max_idx) {
-  if (center_idx == 0 || center_idx > max_idx)
-    return; // 不清除直流或无效中心
+static bool average_power_spectrum(q31_t *mag_spectrum) {
+  uint8_t frames = gAnalysisProfile.average_frames;
+  if (frames <= 1) {
+    power_acc_pending = false;
+    return true; // 不平均, 直接使用单帧频谱
+  }
 
-  // 计算窗口的实际起始和结束索引，并进行边界检查
-  uint32_t start =
-      (center_idx > half_width) ? (center_idx - half_width) : 1; // 最小为 1
-  uint32_t end = center_idx + half_width;
+  // 指数平均的平滑系数 alpha = 1/K (Q16), 首帧直接作为初值
+  bool exponential = gAnalysisProfile.average_mode == AVERAGE_MODE_EXPONENTIAL;
+  bool first_frame = power_acc_frames == 0;
+  uint32_t alpha_q16 = 65536U / frames;
+
+  for (uint32_t i = 1; i < POWER_ACC_BINS; i++) {
+    uint64_t power = (uint64_t)mag_spectrum[i] * (uint64_t)mag_spectrum[i];
+    uint64_t updated;
+
+    while (1) {
+      uint64_t scaled = power >> power_acc_shift;
+      if (!exponential) {
+        updated = (uint64_t)power_acc[i] + scaled;
+      } else if (first_frame) {
+        updated = scaled;
+      } else {
+        int64_t delta = (int64_t)scaled - (int64_t)power_acc[i];
+        updated = (uint64_t)((int64_t)power_acc[i] +
+                             ((delta * (int64_t)alpha_q16) >> 16));
+      }
+      if (updated <= UINT32_MAX) {
+        break;
+      }
+      // 溢出: 所有频点统一降一位精度后重算当前频点
+      renormalize_power_acc();
+    }
+    power_acc[i] = (uint32_t)updated;
+  }
 
-  // 确保结束索引不超过最大有效索引
-  if (end > max_idx) {
-    end = max_idx;
+  if (power_acc_frames < frames) {
+    power_acc_frames++;
+  }
+  if (power_acc_frames < frames) {
+    power_acc_pending = true;
+    return false; // 平均帧数不足, 继续采样
   }
 
-  // 清零窗口内的幅度值
-  if (start <= end) { // 确保窗口有效
-    // 使用 CMSIS-DSP 的 arm_fill_q15 进行优化
-    uint32_t num_elements_to_clear = end - start + 1;
-    if (num_elements_to_clear > 0) {
-      arm_fill_q31(0, mag_spectrum + start, num_elements_to_clear);
+  // 由平均功率还原幅度谱, 后续谐波查找与单帧流程完全一致
+  mag_spectrum[0] = 0;
+  for (uint32_t i = 1; i < POWER_ACC_BINS; i++) {
+    uint64_t power = (uint64_t)power_acc[i] << power_acc_shift;
+    if (!exponential) {
+      power /= frames;
     }
+    mag_spectrum[i] = (q31_t)isqrt64(power);
+  }
+
+  if (!exponential) {
+    reset_spectrum_average(); // 线性平均: 开始下一组 K 帧
   }
+  power_acc_pending = false;
+  return true;
 }
 
 /**
  * @brief 查找基波频率分量。
  */
-static bool find_fundamental(const q31_t *mag_spectrum, q15_t threshold,
+static bool find_fundamental(const q31_t *mag_spectrum, q31_t threshold,
                              uint32_t *fundamental_idx,
-                             q15_t *fundamental_val) {
+                             q31_t *fundamental_val) {
   // 搜索范围从索引 1 到 SAMPLE_SIZE / 2 - 1 (FFT_MAG_SPECTRUM_VALID_LEN)
   uint32_t search_len = FFT_MAG_SPECTRUM_VALID_LEN;
   *fundamental_idx = 0; // 初始化
@@ -316,7 +1154,6 @@ static bool find_fundamental(const q31_t *mag_spectrum, q15_t threshold,
 
   uint32_t max_idx_relative = 0; // 结果是相对于搜索起点的索引
   q31_t max_val = 0;
-  arm_status status;
 
   // 在 mag_spectrum[1] 到 mag_spectrum[SAMPLE_SIZE/2 - 1] 范围内查找最大值
   arm_max_q31(mag_spectrum + 1, // 从索引 1 开始搜索
@@ -342,142 +1179,447 @@ static bool find_fundamental(const q31_t *mag_spectrum, q15_t threshold,
 }
 
 /**
- * @brief 查找各次谐波分量。
+ * @brief 单次扫描的梳状谐波查找。
+ * @details 谐波窗口 [n*f0 - w, n*f0 + w] 沿频谱单调向后排列,
+ * 只需一个游标从基波窗口之后扫到奈奎斯特频率即可找出所有谐波,
+ * 无需每次谐波单独调用 arm_max_q31 再清零窗口。
+ * 窗口重叠时 (f0 <= 2w), 已被上一个谐波占用的频点不会被重复计入,
+ * 效果等同于原先的清零窗口。
+ * @param harmonic_indices 输出前 num_reported 个谐波的索引
+ * @param harmonic_magnitudes 输出奈奎斯特频率以下全部谐波的幅度
+ * @return 奈奎斯特频率以下的谐波个数 (含基波)
  */
-static void
-find_harmonics(q31_t *mag_spectrum, // 注意：此函数会修改 mag_spectrum
-               uint32_t fundamental_idx, q15_t threshold,
-               uint32_t *harmonic_indices, // 输出
-               q15_t *harmonic_magnitudes) // 输出
-{
+static uint32_t find_harmonics(const q31_t *mag_spectrum,
+                               uint32_t fundamental_idx, q31_t threshold,
+                               uint32_t *harmonic_indices,
+                               uint8_t num_reported,
+                               q31_t *harmonic_magnitudes) {
   // 假设 harmonic_indices[0] 和 harmonic_magnitudes[0] 已被填充为基波信息
-
-  // 从二次谐波开始查找 (n=2), 直到 NUM_HARMONICS
-  for (uint8_t n = 2; n <= NUM_HARMONICS; n++) {
-    int harmonic_array_index =
-        n - 1; // 在结果数组中的索引 (H2 存在 index 1, H3 存 index 2...)
-
-    // 1. 计算谐波的期望频率索引 (理想位置)
-    uint32_t expected_idx = n * fundamental_idx;
-
-    // 2. 检查期望索引是否超出有效范围 (FFT_MAG_SPECTRUM_VALID_LEN)
+  // 基波窗口及之前的频点都已被占用
+  uint32_t next_free = fundamental_idx + HARMONIC_SEARCH_WINDOW_HALF_WIDTH + 1;
+  uint32_t expected_idx = fundamental_idx;
+  uint32_t n = 1;
+
+  while (n < MAX_HARMONIC_ORDER) {
+    // 1. 下一次谐波的期望频率索引 (理想位置)
+    expected_idx += fundamental_idx;
     if (expected_idx > FFT_MAG_SPECTRUM_VALID_LEN) {
-      harmonic_magnitudes[harmonic_array_index] = 0;
-      harmonic_indices[harmonic_array_index] =
-          expected_idx; // 仍然保存理论索引位置
-      continue; // 超出范围，该谐波及其更高次谐波都无法查找
+      break; // 已超出奈奎斯特频率
     }
+    n++;
 
-    // 3. 定义搜索窗口 [search_start, search_end]
-    uint32_t search_start =
-        (expected_idx > HARMONIC_SEARCH_WINDOW_HALF_WIDTH)
-            ? (expected_idx - HARMONIC_SEARCH_WINDOW_HALF_WIDTH)
-            : 1; // 最小从索引 1 开始
+    // 2. 定义搜索窗口 [search_start, search_end], 跳过已占用的频点
+    uint32_t search_start = expected_idx - HARMONIC_SEARCH_WINDOW_HALF_WIDTH;
+    if (search_start < next_free) {
+      search_start = next_free;
+    }
     uint32_t search_end = expected_idx + HARMONIC_SEARCH_WINDOW_HALF_WIDTH;
-    // 再次确保 search_end 不超过最大有效索引
     if (search_end > FFT_MAG_SPECTRUM_VALID_LEN) {
       search_end = FFT_MAG_SPECTRUM_VALID_LEN;
     }
-    // 确保 start <= end
-    if (search_start > search_end) {
-      search_start = search_end; // 如果窗口宽度导致 start > end，让它们相等
-    }
-
-    // 4. 在窗口内查找最大峰值
-    uint32_t found_peak_idx = 0;
-    q15_t found_peak_val = 0;
-    bool peak_found_in_window =
-        find_peak_in_window(mag_spectrum, search_start, search_end,
-                            &found_peak_idx, &found_peak_val);
-
-    // 5. 检查找到的峰值是否满足阈值
-    if (peak_found_in_window && found_peak_val >= threshold) {
-      // 存储找到的谐波信息
-      harmonic_magnitudes[harmonic_array_index] = found_peak_val;
-      harmonic_indices[harmonic_array_index] = found_peak_idx;
-
-      // 6. 清除该谐波所在搜索窗口的幅度谱，防止干扰更高次谐波查找
-      //    使用期望索引作为中心进行清除
-      clear_spectrum_window(mag_spectrum, expected_idx,
-                            HARMONIC_SEARCH_WINDOW_HALF_WIDTH,
-                            FFT_MAG_SPECTRUM_VALID_LEN);
+
+    // 3. 在窗口内查找最大峰值
+    uint32_t peak_idx = expected_idx;
+    q31_t peak_val = 0;
+    for (uint32_t k = search_start; k <= search_end; k++) {
+      if (mag_spectrum[k] > peak_val) {
+        peak_val = mag_spectrum[k];
+        peak_idx = k;
+      }
+    }
+
+    // 4. 检查找到的峰值是否满足阈值, 且为局部最大值: 基波靠近低端时
+    // 窗口会落在相邻单音单调下降的泄漏上, 窗口边缘的频点不是谐波
+    const bool is_peak =
+        mag_spectrum[peak_idx] >= mag_spectrum[peak_idx - 1] &&
+        (peak_idx == FFT_MAG_SPECTRUM_VALID_LEN ||
+         mag_spectrum[peak_idx] >= mag_spectrum[peak_idx + 1]);
+    if (peak_val >= threshold && is_peak) {
+      harmonic_magnitudes[n - 1] = peak_val;
+      // 该窗口被当前谐波占用, 防止干扰更高次谐波查找
+      next_free = search_end + 1;
     } else {
       // 未找到满足条件的谐波峰值，但仍记录理论谐波位置
-      harmonic_magnitudes[harmonic_array_index] = 0;
-      harmonic_indices[harmonic_array_index] =
-          expected_idx; // 使用理论期望位置而不是0
-      // 注意：这里不清除窗口，因为没有确认找到目标谐波
+      harmonic_magnitudes[n - 1] = 0;
+      peak_idx = expected_idx;
     }
-  } // 结束谐波查找循环
+    if (n <= num_reported) {
+      harmonic_indices[n - 1] = peak_idx;
+    }
+  }
+
+  // 超出奈奎斯特频率的上报谐波: 幅度为 0，记录理论谐波位置
+  for (uint32_t i = n; i < num_reported; i++) {
+    harmonic_indices[i] = (i + 1) * fundamental_idx;
+  }
+
+  return n;
 }
 
 /**
- * @brief 计算总谐波失真 (THD) 和归一化的谐波幅度。
+ * @brief 抽取的帧在某频点处的 CIC 滤波器增益, 其余帧为 1
  */
-static void calculate_results(const q15_t *harmonic_magnitudes_q15,
-                              AnalysisResult *result) {
-  // 将基波幅度从 Q15 转换为 IQ 格式
-  _iq fundamental_val_iq = _Q15toIQ(harmonic_magnitudes_q15[0]);
+static double decimation_droop(double bin) {
+  if (!is_frame_decimated()) {
+    return 1.0;
+  }
+  // 一个频点对应的频率与抽取后采样率之比 (重采样后频点间隔不同)
+  const double bin_ratio =
+      frame_sample_rate_hz() / (SAMPLE_SIZE * get_sample_rate_hz());
+  return decimation_gain(bin * bin_ratio);
+}
 
-  // 检查基波幅度是否有效 (大于 0)
-  if (fundamental_val_iq <= _IQ(0.0)) {
-    result->thd = -2.0f; // 错误码：基波幅度无效或为零
-    // 归一化谐波保持为 0 (已在 analyze_harmonics 中初始化)
+/**
+ * @brief 抽取的帧补偿 CIC 滤波器的通带下垂: 各次谐波幅度除以滤波器在
+ * 该次谐波理论频率处的增益 (高次谐波衰减较多, 不补偿时 THD 偏小)
+ */
+static void compensate_decimation_droop(q31_t *harmonic_magnitudes,
+                                        uint32_t harmonic_count,
+                                        uint32_t fundamental_idx) {
+  if (!is_frame_decimated()) {
     return;
   }
+  for (uint32_t i = 0; i < harmonic_count; i++) {
+    double corrected = harmonic_magnitudes[i] /
+                       decimation_droop((double)((i + 1) * fundamental_idx));
+    harmonic_magnitudes[i] =
+        corrected < INT32_MAX ? (q31_t)corrected : INT32_MAX;
+  }
+}
 
-  // --- 计算 THD ---
-  _iq harmonics_sq_sum_iq = _IQ(0.0); // 初始化谐波平方和 (IQ 格式)
+/**
+ * @brief 细化 (zoom-FFT) 基波频率与上报的各次谐波幅度
+ * @details 基波在插值结果附近细化, 各次谐波以细化后基波频率的整数倍为中心.
+ * 细化的幅度没有频点间的扇贝损失, 替换幅度谱查到的值后再计算 THD;
+ * 只细化前 zoom_tones 个 (默认只有基波), 其余谐波保持不变
+ * @param offset_q16 输入为插值得到的基波小数偏移, 输出为细化后的偏移
+ */
+static void zoom_harmonics(const ZoomFrame *zoom, WindowType window,
+                           uint32_t fundamental_idx, uint32_t harmonic_count,
+                           uint32_t num_reported, int32_t *offset_q16) {
+#if ZOOM_SUPPORTED
+  void *buffer = &workspace_q31[ZOOM_WORKSPACE_OFFSET];
+  const uint8_t factor = gAnalysisProfile.zoom_factor;
+  double fundamental = fundamental_idx + *offset_q16 / 65536.0;
+  uint32_t count =
+      harmonic_count < num_reported ? harmonic_count : num_reported;
+  if (count > gAnalysisProfile.zoom_tones) {
+    count = gAnalysisProfile.zoom_tones;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    const double center = fundamental * (i + 1);
+    if (harmonic_magnitudes[i] == 0 ||
+        center + ZOOM_SEARCH_BINS >= SAMPLE_SIZE / 2) {
+      continue;
+    }
+    ZoomTone tone;
+    if (!zoom_tone(zoom->samples, zoom->is_signed, zoom->offset, window,
+                   factor, center, ZOOM_SEARCH_BINS, buffer, &tone)) {
+      continue;
+    }
+    if (i == 0) {
+      fundamental = tone.bins;
+      *offset_q16 = (int32_t)lround((tone.bins - fundamental_idx) * 65536.0);
+    }
+    double magnitude = tone.magnitude * (1 << MAG_FRAC_BITS) /
+                       decimation_droop(tone.bins);
+    harmonic_magnitudes[i] =
+        magnitude < INT32_MAX ? (q31_t)(magnitude + 0.5) : INT32_MAX;
+  }
+#else
+  (void)zoom;
+  (void)window;
+  (void)fundamental_idx;
+  (void)harmonic_count;
+  (void)num_reported;
+  (void)offset_q16;
+#endif
+}
+
+/**
+ * @brief 累加幅度谱 [lo, hi] 区间的功率
+ */
+static uint64_t band_power(const q31_t *mag_spectrum, uint32_t lo,
+                           uint32_t hi) {
+  uint64_t power = 0;
+  for (uint32_t k = lo; k <= hi; k++) {
+    uint64_t m = (uint64_t)mag_spectrum[k];
+    power += m * m;
+  }
+  return power;
+}
+
+/**
+ * @brief 按基波的小数频点排列直流区、基波与各次谐波的窗口
+ * @details 基波窗口取完整宽度, 其下方最多 tone_width 个频点为直流区;
+ * 谐波窗口缩小到谐波间隔的一半以内, 谐波之间留有噪声频点
+ * @param offset_q16 基波相对 fundamental_idx 的小数偏移
+ * @param tone_width 窗口半宽 (频点)
+ */
+static void tone_layout(uint32_t fundamental_idx, int32_t offset_q16,
+                        uint32_t tone_width, ToneLayout *layout) {
+  layout->step_q16 = (fundamental_idx << 16) + (uint32_t)offset_q16;
+  const uint32_t center = (layout->step_q16 + 0x8000) >> 16;
+  layout->f_lo = center > tone_width ? center - tone_width : 1;
+  layout->f_hi = center + tone_width;
+  if (layout->f_hi > FFT_MAG_SPECTRUM_VALID_LEN) {
+    layout->f_hi = FFT_MAG_SPECTRUM_VALID_LEN;
+  }
+  layout->dc_end = layout->f_lo - 1 < tone_width ? layout->f_lo - 1 : tone_width;
+  layout->half_width = tone_width;
+  if (layout->half_width > (fundamental_idx - 1) / 2) {
+    layout->half_width = (fundamental_idx - 1) / 2;
+  }
+  layout->center_q16 = layout->step_q16;
+  layout->next_free = layout->f_hi + 1;
+}
+
+/**
+ * @brief 取下一个谐波窗口 [lo, hi] (从二次谐波开始), 窗口按 find_harmonics
+ * 的方式依次排列, 重叠时不重复占用频点
+ * @return false 表示已超出奈奎斯特频率
+ */
+static bool next_harmonic_window(ToneLayout *layout, uint32_t *center,
+                                 uint32_t *lo, uint32_t *hi) {
+  while (1) {
+    layout->center_q16 += layout->step_q16;
+    *center = (layout->center_q16 + 0x8000) >> 16;
+    if (*center > FFT_MAG_SPECTRUM_VALID_LEN) {
+      return false;
+    }
+    *lo = *center - layout->half_width;
+    *hi = *center + layout->half_width;
+    if (*lo < layout->next_free) {
+      *lo = layout->next_free;
+    }
+    if (*hi > FFT_MAG_SPECTRUM_VALID_LEN) {
+      *hi = FFT_MAG_SPECTRUM_VALID_LEN;
+    }
+    if (*lo <= *hi) {
+      layout->next_free = *hi + 1;
+      return true;
+    }
+  }
+}
+
+/**
+ * @brief 由幅度谱计算 THD+N、SINAD、SNR 与 ENOB
+ * @details 直流区与基波窗口以外的功率即为噪声与失真; 再逐个累加各次谐波
+ * 窗口内的功率, 其余频点为噪声。谐波窗口内同样有噪声, 按噪声频点的平均
+ * 功率扣除, 噪声总功率按全部频点折算。
+ * 各频点都按窗的等效噪声带宽展宽, 功率比值与窗无关。
+ * 幅度 < 2^24 (满量程正弦约 2^22), 平方和不会溢出
+ */
+static void calculate_spectral_metrics(const q31_t *mag_spectrum,
+                                       ToneLayout layout,
+                                       SpectralMetrics *metrics) {
+  const uint32_t last = FFT_MAG_SPECTRUM_VALID_LEN;
+  const uint64_t fundamental =
+      band_power(mag_spectrum, layout.f_lo, layout.f_hi);
+  if (fundamental == 0) {
+    *metrics = (SpectralMetrics){0};
+    return;
+  }
+  // 噪声与失真: 除直流区与基波窗口外的全部频点
+  const uint64_t distortion =
+      band_power(mag_spectrum, layout.dc_end + 1, layout.f_lo - 1) +
+      (layout.f_hi < last ? band_power(mag_spectrum, layout.f_hi + 1, last)
+                          : 0);
+  const uint32_t other_bins =
+      last - layout.dc_end - (layout.f_hi - layout.f_lo + 1);
+
+  // 抽取的帧按 CIC 下垂补偿 (与 THD 一致), 噪声按未补偿的频谱计
+  uint64_t harmonics = 0;
+  uint32_t harmonic_bins = 0;
+  double harmonics_comp = 0;
+  uint32_t center, lo, hi;
+  while (next_harmonic_window(&layout, &center, &lo, &hi)) {
+    const uint64_t power = band_power(mag_spectrum, lo, hi);
+    const double gain = decimation_droop(center);
+    harmonics += power;
+    harmonics_comp += (double)power / (gain * gain);
+    harmonic_bins += hi - lo + 1;
+  }
+
+  // 谐波窗口内的噪声按噪声频点的平均功率估计
+  const uint32_t noise_bins = other_bins - harmonic_bins;
+  double noise = (double)(distortion - harmonics);
+  if (noise_bins != 0) {
+    const double density = noise / noise_bins;
+    harmonics_comp -= density * harmonic_bins;
+    if (harmonics_comp < 0) {
+      harmonics_comp = 0;
+    }
+    noise = density * other_bins;
+  }
+  const double f_gain = decimation_droop((layout.step_q16 + 0x8000) >> 16);
+  const double p1 = (double)fundamental / (f_gain * f_gain);
+  const double nad = noise + harmonics_comp;
+
+  metrics->thd_n = (uint32_t)(sqrt(nad / p1) * RATIO_SCALE + 0.5);
+  metrics->sinad = nad * 1e20 > p1
+                       ? (int32_t)lround(1000.0 * log10(p1 / nad))
+                       : SPECTRAL_MAX_DB;
+  // 没有噪声频点时无法区分谐波与噪声, 信噪比按信纳比计
+  metrics->snr = noise_bins == 0 ? metrics->sinad
+                 : noise * 1e20 > p1
+                     ? (int32_t)lround(1000.0 * log10(p1 / noise))
+                     : SPECTRAL_MAX_DB;
+  metrics->enob = (int32_t)lround((metrics->sinad - 176) / 6.02);
+}
+
+/**
+ * @brief 候选峰值按幅度插入从大到小排列的列表, 列表满时替换最小的一个
+ */
+static void insert_peak(q31_t *magnitudes, uint16_t *indices, uint8_t *count,
+                        uint32_t index, q31_t magnitude) {
+  uint32_t n = *count;
+  if (n == SPECTRAL_PEAK_MAX) {
+    if (magnitude <= magnitudes[n - 1]) {
+      return;
+    }
+    n--;
+  } else {
+    (*count)++;
+  }
+  while (n > 0 && magnitudes[n - 1] < magnitude) {
+    magnitudes[n] = magnitudes[n - 1];
+    indices[n] = indices[n - 1];
+    n--;
+  }
+  magnitudes[n] = magnitude;
+  indices[n] = (uint16_t)index;
+}
 
-  // 累加各次谐波幅度的平方 (从二次谐波开始, index=1)
-  for (uint8_t i = 1; i < NUM_HARMONICS; i++) {
-    q15_t current_harmonic_q15 = harmonic_magnitudes_q15[i];
-    if (current_harmonic_q15 > 0) {
-      _iq harmonic_val_iq = _Q15toIQ(current_harmonic_q15);
-      _iq harmonic_sq_iq = _IQmpy(harmonic_val_iq, harmonic_val_iq);
-      // 考虑潜在的溢出，进行累加
-      // 简单的累加，如果 IQmath 范围足够大
-      harmonics_sq_sum_iq += harmonic_sq_iq;
-      // 或者使用饱和累加 (如果担心溢出，需要定义 IQ_MAX, IQ_MIN)
-      // harmonics_sq_sum_iq = _IQsat(harmonics_sq_sum_iq + harmonic_sq_iq,
-      // IQ_MAX, IQ_MIN);
+/**
+ * @brief 单次扫描找出基波与谐波以外最强的 SPECTRAL_PEAK_MAX 个峰值
+ * @details 局部最大值作为候选, 其两侧谷值 (到相邻局部最大值之间的最小值)
+ * 在扫描中顺带得到: 峰值须为较高一侧谷值的 SPECTRAL_PEAK_PROMINENCE 倍,
+ * 且不低于检出阈值 (与谐波相同, 见 harmonic_threshold)。
+ * 直流区、基波与谐波窗口内的频点不参与, 窗口两侧的峰值分别判定
+ * @param fundamental_val 基波幅度 (已补偿 CIC 下垂), 峰值电平相对它计算
+ */
+static void find_spectral_peaks(const q31_t *mag_spectrum, ToneLayout layout,
+                                q31_t threshold, q31_t fundamental_val,
+                                WindowType window, SpectralPeakList *list) {
+  const uint32_t last = FFT_MAG_SPECTRUM_VALID_LEN;
+  q31_t magnitudes[SPECTRAL_PEAK_MAX];
+  uint16_t indices[SPECTRAL_PEAK_MAX];
+  uint8_t count = 0;
+
+  // 当前 (或下一个) 谐波窗口
+  uint32_t center;
+  uint32_t h_lo = last + 1;
+  uint32_t h_hi = last + 1;
+  bool more_windows = next_harmonic_window(&layout, &center, &h_lo, &h_hi);
+
+  bool in_segment = false; // 是否在连续的可用频点中
+  uint32_t candidate = 0;  // 尚未确定右侧谷值的局部最大值, 0 表示没有
+  q31_t left_valley = 0;
+  q31_t valley = 0; // 上一个局部最大值 (或本段开头) 之后的最小值
+
+  for (uint32_t k = layout.dc_end + 1; k <= last + 1; k++) {
+    while (more_windows && k > h_hi) {
+      more_windows = next_harmonic_window(&layout, &center, &h_lo, &h_hi);
+    }
+    const bool excluded = k > last ||
+                          (k >= layout.f_lo && k <= layout.f_hi) ||
+                          (more_windows && k >= h_lo);
+    const q31_t m = k <= last ? mag_spectrum[k] : 0;
+    const bool is_peak = !excluded && m > mag_spectrum[k - 1] &&
+                         (k == last || m >= mag_spectrum[k + 1]);
+    if (candidate != 0 && (excluded || is_peak)) {
+      // 候选峰值的右侧谷值已确定
+      const q31_t peak = mag_spectrum[candidate];
+      const q31_t higher = left_valley > valley ? left_valley : valley;
+      if ((uint64_t)peak >= (uint64_t)higher * SPECTRAL_PEAK_PROMINENCE &&
+          peak >= threshold) {
+        insert_peak(magnitudes, indices, &count, candidate, peak);
+      }
+      candidate = 0;
     }
+    if (excluded) {
+      in_segment = false;
+      continue;
+    }
+    if (!in_segment) {
+      in_segment = true;
+      valley = m;
+    }
+    if (is_peak) {
+      candidate = k;
+      left_valley = valley;
+      valley = m;
+    } else if (m < valley) {
+      valley = m;
+    }
+  }
+
+  // 插值得到频率, 电平相对基波
+  list->count = count;
+  for (uint32_t i = 0; i < count; i++) {
+    SpectralPeak *peak = &list->peaks[i];
+    int32_t offset_q16 =
+        interpolate_peak_offset_q16(mag_spectrum, indices[i], window);
+    peak->index = indices[i];
+    peak->freq_mhz = calc_signal_freq_mhz(indices[i], offset_q16);
+    double ratio = magnitudes[i] / decimation_droop(indices[i]) /
+                   fundamental_val;
+    peak->level = (int16_t)lround(2000.0 * log10(ratio));
   }
+}
+
+/**
+ * @brief 计算总谐波失真 (THD) 和归一化的谐波幅度。
+ * @details 全程整数运算: 谐波平方和用 64 位累加, 开方后与基波相除,
+ * 只在最后一步换算到 RATIO_SCALE 刻度 (1 LSB = 0.001%)。
+ */
+static void calculate_results(const q31_t *harmonic_magnitudes,
+                              uint32_t harmonic_count, AnalysisResult *result) {
+  uint64_t fundamental_val = (uint64_t)harmonic_magnitudes[0];
 
-  _iq thd_numerator_iq = _IQ(0.0);
-  if (harmonics_sq_sum_iq > _IQ(0.0)) {
-    // 计算谐波平方和的平方根
-    // 检查参数是否为负，虽然理论上平方和不应为负
-    if (harmonics_sq_sum_iq < 0)
-      harmonics_sq_sum_iq = _IQ(0.0);
-    thd_numerator_iq = _IQsqrt(harmonics_sq_sum_iq);
+  // 检查基波幅度是否有效 (大于 0)
+  if (harmonic_magnitudes[0] <= 0) {
+    result->thd = THD_ERROR_INVALID_FUNDAMENTAL; // 错误码：基波幅度无效或为零
+    // 归一化谐波保持为 0 (已在 analyze_harmonics 中初始化)
+    return;
   }
 
-  // 计算 THD 比率 (RMS_Harmonics / Fundamental)
-  // 使用安全的除法，防止除以零 (虽然前面检查过 fundamental_val_iq > 0)
-  _iq thd_ratio_iq = _IQdiv(thd_numerator_iq, fundamental_val_iq);
+  // --- 计算 THD ---
+  // 累加奈奎斯特频率以下各次谐波幅度的平方 (从二次谐波开始, index=1)
+  // 幅度 < 2^31, 平方 < 2^62, 谐波个数不超过 MAX_HARMONIC_ORDER 时不会溢出
+  // (实际幅度远小于 2^31)
+  uint64_t harmonics_sq_sum = 0;
+  for (uint32_t i = 1; i < harmonic_count; i++) {
+    uint64_t harmonic_val = (uint64_t)harmonic_magnitudes[i];
+    harmonics_sq_sum += harmonic_val * harmonic_val;
+  }
 
-  // 转换为百分比
-  _iq hundred_iq = _IQ(100.0);
-  _iq thd_percent_iq = _IQmpy(thd_ratio_iq, hundred_iq);
+  // 开方前把平方和左移 2 * frac_bits 位, 让平方根保留 frac_bits 位小数,
+  // 避免谐波很小时整数开方的截断误差
+  uint32_t frac_bits = 0;
+  while (frac_bits < 16 && harmonics_sq_sum != 0 &&
+         harmonics_sq_sum < ((uint64_t)1 << 60)) {
+    harmonics_sq_sum <<= 2;
+    frac_bits++;
+  }
+  uint64_t harmonics_rms = isqrt64(harmonics_sq_sum);
 
-  // 将最终 THD (IQ 格式) 转换为浮点数并存储
-  result->thd = _IQtoF(thd_percent_iq);
+  // THD = sqrt(sum(Hn^2)) / H1, 换算到 0.001% 刻度并四舍五入
+  uint64_t thd_scaled =
+      (harmonics_rms * RATIO_SCALE + (fundamental_val << frac_bits) / 2) /
+      fundamental_val;
+  result->thd = (int32_t)(thd_scaled >> frac_bits);
 
   // --- 计算归一化谐波幅度 ---
-  result->normalized_harmonics_amplitudes[0] = 1.0f; // 基波 H1/H1 = 1.0
-
-  for (uint8_t i = 1; i < NUM_HARMONICS; i++) {
-    q15_t current_harmonic_q15 = harmonic_magnitudes_q15[i];
-    if (current_harmonic_q15 > 0) {
-      _iq harmonic_val_iq = _Q15toIQ(current_harmonic_q15);
-      // 计算归一化幅度 (Hn / H1)
-      _iq norm_harmonic_iq = _IQdiv(harmonic_val_iq, fundamental_val_iq);
-      // 转换为浮点数并存储
-      result->normalized_harmonics_amplitudes[i] = _IQtoF(norm_harmonic_iq);
-    } else {
-      result->normalized_harmonics_amplitudes[i] = 0.0f;
-    }
+  result->normalized_harmonics_amplitudes[0] = RATIO_SCALE; // 基波 H1/H1 = 1.0
+
+  for (uint32_t i = 1; i < result->num_harmonics && i < harmonic_count; i++) {
+    uint64_t harmonic_val = (uint64_t)harmonic_magnitudes[i];
+    // 计算归一化幅度 (Hn / H1), 四舍五入
+    result->normalized_harmonics_amplitudes[i] = (uint32_t)(
+        (harmonic_val * RATIO_SCALE + fundamental_val / 2) / fundamental_val);
   }
 }
 
@@ -486,31 +1628,65 @@ static void calculate_results(const q15_t *harmonic_magnitudes_q15,
 #define NO_SIGNAL_MEAN_THRESHOLD 200.0f // 均值与ADC中点的差值小于此值认为无信号
 
 /**
- * @brief 通过计算均值和方差检测直流信号或无信号
+ * @brief 由一帧的统计量计算时域指标
+ * @param mean 均值 (码值)
+ * @param variance 方差 (码值^2)
+ */
+static void fill_time_metrics(const FrameStats *stats, float mean,
+                              float variance, TimeDomainMetrics *metrics) {
+  const float rms = sqrtf(variance);
+  const float offset = mean - ADC_MIDPOINT;
+  const float peak = fmaxf(stats->max - offset, offset - stats->min);
+
+  metrics->mean = (uint32_t)(mean * 1000.0f + 0.5f);
+  metrics->ac_rms = (uint32_t)(rms * 1000.0f + 0.5f);
+  metrics->min = (uint16_t)(stats->min + ADC_MIDPOINT);
+  metrics->max = (uint16_t)(stats->max + ADC_MIDPOINT);
+  // 交流有效值不到一个码值时峰值因数没有意义
+  metrics->crest_factor =
+      rms >= 1.0f ? (uint32_t)(peak / rms * RATIO_SCALE + 0.5f) : 0;
+  metrics->duty_cycle =
+      (uint32_t)(((uint64_t)stats->above * RATIO_SCALE + SAMPLE_SIZE / 2) /
+                 SAMPLE_SIZE);
+  metrics->zero_crossings = (uint16_t)stats->crossings;
+  metrics->clipped = (uint16_t)stats->clipped;
+}
+
+/**
+ * @brief 通过计算均值和方差检测直流信号或无信号, 同时得到时域指标
  * @param adc_data 输入的ADC数据数组
+ * @param channel 过零与占空比的参考电平所属的通道
  * @return 检测结果: WAVEFORM_DC(直流), WAVEFORM_NONE(无信号),
  * WAVEFORM_UNKNOWN(需要进一步分析)
  */
 static void detect_dc_or_no_signal(const uint16_t *adc_data,
+                                   FrameChannel channel,
                                    WaveformType *waveform, float *mean_out,
-                                   bool *has_dc_offset_out) {
-  uint32_t i;
-  float sum = 0.0f;
-  float sum_sq = 0.0f;
-  float mean, variance;
-
-  // 1. 计算均值
-  for (i = 0; i < SAMPLE_SIZE; i++) {
-    sum += (float)adc_data[i];
+                                   bool *has_dc_offset_out,
+                                   TimeDomainMetrics *metrics) {
+  // 以中点为零的 12 位码值做整数累加, 一次遍历同时得到均值、方差与时域指标;
+  // ADC0 单独采集时已在采集期间逐块累加 (见 capture_stats.c), 只需补上
+  // 最后不足一块的部分. 过零与占空比的参考电平先取上一帧的中值, 信号电平
+  // 或幅度改变时 (包括首帧) 在累加中按已累加部分改用新的, 不再遍历一遍
+  const bool is_signed =
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  FrameStats stats;
+  if (channel != FRAME_CHANNEL_MAIN || !capture_stats_take(adc_data, &stats)) {
+    frame_stats_init(&stats, channel);
+    frame_stats_accumulate(&stats, adc_data, SAMPLE_SIZE, is_signed, 0);
   }
-  mean = sum / SAMPLE_SIZE;
+  frame_stats_finish(&stats);
+  const int32_t sum = stats.sum;
+  const uint64_t sum_sq = stats.sum_sq;
+
+  // 1. 均值
+  float mean = ADC_MIDPOINT + (float)sum / SAMPLE_SIZE;
+  // 2. 方差 = (N * sum(c^2) - sum(c)^2) / N^2
+  int64_t variance_num =
+      (int64_t)(sum_sq * SAMPLE_SIZE) - (int64_t)sum * (int64_t)sum;
+  float variance = (float)variance_num / ((float)SAMPLE_SIZE * SAMPLE_SIZE);
+  fill_time_metrics(&stats, mean, variance, metrics);
 
-  // 2. 计算方差
-  for (i = 0; i < SAMPLE_SIZE; i++) {
-    float diff = (float)adc_data[i] - mean;
-    sum_sq += diff * diff;
-  }
-  variance = sum_sq / SAMPLE_SIZE;
   // 是由有直流偏置
   bool has_dc_offset = fabsf(mean - ADC_MIDPOINT) > NO_SIGNAL_MEAN_THRESHOLD;
   // 信号基本是直线
@@ -535,16 +1711,16 @@ static void detect_dc_or_no_signal(const uint16_t *adc_data,
  * @return 检测到的波形类型
  */
 static WaveformType detect_waveform_type(const AnalysisResult *result) {
-  float h2 = result->normalized_harmonics_amplitudes[1]; // 2次谐波
-  float h3 = result->normalized_harmonics_amplitudes[2]; // 3次谐波
-  float h4 = result->normalized_harmonics_amplitudes[3]; // 4次谐波
-  float h5 = result->normalized_harmonics_amplitudes[4]; // 5次谐波
+  uint32_t h2 = result->normalized_harmonics_amplitudes[1]; // 2次谐波
+  uint32_t h3 = result->normalized_harmonics_amplitudes[2]; // 3次谐波
+  uint32_t h4 = result->normalized_harmonics_amplitudes[3]; // 4次谐波
+  uint32_t h5 = result->normalized_harmonics_amplitudes[4]; // 5次谐波
 
   /* 1. 正弦波判断:
    *    H2, H3, H4, H5 => [0.0, 0.03]
    */
-  if (fabsf(h2) < 0.03f && fabsf(h3) < 0.03f && fabsf(h4) < 0.03f &&
-      fabsf(h5) < 0.03f) {
+  if (h2 < RATIO(0.03) && h3 < RATIO(0.03) && h4 < RATIO(0.03) &&
+      h5 < RATIO(0.03)) {
     return WAVEFORM_SINE;
   }
 
@@ -554,8 +1730,8 @@ static WaveformType detect_waveform_type(const AnalysisResult *result) {
    *    H4 => [0.0, 0.03],
    *    H5 => [0.00, 0.05]
    */
-  if (fabsf(h2) < 0.03f && (h3 >= 0.08f && h3 <= 0.14f) && fabsf(h4) < 0.03f &&
-      (h5 >= 0.0f && h5 <= 0.05f)) {
+  if (h2 < RATIO(0.03) && (h3 >= RATIO(0.08) && h3 <= RATIO(0.14)) &&
+      h4 < RATIO(0.03) && h5 <= RATIO(0.05)) {
     return WAVEFORM_TRIANGLE;
   }
 
@@ -565,8 +1741,8 @@ static WaveformType detect_waveform_type(const AnalysisResult *result) {
    *    H4 => [0.0, 0.03],
    *    H5 => [0.0, 0.25]
    */
-  if (fabsf(h2) < 0.03f && (h3 >= 0.30f && h3 <= 0.36f) && fabsf(h4) < 0.03f &&
-      (h5 >= 0.0f && h5 <= 0.25f)) {
+  if (h2 < RATIO(0.03) && (h3 >= RATIO(0.30) && h3 <= RATIO(0.36)) &&
+      h4 < RATIO(0.03) && h5 <= RATIO(0.25)) {
     return WAVEFORM_SQUARE;
   }
 
@@ -576,11 +1752,129 @@ static WaveformType detect_waveform_type(const AnalysisResult *result) {
    *    H4 => [0.23, 0.27],
    *    H5 => [0.0, 0.22]
    */
-  if ((h2 >= 0.45f && h2 <= 0.55f) && (h3 >= 0.30f && h3 <= 0.36f) &&
-      (h4 >= 0.23f && h4 <= 0.27f) && (h5 >= 0.0f && h5 <= 0.22f)) {
+  if ((h2 >= RATIO(0.45) && h2 <= RATIO(0.55)) &&
+      (h3 >= RATIO(0.30) && h3 <= RATIO(0.36)) &&
+      (h4 >= RATIO(0.23) && h4 <= RATIO(0.27)) && h5 <= RATIO(0.22)) {
     return WAVEFORM_SAWTOOTH;
   }
 
   // 未匹配任何特征
   return WAVEFORM_UNKNOWN;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 测量细化一个单音的耗时: 先 (不计时) 做一次 Q15 FFT, 在幅度谱的
+ * 最大值处细化一次, 同时生成该细化倍数的增益补偿表, 再计时细化一次
+ */
+static uint32_t benchmark_zoom(bool is_signed, int32_t offset) {
+  preprocess_and_prepare_fft(VALID_ADC_DATA, is_signed, offset, workspace_q15);
+  uint32_t exponent = perform_fft(workspace_q15, FFT_ENGINE_RADIX4);
+  calculate_magnitude_spectrum(workspace_q15, exponent, workspace_q31);
+  uint32_t peak = MIN_FUNDAMENTAL_IDX;
+  for (uint32_t k = peak + 1; k < FFT_MAG_SPECTRUM_VALID_LEN; k++) {
+    if (workspace_q31[k] > workspace_q31[peak]) {
+      peak = k;
+    }
+  }
+
+  const uint8_t factor = gAnalysisProfile.zoom_factor != 0
+                             ? gAnalysisProfile.zoom_factor
+                             : ZOOM_MIN_FACTOR;
+  void *buffer = &workspace_q31[ZOOM_WORKSPACE_OFFSET];
+  ZoomTone tone;
+  zoom_tone(VALID_ADC_DATA, is_signed, offset, active_window(), factor, peak,
+            ZOOM_SEARCH_BINS, buffer, &tone);
+  uint32_t start = get_cycle_count();
+  zoom_tone(VALID_ADC_DATA, is_signed, offset, active_window(), factor, peak,
+            ZOOM_SEARCH_BINS, buffer, &tone);
+  return get_cycle_count() - start;
+}
+
+/**
+ * @brief 双通道两路幅度谱的耗时, 输出位置与 analyze_dual_channel 相同
+ * @param separate false 为合成一次复数 FFT 再拆分, true 为两路各做一次
+ * 实数 FFT (engine 为所用实现)
+ */
+static uint32_t benchmark_dual(bool is_signed, int32_t v_offset,
+                               int32_t i_offset, bool separate,
+                               FftEngine engine) {
+  q31_t *v_spectrum = &workspace_q31[SAMPLE_SIZE];
+  q31_t *i_spectrum = &workspace_q31[SAMPLE_SIZE + SAMPLE_SIZE / 2];
+  uint32_t start = get_cycle_count();
+  if (separate) {
+    preprocess_and_prepare_fft(VALID_ADC_DATA, is_signed, v_offset,
+                               workspace_q15);
+    uint32_t exponent = perform_fft(workspace_q15, engine);
+    calculate_magnitude_spectrum(workspace_q15, exponent, v_spectrum);
+    preprocess_and_prepare_fft(VALID_CURRENT_DATA, is_signed, i_offset,
+                               workspace_q15);
+    exponent = perform_fft(workspace_q15, engine);
+    calculate_magnitude_spectrum(workspace_q15, exponent, i_spectrum);
+  } else {
+    DualChannelSums sums;
+    preprocess_dual_channel(VALID_ADC_DATA, VALID_CURRENT_DATA, is_signed,
+                            v_offset, i_offset, workspace_q15, &sums);
+    uint32_t exponent = cfft_q15_inplace(workspace_q15, SAMPLE_SIZE);
+    split_dual_spectrum(workspace_q15, exponent, v_spectrum, i_spectrum);
+  }
+  return get_cycle_count() - start;
+}
+
+uint32_t benchmark_analysis_stage(BenchmarkStage stage, FftEngine engine,
+                                  FftPrecision precision) {
+  if (!BENCHMARK_SUPPORTED) {
+    return 0;
+  }
+  WaveformType preliminary_detection = WAVEFORM_UNKNOWN;
+  float mean_value = 0.0;
+  bool has_dc_offset = false;
+  const bool is_signed =
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+
+  if (stage == BENCHMARK_STAGE_RESAMPLE) {
+    uint32_t step_q20 =
+        frame_step_q20 != 0 ? frame_step_q20 : ORDER_TRACKING_BENCHMARK_STEP;
+    uint32_t start = get_cycle_count();
+    resample_frame(VALID_ADC_DATA, is_signed, step_q20,
+                   resample_buffer(precision));
+    return get_cycle_count() - start;
+  }
+
+  // 均值只用于去直流, 检测本身不计入前端阶段 (正常采集时大多已在
+  // 采集期间完成, 见 capture_stats.c)
+  TimeDomainMetrics metrics;
+  detect_dc_or_no_signal(VALID_ADC_DATA, FRAME_CHANNEL_MAIN,
+                         &preliminary_detection, &mean_value, &has_dc_offset,
+                         &metrics);
+  const int32_t offset = scaled_mean(mean_value);
+  if (stage == BENCHMARK_STAGE_ZOOM) {
+    return benchmark_zoom(is_signed, offset);
+  }
+  if (stage == BENCHMARK_STAGE_DUAL || stage == BENCHMARK_STAGE_DUAL_SEPARATE) {
+    float current_mean = 0.0f;
+    detect_dc_or_no_signal(VALID_CURRENT_DATA, FRAME_CHANNEL_CURRENT,
+                           &preliminary_detection, &current_mean,
+                           &has_dc_offset, &metrics);
+    return benchmark_dual(is_signed, offset, scaled_mean(current_mean),
+                          stage == BENCHMARK_STAGE_DUAL_SEPARATE, engine);
+  }
+  uint32_t start = get_cycle_count();
+  if (precision == FFT_PRECISION_Q31) {
+    preprocess_and_prepare_fft_q31(VALID_ADC_DATA, is_signed, offset,
+                                   workspace_q31);
+  } else {
+    preprocess_and_prepare_fft(VALID_ADC_DATA, is_signed, offset,
+                               workspace_q15);
+  }
+  if (stage == BENCHMARK_STAGE_PREPROCESS) {
+    return get_cycle_count() - start;
+  }
+
+  start = get_cycle_count();
+  if (precision == FFT_PRECISION_Q31) {
+    perform_fft_q31(workspace_q31);
+  } else {
+    perform_fft(workspace_q15, engine);
+  }
+  return get_cycle_count() - start;
+}
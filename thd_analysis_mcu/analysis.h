@@ -16,15 +16,62 @@ typedef enum {
   WAVEFORM_UNKNOWN   // 未知或无法归类的波形
 } WaveformType;
 
+// 比值定点刻度: RATIO_SCALE 表示 1.0 (100%), 1 LSB = 0.001%
+#define RATIO_SCALE 100000
+#define RATIO(x) ((uint32_t)((x) * RATIO_SCALE))
+
+// THD 错误码 (RATIO_SCALE 刻度下的 -1.0% 与 -2.0%)
+#define THD_ERROR_NO_SIGNAL (-1000)           // 无有效波形或未找到基波
+#define THD_ERROR_INVALID_FUNDAMENTAL (-2000) // 基波幅度无效
+
+// 时域指标, 与直流/无信号检测在同一次遍历中得到; 码值为 12 位 ADC 码值
+typedef struct {
+  uint32_t mean;           // 均值, 单位 0.001 码值
+  uint32_t ac_rms;         // 交流有效值 (去除均值后的均方根), 单位 0.001 码值
+  uint16_t min;            // 最小码值
+  uint16_t max;            // 最大码值, 峰峰值 = max - min
+  uint32_t crest_factor;   // 峰值因数 max|x - 均值| / 交流有效值, RATIO_SCALE 刻度
+  uint32_t duty_cycle;     // 高于中值 (最大最小值的平均) 的点数占比, RATIO_SCALE 刻度
+  uint16_t zero_crossings; // 穿越中值的次数 (上升与下降合计, 带回差)
+  uint16_t clipped;        // 落在满量程两端 (码值 0 或 4095) 的点数
+} TimeDomainMetrics;
+
+// 频谱指标, 由谐波分析所用的同一幅度谱得到; 未找到基波时全为 0
+typedef struct {
+  uint32_t thd_n; // 总谐波失真加噪声 sqrt(除基波外的总功率 / 基波功率), RATIO_SCALE 刻度
+  int32_t sinad;  // 信纳比 10lg(基波功率 / 噪声与失真功率), 单位 0.01dB
+  int32_t snr;    // 信噪比 10lg(基波功率 / 除谐波外的噪声功率), 单位 0.01dB
+  int32_t enob;   // 有效位数 (SINAD - 1.76) / 6.02, 单位 0.01 位
+} SpectralMetrics;
+
+// 频谱峰值列表的最大条数
+#define SPECTRAL_PEAK_MAX 8
+
+// 基波与谐波以外的一个频谱峰值 (间谐波、开关频率、工频泄漏等)
+typedef struct {
+  uint32_t freq_mhz; // 插值后的频率 (mHz)
+  uint16_t index;    // 峰值所在频点
+  int16_t level;     // 相对基波的幅度, 单位 0.01dBc
+} SpectralPeak;
+
+// 最强的若干个非谐波峰值, 按幅度从大到小排列; 未找到基波时为空
+typedef struct {
+  uint8_t count;
+  SpectralPeak peaks[SPECTRAL_PEAK_MAX];
+} SpectralPeakList;
+
 // 谐波分析结果结构体
 typedef struct {
   // 4 Byte
-  float thd; // 总谐波失真 (%)
-  // 4 * NUM_HARMONICS Bytes
-  float normalized_harmonics_amplitudes[NUM_HARMONICS]; // 归一化谐波幅度 (Hn / H1),
-                                             // [0]是基波(=1.0), [1]是二次,...
-  // 4 * NUM_HARMONICS Bytes
-  uint32_t harmonic_indices[NUM_HARMONICS]; // 各次谐波在 FFT 频谱中的索引,
+  int32_t thd; // 总谐波失真, 单位 0.001% (例如 1234 表示 1.234%), 负值为错误码
+  // 有效的谐波数量 (含基波), 即下面两个数组实际使用的长度
+  uint8_t num_harmonics;
+  // 4 * num_harmonics Bytes
+  uint32_t normalized_harmonics_amplitudes[MAX_HARMONICS]; // 归一化谐波幅度
+                           // (Hn / H1), 单位 0.001%,
+                           // [0]是基波(=RATIO_SCALE), [1]是二次,...
+  // 4 * num_harmonics Bytes
+  uint32_t harmonic_indices[MAX_HARMONICS]; // 各次谐波在 FFT 频谱中的索引,
                                             // [0]是基波, [1]是二次,...
   // 4 Bytes
   uint32_t fundamental_freq;
@@ -32,9 +79,90 @@ typedef struct {
   WaveformType waveform; // 检测到的波形类型
   // 1 Byte
   bool has_dc_offset;
-  // 可以选择性地添加基波频率 (如果需要计算的话)
-  // float fundamental_frequency;
+  // 插值后的基波频率 (mHz), 供相干采样计算定时器参数, 不上传
+  uint32_t fundamental_freq_mhz;
+  // 时域指标, 只在扩展记录中上传 (见 RESULT_EXT_TIME_DOMAIN)
+  TimeDomainMetrics time_metrics;
+  // 频谱指标, 只在扩展记录中上传 (见 RESULT_EXT_SPECTRAL)
+  SpectralMetrics spectral_metrics;
+  // 非谐波峰值, 只在扩展记录中上传 (见 RESULT_EXT_PEAKS)
+  SpectralPeakList spectral_peaks;
 } AnalysisResult;
+
+// 电压/电流双通道分析的功率参数
+typedef struct {
+  // 电流通道的谐波分析结果 (电压通道的结果由 analyze_dual_channel 返回)
+  AnalysisResult current;
+  // 两个通道都找到基波时以下各项才有效
+  bool valid;
+  // 真功率因数 P / (Vrms * Irms), 含谐波, RATIO_SCALE 刻度, 负值表示反向送电
+  int32_t power_factor;
+  // 位移功率因数 cos(phi1), 只计基波, RATIO_SCALE 刻度
+  int32_t displacement_power_factor;
+  // 位移角 phi1 = 电压基波相位 - 电流基波相位, 单位 0.01°,
+  // 范围 -18000 ~ 18000, 正值为电流滞后 (感性)
+  int32_t displacement_angle;
+  // 位移角换算成的电流相对电压的时间偏移 (ns), 正值为电流滞后
+  int32_t phase_offset_ns;
+} PowerAnalysis;
+
+// 频谱平均方式
+typedef enum {
+  AVERAGE_MODE_LINEAR = 0,     // 线性平均: 累加 K 帧功率谱后输出一次结果
+  AVERAGE_MODE_EXPONENTIAL = 1 // 指数平均: 预热 K 帧后每帧输出一次滑动平均结果
+} AverageMode;
+
+// 频谱平均帧数上限 (不超过u8)
+#define MAX_AVERAGE_FRAMES 64
+
+// 检出阈值高出噪声底的裕量范围 (dB)
+#define MIN_NOISE_MARGIN_DB 3
+#define MAX_NOISE_MARGIN_DB 60
+
+// FFT 实现
+typedef enum {
+  FFT_ENGINE_CMSIS = 0, // CMSIS-DSP arm_rfft_q15 (每级固定缩放)
+  FFT_ENGINE_RADIX4 = 1 // 原地基4实数 FFT (块浮点缩放, 见 fft.c)
+} FftEngine;
+
+// FFT 运算精度
+typedef enum {
+  FFT_PRECISION_Q15 = 0, // Q15 全流程 (默认, 最快)
+  FFT_PRECISION_Q31 = 1  // Q31 全流程 (arm_rfft_q31, 动态范围更大, 约慢一倍以上)
+} FftPrecision;
+
+// 分析配置
+typedef struct {
+  // 参与功率谱平均的帧数 K, 1 表示不平均(单帧分析)
+  uint8_t average_frames;
+  // 平均方式
+  AverageMode average_mode;
+  // 上报的谐波数量 (含基波), MIN_HARMONICS ~ MAX_HARMONICS
+  // 注意: THD 始终按奈奎斯特频率以下的全部谐波计算, 与此值无关
+  uint8_t num_harmonics;
+  // FFT 实现 (仅 Q15 精度时有效, Q31 精度固定使用 CMSIS-DSP)
+  FftEngine fft_engine;
+  // FFT 运算精度
+  FftPrecision fft_precision;
+  // 加窗类型
+  WindowType window;
+  // 基波、谐波与频谱峰值的检出阈值高出本帧噪声底的裕量 (dB),
+  // MIN_NOISE_MARGIN_DB ~ MAX_NOISE_MARGIN_DB
+  uint8_t noise_margin_db;
+  // 细化倍数: 0 关闭, 否则在基波 (及 zoom_tones 包含的谐波) 附近以
+  // 1/zoom_factor 频点的间隔细化频率与幅度 (见 zoom.h);
+  // 多帧平均、阶次跟踪与双通道时不生效
+  uint8_t zoom_factor;
+  // 细化的单音数: 1 只细化基波 (默认), 最多 ZOOM_MAX_TONES (基波加低次谐波).
+  // 每个单音需一次整帧的下变频与滤波和一次细化 FFT
+  uint8_t zoom_tones;
+  // 阶次跟踪: 按上一帧的基波频率把一帧重采样到整周期后再做 FFT
+  // (使用矩形窗), 相干采样锁定时不生效
+  bool order_tracking;
+} AnalysisProfile;
+
+extern AnalysisProfile gAnalysisProfile;
+
 /**
  * @brief 分析信号谐波并计算总谐波失真
  * @param adc_data ADC采样数据
@@ -42,4 +170,107 @@ typedef struct {
  */
 AnalysisResult analyze_harmonics(const uint16_t *adc_data);
 
+/**
+ * @brief 电压/电流双通道分析: 两路实数信号合成一个复数序列,
+ * 只做一次 SAMPLE_SIZE 点复数 FFT 即得到两路频谱
+ * @param voltage 电压通道 (ADC0) 采样
+ * @param current 电流通道 (ADC1) 采样
+ * @param power 输出电流通道结果与功率参数
+ * @return 电压通道的谐波分析结果
+ * @note 只支持 Q15 精度 (固定使用原地基4实现), 不做频谱平均与阶次跟踪;
+ * SAMPLE_SIZE > 1024 时不可用 (见 DUAL_CHANNEL_SUPPORTED)
+ */
+AnalysisResult analyze_dual_channel(const uint16_t *voltage,
+                                    const uint16_t *current,
+                                    PowerAnalysis *power);
+
+/**
+ * @brief 清空功率谱平均累加器, 下一帧重新开始平均
+ * @note 采样率或平均参数改变后必须调用, 否则会混入不同频率分辨率的频谱
+ */
+void reset_spectrum_average(void);
+
+/**
+ * @brief 丢弃阶次跟踪的基波频率估计, 下一帧不重采样
+ * @note 切换到另一路信号 (多通道扫描) 时调用
+ */
+void reset_order_tracking(void);
+
+/**
+ * @brief 开始一帧采集时调用 (capture_stats.c): 本帧能否边采集边预处理
+ * @details 采集期间每累加一块统计量, 同时把这一块按上一帧的均值去直流、
+ * 缩放并加窗写入 FFT 工作区. 分析时本帧均值与之相差不大、且窗函数与精度
+ * 未变时直接做 FFT, 不再遍历一遍采样
+ * @return false 表示不能 (大点数时工作区就是采集缓冲区; 阶次跟踪)
+ */
+bool pipeline_preprocess_begin(void);
+
+/**
+ * @brief 预处理一帧中已采到的 [start, end) 部分
+ */
+void pipeline_preprocess_chunk(const uint16_t *adc_data, uint32_t start,
+                               uint32_t end);
+
+// 噪声底百分位数的分辨率: 每个二进制数量级再细分为 2^NOISE_FLOOR_SUB_BITS 档
+#define NOISE_FLOOR_SUB_BITS 5
+
+/**
+ * @brief 求 mag_spectrum[begin, end] 中从小到大第 rank 个 (从 0 起) 幅度,
+ * 两遍计数, 线性时间, 不需要排序也不改动频谱
+ * @return 所在档的中点, 相对误差不超过 2^-(NOISE_FLOOR_SUB_BITS + 1);
+ * 幅度为 0 时返回 0
+ * @note 供噪声底估计使用 (第 25 百分位数), 幅度须非负
+ */
+q31_t select_magnitude(const q31_t *mag_spectrum, uint32_t begin, uint32_t end,
+                       uint32_t rank);
+
+/**
+ * @brief 查询频谱平均是否仍在累加中
+ * @return true 表示最近一次 analyze_harmonics 只累加了频谱, 结果尚不可用,
+ * 需要继续采样
+ */
+bool is_spectrum_average_pending(void);
+
+/**
+ * @brief 查询下一次 analyze_harmonics 是否会给出结果 (而不是只累加频谱)
+ * @note 大点数时 FFT 会覆盖原始采样, 需据此决定是否在分析前先上传原始采样.
+ * 直流/无信号时即使预计不出结果也会直接返回结果, 此时原始采样未被覆盖
+ */
+bool will_next_frame_report(void);
+
+/**
+ * @brief 检查 FFT 实现与精度组合在当前 SAMPLE_SIZE 下是否可用
+ * @note SAMPLE_SIZE > 1024 时 FFT 在采集缓冲区上原地进行, 只支持基4 Q15
+ */
+bool is_fft_config_supported(FftEngine engine, FftPrecision precision);
+
+// 可测量耗时的分析阶段
+typedef enum {
+  BENCHMARK_STAGE_FFT = 0,        // 单次 FFT
+  BENCHMARK_STAGE_PREPROCESS = 1, // 前端: 去直流、缩放与加窗 (不含直流/无信号检测)
+  BENCHMARK_STAGE_RESAMPLE = 2,   // 阶次跟踪重采样 (Catmull-Rom 插值)
+  BENCHMARK_STAGE_ZOOM = 3,       // 细化一个单音 (下变频、抽取与短 FFT)
+  BENCHMARK_STAGE_DUAL = 4,       // 双通道两路频谱: 合成、一次复数 FFT 并拆分
+  BENCHMARK_STAGE_DUAL_SEPARATE = 5 // 同样两路频谱改为各做一次实数 FFT
+} BenchmarkStage;
+
+// 大点数时 FFT 工作区就是采集缓冲区, 测量会覆盖被测的采样, 不支持测量
+#define BENCHMARK_SUPPORTED (!SPECTRUM_IN_CAPTURE_BUFFER)
+
+/**
+ * @brief 测量一个分析阶段的耗时
+ * @param stage 被测阶段
+ * @param engine 被测 FFT 实现 (precision 为 Q31 时及细化、双通道合成阶段
+ * 忽略)
+ * @param precision 被测 FFT 精度 (细化与双通道两个阶段忽略, 均为 Q15)
+ * @return SysTick 计数的 CPU 周期数, 不支持测量时 (见 BENCHMARK_SUPPORTED)
+ * 返回 0
+ * @note 使用 VALID_ADC_DATA 中最近一帧采样作为输入, 不修改该帧,
+ * 不影响频谱平均状态. 前端阶段的均值由计时之外的直流/无信号检测得到.
+ * 双通道两个阶段以 VALID_CURRENT_DATA 为电流通道, 含两路的预处理、FFT 与
+ * 幅度谱, 不含功率计算
+ */
+uint32_t benchmark_analysis_stage(BenchmarkStage stage, FftEngine engine,
+                                  FftPrecision precision);
+
 #endif /* HARMONICS_ANALYSIS_H */
@@ -0,0 +1,232 @@
+#include "capture_stats.h"
+#include "analysis.h"
+#include "sampling.h"
+#include "ti_msp_dl_config.h"
+
+// 单 ADC 采集时 DMA 一次搬运两点, 一帧 (含丢弃区) 的字数
+#define CAPTURE_WORDS ((SAMPLE_SIZE + ADC_DISCARD_SAMPLES) / 2)
+
+static FrameStats acc;
+// 已累加的点数 (从 VALID_ADC_DATA 开头算起)
+static uint32_t processed = 0;
+static bool active = false;
+// 本帧边采集边预处理 (去直流、缩放与加窗), 以及取用时是否已预处理完整帧
+static bool preprocessing = false;
+static bool preprocessed = false;
+static bool frame_signed = false;
+static uint32_t frame_shift = 0;
+// 硬件平均时原始采样为无符号格式, 多出的位数与换算时的舍入
+// 与 sampling_normalize_frame 一致
+static bool frame_oversampled = false;
+static uint32_t frame_extra = 0;
+static int32_t frame_round = 0;
+
+// 各通道的参考电平、回差与峰峰值, 由上一帧的统计量得到; 峰峰值为 0
+// (上电后首帧) 时在累加第一块后改用按这一块算出的参考电平
+typedef struct {
+  int16_t reference;
+  int16_t hysteresis;
+  int16_t span;
+} FrameLevel;
+static FrameLevel levels[FRAME_CHANNEL_COUNT];
+
+// 回差取峰峰值的 1/16, 至少 FRAME_MIN_HYSTERESIS 个码值 (噪声)
+#define FRAME_HYSTERESIS_DIV 16
+#define FRAME_MIN_HYSTERESIS 4
+
+static FrameLevel level_from_range(int32_t min, int32_t max) {
+  const int32_t span = max - min;
+  int32_t hysteresis = span / FRAME_HYSTERESIS_DIV;
+  if (hysteresis < FRAME_MIN_HYSTERESIS) {
+    hysteresis = FRAME_MIN_HYSTERESIS;
+  }
+  return (FrameLevel){(int16_t)((min + max) / 2), (int16_t)hysteresis,
+                      (int16_t)span};
+}
+
+/**
+ * @brief 每累加一块后检查参考电平: 已累加部分的峰峰值超过得到参考电平时的
+ * 2 倍 (首帧或幅度变大), 或峰峰值已不小于当时而中值偏离参考电平超过峰峰值的
+ * 1/8 (电平改变) 时, 改用按已累加部分算出的参考电平, 占空比与过零重新计数
+ * @note 已累加部分不到一个周期时峰峰值偏小, 不据此判定电平改变;
+ * 幅度变小在帧内无法与此区分, 本帧仍按原回差计数, 下一帧起按新的
+ */
+static void track_reference(FrameStats *s) {
+  const FrameLevel now = level_from_range(s->min, s->max);
+  const int32_t offset = now.reference - s->reference;
+  if (now.span <= 2 * s->span &&
+      (now.span < s->span ||
+       (offset <= now.span / 8 && -offset <= now.span / 8))) {
+    return;
+  }
+  s->reference = now.reference;
+  s->hysteresis = now.hysteresis;
+  s->span = now.span;
+  s->above = 0;
+  s->crossings = 0;
+  s->counted = 0;
+  s->side = 0;
+}
+
+void frame_stats_init(FrameStats *stats, FrameChannel channel) {
+  const FrameLevel *level = &levels[channel];
+  const uint32_t shift = ADC_RESOLUTION_SHIFT(get_adc_resolution());
+  *stats = (FrameStats){
+      .min = INT16_MAX,
+      .max = INT16_MIN,
+      .clip_high = (int16_t)((((ADC_MIDPOINT * 2 - 1) >> shift) << shift) -
+                             ADC_MIDPOINT),
+      .reference = level->reference,
+      .hysteresis = level->hysteresis,
+      .span = level->span,
+      .channel = (uint8_t)channel,
+  };
+}
+
+void frame_stats_finish(FrameStats *stats) {
+  // 参考电平在帧内改变过时, 只有最后一段按它计数, 按点数比例换算到整帧
+  if (stats->counted != 0 && stats->counted < stats->count) {
+    stats->above = (uint32_t)(((uint64_t)stats->above * stats->count +
+                               stats->counted / 2) /
+                              stats->counted);
+    stats->crossings = (stats->crossings * stats->count + stats->counted / 2) /
+                       stats->counted;
+  }
+  levels[stats->channel] = level_from_range(stats->min, stats->max);
+}
+
+// 把一个码值计入统计量; 调用方在局部副本上累加, 便于编译器放在寄存器中
+static inline void add_code(FrameStats *s, int32_t c) {
+  if (c < s->min) {
+    s->min = (int16_t)c;
+  }
+  if (c > s->max) {
+    s->max = (int16_t)c;
+  }
+  if (c <= -ADC_MIDPOINT || c >= s->clip_high) {
+    s->clipped++;
+  }
+  if (c > s->reference) {
+    s->above++;
+    if (c > s->reference + s->hysteresis) {
+      s->crossings += s->side < 0;
+      s->side = 1;
+    }
+  } else if (c < s->reference - s->hysteresis) {
+    s->crossings += s->side > 0;
+    s->side = -1;
+  }
+}
+
+/**
+ * @brief 把采样换算为以中点为零的 12 位码值后累加, 每到
+ * CAPTURE_STATS_CHUNK 的整数倍点数检查一次参考电平
+ * @param shift 换算前的左移位数
+ * @param extra 硬件平均多出的位数 (右移, 加 round 舍入), 无符号格式
+ */
+static void accumulate_codes(FrameStats *stats, const uint16_t *samples,
+                             uint32_t count, bool is_signed, uint32_t shift,
+                             uint32_t extra, int32_t round) {
+  FrameStats s = *stats;
+  while (count != 0) {
+    uint32_t n = CAPTURE_STATS_CHUNK - s.count % CAPTURE_STATS_CHUNK;
+    n = n < count ? n : count;
+    int32_t sum = 0;
+    uint64_t sum_sq = 0;
+    for (uint32_t i = 0; i < n; i++) {
+      int32_t c =
+          is_signed ? ((int16_t)samples[i] >> ADC_SIGNED_SHIFT)
+                    : (((((int32_t)samples[i] << shift) + round) >> extra) -
+                       ADC_MIDPOINT);
+      sum += c;
+      sum_sq += (uint32_t)(c * c);
+      add_code(&s, c);
+    }
+    s.sum += sum;
+    s.sum_sq += sum_sq;
+    s.count += n;
+    s.counted += n;
+    samples += n;
+    count -= n;
+    if (s.count % CAPTURE_STATS_CHUNK == 0) {
+      track_reference(&s);
+    }
+  }
+  *stats = s;
+}
+
+void frame_stats_accumulate(FrameStats *stats, const uint16_t *samples,
+                            uint32_t count, bool is_signed, uint32_t shift) {
+  accumulate_codes(stats, samples, count, is_signed, shift, 0, 0);
+}
+
+void capture_stats_begin(bool enable) {
+  frame_stats_init(&acc, FRAME_CHANNEL_MAIN);
+  processed = 0;
+  active = enable;
+  preprocessed = false;
+  // 与 sampling_normalize_frame 的换算一致; 有符号格式在任何分辨率下都是 Q15
+  frame_signed = gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  frame_shift = is_raw_data_signed()
+                    ? 0
+                    : ADC_RESOLUTION_SHIFT(get_adc_resolution());
+  frame_oversampled = get_oversampling_ratio() > 1;
+  frame_extra = oversampling_extra_bits(get_oversampling_ratio());
+  // 有符号格式保留多出的位, 按码值统计时向下取整; 无符号格式四舍五入
+  frame_round = frame_signed ? 0 : (int32_t)((1U << frame_extra) >> 1);
+  // 预处理按换算后的采样进行, 只在采集的原始采样无需换算时同时进行
+  preprocessing = enable && frame_shift == 0 && !frame_oversampled &&
+                  pipeline_preprocess_begin();
+}
+
+bool capture_stats_running(void) { return active && processed < SAMPLE_SIZE; }
+
+void capture_stats_poll(void) {
+  if (!capture_stats_running()) {
+    return;
+  }
+  // 一帧写完后 DMA 自动重装, 剩余字数回到满值, 算出的进度为 0 而被忽略;
+  // 剩余部分由 capture_stats_take 处理
+  uint32_t written =
+      (CAPTURE_WORDS - DL_DMA_getTransferSize(DMA, DMA_CH0_CHAN_ID)) * 2;
+  if (written < ADC_DISCARD_SAMPLES + processed + CAPTURE_STATS_CHUNK) {
+    return;
+  }
+  uint32_t end = written - ADC_DISCARD_SAMPLES;
+  // 硬件平均的原始采样为无符号格式, 按 sampling_normalize_frame 的方式
+  // 舍入到 12 位码值
+  accumulate_codes(&acc, &VALID_ADC_DATA[processed], end - processed,
+                   frame_signed && !frame_oversampled, frame_shift,
+                   frame_extra, frame_round);
+  if (preprocessing) {
+    pipeline_preprocess_chunk(VALID_ADC_DATA, processed, end);
+  }
+  processed = end;
+}
+
+bool capture_stats_take(const uint16_t *samples, FrameStats *out) {
+  if (!active || samples != VALID_ADC_DATA) {
+    return false;
+  }
+  // 此时已换算到 12 位码值, 剩余部分不再移位
+  frame_stats_accumulate(&acc, &samples[processed], SAMPLE_SIZE - processed,
+                         frame_signed, 0);
+  if (preprocessing) {
+    pipeline_preprocess_chunk(samples, processed, SAMPLE_SIZE);
+  }
+  active = false;
+  preprocessed = preprocessing;
+  *out = acc;
+  return true;
+}
+
+void capture_stats_invalidate(void) {
+  active = false;
+  preprocessed = false;
+}
+
+bool capture_stats_take_preprocessed(void) {
+  const bool done = preprocessed;
+  preprocessed = false;
+  return done;
+}
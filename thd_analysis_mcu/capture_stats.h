@@ -0,0 +1,102 @@
+#ifndef CAPTURE_STATS_H
+#define CAPTURE_STATS_H
+
+#include "consts.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 采集期间每次至少处理的点数, 减少读取 DMA 计数的次数;
+// 参考电平也按这个间隔检查 (从帧首算起, 与每次处理的点数无关)
+#define CAPTURE_STATS_CHUNK 64
+
+// 一帧的时域统计量 (直流/无信号检测与时域指标共用一次遍历),
+// c 为以中点为零的 12 位码值
+// |c| <= 2048: 和 < 2^24, 平方和 < 2^36 (64 位)
+typedef struct {
+  int32_t sum;        // sum(c)
+  uint64_t sum_sq;    // sum(c^2)
+  int16_t min;        // min(c)
+  int16_t max;        // max(c)
+  uint32_t clipped;   // 落在满量程两端的点数
+  uint32_t above;     // 高于参考电平的点数 (占空比)
+  uint32_t crossings; // 穿越参考电平的次数 (上升与下降合计)
+  uint32_t count;     // 已累加的点数
+  uint32_t counted;   // 参考电平最近一次改变后累加的点数 (above 与
+                      // crossings 只计这一段, frame_stats_finish 换算到整帧)
+  // 以下由 frame_stats_init 设置, 参考电平在累加中可能改变
+  int16_t clip_high;  // 当前分辨率下满量程上端的码值
+  int16_t reference;  // 参考电平: 中值 (最大最小值的平均), 先取同一通道上一帧的
+  int16_t hysteresis; // 过零判定的回差, 越过参考电平 +-回差才算一次穿越
+  int16_t span;       // 得到参考电平时的峰峰值
+  int8_t side;        // 最近一次越过回差带时在参考电平的哪一侧: 1 上, -1 下
+  uint8_t channel;
+} FrameStats;
+
+// 参考电平按通道分别保存: ADC0 (单通道、扫描或双通道的电压) 与双通道的电流
+typedef enum {
+  FRAME_CHANNEL_MAIN = 0,
+  FRAME_CHANNEL_CURRENT = 1,
+  FRAME_CHANNEL_COUNT
+} FrameChannel;
+
+/**
+ * @brief 清空统计量, 取该通道保存的参考电平
+ */
+void frame_stats_init(FrameStats *stats, FrameChannel channel);
+
+/**
+ * @brief 一帧累加完后把 above 与 crossings 按比例换算到整帧,
+ * 并以本帧的中值与峰峰值更新该通道的参考电平
+ */
+void frame_stats_finish(FrameStats *stats);
+
+/**
+ * @brief 把一段采样累加进统计量
+ * @details 每累加到 CAPTURE_STATS_CHUNK 的整数倍点数时, 若已累加部分的
+ * 中值或峰峰值表明参考电平不适用 (首帧或信号电平、幅度改变), 改用按已累加
+ * 部分算出的参考电平, 占空比与过零次数从此重新计数, 不需要再遍历一遍
+ * @param is_signed 采样为有符号左对齐 (Q15) 格式
+ * @param shift 无符号格式下换算到 12 位码值的左移位数 (低分辨率采集时非 0)
+ */
+void frame_stats_accumulate(FrameStats *stats, const uint16_t *samples,
+                            uint32_t count, bool is_signed, uint32_t shift);
+
+/**
+ * @brief 开始一帧采集时调用, 清空统计量
+ * @param enable 本帧是否边采集边累加: 只用于 ADC0 单独连续写入一帧
+ * (交织采集要先校正失配, 电平触发要先旋转环形缓冲区, 双通道两路各自统计)
+ */
+void capture_stats_begin(bool enable);
+
+// 本帧是否在边采集边累加, 此时主循环不应休眠
+bool capture_stats_running(void);
+
+/**
+ * @brief 按 DMA 的写入进度累加已采到的部分
+ * @note 在主循环的采样状态下反复调用; 新写入不足 CAPTURE_STATS_CHUNK 点时
+ * 直接返回
+ */
+void capture_stats_poll(void);
+
+/**
+ * @brief 取出一帧的统计量: 累加剩余的部分后返回
+ * @param samples 被分析的采样, 不是本帧的采集缓冲区时不可用
+ * @return false 表示本帧没有边采集边累加 (或已取用、已失效), 需自行计算
+ * @note 只能取用一次
+ */
+bool capture_stats_take(const uint16_t *samples, FrameStats *stats);
+
+/**
+ * @brief 采集缓冲区在分析前被改写 (如等效时间采样重建) 时调用,
+ * 已累加的统计量与预处理结果不再对应缓冲区中的数据
+ */
+void capture_stats_invalidate(void);
+
+/**
+ * @brief 本帧是否已在采集期间预处理完整帧 (见 analysis.h 的
+ * pipeline_preprocess_begin)
+ * @note 在 capture_stats_take 之后调用, 只能取用一次
+ */
+bool capture_stats_take_preprocessed(void);
+
+#endif /* CAPTURE_STATS_H */
@@ -1,6 +1,13 @@
 #include "command.h"
 #include "consts.h"
+#include "custom_init.h"
+#include "decimate.h"
+#include "ets.h"
+#include "sampling.h"
+#include "scan.h"
+#include "trigger.h"
 #include "uart_comm.h"
+#include "zoom.h"
 #include <stdint.h>
 
 // 处理UART命令
@@ -14,6 +21,8 @@ void process_uart_command(uint8_t *packet, OperationMode *gCurrentMode,
 
   // 解析命令
   uint8_t cmd = packet[1];
+  // 分析配置命令的作用对象, 多通道扫描时可以是尚未轮到的通道
+  AnalysisProfile *profile = scan_edit_profile();
 
   switch (cmd) {
   case CMD_SET_AUTO_MODE:
@@ -60,6 +69,575 @@ void process_uart_command(uint8_t *packet, OperationMode *gCurrentMode,
     send_uart_response(CMD_GET_AUTO_DELAY, RESP_OK, gAutoModeDelayMs);
     break;
 
+  case CMD_SET_AVERAGE: {
+    // 数据字节0为平均帧数K(1~MAX_AVERAGE_FRAMES)，数据字节1为平均方式
+    uint8_t frames = packet[2];
+    uint8_t mode = packet[3];
+    if (frames >= 1 && frames <= MAX_AVERAGE_FRAMES &&
+        (mode == AVERAGE_MODE_LINEAR || mode == AVERAGE_MODE_EXPONENTIAL)) {
+      profile->average_frames = frames;
+      profile->average_mode = (AverageMode)mode;
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_AVERAGE, RESP_OK, frames | (mode << 8));
+    } else {
+      send_uart_response(CMD_SET_AVERAGE, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_AVERAGE:
+    send_uart_response(CMD_GET_AVERAGE, RESP_OK,
+                       profile->average_frames |
+                           (profile->average_mode << 8));
+    break;
+
+  case CMD_SET_HARMONICS: {
+    // 数据字节0为上报的谐波数量(含基波)
+    uint8_t num_harmonics = packet[2];
+    if (num_harmonics >= MIN_HARMONICS && num_harmonics <= MAX_HARMONICS) {
+      profile->num_harmonics = num_harmonics;
+      send_uart_response(CMD_SET_HARMONICS, RESP_OK, num_harmonics);
+    } else {
+      send_uart_response(CMD_SET_HARMONICS, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_HARMONICS:
+    send_uart_response(CMD_GET_HARMONICS, RESP_OK,
+                       profile->num_harmonics);
+    break;
+
+  case CMD_SET_RESULT_FORMAT: {
+    // 数据字节0: 0为浮点兼容格式，1为定点格式
+    uint8_t format = packet[2];
+    if (format == RESULT_FORMAT_FLOAT || format == RESULT_FORMAT_FIXED) {
+      gResultFormat = (ResultFormat)format;
+      send_uart_response(CMD_SET_RESULT_FORMAT, RESP_OK, format);
+    } else {
+      send_uart_response(CMD_SET_RESULT_FORMAT, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_RESULT_FORMAT:
+    send_uart_response(CMD_GET_RESULT_FORMAT, RESP_OK, gResultFormat);
+    break;
+
+  case CMD_SET_FFT_ENGINE: {
+    // 数据字节0: 0为CMSIS-DSP，1为原地基4实现
+    uint8_t engine = packet[2];
+    if ((engine == FFT_ENGINE_CMSIS || engine == FFT_ENGINE_RADIX4) &&
+        is_fft_config_supported((FftEngine)engine,
+                                profile->fft_precision)) {
+      // 两种实现的幅度谱刻度一致，无需清空频谱平均
+      profile->fft_engine = (FftEngine)engine;
+      send_uart_response(CMD_SET_FFT_ENGINE, RESP_OK, engine);
+    } else {
+      send_uart_response(CMD_SET_FFT_ENGINE, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_FFT_ENGINE:
+    send_uart_response(CMD_GET_FFT_ENGINE, RESP_OK,
+                       profile->fft_engine);
+    break;
+
+  case CMD_RUN_BENCHMARK: {
+    // 数据字节0为被测 FFT 实现，数据字节1为精度，数据字节2为被测阶段
+    // 使用最近一帧采样数据，仅空闲时可执行
+    uint8_t engine = packet[2];
+    uint8_t precision = packet[3];
+    uint8_t stage = packet[4];
+    if (!BENCHMARK_SUPPORTED ||
+        (engine != FFT_ENGINE_CMSIS && engine != FFT_ENGINE_RADIX4) ||
+        (precision != FFT_PRECISION_Q15 && precision != FFT_PRECISION_Q31) ||
+        stage > BENCHMARK_STAGE_DUAL_SEPARATE ||
+        (stage >= BENCHMARK_STAGE_DUAL && !DUAL_CHANNEL_SUPPORTED) ||
+        !is_fft_config_supported((FftEngine)engine,
+                                 (FftPrecision)precision)) {
+      send_uart_response(CMD_RUN_BENCHMARK, RESP_ERROR, 0);
+    } else if (*gSystemState != STATE_IDLE) {
+      send_uart_response(CMD_RUN_BENCHMARK, RESP_BUSY, 0);
+    } else {
+      send_uart_response(CMD_RUN_BENCHMARK, RESP_OK,
+                         benchmark_analysis_stage((BenchmarkStage)stage,
+                                                  (FftEngine)engine,
+                                                  (FftPrecision)precision));
+    }
+    break;
+  }
+
+  case CMD_SET_FFT_PRECISION: {
+    // 数据字节0: 0为Q15，1为Q31
+    uint8_t precision = packet[2];
+    if ((precision == FFT_PRECISION_Q15 || precision == FFT_PRECISION_Q31) &&
+        is_fft_config_supported(profile->fft_engine,
+                                (FftPrecision)precision)) {
+      // 两种精度的幅度谱刻度一致，无需清空频谱平均
+      profile->fft_precision = (FftPrecision)precision;
+      send_uart_response(CMD_SET_FFT_PRECISION, RESP_OK, precision);
+    } else {
+      send_uart_response(CMD_SET_FFT_PRECISION, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_FFT_PRECISION:
+    send_uart_response(CMD_GET_FFT_PRECISION, RESP_OK,
+                       profile->fft_precision);
+    break;
+
+  case CMD_SET_WINDOW: {
+    // 数据字节0为窗函数类型
+    uint8_t window = packet[2];
+    if (window < WINDOW_COUNT) {
+      profile->window = (WindowType)window;
+      reset_spectrum_average(); // 不同窗的频谱幅度不能混合平均
+      send_uart_response(CMD_SET_WINDOW, RESP_OK, window);
+    } else {
+      send_uart_response(CMD_SET_WINDOW, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_WINDOW:
+    send_uart_response(CMD_GET_WINDOW, RESP_OK, profile->window);
+    break;
+
+  case CMD_SET_ADC_FORMAT: {
+    // 数据字节0: 0为无符号右对齐，1为有符号左对齐(Q15)
+    uint8_t format = packet[2];
+    if (format == ADC_DATA_FORMAT_UNSIGNED ||
+        format == ADC_DATA_FORMAT_SIGNED_Q15) {
+      gAcquisitionConfig.data_format = (AdcDataFormat)format;
+      apply_sampling_clock();
+      // 下一帧之前缓冲区中仍是旧格式的数据
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_ADC_FORMAT, RESP_OK, format);
+    } else {
+      send_uart_response(CMD_SET_ADC_FORMAT, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_ADC_FORMAT:
+    send_uart_response(CMD_GET_ADC_FORMAT, RESP_OK,
+                       gAcquisitionConfig.data_format);
+    break;
+
+  case CMD_SET_SAMPLING_CLOCK: {
+    // 数据字节0: 0为ADC连续转换，1为定时器触发的相干采样
+    uint8_t mode = packet[2];
+    if (mode == SAMPLING_CLOCK_ADC || mode == SAMPLING_CLOCK_COHERENT) {
+      gAcquisitionConfig.clock_mode = (SamplingClockMode)mode;
+      // 相干采样需由下一帧的基波频率重新锁定
+      apply_sampling_clock();
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_SAMPLING_CLOCK, RESP_OK, mode);
+    } else {
+      send_uart_response(CMD_SET_SAMPLING_CLOCK, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_SAMPLING_CLOCK: {
+    // 字节0为模式，字节1为是否已锁定，字节2为锁定时每帧的基波周期数
+    CoherentTiming timing = get_coherent_timing();
+    send_uart_response(CMD_GET_SAMPLING_CLOCK, RESP_OK,
+                       gAcquisitionConfig.clock_mode |
+                           (is_coherent_locked() << 8) |
+                           ((uint32_t)timing.cycles << 16));
+    break;
+  }
+
+  case CMD_SET_ORDER_TRACKING: {
+    // 数据字节0: 0为关闭，1为开启阶次跟踪重采样
+    uint8_t enable = packet[2];
+    if (enable <= 1) {
+      profile->order_tracking = enable;
+      reset_spectrum_average(); // 重采样前后的频点刻度不同
+      send_uart_response(CMD_SET_ORDER_TRACKING, RESP_OK, enable);
+    } else {
+      send_uart_response(CMD_SET_ORDER_TRACKING, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_ORDER_TRACKING:
+    send_uart_response(CMD_GET_ORDER_TRACKING, RESP_OK,
+                       profile->order_tracking);
+    break;
+
+  case CMD_SET_ADC_RESOLUTION: {
+    // 数据字节0: 0/1/2为固定12/10/8位，3为按基波频率自动选择
+    uint8_t resolution = packet[2];
+    if (resolution <= ADC_RESOLUTION_AUTO) {
+      gAcquisitionConfig.resolution = (AdcResolution)resolution;
+      apply_sampling_clock();
+      // 采样率随转换时间改变
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_ADC_RESOLUTION, RESP_OK, resolution);
+    } else {
+      send_uart_response(CMD_SET_ADC_RESOLUTION, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_ADC_RESOLUTION:
+    // 字节0为设置值，字节1为当前实际使用的分辨率
+    send_uart_response(CMD_GET_ADC_RESOLUTION, RESP_OK,
+                       gAcquisitionConfig.resolution |
+                           ((uint32_t)get_adc_resolution() << 8));
+    break;
+
+  case CMD_SET_INTERLEAVE: {
+    // 数据字节0: 0为只用ADC0，1为ADC0/ADC1交织采集
+    // 每次设置为1都会在下一帧重新估计两个ADC的失配
+    uint8_t enable = packet[2];
+    if (enable <= 1) {
+      gAcquisitionConfig.interleaved = enable;
+      if (enable) {
+        gAcquisitionConfig.dual_channel = false; // 两种用法都要占用 ADC1
+        scan_configure(NULL, 0); // 扫描只用 ADC0
+        gAcquisitionConfig.trigger.edge = TRIGGER_EDGE_NONE;
+        request_interleave_calibration();
+      }
+      apply_sampling_clock();
+      reset_spectrum_average(); // 采样率改变
+      send_uart_response(CMD_SET_INTERLEAVE, RESP_OK, enable);
+    } else {
+      send_uart_response(CMD_SET_INTERLEAVE, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_INTERLEAVE: {
+    // 字节0为开关，字节1为失配是否已估计
+    InterleaveCalibration cal;
+    bool calibrated = get_interleave_calibration(&cal);
+    send_uart_response(CMD_GET_INTERLEAVE, RESP_OK,
+                       gAcquisitionConfig.interleaved | (calibrated << 8));
+    break;
+  }
+
+  case CMD_GET_INTERLEAVE_CAL: {
+    // 字节0~1为ADC1的增益校正(Q14)，字节2~3为偏置校正(Q15，有符号)
+    InterleaveCalibration cal;
+    get_interleave_calibration(&cal);
+    send_uart_response(CMD_GET_INTERLEAVE_CAL, RESP_OK,
+                       cal.gain_q14 |
+                           ((uint32_t)(uint16_t)cal.offset_q15 << 16));
+    break;
+  }
+
+  case CMD_SET_DUAL_CHANNEL: {
+    // 数据字节0: 0为单通道，1为ADC0电压/ADC1电流双通道采集 (关闭交织采集)
+    uint8_t enable = packet[2];
+    if (enable <= 1 && (!enable || DUAL_CHANNEL_SUPPORTED)) {
+      gAcquisitionConfig.dual_channel = enable;
+      if (enable) {
+        gAcquisitionConfig.interleaved = false;
+        scan_configure(NULL, 0);
+        gAcquisitionConfig.trigger.edge = TRIGGER_EDGE_NONE;
+        gAcquisitionConfig.ets_frames = 0;
+        ets_reset();
+      }
+      apply_sampling_clock();
+      reset_spectrum_average(); // 采样率改变
+      send_uart_response(CMD_SET_DUAL_CHANNEL, RESP_OK, enable);
+    } else {
+      send_uart_response(CMD_SET_DUAL_CHANNEL, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_DUAL_CHANNEL:
+    send_uart_response(CMD_GET_DUAL_CHANNEL, RESP_OK,
+                       gAcquisitionConfig.dual_channel);
+    break;
+
+  case CMD_SET_SCAN_CHANNELS: {
+    // 数据字节0为通道数(0~SCAN_MAX_CHANNELS，0为停止扫描)，
+    // 数据字节1~4依次为ADC0输入通道号；开启时关闭交织与双通道采集
+    uint8_t count = packet[2];
+    if (scan_configure(&packet[3], count)) {
+      if (count != 0) {
+        gAcquisitionConfig.interleaved = false;
+        gAcquisitionConfig.dual_channel = false;
+        gAcquisitionConfig.ets_frames = 0;
+        ets_reset();
+      }
+      // 重新配置 DMA 与 ADC, 扫描时沿用第一个通道恢复的采样时钟
+      apply_sampling_clock();
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_SCAN_CHANNELS, RESP_OK, count);
+    } else {
+      send_uart_response(CMD_SET_SCAN_CHANNELS, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_SCAN:
+    // 字节0为通道数，字节1为当前位置，字节2为当前输入通道，
+    // 字节3为配置命令作用的位置
+    send_uart_response(CMD_GET_SCAN, RESP_OK,
+                       scan_channel_count() |
+                           ((uint32_t)scan_active_slot() << 8) |
+                           ((uint32_t)gAcquisitionConfig.input_channel << 16) |
+                           ((uint32_t)scan_edit_slot() << 24));
+    break;
+
+  case CMD_SET_SCAN_EDIT_SLOT: {
+    // 数据字节0为扫描列表中的位置，之后的分析配置命令只作用于该通道
+    uint8_t slot = packet[2];
+    if (scan_select_edit_slot(slot)) {
+      send_uart_response(CMD_SET_SCAN_EDIT_SLOT, RESP_OK, slot);
+    } else {
+      send_uart_response(CMD_SET_SCAN_EDIT_SLOT, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_SET_TRIGGER: {
+    // 数据字节0为边沿(0为关闭)，数据字节1~2为触发电平(12位码值，低字节在前)，
+    // 数据字节3为预触发比例(%)；开启时关闭交织与双通道采集
+    uint8_t edge = packet[2];
+    uint16_t level = packet[3] | (packet[4] << 8);
+    uint8_t pre_percent = packet[5];
+    if (edge <= TRIGGER_EDGE_FALLING && level <= 4095 && pre_percent <= 100) {
+      gAcquisitionConfig.trigger.edge = (TriggerEdge)edge;
+      gAcquisitionConfig.trigger.level = level;
+      gAcquisitionConfig.trigger.pre_percent = pre_percent;
+      if (edge != TRIGGER_EDGE_NONE) {
+        gAcquisitionConfig.interleaved = false;
+        gAcquisitionConfig.dual_channel = false;
+      }
+      // 重新配置 ADC0 的窗口比较器与 DMA
+      apply_sampling_clock();
+      send_uart_response(CMD_SET_TRIGGER, RESP_OK,
+                         edge | ((uint32_t)level << 8) |
+                             ((uint32_t)pre_percent << 24));
+    } else {
+      send_uart_response(CMD_SET_TRIGGER, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_TRIGGER:
+    send_uart_response(CMD_GET_TRIGGER, RESP_OK,
+                       gAcquisitionConfig.trigger.edge |
+                           ((uint32_t)gAcquisitionConfig.trigger.level << 8) |
+                           ((uint32_t)gAcquisitionConfig.trigger.pre_percent
+                            << 24));
+    break;
+
+  case CMD_SET_TRIGGER_TIMEOUT: {
+    // 从命令包中获取超时时间(ms)，使用2个字节表示(低字节在前)
+    uint16_t timeout_ms = (packet[2] | (packet[3] << 8));
+    if (timeout_ms >= TRIGGER_MIN_TIMEOUT_MS &&
+        timeout_ms <= TRIGGER_MAX_TIMEOUT_MS) {
+      gAcquisitionConfig.trigger.timeout_ms = timeout_ms;
+      send_uart_response(CMD_SET_TRIGGER_TIMEOUT, RESP_OK, timeout_ms);
+    } else {
+      send_uart_response(CMD_SET_TRIGGER_TIMEOUT, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_TRIGGER_TIMEOUT:
+    // 字节0~1为超时时间，字节2为最近一帧是否由触发结束(0为超时)
+    send_uart_response(CMD_GET_TRIGGER_TIMEOUT, RESP_OK,
+                       gAcquisitionConfig.trigger.timeout_ms |
+                           ((uint32_t)trigger_last_frame_triggered() << 16));
+    break;
+
+  case CMD_SET_ETS: {
+    // 数据字节0为每次重建累加的帧数(0为关闭)；开启时关闭双通道采集、
+    // 多通道扫描与抽取
+    uint8_t frames = packet[2];
+    if (frames == 0 || (frames >= ETS_MIN_FRAMES && frames <= ETS_MAX_FRAMES)) {
+      gAcquisitionConfig.ets_frames = frames;
+      if (frames != 0 && gAcquisitionConfig.decimation != 1) {
+        gAcquisitionConfig.decimation = 1;
+        apply_sampling_clock();
+      }
+      if (frames != 0 &&
+          (gAcquisitionConfig.dual_channel || is_scan_enabled())) {
+        gAcquisitionConfig.dual_channel = false;
+        scan_configure(NULL, 0);
+        apply_sampling_clock();
+      }
+      ets_reset(); // 下一帧重新估计基波频率
+      send_uart_response(CMD_SET_ETS, RESP_OK, frames);
+    } else {
+      send_uart_response(CMD_SET_ETS, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_ETS:
+    // 字节0为每次重建的帧数，字节1为本轮已累加的帧数，
+    // 字节2为最近一帧结果是否来自重建的波形
+    send_uart_response(CMD_GET_ETS, RESP_OK,
+                       gAcquisitionConfig.ets_frames |
+                           ((uint32_t)ets_accumulated_frames() << 8) |
+                           ((uint32_t)ets_frame_reconstructed() << 16));
+    break;
+
+  case CMD_SET_OVERSAMPLING: {
+    // 数据字节0为每点平均的转换次数: 1(关闭)/2/4/.../128
+    uint8_t ratio = packet[2];
+    if (ratio != 0 && ratio <= ADC_MAX_OVERSAMPLING &&
+        (ratio & (ratio - 1)) == 0) {
+      gAcquisitionConfig.oversampling = ratio;
+      apply_sampling_clock();
+      // 采样率与数据刻度都随之改变
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_OVERSAMPLING, RESP_OK, ratio);
+    } else {
+      send_uart_response(CMD_SET_OVERSAMPLING, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_OVERSAMPLING: {
+    // 字节0为设置值，字节1为实际生效的倍数(定时器触发时为1)，
+    // 字节2为数据中保留的多出位数(只有有符号格式保留)，
+    // 字节3为理论分辨率的10倍(转换位数 + log2(倍数)/2)
+    uint32_t ratio = get_oversampling_ratio();
+    uint32_t extra =
+        gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15
+            ? oversampling_extra_bits(ratio)
+            : 0;
+    uint32_t tenths = (12 - ADC_RESOLUTION_SHIFT(get_adc_resolution())) * 10;
+    for (uint32_t r = ratio; r > 1; r >>= 1) {
+      tenths += 5;
+    }
+    send_uart_response(CMD_GET_OVERSAMPLING, RESP_OK,
+                       gAcquisitionConfig.oversampling | (ratio << 8) |
+                           (extra << 16) | (tenths << 24));
+    break;
+  }
+
+  case CMD_SET_DECIMATION: {
+    // 数据字节0为抽取倍数: 1(关闭)/2/4/.../32；开启时关闭等效时间采样
+    uint8_t ratio = packet[2];
+    if (ratio != 0 && ratio <= DECIMATION_MAX_RATIO &&
+        (ratio & (ratio - 1)) == 0 && (ratio == 1 || DECIMATION_SUPPORTED)) {
+      gAcquisitionConfig.decimation = ratio;
+      if (ratio != 1 && gAcquisitionConfig.ets_frames != 0) {
+        gAcquisitionConfig.ets_frames = 0;
+        ets_reset();
+      }
+      apply_sampling_clock();
+      // 采样率与频点间隔都随之改变
+      reset_spectrum_average();
+      send_uart_response(CMD_SET_DECIMATION, RESP_OK, ratio);
+    } else {
+      send_uart_response(CMD_SET_DECIMATION, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_DECIMATION: {
+    // 字节0为设置值，字节1为实际生效的倍数(定时器触发或电平触发时为1)，
+    // 字节2为因来不及处理而丢失数据的累计次数(超过255按255)
+    uint32_t overruns = decimation_overruns();
+    send_uart_response(CMD_GET_DECIMATION, RESP_OK,
+                       gAcquisitionConfig.decimation |
+                           (get_decimation_ratio() << 8) |
+                           ((overruns > 255 ? 255 : overruns) << 16));
+    break;
+  }
+
+  case CMD_SET_RESULT_EXTENSIONS: {
+    // 数据字节0为扩展记录的位掩码: bit0 时域指标，bit1 频谱指标，
+    // bit2 非谐波峰值表；0 表示不追加扩展块
+    uint8_t mask = packet[2];
+    if ((mask & ~RESULT_EXT_ALL) == 0) {
+      gResultExtensions = mask;
+      send_uart_response(CMD_SET_RESULT_EXTENSIONS, RESP_OK, mask);
+    } else {
+      send_uart_response(CMD_SET_RESULT_EXTENSIONS, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_RESULT_EXTENSIONS:
+    // 字节0为当前位掩码，字节1为固件支持的全部位
+    send_uart_response(CMD_GET_RESULT_EXTENSIONS, RESP_OK,
+                       gResultExtensions | (RESULT_EXT_ALL << 8));
+    break;
+
+  case CMD_SET_NOISE_MARGIN: {
+    // 数据字节0为裕量(dB)，MIN_NOISE_MARGIN_DB~MAX_NOISE_MARGIN_DB
+    uint8_t margin = packet[2];
+    if (margin >= MIN_NOISE_MARGIN_DB && margin <= MAX_NOISE_MARGIN_DB) {
+      profile->noise_margin_db = margin;
+      send_uart_response(CMD_SET_NOISE_MARGIN, RESP_OK, margin);
+    } else {
+      send_uart_response(CMD_SET_NOISE_MARGIN, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_NOISE_MARGIN:
+    send_uart_response(CMD_GET_NOISE_MARGIN, RESP_OK,
+                       profile->noise_margin_db);
+    break;
+
+  case CMD_SET_ZOOM: {
+    // 数据字节0为细化倍数: 0 关闭, 或 ZOOM_MIN_FACTOR~ZOOM_MAX_FACTOR 的 2 的幂；
+    // 字节1为细化的单音数 1~ZOOM_MAX_TONES, 0 按 1 处理 (只细化基波)
+    uint8_t factor = packet[2];
+    uint8_t tones = packet[3] != 0 ? packet[3] : 1;
+    if (is_zoom_factor_valid(factor) && tones <= ZOOM_MAX_TONES) {
+      profile->zoom_factor = factor;
+      profile->zoom_tones = tones;
+      send_uart_response(CMD_SET_ZOOM, RESP_OK, factor | (tones << 8));
+    } else {
+      send_uart_response(CMD_SET_ZOOM, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_ZOOM:
+    // 字节0为当前倍数，字节1为支持的最大倍数 (不支持细化时为 0)，
+    // 字节2为细化的单音数
+    send_uart_response(CMD_GET_ZOOM, RESP_OK,
+                       profile->zoom_factor |
+                           ((ZOOM_SUPPORTED ? ZOOM_MAX_FACTOR : 0) << 8) |
+                           (profile->zoom_tones << 16));
+    break;
+
+  case CMD_SET_STFT: {
+    // 数据字节0为跳步: 0 关闭, 或 STFT_MIN_HOP~STFT_MAX_HOP；
+    // 字节1~2为每次采集输出的行数(小端), 0 表示一直输出到收到新命令
+    uint8_t hop = packet[2];
+    uint16_t rows = (uint16_t)(packet[3] | (packet[4] << 8));
+    if (hop == 0 ||
+        (STFT_SUPPORTED && hop >= STFT_MIN_HOP && hop <= STFT_MAX_HOP)) {
+      gAcquisitionConfig.stft_hop = hop;
+      gAcquisitionConfig.stft_rows = rows;
+      send_uart_response(CMD_SET_STFT, RESP_OK, hop | ((uint32_t)rows << 8));
+    } else {
+      send_uart_response(CMD_SET_STFT, RESP_ERROR, 0);
+    }
+    break;
+  }
+
+  case CMD_GET_STFT: {
+    // 字节0为设置的跳步，字节1为实际生效的跳步(不满足条件时为0)，
+    // 字节2为因来不及发送而跳过的累计行数(超过255按255)
+    uint32_t dropped = stft_dropped_rows();
+    send_uart_response(CMD_GET_STFT, RESP_OK,
+                       gAcquisitionConfig.stft_hop | (get_stft_hop() << 8) |
+                           ((dropped > 255 ? 255 : dropped) << 16));
+    break;
+  }
+
   default:
     // 未知命令
     send_uart_response(cmd, RESP_ERROR, 0);
@@ -83,8 +661,35 @@ void send_uart_response(uint8_t cmd, uint8_t status, uint32_t data) {
   UART_sendDataBlocking(respPacket, UART_PACKET_SIZE);
 }
 
-// 发送ADC分析结果
-void send_adc_result(AnalysisResult result) {
+// 发送一个通道的ADC原始数据, 上位机始终按 12 位无符号码值解析
+static void send_samples(const uint16_t *samples) {
+  if (gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15) {
+    // 有符号格式逐块换算回无符号码值再发送, 不改动采集缓冲区
+    uint16_t chunk[32];
+    for (uint32_t i = 0; i < SAMPLE_SIZE; i += 32) {
+      for (uint32_t j = 0; j < 32; j++) {
+        chunk[j] = ADC_Q15_TO_CODE(samples[i + j]);
+      }
+      UART_sendDataBlocking((uint8_t *)chunk, sizeof(chunk));
+    }
+  } else {
+    UART_sendDataBlocking((const uint8_t *)samples, SAMPLE_SIZE * 2);
+  }
+}
+
+// 发送数据包尾 - 使用5字节特殊序列
+static void send_packet_tail(void) {
+  uint8_t tail[5];
+  tail[0] = 0xBB; // 特殊包尾序列开始
+  tail[1] = 0x66;
+  tail[2] = 0xB6;
+  tail[3] = 0x6B;
+  tail[4] = 0xBB; // 特殊包尾序列结束
+  UART_sendDataBlocking(tail, 5);
+}
+
+// 发送分析结果数据包的前半部分: 包头和ADC原始数据
+void send_adc_samples(uint8_t num_harmonics) {
   // 发送数据包头 - 使用5字节特殊序列
   uint8_t header[8];
   header[0] = 0xAA; // 特殊包头序列开始
@@ -94,21 +699,119 @@ void send_adc_result(AnalysisResult result) {
   header[4] = 0xAA; // 特殊包头序列结束
   header[5] = (uint8_t)(SAMPLE_SIZE & 0xFF);
   header[6] = (uint8_t)((SAMPLE_SIZE >> 8) & 0xFF);
-  header[7] = (uint8_t)(NUM_HARMONICS);
+  header[7] = num_harmonics;
+  if (gResultFormat == RESULT_FORMAT_FIXED) {
+    header[7] |= RESULT_FORMAT_FIXED_FLAG;
+  }
+  if (gAcquisitionConfig.dual_channel) {
+    header[7] |= RESULT_DUAL_CHANNEL_FLAG;
+  }
+  if (is_scan_enabled()) {
+    header[6] |= RESULT_SCAN_CHANNEL_FLAG;
+  }
+  if (gResultExtensions != 0) {
+    header[6] |= RESULT_EXTENDED_FLAG;
+  }
   UART_sendDataBlocking(header, 8);
+  // 多通道扫描时包头后紧跟 1 字节输入通道号
+  if (is_scan_enabled()) {
+    UART_sendDataBlocking(&gAcquisitionConfig.input_channel, 1);
+  }
+
+  // 发送ADC原始数据, 双通道时先电压后电流
+  send_samples(VALID_ADC_DATA);
+  if (gAcquisitionConfig.dual_channel) {
+    send_samples(VALID_CURRENT_DATA);
+  }
+}
+
+// 发送扩展块 (包头已置位 RESULT_EXTENDED_FLAG), current 为 NULL 表示单通道
+static void send_result_extensions(const AnalysisResult *voltage,
+                                   const AnalysisResult *current) {
+  if (gResultExtensions == 0) {
+    return;
+  }
+  const uint16_t records = current != NULL ? 2 : 1;
+  uint16_t length = 0;
+  if (gResultExtensions & RESULT_EXT_TIME_DOMAIN) {
+    length += records * TIME_DOMAIN_RECORD_SIZE;
+  }
+  if (gResultExtensions & RESULT_EXT_SPECTRAL) {
+    length += records * SPECTRAL_RECORD_SIZE;
+  }
+  if (gResultExtensions & RESULT_EXT_PEAKS) {
+    length += 1 + voltage->spectral_peaks.count * SPECTRAL_PEAK_RECORD_SIZE;
+    if (current != NULL) {
+      length += 1 + current->spectral_peaks.count * SPECTRAL_PEAK_RECORD_SIZE;
+    }
+  }
+  UART_sendDataBlocking(&gResultExtensions, 1);
+  UART_sendDataBlocking((const uint8_t *)&length, sizeof(uint16_t));
 
-  // 发送ADC原始数据
-  UART_sendDataBlocking((uint8_t *)VALID_ADC_DATA, SAMPLE_SIZE * 2);
+  if (gResultExtensions & RESULT_EXT_TIME_DOMAIN) {
+    UART_sendTimeDomainMetricsBlocking(&voltage->time_metrics);
+    if (current != NULL) {
+      UART_sendTimeDomainMetricsBlocking(&current->time_metrics);
+    }
+  }
+  if (gResultExtensions & RESULT_EXT_SPECTRAL) {
+    UART_sendSpectralMetricsBlocking(&voltage->spectral_metrics);
+    if (current != NULL) {
+      UART_sendSpectralMetricsBlocking(&current->spectral_metrics);
+    }
+  }
+  if (gResultExtensions & RESULT_EXT_PEAKS) {
+    UART_sendSpectralPeaksBlocking(&voltage->spectral_peaks);
+    if (current != NULL) {
+      UART_sendSpectralPeaksBlocking(&current->spectral_peaks);
+    }
+  }
+}
 
+// 发送分析结果数据包的后半部分: 分析结果和包尾
+void send_analysis_result(const AnalysisResult *result) {
   // 发送分析结果
-  UART_sendHarmonicsAnalysisResultBlocking(&result);
+  UART_sendHarmonicsAnalysisResultBlocking(result);
+  send_result_extensions(result, NULL);
+  send_packet_tail();
+}
 
-  // 发送数据包尾 - 使用5字节特殊序列
-  uint8_t tail[5];
-  tail[0] = 0xBB; // 特殊包尾序列开始
-  tail[1] = 0x66;
-  tail[2] = 0xB6;
-  tail[3] = 0x6B;
-  tail[4] = 0xBB; // 特殊包尾序列结束
-  UART_sendDataBlocking(tail, 5);
+// 发送ADC分析结果
+void send_adc_result(const AnalysisResult *result) {
+  send_adc_samples(result->num_harmonics);
+  send_analysis_result(result);
+}
+
+// 发送一行短时频谱: 包头与分析结果数据包只差最后一字节, 数据小端
+void send_stft_row(const StftRow *row) {
+  uint8_t header[15];
+  header[0] = 0xAA; // 特殊包头序列开始
+  header[1] = 0x55;
+  header[2] = 0xA5;
+  header[3] = 0x5A;
+  header[4] = 0x5A; // 短时频谱行
+  header[5] = (uint8_t)(row->seq & 0xFF);
+  header[6] = (uint8_t)(row->seq >> 8);
+  header[7] = (uint8_t)(row->sample_rate_hz & 0xFF);
+  header[8] = (uint8_t)((row->sample_rate_hz >> 8) & 0xFF);
+  header[9] = (uint8_t)((row->sample_rate_hz >> 16) & 0xFF);
+  header[10] = (uint8_t)((row->sample_rate_hz >> 24) & 0xFF);
+  header[11] = (uint8_t)(row->fundamental_q8 & 0xFF);
+  header[12] = (uint8_t)(row->fundamental_q8 >> 8);
+  header[13] = (uint8_t)(row->thd & 0xFF);
+  header[14] = (uint8_t)(row->thd >> 8);
+  UART_sendDataBlocking(header, sizeof(header));
+  UART_sendDataBlocking(row->levels, STFT_BINS);
+  send_packet_tail();
+}
+
+// 发送双通道分析结果
+void send_dual_channel_result(const AnalysisResult *voltage,
+                              const PowerAnalysis *power) {
+  send_adc_samples(voltage->num_harmonics);
+  UART_sendHarmonicsAnalysisResultBlocking(voltage);
+  UART_sendHarmonicsAnalysisResultBlocking(&power->current);
+  UART_sendPowerAnalysisBlocking(power);
+  send_result_extensions(voltage, &power->current);
+  send_packet_tail();
 }
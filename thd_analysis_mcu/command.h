@@ -2,6 +2,7 @@
 #define COMMAND_H
 
 #include "analysis.h"
+#include "stft.h"
 #include <stdint.h>
 
 // 操作模式定义
@@ -24,6 +25,53 @@ typedef enum {
 #define CMD_TRIGGER_ONCE 0x04     // 触发一次采样
 #define CMD_SET_AUTO_DELAY 0x05   // 设置自动模式延时时间
 #define CMD_GET_AUTO_DELAY 0x06   // 获取自动模式延时时间
+#define CMD_SET_AVERAGE 0x07      // 设置频谱平均帧数和平均方式
+#define CMD_GET_AVERAGE 0x08      // 获取频谱平均帧数和平均方式
+#define CMD_SET_HARMONICS 0x09    // 设置上报的谐波数量
+#define CMD_GET_HARMONICS 0x0A    // 获取上报的谐波数量
+#define CMD_SET_RESULT_FORMAT 0x0B // 设置分析结果发送格式
+#define CMD_GET_RESULT_FORMAT 0x0C // 获取分析结果发送格式
+#define CMD_SET_FFT_ENGINE 0x0D    // 设置 FFT 实现
+#define CMD_GET_FFT_ENGINE 0x0E    // 获取 FFT 实现
+#define CMD_RUN_BENCHMARK 0x0F     // 测量 FFT 耗时 (CPU 周期)
+#define CMD_SET_FFT_PRECISION 0x10 // 设置 FFT 运算精度
+#define CMD_GET_FFT_PRECISION 0x11 // 获取 FFT 运算精度
+#define CMD_SET_WINDOW 0x12        // 设置窗函数
+#define CMD_GET_WINDOW 0x13        // 获取窗函数
+#define CMD_SET_ADC_FORMAT 0x14    // 设置 ADC 结果格式
+#define CMD_GET_ADC_FORMAT 0x15    // 获取 ADC 结果格式
+#define CMD_SET_SAMPLING_CLOCK 0x16 // 设置采样时钟来源 (相干采样)
+#define CMD_GET_SAMPLING_CLOCK 0x17 // 获取采样时钟来源及锁定状态
+#define CMD_SET_ORDER_TRACKING 0x18 // 设置阶次跟踪重采样开关
+#define CMD_GET_ORDER_TRACKING 0x19 // 获取阶次跟踪重采样开关
+#define CMD_SET_ADC_RESOLUTION 0x1A // 设置 ADC 转换分辨率
+#define CMD_GET_ADC_RESOLUTION 0x1B // 获取 ADC 转换分辨率
+#define CMD_SET_INTERLEAVE 0x1C     // 设置 ADC0/ADC1 交织采集
+#define CMD_GET_INTERLEAVE 0x1D     // 获取交织采集设置及校准状态
+#define CMD_GET_INTERLEAVE_CAL 0x1E // 获取交织失配校正参数
+#define CMD_SET_DUAL_CHANNEL 0x1F   // 设置电压/电流双通道采集
+#define CMD_GET_DUAL_CHANNEL 0x20   // 获取双通道采集设置
+#define CMD_SET_SCAN_CHANNELS 0x21  // 设置多通道轮流扫描的输入通道列表
+#define CMD_GET_SCAN 0x22           // 获取多通道扫描状态
+#define CMD_SET_SCAN_EDIT_SLOT 0x23 // 选择分析配置命令作用的扫描通道
+#define CMD_SET_TRIGGER 0x24        // 设置电平触发 (边沿、电平、预触发比例)
+#define CMD_GET_TRIGGER 0x25        // 获取电平触发设置
+#define CMD_SET_TRIGGER_TIMEOUT 0x26 // 设置触发超时时间
+#define CMD_GET_TRIGGER_TIMEOUT 0x27 // 获取触发超时时间及最近一帧是否触发
+#define CMD_SET_ETS 0x28             // 设置等效时间采样 (每次重建的帧数)
+#define CMD_GET_ETS 0x29             // 获取等效时间采样设置与累加进度
+#define CMD_SET_OVERSAMPLING 0x2A    // 设置硬件平均过采样倍数
+#define CMD_GET_OVERSAMPLING 0x2B    // 获取过采样设置与实际生效的倍数
+#define CMD_SET_DECIMATION 0x2C      // 设置抽取前端的抽取倍数
+#define CMD_GET_DECIMATION 0x2D      // 获取抽取设置与丢失数据次数
+#define CMD_SET_RESULT_EXTENSIONS 0x2E // 设置数据包中追加的扩展记录
+#define CMD_GET_RESULT_EXTENSIONS 0x2F // 获取扩展记录设置
+#define CMD_SET_NOISE_MARGIN 0x30    // 设置检出阈值高出噪声底的裕量
+#define CMD_GET_NOISE_MARGIN 0x31    // 获取检出阈值裕量
+#define CMD_SET_ZOOM 0x32            // 设置细化倍数 (0 关闭)
+#define CMD_GET_ZOOM 0x33            // 获取细化倍数
+#define CMD_SET_STFT 0x34            // 设置短时频谱流 (跳步与行数)
+#define CMD_GET_STFT 0x35            // 获取短时频谱流设置与丢行次数
 
 // UART响应状态码定义
 #define RESP_OK 0x00    // 操作成功
@@ -38,6 +86,14 @@ typedef enum {
 void process_uart_command(uint8_t *packet, OperationMode *gCurrentMode,
                           SystemState *gSystemState, bool *gTriggerSampling);
 void send_uart_response(uint8_t cmd, uint8_t status, uint32_t data);
-void send_adc_result(AnalysisResult result);
+void send_adc_result(const AnalysisResult *result);
+// 分两步发送同一个分析结果数据包, 用于原始采样需要在分析前发出的情况
+void send_adc_samples(uint8_t num_harmonics);
+void send_analysis_result(const AnalysisResult *result);
+// 发送双通道数据包: 电压结果与 power 中的电流结果、功率参数
+void send_dual_channel_result(const AnalysisResult *voltage,
+                              const PowerAnalysis *power);
+// 发送一行短时频谱
+void send_stft_row(const StftRow *row);
 
 #endif // COMMAND_H
@@ -1,10 +1,52 @@
 #include "consts.h"
+#include "analysis.h"
+#include "uart_comm.h"
 #include <ti/iqmath/include/IQmathLib.h>
 
-uint16_t *VALID_ADC_DATA = &gADCRealSamples[50];
+_Static_assert((1UL << SAMPLE_SIZE_LOG2) == SAMPLE_SIZE,
+               "SAMPLE_SIZE_LOG2 must match SAMPLE_SIZE");
+
+uint16_t *VALID_ADC_DATA = &gADCRealSamples[ADC_DISCARD_SAMPLES];
+uint16_t *VALID_CURRENT_DATA =
+    &gCurrentSamples[DUAL_CHANNEL_SUPPORTED ? ADC_DISCARD_SAMPLES : 0];
 uint16_t gADCCLKS = 2;
 uint8_t gRxPacket[UART_PACKET_SIZE];
 uint16_t gAutoModeDelayMs = 1000;
+ResultFormat gResultFormat = RESULT_FORMAT_FLOAT;
+uint8_t gResultExtensions = 0;
+AcquisitionConfig gAcquisitionConfig = {
+    .data_format = ADC_DATA_FORMAT_UNSIGNED,
+    .clock_mode = SAMPLING_CLOCK_ADC,
+    .resolution = ADC_RESOLUTION_AUTO,
+    .oversampling = 1,
+    .decimation = 1,
+    .interleaved = false,
+    .dual_channel = false,
+    .input_channel = ADC_DEFAULT_INPUT_CHANNEL,
+    .trigger =
+        {
+            .edge = TRIGGER_EDGE_NONE,
+            .level = ADC_MIDPOINT,
+            .pre_percent = 50,
+            .timeout_ms = 100,
+        },
+    .ets_frames = 0,
+    .stft_hop = 0,
+    .stft_rows = 0,
+};
+AnalysisProfile gAnalysisProfile = {
+    .average_frames = 1,
+    .average_mode = AVERAGE_MODE_LINEAR,
+    .num_harmonics = MIN_HARMONICS,
+    .fft_engine =
+        SPECTRUM_IN_CAPTURE_BUFFER ? FFT_ENGINE_RADIX4 : FFT_ENGINE_CMSIS,
+    .fft_precision = FFT_PRECISION_Q15,
+    .window = WINDOW_HANN,
+    .noise_margin_db = 12,
+    .zoom_factor = 0,
+    .zoom_tones = 1,
+    .order_tracking = false,
+};
 
 #define NO_SIGNAL
 // #define DC_SIGNAL
@@ -17,380 +59,1498 @@ uint16_t gAutoModeDelayMs = 1000;
 // #define TRIANGLE_DC_SIGNAL
 // #define TWO_SINE_SIGNAL
 
-// 汉宁窗系数表
-#if SAMPLE_SIZE == 1024
-const float gHanningWindow[SAMPLE_SIZE] = {
-    0.0000093940, 0.0000375757, 0.0000845439, 0.0001502970, 0.0002348324,
-    0.0003381470, 0.0004602369, 0.0006010975, 0.0007607236, 0.0009391090,
-    0.0011362472, 0.0013521307, 0.0015867514, 0.0018401004, 0.0021121683,
-    0.0024029449, 0.0027124192, 0.0030405795, 0.0033874136, 0.0037529084,
-    0.0041370502, 0.0045398246, 0.0049612164, 0.0054012097, 0.0058597881,
-    0.0063369343, 0.0068326304, 0.0073468578, 0.0078795971, 0.0084308283,
-    0.0090005308, 0.0095886830, 0.0101952629, 0.0108202478, 0.0114636140,
-    0.0121253375, 0.0128053934, 0.0135037562, 0.0142203995, 0.0149552964,
-    0.0157084194, 0.0164797402, 0.0172692297, 0.0180768583, 0.0189025957,
-    0.0197464108, 0.0206082719, 0.0214881466, 0.0223860019, 0.0233018040,
-    0.0242355185, 0.0251871104, 0.0261565438, 0.0271437824, 0.0281487890,
-    0.0291715259, 0.0302119547, 0.0312700362, 0.0323457307, 0.0334389978,
-    0.0345497965, 0.0356780848, 0.0368238206, 0.0379869606, 0.0391674613,
-    0.0403652782, 0.0415803663, 0.0428126800, 0.0440621730, 0.0453287983,
-    0.0466125084, 0.0479132549, 0.0492309891, 0.0505656613, 0.0519172215,
-    0.0532856189, 0.0546708020, 0.0560727188, 0.0574913166, 0.0589265421,
-    0.0603783414, 0.0618466600, 0.0633314426, 0.0648326334, 0.0663501761,
-    0.0678840136, 0.0694340884, 0.0710003420, 0.0725827158, 0.0741811502,
-    0.0757955852, 0.0774259601, 0.0790722136, 0.0807342839, 0.0824121086,
-    0.0841056245, 0.0858147681, 0.0875394751, 0.0892796808, 0.0910353196,
-    0.0928063257, 0.0945926326, 0.0963941730, 0.0982108793, 0.1000426833,
-    0.1018895160, 0.1037513082, 0.1056279898, 0.1075194903, 0.1094257387,
-    0.1113466633, 0.1132821920, 0.1152322519, 0.1171967699, 0.1191756721,
-    0.1211688842, 0.1231763312, 0.1251979378, 0.1272336279, 0.1292833251,
-    0.1313469523, 0.1334244321, 0.1355156863, 0.1376206364, 0.1397392032,
-    0.1418713072, 0.1440168683, 0.1461758057, 0.1483480385, 0.1505334850,
-    0.1527320630, 0.1549436899, 0.1571682827, 0.1594057577, 0.1616560310,
-    0.1639190178, 0.1661946332, 0.1684827917, 0.1707834073, 0.1730963935,
-    0.1754216634, 0.1777591297, 0.1801087046, 0.1824702997, 0.1848438262,
-    0.1872291951, 0.1896263167, 0.1920351009, 0.1944554571, 0.1968872945,
-    0.1993305217, 0.2017850468, 0.2042507777, 0.2067276216, 0.2092154855,
-    0.2117142760, 0.2142238991, 0.2167442605, 0.2192752655, 0.2218168191,
-    0.2243688256, 0.2269311893, 0.2295038138, 0.2320866025, 0.2346794583,
-    0.2372822838, 0.2398949812, 0.2425174522, 0.2451495985, 0.2477913210,
-    0.2504425205, 0.2531030974, 0.2557729516, 0.2584519830, 0.2611400907,
-    0.2638371739, 0.2665431311, 0.2692578607, 0.2719812607, 0.2747132287,
-    0.2774536621, 0.2802024578, 0.2829595127, 0.2857247232, 0.2884979852,
-    0.2912791946, 0.2940682469, 0.2968650373, 0.2996694607, 0.3024814118,
-    0.3053007848, 0.3081274738, 0.3109613726, 0.3138023747, 0.3166503734,
-    0.3195052617, 0.3223669322, 0.3252352774, 0.3281101896, 0.3309915608,
-    0.3338792826, 0.3367732466, 0.3396733440, 0.3425794658, 0.3454915028,
-    0.3484093457, 0.3513328847, 0.3542620101, 0.3571966117, 0.3601365792,
-    0.3630818023, 0.3660321703, 0.3689875722, 0.3719478970, 0.3749130335,
-    0.3778828703, 0.3808572958, 0.3838361981, 0.3868194655, 0.3898069857,
-    0.3927986465, 0.3957943355, 0.3987939402, 0.4017973478, 0.4048044454,
-    0.4078151201, 0.4108292588, 0.4138467481, 0.4168674747, 0.4198913252,
-    0.4229181857, 0.4259479427, 0.4289804823, 0.4320156905, 0.4350534533,
-    0.4380936566, 0.4411361860, 0.4441809273, 0.4472277660, 0.4502765877,
-    0.4533272779, 0.4563797218, 0.4594338047, 0.4624894120, 0.4655464288,
-    0.4686047402, 0.4716642314, 0.4747247872, 0.4777862928, 0.4808486332,
-    0.4839116931, 0.4869753576, 0.4900395115, 0.4931040396, 0.4961688269,
-    0.4992337582, 0.5022987182, 0.5053635919, 0.5084282640, 0.5114926195,
-    0.5145565430, 0.5176199196, 0.5206826341, 0.5237445715, 0.5268056166,
-    0.5298656545, 0.5329245701, 0.5359822486, 0.5390385750, 0.5420934345,
-    0.5451467122, 0.5481982936, 0.5512480638, 0.5542959084, 0.5573417127,
-    0.5603853624, 0.5634267430, 0.5664657402, 0.5695022400, 0.5725361282,
-    0.5755672907, 0.5785956137, 0.5816209834, 0.5846432861, 0.5876624083,
-    0.5906782365, 0.5936906573, 0.5966995576, 0.5997048243, 0.6027063445,
-    0.6057040055, 0.6086976945, 0.6116872990, 0.6146727068, 0.6176538057,
-    0.6206304836, 0.6236026287, 0.6265701292, 0.6295328738, 0.6324907511,
-    0.6354436499, 0.6383914592, 0.6413340684, 0.6442713668, 0.6472032440,
-    0.6501295900, 0.6530502946, 0.6559652483, 0.6588743414, 0.6617774646,
-    0.6646745089, 0.6675653654, 0.6704499254, 0.6733280806, 0.6761997228,
-    0.6790647442, 0.6819230370, 0.6847744938, 0.6876190076, 0.6904564714,
-    0.6932867786, 0.6961098229, 0.6989254981, 0.7017336985, 0.7045343186,
-    0.7073272531, 0.7101123970, 0.7128896458, 0.7156588950, 0.7184200406,
-    0.7211729789, 0.7239176064, 0.7266538199, 0.7293815167, 0.7321005943,
-    0.7348109504, 0.7375124833, 0.7402050914, 0.7428886735, 0.7455631289,
-    0.7482283570, 0.7508842577, 0.7535307311, 0.7561676779, 0.7587949989,
-    0.7614125954, 0.7640203691, 0.7666182219, 0.7692060563, 0.7717837750,
-    0.7743512812, 0.7769084783, 0.7794552703, 0.7819915615, 0.7845172566,
-    0.7870322606, 0.7895364792, 0.7920298181, 0.7945121837, 0.7969834827,
-    0.7994436222, 0.8018925099, 0.8043300536, 0.8067561619, 0.8091707434,
-    0.8115737076, 0.8139649640, 0.8163444229, 0.8187119949, 0.8210675909,
-    0.8234111225, 0.8257425016, 0.8280616405, 0.8303684523, 0.8326628501,
-    0.8349447477, 0.8372140595, 0.8394707001, 0.8417145848, 0.8439456292,
-    0.8461637495, 0.8483688623, 0.8505608849, 0.8527397347, 0.8549053300,
-    0.8570575894, 0.8591964319, 0.8613217774, 0.8634335457, 0.8655316577,
-    0.8676160345, 0.8696865977, 0.8717432696, 0.8737859729, 0.8758146307,
-    0.8778291670, 0.8798295059, 0.8818155724, 0.8837872917, 0.8857445899,
-    0.8876873933, 0.8896156290, 0.8915292245, 0.8934281079, 0.8953122078,
-    0.8971814534, 0.8990357746, 0.9008751016, 0.9026993653, 0.9045084972,
-    0.9063024292, 0.9080810941, 0.9098444249, 0.9115923553, 0.9133248198,
-    0.9150417531, 0.9167430909, 0.9184287691, 0.9200987244, 0.9217528941,
-    0.9233912160, 0.9250136286, 0.9266200708, 0.9282104824, 0.9297848035,
-    0.9313429750, 0.9328849384, 0.9344106357, 0.9359200095, 0.9374130033,
-    0.9388895608, 0.9403496265, 0.9417931457, 0.9432200641, 0.9446303280,
-    0.9460238845, 0.9474006812, 0.9487606664, 0.9501037890, 0.9514299984,
-    0.9527392449, 0.9540314792, 0.9553066529, 0.9565647180, 0.9578056272,
-    0.9590293338, 0.9602357920, 0.9614249564, 0.9625967822, 0.9637512256,
-    0.9648882429, 0.9660077917, 0.9671098297, 0.9681943156, 0.9692612087,
-    0.9703104688, 0.9713420564, 0.9723559330, 0.9733520603, 0.9743304009,
-    0.9752909180, 0.9762335756, 0.9771583383, 0.9780651713, 0.9789540404,
-    0.9798249124, 0.9806777545, 0.9815125347, 0.9823292215, 0.9831277843,
-    0.9839081931, 0.9846704186, 0.9854144321, 0.9861402056, 0.9868477119,
-    0.9875369245, 0.9882078173, 0.9888603653, 0.9894945438, 0.9901103291,
-    0.9907076980, 0.9912866280, 0.9918470975, 0.9923890853, 0.9929125711,
-    0.9934175352, 0.9939039587, 0.9943718232, 0.9948211111, 0.9952518057,
-    0.9956638907, 0.9960573507, 0.9964321707, 0.9967883369, 0.9971258357,
-    0.9974446545, 0.9977447813, 0.9980262049, 0.9982889146, 0.9985329006,
-    0.9987581537, 0.9989646655, 0.9991524282, 0.9993214348, 0.9994716788,
-    0.9996031547, 0.9997158575, 0.9998097829, 0.9998849275, 0.9999412885,
-    0.9999788636, 0.9999976515, 0.9999976515, 0.9999788636, 0.9999412885,
-    0.9998849275, 0.9998097829, 0.9997158575, 0.9996031547, 0.9994716788,
-    0.9993214348, 0.9991524282, 0.9989646655, 0.9987581537, 0.9985329006,
-    0.9982889146, 0.9980262049, 0.9977447813, 0.9974446545, 0.9971258357,
-    0.9967883369, 0.9964321707, 0.9960573507, 0.9956638907, 0.9952518057,
-    0.9948211111, 0.9943718232, 0.9939039587, 0.9934175352, 0.9929125711,
-    0.9923890853, 0.9918470975, 0.9912866280, 0.9907076980, 0.9901103291,
-    0.9894945438, 0.9888603653, 0.9882078173, 0.9875369245, 0.9868477119,
-    0.9861402056, 0.9854144321, 0.9846704186, 0.9839081931, 0.9831277843,
-    0.9823292215, 0.9815125347, 0.9806777545, 0.9798249124, 0.9789540404,
-    0.9780651713, 0.9771583383, 0.9762335756, 0.9752909180, 0.9743304009,
-    0.9733520603, 0.9723559330, 0.9713420564, 0.9703104688, 0.9692612087,
-    0.9681943156, 0.9671098297, 0.9660077917, 0.9648882429, 0.9637512256,
-    0.9625967822, 0.9614249564, 0.9602357920, 0.9590293338, 0.9578056272,
-    0.9565647180, 0.9553066529, 0.9540314792, 0.9527392449, 0.9514299984,
-    0.9501037890, 0.9487606664, 0.9474006812, 0.9460238845, 0.9446303280,
-    0.9432200641, 0.9417931457, 0.9403496265, 0.9388895608, 0.9374130033,
-    0.9359200095, 0.9344106357, 0.9328849384, 0.9313429750, 0.9297848035,
-    0.9282104824, 0.9266200708, 0.9250136286, 0.9233912160, 0.9217528941,
-    0.9200987244, 0.9184287691, 0.9167430909, 0.9150417531, 0.9133248198,
-    0.9115923553, 0.9098444249, 0.9080810941, 0.9063024292, 0.9045084972,
-    0.9026993653, 0.9008751016, 0.8990357746, 0.8971814534, 0.8953122078,
-    0.8934281079, 0.8915292245, 0.8896156290, 0.8876873933, 0.8857445899,
-    0.8837872917, 0.8818155724, 0.8798295059, 0.8778291670, 0.8758146307,
-    0.8737859729, 0.8717432696, 0.8696865977, 0.8676160345, 0.8655316577,
-    0.8634335457, 0.8613217774, 0.8591964319, 0.8570575894, 0.8549053300,
-    0.8527397347, 0.8505608849, 0.8483688623, 0.8461637495, 0.8439456292,
-    0.8417145848, 0.8394707001, 0.8372140595, 0.8349447477, 0.8326628501,
-    0.8303684523, 0.8280616405, 0.8257425016, 0.8234111225, 0.8210675909,
-    0.8187119949, 0.8163444229, 0.8139649640, 0.8115737076, 0.8091707434,
-    0.8067561619, 0.8043300536, 0.8018925099, 0.7994436222, 0.7969834827,
-    0.7945121837, 0.7920298181, 0.7895364792, 0.7870322606, 0.7845172566,
-    0.7819915615, 0.7794552703, 0.7769084783, 0.7743512812, 0.7717837750,
-    0.7692060563, 0.7666182219, 0.7640203691, 0.7614125954, 0.7587949989,
-    0.7561676779, 0.7535307311, 0.7508842577, 0.7482283570, 0.7455631289,
-    0.7428886735, 0.7402050914, 0.7375124833, 0.7348109504, 0.7321005943,
-    0.7293815167, 0.7266538199, 0.7239176064, 0.7211729789, 0.7184200406,
-    0.7156588950, 0.7128896458, 0.7101123970, 0.7073272531, 0.7045343186,
-    0.7017336985, 0.6989254981, 0.6961098229, 0.6932867786, 0.6904564714,
-    0.6876190076, 0.6847744938, 0.6819230370, 0.6790647442, 0.6761997228,
-    0.6733280806, 0.6704499254, 0.6675653654, 0.6646745089, 0.6617774646,
-    0.6588743414, 0.6559652483, 0.6530502946, 0.6501295900, 0.6472032440,
-    0.6442713668, 0.6413340684, 0.6383914592, 0.6354436499, 0.6324907511,
-    0.6295328738, 0.6265701292, 0.6236026287, 0.6206304836, 0.6176538057,
-    0.6146727068, 0.6116872990, 0.6086976945, 0.6057040055, 0.6027063445,
-    0.5997048243, 0.5966995576, 0.5936906573, 0.5906782365, 0.5876624083,
-    0.5846432861, 0.5816209834, 0.5785956137, 0.5755672907, 0.5725361282,
-    0.5695022400, 0.5664657402, 0.5634267430, 0.5603853624, 0.5573417127,
-    0.5542959084, 0.5512480638, 0.5481982936, 0.5451467122, 0.5420934345,
-    0.5390385750, 0.5359822486, 0.5329245701, 0.5298656545, 0.5268056166,
-    0.5237445715, 0.5206826341, 0.5176199196, 0.5145565430, 0.5114926195,
-    0.5084282640, 0.5053635919, 0.5022987182, 0.4992337582, 0.4961688269,
-    0.4931040396, 0.4900395115, 0.4869753576, 0.4839116931, 0.4808486332,
-    0.4777862928, 0.4747247872, 0.4716642314, 0.4686047402, 0.4655464288,
-    0.4624894120, 0.4594338047, 0.4563797218, 0.4533272779, 0.4502765877,
-    0.4472277660, 0.4441809273, 0.4411361860, 0.4380936566, 0.4350534533,
-    0.4320156905, 0.4289804823, 0.4259479427, 0.4229181857, 0.4198913252,
-    0.4168674747, 0.4138467481, 0.4108292588, 0.4078151201, 0.4048044454,
-    0.4017973478, 0.3987939402, 0.3957943355, 0.3927986465, 0.3898069857,
-    0.3868194655, 0.3838361981, 0.3808572958, 0.3778828703, 0.3749130335,
-    0.3719478970, 0.3689875722, 0.3660321703, 0.3630818023, 0.3601365792,
-    0.3571966117, 0.3542620101, 0.3513328847, 0.3484093457, 0.3454915028,
-    0.3425794658, 0.3396733440, 0.3367732466, 0.3338792826, 0.3309915608,
-    0.3281101896, 0.3252352774, 0.3223669322, 0.3195052617, 0.3166503734,
-    0.3138023747, 0.3109613726, 0.3081274738, 0.3053007848, 0.3024814118,
-    0.2996694607, 0.2968650373, 0.2940682469, 0.2912791946, 0.2884979852,
-    0.2857247232, 0.2829595127, 0.2802024578, 0.2774536621, 0.2747132287,
-    0.2719812607, 0.2692578607, 0.2665431311, 0.2638371739, 0.2611400907,
-    0.2584519830, 0.2557729516, 0.2531030974, 0.2504425205, 0.2477913210,
-    0.2451495985, 0.2425174522, 0.2398949812, 0.2372822838, 0.2346794583,
-    0.2320866025, 0.2295038138, 0.2269311893, 0.2243688256, 0.2218168191,
-    0.2192752655, 0.2167442605, 0.2142238991, 0.2117142760, 0.2092154855,
-    0.2067276216, 0.2042507777, 0.2017850468, 0.1993305217, 0.1968872945,
-    0.1944554571, 0.1920351009, 0.1896263167, 0.1872291951, 0.1848438262,
-    0.1824702997, 0.1801087046, 0.1777591297, 0.1754216634, 0.1730963935,
-    0.1707834073, 0.1684827917, 0.1661946332, 0.1639190178, 0.1616560310,
-    0.1594057577, 0.1571682827, 0.1549436899, 0.1527320630, 0.1505334850,
-    0.1483480385, 0.1461758057, 0.1440168683, 0.1418713072, 0.1397392032,
-    0.1376206364, 0.1355156863, 0.1334244321, 0.1313469523, 0.1292833251,
-    0.1272336279, 0.1251979378, 0.1231763312, 0.1211688842, 0.1191756721,
-    0.1171967699, 0.1152322519, 0.1132821920, 0.1113466633, 0.1094257387,
-    0.1075194903, 0.1056279898, 0.1037513082, 0.1018895160, 0.1000426833,
-    0.0982108793, 0.0963941730, 0.0945926326, 0.0928063257, 0.0910353196,
-    0.0892796808, 0.0875394751, 0.0858147681, 0.0841056245, 0.0824121086,
-    0.0807342839, 0.0790722136, 0.0774259601, 0.0757955852, 0.0741811502,
-    0.0725827158, 0.0710003420, 0.0694340884, 0.0678840136, 0.0663501761,
-    0.0648326334, 0.0633314426, 0.0618466600, 0.0603783414, 0.0589265421,
-    0.0574913166, 0.0560727188, 0.0546708020, 0.0532856189, 0.0519172215,
-    0.0505656613, 0.0492309891, 0.0479132549, 0.0466125084, 0.0453287983,
-    0.0440621730, 0.0428126800, 0.0415803663, 0.0403652782, 0.0391674613,
-    0.0379869606, 0.0368238206, 0.0356780848, 0.0345497965, 0.0334389978,
-    0.0323457307, 0.0312700362, 0.0302119547, 0.0291715259, 0.0281487890,
-    0.0271437824, 0.0261565438, 0.0251871104, 0.0242355185, 0.0233018040,
-    0.0223860019, 0.0214881466, 0.0206082719, 0.0197464108, 0.0189025957,
-    0.0180768583, 0.0172692297, 0.0164797402, 0.0157084194, 0.0149552964,
-    0.0142203995, 0.0135037562, 0.0128053934, 0.0121253375, 0.0114636140,
-    0.0108202478, 0.0101952629, 0.0095886830, 0.0090005308, 0.0084308283,
-    0.0078795971, 0.0073468578, 0.0068326304, 0.0063369343, 0.0058597881,
-    0.0054012097, 0.0049612164, 0.0045398246, 0.0041370502, 0.0037529084,
-    0.0033874136, 0.0030405795, 0.0027124192, 0.0024029449, 0.0021121683,
-    0.0018401004, 0.0015867514, 0.0013521307, 0.0011362472, 0.0009391090,
-    0.0007607236, 0.0006010975, 0.0004602369, 0.0003381470, 0.0002348324,
-    0.0001502970, 0.0000845439, 0.0000375757, 0.0000093940,
+// FFT 旋转因子表: 四分之一周期正弦表 sin(2*pi*i/SAMPLE_SIZE), Q15
+// 其余象限和余弦由对称性得到, 同一张表可用于不超过 SAMPLE_SIZE 的任意2的幂点数
+#if SAMPLE_SIZE == 4096
+const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1] = {
+    0, 50, 101, 151, 201, 251, 302, 352, 402, 452,
+    503, 553, 603, 653, 704, 754, 804, 854, 905, 955,
+    1005, 1055, 1106, 1156, 1206, 1256, 1307, 1357, 1407, 1457,
+    1507, 1558, 1608, 1658, 1708, 1758, 1809, 1859, 1909, 1959,
+    2009, 2060, 2110, 2160, 2210, 2260, 2310, 2360, 2411, 2461,
+    2511, 2561, 2611, 2661, 2711, 2761, 2811, 2861, 2912, 2962,
+    3012, 3062, 3112, 3162, 3212, 3262, 3312, 3362, 3412, 3462,
+    3512, 3562, 3612, 3662, 3712, 3762, 3812, 3861, 3911, 3961,
+    4011, 4061, 4111, 4161, 4211, 4260, 4310, 4360, 4410, 4460,
+    4510, 4559, 4609, 4659, 4709, 4758, 4808, 4858, 4907, 4957,
+    5007, 5057, 5106, 5156, 5205, 5255, 5305, 5354, 5404, 5453,
+    5503, 5553, 5602, 5652, 5701, 5751, 5800, 5850, 5899, 5948,
+    5998, 6047, 6097, 6146, 6195, 6245, 6294, 6343, 6393, 6442,
+    6491, 6541, 6590, 6639, 6688, 6737, 6787, 6836, 6885, 6934,
+    6983, 7032, 7081, 7130, 7180, 7229, 7278, 7327, 7376, 7425,
+    7473, 7522, 7571, 7620, 7669, 7718, 7767, 7816, 7864, 7913,
+    7962, 8011, 8059, 8108, 8157, 8206, 8254, 8303, 8351, 8400,
+    8449, 8497, 8546, 8594, 8643, 8691, 8740, 8788, 8836, 8885,
+    8933, 8982, 9030, 9078, 9127, 9175, 9223, 9271, 9319, 9368,
+    9416, 9464, 9512, 9560, 9608, 9656, 9704, 9752, 9800, 9848,
+    9896, 9944, 9992, 10040, 10088, 10135, 10183, 10231, 10279, 10326,
+    10374, 10422, 10469, 10517, 10565, 10612, 10660, 10707, 10755, 10802,
+    10850, 10897, 10945, 10992, 11039, 11087, 11134, 11181, 11228, 11276,
+    11323, 11370, 11417, 11464, 11511, 11558, 11605, 11652, 11699, 11746,
+    11793, 11840, 11887, 11934, 11980, 12027, 12074, 12121, 12167, 12214,
+    12261, 12307, 12354, 12400, 12447, 12493, 12540, 12586, 12633, 12679,
+    12725, 12772, 12818, 12864, 12910, 12957, 13003, 13049, 13095, 13141,
+    13187, 13233, 13279, 13325, 13371, 13417, 13463, 13508, 13554, 13600,
+    13646, 13691, 13737, 13783, 13828, 13874, 13919, 13965, 14010, 14056,
+    14101, 14146, 14192, 14237, 14282, 14327, 14373, 14418, 14463, 14508,
+    14553, 14598, 14643, 14688, 14733, 14778, 14823, 14867, 14912, 14957,
+    15002, 15046, 15091, 15136, 15180, 15225, 15269, 15314, 15358, 15402,
+    15447, 15491, 15535, 15580, 15624, 15668, 15712, 15756, 15800, 15844,
+    15888, 15932, 15976, 16020, 16064, 16108, 16151, 16195, 16239, 16282,
+    16326, 16369, 16413, 16456, 16500, 16543, 16587, 16630, 16673, 16717,
+    16760, 16803, 16846, 16889, 16932, 16975, 17018, 17061, 17104, 17147,
+    17190, 17233, 17275, 17318, 17361, 17403, 17446, 17488, 17531, 17573,
+    17616, 17658, 17700, 17743, 17785, 17827, 17869, 17911, 17953, 17995,
+    18037, 18079, 18121, 18163, 18205, 18247, 18288, 18330, 18372, 18413,
+    18455, 18496, 18538, 18579, 18621, 18662, 18703, 18745, 18786, 18827,
+    18868, 18909, 18950, 18991, 19032, 19073, 19114, 19155, 19195, 19236,
+    19277, 19317, 19358, 19399, 19439, 19479, 19520, 19560, 19601, 19641,
+    19681, 19721, 19761, 19801, 19841, 19881, 19921, 19961, 20001, 20041,
+    20081, 20120, 20160, 20200, 20239, 20279, 20318, 20357, 20397, 20436,
+    20475, 20515, 20554, 20593, 20632, 20671, 20710, 20749, 20788, 20827,
+    20865, 20904, 20943, 20981, 21020, 21059, 21097, 21136, 21174, 21212,
+    21251, 21289, 21327, 21365, 21403, 21441, 21479, 21517, 21555, 21593,
+    21631, 21668, 21706, 21744, 21781, 21819, 21856, 21894, 21931, 21968,
+    22006, 22043, 22080, 22117, 22154, 22191, 22228, 22265, 22302, 22339,
+    22375, 22412, 22449, 22485, 22522, 22558, 22595, 22631, 22668, 22704,
+    22740, 22776, 22812, 22848, 22884, 22920, 22956, 22992, 23028, 23064,
+    23099, 23135, 23170, 23206, 23241, 23277, 23312, 23348, 23383, 23418,
+    23453, 23488, 23523, 23558, 23593, 23628, 23663, 23697, 23732, 23767,
+    23801, 23836, 23870, 23905, 23939, 23973, 24008, 24042, 24076, 24110,
+    24144, 24178, 24212, 24246, 24279, 24313, 24347, 24380, 24414, 24448,
+    24481, 24514, 24548, 24581, 24614, 24647, 24680, 24713, 24746, 24779,
+    24812, 24845, 24878, 24910, 24943, 24976, 25008, 25041, 25073, 25105,
+    25138, 25170, 25202, 25234, 25266, 25298, 25330, 25362, 25394, 25425,
+    25457, 25489, 25520, 25552, 25583, 25615, 25646, 25677, 25708, 25739,
+    25771, 25802, 25833, 25863, 25894, 25925, 25956, 25986, 26017, 26048,
+    26078, 26108, 26139, 26169, 26199, 26229, 26259, 26290, 26320, 26349,
+    26379, 26409, 26439, 26468, 26498, 26528, 26557, 26586, 26616, 26645,
+    26674, 26704, 26733, 26762, 26791, 26820, 26848, 26877, 26906, 26935,
+    26963, 26992, 27020, 27049, 27077, 27105, 27133, 27162, 27190, 27218,
+    27246, 27273, 27301, 27329, 27357, 27384, 27412, 27440, 27467, 27494,
+    27522, 27549, 27576, 27603, 27630, 27657, 27684, 27711, 27738, 27765,
+    27791, 27818, 27844, 27871, 27897, 27924, 27950, 27976, 28002, 28028,
+    28054, 28080, 28106, 28132, 28158, 28183, 28209, 28234, 28260, 28285,
+    28311, 28336, 28361, 28386, 28411, 28436, 28461, 28486, 28511, 28536,
+    28560, 28585, 28610, 28634, 28658, 28683, 28707, 28731, 28755, 28779,
+    28803, 28827, 28851, 28875, 28899, 28922, 28946, 28970, 28993, 29016,
+    29040, 29063, 29086, 29109, 29132, 29155, 29178, 29201, 29224, 29247,
+    29269, 29292, 29314, 29337, 29359, 29381, 29404, 29426, 29448, 29470,
+    29492, 29514, 29535, 29557, 29579, 29600, 29622, 29643, 29665, 29686,
+    29707, 29729, 29750, 29771, 29792, 29813, 29833, 29854, 29875, 29895,
+    29916, 29936, 29957, 29977, 29997, 30018, 30038, 30058, 30078, 30098,
+    30118, 30137, 30157, 30177, 30196, 30216, 30235, 30254, 30274, 30293,
+    30312, 30331, 30350, 30369, 30388, 30407, 30425, 30444, 30462, 30481,
+    30499, 30518, 30536, 30554, 30572, 30590, 30608, 30626, 30644, 30662,
+    30680, 30697, 30715, 30732, 30750, 30767, 30784, 30801, 30819, 30836,
+    30853, 30869, 30886, 30903, 30920, 30936, 30953, 30969, 30986, 31002,
+    31018, 31034, 31050, 31067, 31082, 31098, 31114, 31130, 31146, 31161,
+    31177, 31192, 31207, 31223, 31238, 31253, 31268, 31283, 31298, 31313,
+    31328, 31342, 31357, 31372, 31386, 31400, 31415, 31429, 31443, 31457,
+    31471, 31485, 31499, 31513, 31527, 31540, 31554, 31568, 31581, 31594,
+    31608, 31621, 31634, 31647, 31660, 31673, 31686, 31699, 31711, 31724,
+    31737, 31749, 31761, 31774, 31786, 31798, 31810, 31822, 31834, 31846,
+    31858, 31870, 31881, 31893, 31904, 31916, 31927, 31938, 31950, 31961,
+    31972, 31983, 31994, 32005, 32015, 32026, 32037, 32047, 32058, 32068,
+    32078, 32088, 32099, 32109, 32119, 32129, 32138, 32148, 32158, 32167,
+    32177, 32186, 32196, 32205, 32214, 32224, 32233, 32242, 32251, 32259,
+    32268, 32277, 32286, 32294, 32303, 32311, 32319, 32328, 32336, 32344,
+    32352, 32360, 32368, 32376, 32383, 32391, 32398, 32406, 32413, 32421,
+    32428, 32435, 32442, 32449, 32456, 32463, 32470, 32477, 32483, 32490,
+    32496, 32503, 32509, 32515, 32522, 32528, 32534, 32540, 32546, 32551,
+    32557, 32563, 32568, 32574, 32579, 32585, 32590, 32595, 32600, 32605,
+    32610, 32615, 32620, 32625, 32629, 32634, 32638, 32643, 32647, 32651,
+    32656, 32660, 32664, 32668, 32672, 32675, 32679, 32683, 32686, 32690,
+    32693, 32697, 32700, 32703, 32706, 32709, 32712, 32715, 32718, 32721,
+    32723, 32726, 32729, 32731, 32733, 32736, 32738, 32740, 32742, 32744,
+    32746, 32748, 32749, 32751, 32753, 32754, 32756, 32757, 32758, 32759,
+    32760, 32761, 32762, 32763, 32764, 32765, 32766, 32766, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767,
+};
+#elif SAMPLE_SIZE == 2048
+const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1] = {
+    0, 101, 201, 302, 402, 503, 603, 704, 804, 905,
+    1005, 1106, 1206, 1307, 1407, 1507, 1608, 1708, 1809, 1909,
+    2009, 2110, 2210, 2310, 2411, 2511, 2611, 2711, 2811, 2912,
+    3012, 3112, 3212, 3312, 3412, 3512, 3612, 3712, 3812, 3911,
+    4011, 4111, 4211, 4310, 4410, 4510, 4609, 4709, 4808, 4907,
+    5007, 5106, 5205, 5305, 5404, 5503, 5602, 5701, 5800, 5899,
+    5998, 6097, 6195, 6294, 6393, 6491, 6590, 6688, 6787, 6885,
+    6983, 7081, 7180, 7278, 7376, 7473, 7571, 7669, 7767, 7864,
+    7962, 8059, 8157, 8254, 8351, 8449, 8546, 8643, 8740, 8836,
+    8933, 9030, 9127, 9223, 9319, 9416, 9512, 9608, 9704, 9800,
+    9896, 9992, 10088, 10183, 10279, 10374, 10469, 10565, 10660, 10755,
+    10850, 10945, 11039, 11134, 11228, 11323, 11417, 11511, 11605, 11699,
+    11793, 11887, 11980, 12074, 12167, 12261, 12354, 12447, 12540, 12633,
+    12725, 12818, 12910, 13003, 13095, 13187, 13279, 13371, 13463, 13554,
+    13646, 13737, 13828, 13919, 14010, 14101, 14192, 14282, 14373, 14463,
+    14553, 14643, 14733, 14823, 14912, 15002, 15091, 15180, 15269, 15358,
+    15447, 15535, 15624, 15712, 15800, 15888, 15976, 16064, 16151, 16239,
+    16326, 16413, 16500, 16587, 16673, 16760, 16846, 16932, 17018, 17104,
+    17190, 17275, 17361, 17446, 17531, 17616, 17700, 17785, 17869, 17953,
+    18037, 18121, 18205, 18288, 18372, 18455, 18538, 18621, 18703, 18786,
+    18868, 18950, 19032, 19114, 19195, 19277, 19358, 19439, 19520, 19601,
+    19681, 19761, 19841, 19921, 20001, 20081, 20160, 20239, 20318, 20397,
+    20475, 20554, 20632, 20710, 20788, 20865, 20943, 21020, 21097, 21174,
+    21251, 21327, 21403, 21479, 21555, 21631, 21706, 21781, 21856, 21931,
+    22006, 22080, 22154, 22228, 22302, 22375, 22449, 22522, 22595, 22668,
+    22740, 22812, 22884, 22956, 23028, 23099, 23170, 23241, 23312, 23383,
+    23453, 23523, 23593, 23663, 23732, 23801, 23870, 23939, 24008, 24076,
+    24144, 24212, 24279, 24347, 24414, 24481, 24548, 24614, 24680, 24746,
+    24812, 24878, 24943, 25008, 25073, 25138, 25202, 25266, 25330, 25394,
+    25457, 25520, 25583, 25646, 25708, 25771, 25833, 25894, 25956, 26017,
+    26078, 26139, 26199, 26259, 26320, 26379, 26439, 26498, 26557, 26616,
+    26674, 26733, 26791, 26848, 26906, 26963, 27020, 27077, 27133, 27190,
+    27246, 27301, 27357, 27412, 27467, 27522, 27576, 27630, 27684, 27738,
+    27791, 27844, 27897, 27950, 28002, 28054, 28106, 28158, 28209, 28260,
+    28311, 28361, 28411, 28461, 28511, 28560, 28610, 28658, 28707, 28755,
+    28803, 28851, 28899, 28946, 28993, 29040, 29086, 29132, 29178, 29224,
+    29269, 29314, 29359, 29404, 29448, 29492, 29535, 29579, 29622, 29665,
+    29707, 29750, 29792, 29833, 29875, 29916, 29957, 29997, 30038, 30078,
+    30118, 30157, 30196, 30235, 30274, 30312, 30350, 30388, 30425, 30462,
+    30499, 30536, 30572, 30608, 30644, 30680, 30715, 30750, 30784, 30819,
+    30853, 30886, 30920, 30953, 30986, 31018, 31050, 31082, 31114, 31146,
+    31177, 31207, 31238, 31268, 31298, 31328, 31357, 31386, 31415, 31443,
+    31471, 31499, 31527, 31554, 31581, 31608, 31634, 31660, 31686, 31711,
+    31737, 31761, 31786, 31810, 31834, 31858, 31881, 31904, 31927, 31950,
+    31972, 31994, 32015, 32037, 32058, 32078, 32099, 32119, 32138, 32158,
+    32177, 32196, 32214, 32233, 32251, 32268, 32286, 32303, 32319, 32336,
+    32352, 32368, 32383, 32398, 32413, 32428, 32442, 32456, 32470, 32483,
+    32496, 32509, 32522, 32534, 32546, 32557, 32568, 32579, 32590, 32600,
+    32610, 32620, 32629, 32638, 32647, 32656, 32664, 32672, 32679, 32686,
+    32693, 32700, 32706, 32712, 32718, 32723, 32729, 32733, 32738, 32742,
+    32746, 32749, 32753, 32756, 32758, 32760, 32762, 32764, 32766, 32767,
+    32767, 32767, 32767,
+};
+#elif SAMPLE_SIZE == 1024
+const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809,
+    2009, 2210, 2411, 2611, 2811, 3012, 3212, 3412, 3612, 3812,
+    4011, 4211, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800,
+    5998, 6195, 6393, 6590, 6787, 6983, 7180, 7376, 7571, 7767,
+    7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319, 9512, 9704,
+    9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463,
+    13646, 13828, 14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+    15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673, 16846, 17018,
+    17190, 17361, 17531, 17700, 17869, 18037, 18205, 18372, 18538, 18703,
+    18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001, 20160, 20318,
+    20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312,
+    23453, 23593, 23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680,
+    24812, 24943, 25073, 25202, 25330, 25457, 25583, 25708, 25833, 25956,
+    26078, 26199, 26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+    27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002, 28106, 28209,
+    28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038,
+    30118, 30196, 30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784,
+    30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298, 31357, 31415,
+    31471, 31527, 31581, 31634, 31686, 31737, 31786, 31834, 31881, 31927,
+    31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251, 32286, 32319,
+    32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738,
+    32746, 32753, 32758, 32762, 32766, 32767, 32767,
+};
+#elif SAMPLE_SIZE == 512
+const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1] = {
+    0, 402, 804, 1206, 1608, 2009, 2411, 2811, 3212, 3612,
+    4011, 4410, 4808, 5205, 5602, 5998, 6393, 6787, 7180, 7571,
+    7962, 8351, 8740, 9127, 9512, 9896, 10279, 10660, 11039, 11417,
+    11793, 12167, 12540, 12910, 13279, 13646, 14010, 14373, 14733, 15091,
+    15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869, 18205, 18538,
+    18868, 19195, 19520, 19841, 20160, 20475, 20788, 21097, 21403, 21706,
+    22006, 22302, 22595, 22884, 23170, 23453, 23732, 24008, 24279, 24548,
+    24812, 25073, 25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020,
+    27246, 27467, 27684, 27897, 28106, 28311, 28511, 28707, 28899, 29086,
+    29269, 29448, 29622, 29792, 29957, 30118, 30274, 30425, 30572, 30715,
+    30853, 30986, 31114, 31238, 31357, 31471, 31581, 31686, 31786, 31881,
+    31972, 32058, 32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+    32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766, 32767,
+};
+#elif SAMPLE_SIZE == 256
+const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1] = {
+    0, 804, 1608, 2411, 3212, 4011, 4808, 5602, 6393, 7180,
+    7962, 8740, 9512, 10279, 11039, 11793, 12540, 13279, 14010, 14733,
+    15447, 16151, 16846, 17531, 18205, 18868, 19520, 20160, 20788, 21403,
+    22006, 22595, 23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957, 30274, 30572,
+    30853, 31114, 31357, 31581, 31786, 31972, 32138, 32286, 32413, 32522,
+    32610, 32679, 32729, 32758, 32767,
+};
+#endif
+
+// 窗函数系数半表 (Q15)
+// w[i] = a0 - a1*cos(t) + a2*cos(2t) - a3*cos(3t) + a4*cos(4t),
+// t = 2*pi*(i+1)/(SAMPLE_SIZE+1), 只存前 SAMPLE_SIZE/2 点, w[SAMPLE_SIZE-1-i] = w[i]
+// 相干增益 = sum(w)/N (Q15), 等效噪声带宽 ENBW = N*sum(w^2)/sum(w)^2 (频点, Q12)
+#if SAMPLE_SIZE == 4096
+static const q15_t hann_half[SAMPLE_SIZE / 2] = {
+    0, 0, 0, 0, 0, 1, 1, 1, 2, 2,
+    2, 3, 3, 4, 4, 5, 6, 6, 7, 8,
+    8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+    19, 20, 21, 22, 24, 25, 26, 28, 29, 31,
+    32, 34, 36, 37, 39, 41, 43, 44, 46, 48,
+    50, 52, 54, 56, 58, 60, 63, 65, 67, 69,
+    72, 74, 76, 79, 81, 84, 86, 89, 92, 94,
+    97, 100, 103, 105, 108, 111, 114, 117, 120, 123,
+    126, 129, 133, 136, 139, 142, 146, 149, 152, 156,
+    159, 163, 166, 170, 174, 177, 181, 185, 188, 192,
+    196, 200, 204, 208, 212, 216, 220, 224, 228, 233,
+    237, 241, 245, 250, 254, 259, 263, 268, 272, 277,
+    281, 286, 291, 295, 300, 305, 310, 315, 320, 325,
+    330, 335, 340, 345, 350, 355, 360, 366, 371, 376,
+    382, 387, 392, 398, 403, 409, 415, 420, 426, 432,
+    437, 443, 449, 455, 461, 467, 473, 479, 485, 491,
+    497, 503, 509, 515, 522, 528, 534, 541, 547, 554,
+    560, 567, 573, 580, 587, 593, 600, 607, 613, 620,
+    627, 634, 641, 648, 655, 662, 669, 676, 683, 691,
+    698, 705, 712, 720, 727, 735, 742, 750, 757, 765,
+    772, 780, 788, 795, 803, 811, 819, 827, 834, 842,
+    850, 858, 866, 874, 883, 891, 899, 907, 915, 924,
+    932, 940, 949, 957, 966, 974, 983, 991, 1000, 1009,
+    1017, 1026, 1035, 1044, 1053, 1061, 1070, 1079, 1088, 1097,
+    1106, 1115, 1125, 1134, 1143, 1152, 1161, 1171, 1180, 1190,
+    1199, 1208, 1218, 1227, 1237, 1247, 1256, 1266, 1276, 1285,
+    1295, 1305, 1315, 1325, 1335, 1344, 1354, 1364, 1375, 1385,
+    1395, 1405, 1415, 1425, 1436, 1446, 1456, 1467, 1477, 1487,
+    1498, 1508, 1519, 1530, 1540, 1551, 1562, 1572, 1583, 1594,
+    1605, 1616, 1626, 1637, 1648, 1659, 1670, 1681, 1693, 1704,
+    1715, 1726, 1737, 1749, 1760, 1771, 1783, 1794, 1805, 1817,
+    1828, 1840, 1852, 1863, 1875, 1887, 1898, 1910, 1922, 1934,
+    1946, 1957, 1969, 1981, 1993, 2005, 2017, 2029, 2042, 2054,
+    2066, 2078, 2090, 2103, 2115, 2127, 2140, 2152, 2165, 2177,
+    2190, 2202, 2215, 2228, 2240, 2253, 2266, 2278, 2291, 2304,
+    2317, 2330, 2343, 2356, 2369, 2382, 2395, 2408, 2421, 2434,
+    2447, 2461, 2474, 2487, 2501, 2514, 2527, 2541, 2554, 2568,
+    2581, 2595, 2608, 2622, 2636, 2649, 2663, 2677, 2691, 2704,
+    2718, 2732, 2746, 2760, 2774, 2788, 2802, 2816, 2830, 2844,
+    2858, 2873, 2887, 2901, 2915, 2930, 2944, 2958, 2973, 2987,
+    3002, 3016, 3031, 3045, 3060, 3075, 3089, 3104, 3119, 3133,
+    3148, 3163, 3178, 3193, 3208, 3223, 3238, 3253, 3268, 3283,
+    3298, 3313, 3328, 3343, 3359, 3374, 3389, 3405, 3420, 3435,
+    3451, 3466, 3482, 3497, 3513, 3528, 3544, 3559, 3575, 3591,
+    3606, 3622, 3638, 3654, 3670, 3685, 3701, 3717, 3733, 3749,
+    3765, 3781, 3797, 3813, 3830, 3846, 3862, 3878, 3894, 3911,
+    3927, 3943, 3960, 3976, 3992, 4009, 4025, 4042, 4058, 4075,
+    4092, 4108, 4125, 4142, 4158, 4175, 4192, 4209, 4225, 4242,
+    4259, 4276, 4293, 4310, 4327, 4344, 4361, 4378, 4395, 4412,
+    4430, 4447, 4464, 4481, 4499, 4516, 4533, 4551, 4568, 4585,
+    4603, 4620, 4638, 4655, 4673, 4690, 4708, 4726, 4743, 4761,
+    4779, 4797, 4814, 4832, 4850, 4868, 4886, 4904, 4922, 4940,
+    4958, 4976, 4994, 5012, 5030, 5048, 5066, 5084, 5102, 5121,
+    5139, 5157, 5176, 5194, 5212, 5231, 5249, 5267, 5286, 5304,
+    5323, 5342, 5360, 5379, 5397, 5416, 5435, 5453, 5472, 5491,
+    5510, 5528, 5547, 5566, 5585, 5604, 5623, 5642, 5661, 5680,
+    5699, 5718, 5737, 5756, 5775, 5794, 5814, 5833, 5852, 5871,
+    5891, 5910, 5929, 5949, 5968, 5987, 6007, 6026, 6046, 6065,
+    6085, 6104, 6124, 6144, 6163, 6183, 6202, 6222, 6242, 6262,
+    6281, 6301, 6321, 6341, 6361, 6381, 6401, 6420, 6440, 6460,
+    6480, 6500, 6520, 6541, 6561, 6581, 6601, 6621, 6641, 6661,
+    6682, 6702, 6722, 6743, 6763, 6783, 6804, 6824, 6844, 6865,
+    6885, 6906, 6926, 6947, 6967, 6988, 7009, 7029, 7050, 7070,
+    7091, 7112, 7133, 7153, 7174, 7195, 7216, 7237, 7257, 7278,
+    7299, 7320, 7341, 7362, 7383, 7404, 7425, 7446, 7467, 7488,
+    7509, 7530, 7552, 7573, 7594, 7615, 7636, 7658, 7679, 7700,
+    7722, 7743, 7764, 7786, 7807, 7828, 7850, 7871, 7893, 7914,
+    7936, 7957, 7979, 8001, 8022, 8044, 8065, 8087, 8109, 8130,
+    8152, 8174, 8196, 8217, 8239, 8261, 8283, 8305, 8327, 8348,
+    8370, 8392, 8414, 8436, 8458, 8480, 8502, 8524, 8546, 8568,
+    8590, 8613, 8635, 8657, 8679, 8701, 8723, 8746, 8768, 8790,
+    8812, 8835, 8857, 8879, 8902, 8924, 8946, 8969, 8991, 9014,
+    9036, 9059, 9081, 9104, 9126, 9149, 9171, 9194, 9216, 9239,
+    9262, 9284, 9307, 9329, 9352, 9375, 9398, 9420, 9443, 9466,
+    9489, 9511, 9534, 9557, 9580, 9603, 9626, 9649, 9671, 9694,
+    9717, 9740, 9763, 9786, 9809, 9832, 9855, 9878, 9901, 9925,
+    9948, 9971, 9994, 10017, 10040, 10063, 10087, 10110, 10133, 10156,
+    10179, 10203, 10226, 10249, 10273, 10296, 10319, 10343, 10366, 10389,
+    10413, 10436, 10460, 10483, 10506, 10530, 10553, 10577, 10600, 10624,
+    10647, 10671, 10695, 10718, 10742, 10765, 10789, 10812, 10836, 10860,
+    10883, 10907, 10931, 10955, 10978, 11002, 11026, 11049, 11073, 11097,
+    11121, 11145, 11168, 11192, 11216, 11240, 11264, 11288, 11312, 11335,
+    11359, 11383, 11407, 11431, 11455, 11479, 11503, 11527, 11551, 11575,
+    11599, 11623, 11647, 11671, 11695, 11719, 11743, 11768, 11792, 11816,
+    11840, 11864, 11888, 11912, 11937, 11961, 11985, 12009, 12033, 12058,
+    12082, 12106, 12130, 12155, 12179, 12203, 12228, 12252, 12276, 12300,
+    12325, 12349, 12374, 12398, 12422, 12447, 12471, 12495, 12520, 12544,
+    12569, 12593, 12618, 12642, 12667, 12691, 12715, 12740, 12764, 12789,
+    12813, 12838, 12863, 12887, 12912, 12936, 12961, 12985, 13010, 13035,
+    13059, 13084, 13108, 13133, 13158, 13182, 13207, 13232, 13256, 13281,
+    13306, 13330, 13355, 13380, 13404, 13429, 13454, 13478, 13503, 13528,
+    13553, 13577, 13602, 13627, 13652, 13677, 13701, 13726, 13751, 13776,
+    13801, 13825, 13850, 13875, 13900, 13925, 13949, 13974, 13999, 14024,
+    14049, 14074, 14099, 14124, 14148, 14173, 14198, 14223, 14248, 14273,
+    14298, 14323, 14348, 14373, 14398, 14423, 14448, 14472, 14497, 14522,
+    14547, 14572, 14597, 14622, 14647, 14672, 14697, 14722, 14747, 14772,
+    14797, 14822, 14847, 14872, 14897, 14922, 14947, 14972, 14997, 15022,
+    15047, 15073, 15098, 15123, 15148, 15173, 15198, 15223, 15248, 15273,
+    15298, 15323, 15348, 15373, 15398, 15423, 15449, 15474, 15499, 15524,
+    15549, 15574, 15599, 15624, 15649, 15674, 15699, 15725, 15750, 15775,
+    15800, 15825, 15850, 15875, 15900, 15925, 15951, 15976, 16001, 16026,
+    16051, 16076, 16101, 16126, 16152, 16177, 16202, 16227, 16252, 16277,
+    16302, 16327, 16353, 16378, 16403, 16428, 16453, 16478, 16503, 16528,
+    16554, 16579, 16604, 16629, 16654, 16679, 16704, 16729, 16755, 16780,
+    16805, 16830, 16855, 16880, 16905, 16930, 16956, 16981, 17006, 17031,
+    17056, 17081, 17106, 17131, 17156, 17181, 17207, 17232, 17257, 17282,
+    17307, 17332, 17357, 17382, 17407, 17432, 17457, 17482, 17508, 17533,
+    17558, 17583, 17608, 17633, 17658, 17683, 17708, 17733, 17758, 17783,
+    17808, 17833, 17858, 17883, 17908, 17933, 17958, 17983, 18008, 18033,
+    18058, 18083, 18108, 18133, 18158, 18183, 18208, 18233, 18258, 18283,
+    18308, 18333, 18358, 18383, 18408, 18433, 18458, 18483, 18507, 18532,
+    18557, 18582, 18607, 18632, 18657, 18682, 18707, 18732, 18756, 18781,
+    18806, 18831, 18856, 18881, 18905, 18930, 18955, 18980, 19005, 19030,
+    19054, 19079, 19104, 19129, 19153, 19178, 19203, 19228, 19252, 19277,
+    19302, 19327, 19351, 19376, 19401, 19425, 19450, 19475, 19499, 19524,
+    19549, 19573, 19598, 19623, 19647, 19672, 19697, 19721, 19746, 19770,
+    19795, 19820, 19844, 19869, 19893, 19918, 19942, 19967, 19991, 20016,
+    20040, 20065, 20089, 20114, 20138, 20163, 20187, 20212, 20236, 20260,
+    20285, 20309, 20334, 20358, 20382, 20407, 20431, 20455, 20480, 20504,
+    20528, 20553, 20577, 20601, 20626, 20650, 20674, 20698, 20723, 20747,
+    20771, 20795, 20819, 20844, 20868, 20892, 20916, 20940, 20964, 20988,
+    21013, 21037, 21061, 21085, 21109, 21133, 21157, 21181, 21205, 21229,
+    21253, 21277, 21301, 21325, 21349, 21373, 21397, 21421, 21445, 21468,
+    21492, 21516, 21540, 21564, 21588, 21612, 21635, 21659, 21683, 21707,
+    21730, 21754, 21778, 21802, 21825, 21849, 21873, 21896, 21920, 21944,
+    21967, 21991, 22015, 22038, 22062, 22085, 22109, 22132, 22156, 22179,
+    22203, 22226, 22250, 22273, 22297, 22320, 22344, 22367, 22390, 22414,
+    22437, 22460, 22484, 22507, 22530, 22554, 22577, 22600, 22623, 22647,
+    22670, 22693, 22716, 22739, 22763, 22786, 22809, 22832, 22855, 22878,
+    22901, 22924, 22947, 22970, 22993, 23016, 23039, 23062, 23085, 23108,
+    23131, 23154, 23177, 23200, 23222, 23245, 23268, 23291, 23314, 23336,
+    23359, 23382, 23404, 23427, 23450, 23473, 23495, 23518, 23540, 23563,
+    23586, 23608, 23631, 23653, 23676, 23698, 23721, 23743, 23766, 23788,
+    23810, 23833, 23855, 23878, 23900, 23922, 23944, 23967, 23989, 24011,
+    24034, 24056, 24078, 24100, 24122, 24144, 24167, 24189, 24211, 24233,
+    24255, 24277, 24299, 24321, 24343, 24365, 24387, 24409, 24431, 24452,
+    24474, 24496, 24518, 24540, 24561, 24583, 24605, 24627, 24648, 24670,
+    24692, 24713, 24735, 24757, 24778, 24800, 24821, 24843, 24864, 24886,
+    24907, 24929, 24950, 24972, 24993, 25014, 25036, 25057, 25078, 25100,
+    25121, 25142, 25163, 25185, 25206, 25227, 25248, 25269, 25290, 25311,
+    25332, 25354, 25375, 25396, 25416, 25437, 25458, 25479, 25500, 25521,
+    25542, 25563, 25584, 25604, 25625, 25646, 25667, 25687, 25708, 25729,
+    25749, 25770, 25790, 25811, 25831, 25852, 25872, 25893, 25913, 25934,
+    25954, 25975, 25995, 26015, 26036, 26056, 26076, 26096, 26117, 26137,
+    26157, 26177, 26197, 26217, 26238, 26258, 26278, 26298, 26318, 26338,
+    26358, 26377, 26397, 26417, 26437, 26457, 26477, 26496, 26516, 26536,
+    26556, 26575, 26595, 26615, 26634, 26654, 26673, 26693, 26713, 26732,
+    26751, 26771, 26790, 26810, 26829, 26848, 26868, 26887, 26906, 26926,
+    26945, 26964, 26983, 27002, 27021, 27041, 27060, 27079, 27098, 27117,
+    27136, 27155, 27174, 27192, 27211, 27230, 27249, 27268, 27287, 27305,
+    27324, 27343, 27361, 27380, 27399, 27417, 27436, 27454, 27473, 27491,
+    27510, 27528, 27547, 27565, 27583, 27602, 27620, 27638, 27656, 27675,
+    27693, 27711, 27729, 27747, 27765, 27783, 27801, 27819, 27837, 27855,
+    27873, 27891, 27909, 27927, 27945, 27963, 27980, 27998, 28016, 28033,
+    28051, 28069, 28086, 28104, 28121, 28139, 28156, 28174, 28191, 28209,
+    28226, 28243, 28261, 28278, 28295, 28313, 28330, 28347, 28364, 28381,
+    28398, 28415, 28433, 28450, 28466, 28483, 28500, 28517, 28534, 28551,
+    28568, 28585, 28601, 28618, 28635, 28651, 28668, 28685, 28701, 28718,
+    28734, 28751, 28767, 28784, 28800, 28817, 28833, 28849, 28866, 28882,
+    28898, 28914, 28930, 28947, 28963, 28979, 28995, 29011, 29027, 29043,
+    29059, 29075, 29090, 29106, 29122, 29138, 29154, 29169, 29185, 29201,
+    29216, 29232, 29248, 29263, 29279, 29294, 29310, 29325, 29340, 29356,
+    29371, 29386, 29402, 29417, 29432, 29447, 29462, 29478, 29493, 29508,
+    29523, 29538, 29553, 29568, 29583, 29597, 29612, 29627, 29642, 29657,
+    29671, 29686, 29701, 29715, 29730, 29744, 29759, 29773, 29788, 29802,
+    29817, 29831, 29845, 29860, 29874, 29888, 29903, 29917, 29931, 29945,
+    29959, 29973, 29987, 30001, 30015, 30029, 30043, 30057, 30071, 30084,
+    30098, 30112, 30126, 30139, 30153, 30166, 30180, 30194, 30207, 30221,
+    30234, 30247, 30261, 30274, 30287, 30301, 30314, 30327, 30340, 30353,
+    30367, 30380, 30393, 30406, 30419, 30432, 30445, 30457, 30470, 30483,
+    30496, 30509, 30521, 30534, 30547, 30559, 30572, 30584, 30597, 30609,
+    30622, 30634, 30647, 30659, 30671, 30684, 30696, 30708, 30720, 30732,
+    30745, 30757, 30769, 30781, 30793, 30805, 30817, 30828, 30840, 30852,
+    30864, 30876, 30887, 30899, 30911, 30922, 30934, 30945, 30957, 30968,
+    30980, 30991, 31002, 31014, 31025, 31036, 31048, 31059, 31070, 31081,
+    31092, 31103, 31114, 31125, 31136, 31147, 31158, 31169, 31180, 31190,
+    31201, 31212, 31222, 31233, 31244, 31254, 31265, 31275, 31286, 31296,
+    31307, 31317, 31327, 31338, 31348, 31358, 31368, 31378, 31388, 31399,
+    31409, 31419, 31429, 31438, 31448, 31458, 31468, 31478, 31488, 31497,
+    31507, 31517, 31526, 31536, 31545, 31555, 31564, 31574, 31583, 31593,
+    31602, 31611, 31620, 31630, 31639, 31648, 31657, 31666, 31675, 31684,
+    31693, 31702, 31711, 31720, 31729, 31737, 31746, 31755, 31764, 31772,
+    31781, 31789, 31798, 31806, 31815, 31823, 31832, 31840, 31848, 31857,
+    31865, 31873, 31881, 31889, 31898, 31906, 31914, 31922, 31930, 31938,
+    31945, 31953, 31961, 31969, 31977, 31984, 31992, 32000, 32007, 32015,
+    32022, 32030, 32037, 32045, 32052, 32059, 32066, 32074, 32081, 32088,
+    32095, 32102, 32109, 32117, 32124, 32130, 32137, 32144, 32151, 32158,
+    32165, 32171, 32178, 32185, 32191, 32198, 32205, 32211, 32218, 32224,
+    32230, 32237, 32243, 32249, 32256, 32262, 32268, 32274, 32280, 32286,
+    32292, 32298, 32304, 32310, 32316, 32322, 32328, 32334, 32339, 32345,
+    32351, 32356, 32362, 32367, 32373, 32378, 32384, 32389, 32394, 32400,
+    32405, 32410, 32416, 32421, 32426, 32431, 32436, 32441, 32446, 32451,
+    32456, 32461, 32465, 32470, 32475, 32480, 32484, 32489, 32494, 32498,
+    32503, 32507, 32512, 32516, 32520, 32525, 32529, 32533, 32538, 32542,
+    32546, 32550, 32554, 32558, 32562, 32566, 32570, 32574, 32578, 32581,
+    32585, 32589, 32593, 32596, 32600, 32603, 32607, 32610, 32614, 32617,
+    32621, 32624, 32627, 32631, 32634, 32637, 32640, 32643, 32646, 32649,
+    32652, 32655, 32658, 32661, 32664, 32667, 32670, 32672, 32675, 32678,
+    32680, 32683, 32685, 32688, 32690, 32693, 32695, 32698, 32700, 32702,
+    32704, 32707, 32709, 32711, 32713, 32715, 32717, 32719, 32721, 32723,
+    32725, 32726, 32728, 32730, 32732, 32733, 32735, 32736, 32738, 32739,
+    32741, 32742, 32744, 32745, 32746, 32748, 32749, 32750, 32751, 32752,
+    32753, 32754, 32755, 32756, 32757, 32758, 32759, 32760, 32761, 32761,
+    32762, 32763, 32763, 32764, 32764, 32765, 32765, 32766, 32766, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+};
+static const q15_t blackman_harris_half[SAMPLE_SIZE / 2] = {
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 6, 6, 6, 6,
+    6, 6, 6, 7, 7, 7, 7, 7, 7, 7,
+    8, 8, 8, 8, 8, 8, 9, 9, 9, 9,
+    9, 10, 10, 10, 10, 10, 11, 11, 11, 11,
+    11, 12, 12, 12, 12, 13, 13, 13, 13, 13,
+    14, 14, 14, 14, 15, 15, 15, 16, 16, 16,
+    16, 17, 17, 17, 17, 18, 18, 18, 19, 19,
+    19, 20, 20, 20, 21, 21, 21, 22, 22, 22,
+    23, 23, 23, 24, 24, 24, 25, 25, 25, 26,
+    26, 26, 27, 27, 28, 28, 28, 29, 29, 30,
+    30, 30, 31, 31, 32, 32, 33, 33, 34, 34,
+    34, 35, 35, 36, 36, 37, 37, 38, 38, 39,
+    39, 40, 40, 41, 41, 42, 42, 43, 43, 44,
+    44, 45, 45, 46, 47, 47, 48, 48, 49, 49,
+    50, 51, 51, 52, 52, 53, 54, 54, 55, 56,
+    56, 57, 57, 58, 59, 59, 60, 61, 61, 62,
+    63, 64, 64, 65, 66, 66, 67, 68, 69, 69,
+    70, 71, 72, 72, 73, 74, 75, 75, 76, 77,
+    78, 79, 80, 80, 81, 82, 83, 84, 85, 85,
+    86, 87, 88, 89, 90, 91, 92, 93, 94, 94,
+    95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 109, 110, 111, 112, 113, 115,
+    116, 117, 118, 119, 120, 121, 122, 123, 125, 126,
+    127, 128, 129, 130, 132, 133, 134, 135, 136, 138,
+    139, 140, 141, 143, 144, 145, 147, 148, 149, 151,
+    152, 153, 155, 156, 157, 159, 160, 161, 163, 164,
+    166, 167, 169, 170, 171, 173, 174, 176, 177, 179,
+    180, 182, 183, 185, 187, 188, 190, 191, 193, 195,
+    196, 198, 199, 201, 203, 204, 206, 208, 209, 211,
+    213, 215, 216, 218, 220, 222, 223, 225, 227, 229,
+    231, 233, 234, 236, 238, 240, 242, 244, 246, 248,
+    250, 252, 254, 256, 258, 260, 262, 264, 266, 268,
+    270, 272, 274, 276, 278, 280, 282, 285, 287, 289,
+    291, 293, 296, 298, 300, 302, 305, 307, 309, 312,
+    314, 316, 319, 321, 323, 326, 328, 331, 333, 335,
+    338, 340, 343, 345, 348, 350, 353, 355, 358, 361,
+    363, 366, 369, 371, 374, 376, 379, 382, 385, 387,
+    390, 393, 396, 398, 401, 404, 407, 410, 413, 416,
+    418, 421, 424, 427, 430, 433, 436, 439, 442, 445,
+    448, 452, 455, 458, 461, 464, 467, 470, 474, 477,
+    480, 483, 487, 490, 493, 496, 500, 503, 506, 510,
+    513, 517, 520, 524, 527, 531, 534, 538, 541, 545,
+    548, 552, 556, 559, 563, 567, 570, 574, 578, 581,
+    585, 589, 593, 597, 600, 604, 608, 612, 616, 620,
+    624, 628, 632, 636, 640, 644, 648, 652, 656, 660,
+    665, 669, 673, 677, 681, 686, 690, 694, 699, 703,
+    707, 712, 716, 721, 725, 729, 734, 738, 743, 748,
+    752, 757, 761, 766, 771, 775, 780, 785, 789, 794,
+    799, 804, 809, 814, 818, 823, 828, 833, 838, 843,
+    848, 853, 858, 863, 868, 874, 879, 884, 889, 894,
+    900, 905, 910, 915, 921, 926, 932, 937, 942, 948,
+    953, 959, 964, 970, 976, 981, 987, 992, 998, 1004,
+    1010, 1015, 1021, 1027, 1033, 1039, 1044, 1050, 1056, 1062,
+    1068, 1074, 1080, 1086, 1092, 1099, 1105, 1111, 1117, 1123,
+    1129, 1136, 1142, 1148, 1155, 1161, 1167, 1174, 1180, 1187,
+    1193, 1200, 1206, 1213, 1220, 1226, 1233, 1240, 1246, 1253,
+    1260, 1267, 1274, 1280, 1287, 1294, 1301, 1308, 1315, 1322,
+    1329, 1336, 1343, 1351, 1358, 1365, 1372, 1379, 1387, 1394,
+    1401, 1409, 1416, 1424, 1431, 1439, 1446, 1454, 1461, 1469,
+    1476, 1484, 1492, 1500, 1507, 1515, 1523, 1531, 1539, 1547,
+    1554, 1562, 1570, 1578, 1587, 1595, 1603, 1611, 1619, 1627,
+    1636, 1644, 1652, 1660, 1669, 1677, 1686, 1694, 1703, 1711,
+    1720, 1728, 1737, 1746, 1754, 1763, 1772, 1780, 1789, 1798,
+    1807, 1816, 1825, 1834, 1843, 1852, 1861, 1870, 1879, 1888,
+    1898, 1907, 1916, 1925, 1935, 1944, 1954, 1963, 1972, 1982,
+    1991, 2001, 2011, 2020, 2030, 2040, 2049, 2059, 2069, 2079,
+    2089, 2099, 2109, 2119, 2129, 2139, 2149, 2159, 2169, 2179,
+    2189, 2200, 2210, 2220, 2231, 2241, 2251, 2262, 2272, 2283,
+    2294, 2304, 2315, 2325, 2336, 2347, 2358, 2369, 2379, 2390,
+    2401, 2412, 2423, 2434, 2445, 2456, 2468, 2479, 2490, 2501,
+    2513, 2524, 2535, 2547, 2558, 2570, 2581, 2593, 2604, 2616,
+    2628, 2639, 2651, 2663, 2675, 2686, 2698, 2710, 2722, 2734,
+    2746, 2758, 2771, 2783, 2795, 2807, 2819, 2832, 2844, 2856,
+    2869, 2881, 2894, 2906, 2919, 2932, 2944, 2957, 2970, 2982,
+    2995, 3008, 3021, 3034, 3047, 3060, 3073, 3086, 3099, 3112,
+    3125, 3139, 3152, 3165, 3179, 3192, 3206, 3219, 3233, 3246,
+    3260, 3273, 3287, 3301, 3314, 3328, 3342, 3356, 3370, 3384,
+    3398, 3412, 3426, 3440, 3454, 3468, 3483, 3497, 3511, 3526,
+    3540, 3555, 3569, 3584, 3598, 3613, 3627, 3642, 3657, 3672,
+    3686, 3701, 3716, 3731, 3746, 3761, 3776, 3791, 3806, 3822,
+    3837, 3852, 3867, 3883, 3898, 3914, 3929, 3945, 3960, 3976,
+    3991, 4007, 4023, 4039, 4054, 4070, 4086, 4102, 4118, 4134,
+    4150, 4166, 4183, 4199, 4215, 4231, 4248, 4264, 4280, 4297,
+    4313, 4330, 4346, 4363, 4380, 4396, 4413, 4430, 4447, 4464,
+    4481, 4498, 4515, 4532, 4549, 4566, 4583, 4600, 4618, 4635,
+    4652, 4670, 4687, 4704, 4722, 4740, 4757, 4775, 4793, 4810,
+    4828, 4846, 4864, 4882, 4900, 4918, 4936, 4954, 4972, 4990,
+    5008, 5027, 5045, 5063, 5082, 5100, 5119, 5137, 5156, 5174,
+    5193, 5212, 5230, 5249, 5268, 5287, 5306, 5325, 5344, 5363,
+    5382, 5401, 5420, 5439, 5459, 5478, 5497, 5517, 5536, 5556,
+    5575, 5595, 5615, 5634, 5654, 5674, 5693, 5713, 5733, 5753,
+    5773, 5793, 5813, 5833, 5853, 5874, 5894, 5914, 5935, 5955,
+    5975, 5996, 6016, 6037, 6057, 6078, 6099, 6119, 6140, 6161,
+    6182, 6203, 6224, 6245, 6266, 6287, 6308, 6329, 6350, 6372,
+    6393, 6414, 6436, 6457, 6479, 6500, 6522, 6543, 6565, 6587,
+    6608, 6630, 6652, 6674, 6696, 6718, 6740, 6762, 6784, 6806,
+    6828, 6850, 6873, 6895, 6917, 6940, 6962, 6985, 7007, 7030,
+    7052, 7075, 7098, 7120, 7143, 7166, 7189, 7212, 7235, 7258,
+    7281, 7304, 7327, 7350, 7373, 7397, 7420, 7443, 7467, 7490,
+    7514, 7537, 7561, 7584, 7608, 7632, 7655, 7679, 7703, 7727,
+    7751, 7775, 7799, 7823, 7847, 7871, 7895, 7919, 7944, 7968,
+    7992, 8017, 8041, 8066, 8090, 8115, 8139, 8164, 8189, 8213,
+    8238, 8263, 8288, 8313, 8338, 8363, 8388, 8413, 8438, 8463,
+    8488, 8513, 8538, 8564, 8589, 8615, 8640, 8665, 8691, 8717,
+    8742, 8768, 8793, 8819, 8845, 8871, 8897, 8922, 8948, 8974,
+    9000, 9026, 9052, 9079, 9105, 9131, 9157, 9184, 9210, 9236,
+    9263, 9289, 9316, 9342, 9369, 9395, 9422, 9449, 9475, 9502,
+    9529, 9556, 9583, 9610, 9637, 9664, 9691, 9718, 9745, 9772,
+    9799, 9827, 9854, 9881, 9908, 9936, 9963, 9991, 10018, 10046,
+    10073, 10101, 10129, 10156, 10184, 10212, 10240, 10268, 10296, 10323,
+    10351, 10379, 10407, 10436, 10464, 10492, 10520, 10548, 10577, 10605,
+    10633, 10662, 10690, 10718, 10747, 10775, 10804, 10833, 10861, 10890,
+    10919, 10947, 10976, 11005, 11034, 11063, 11092, 11121, 11150, 11179,
+    11208, 11237, 11266, 11295, 11324, 11353, 11383, 11412, 11441, 11471,
+    11500, 11530, 11559, 11589, 11618, 11648, 11677, 11707, 11737, 11766,
+    11796, 11826, 11856, 11885, 11915, 11945, 11975, 12005, 12035, 12065,
+    12095, 12125, 12155, 12186, 12216, 12246, 12276, 12307, 12337, 12367,
+    12398, 12428, 12459, 12489, 12520, 12550, 12581, 12611, 12642, 12673,
+    12703, 12734, 12765, 12795, 12826, 12857, 12888, 12919, 12950, 12981,
+    13012, 13043, 13074, 13105, 13136, 13167, 13198, 13229, 13261, 13292,
+    13323, 13354, 13386, 13417, 13449, 13480, 13511, 13543, 13574, 13606,
+    13637, 13669, 13700, 13732, 13764, 13795, 13827, 13859, 13891, 13922,
+    13954, 13986, 14018, 14050, 14082, 14114, 14145, 14177, 14209, 14241,
+    14273, 14306, 14338, 14370, 14402, 14434, 14466, 14498, 14531, 14563,
+    14595, 14627, 14660, 14692, 14724, 14757, 14789, 14822, 14854, 14887,
+    14919, 14952, 14984, 15017, 15049, 15082, 15115, 15147, 15180, 15212,
+    15245, 15278, 15311, 15343, 15376, 15409, 15442, 15475, 15507, 15540,
+    15573, 15606, 15639, 15672, 15705, 15738, 15771, 15804, 15837, 15870,
+    15903, 15936, 15969, 16002, 16035, 16069, 16102, 16135, 16168, 16201,
+    16234, 16268, 16301, 16334, 16367, 16401, 16434, 16467, 16501, 16534,
+    16567, 16601, 16634, 16668, 16701, 16734, 16768, 16801, 16835, 16868,
+    16902, 16935, 16969, 17002, 17036, 17069, 17103, 17137, 17170, 17204,
+    17237, 17271, 17305, 17338, 17372, 17405, 17439, 17473, 17506, 17540,
+    17574, 17608, 17641, 17675, 17709, 17742, 17776, 17810, 17844, 17877,
+    17911, 17945, 17979, 18013, 18046, 18080, 18114, 18148, 18182, 18215,
+    18249, 18283, 18317, 18351, 18385, 18418, 18452, 18486, 18520, 18554,
+    18588, 18622, 18656, 18689, 18723, 18757, 18791, 18825, 18859, 18893,
+    18927, 18961, 18994, 19028, 19062, 19096, 19130, 19164, 19198, 19232,
+    19266, 19300, 19333, 19367, 19401, 19435, 19469, 19503, 19537, 19571,
+    19605, 19639, 19672, 19706, 19740, 19774, 19808, 19842, 19876, 19910,
+    19943, 19977, 20011, 20045, 20079, 20113, 20146, 20180, 20214, 20248,
+    20282, 20316, 20349, 20383, 20417, 20451, 20484, 20518, 20552, 20586,
+    20619, 20653, 20687, 20721, 20754, 20788, 20822, 20855, 20889, 20923,
+    20956, 20990, 21024, 21057, 21091, 21124, 21158, 21192, 21225, 21259,
+    21292, 21326, 21359, 21393, 21426, 21460, 21493, 21527, 21560, 21594,
+    21627, 21660, 21694, 21727, 21761, 21794, 21827, 21861, 21894, 21927,
+    21960, 21994, 22027, 22060, 22093, 22127, 22160, 22193, 22226, 22259,
+    22292, 22325, 22358, 22391, 22424, 22457, 22490, 22523, 22556, 22589,
+    22622, 22655, 22688, 22721, 22754, 22787, 22819, 22852, 22885, 22918,
+    22950, 22983, 23016, 23048, 23081, 23113, 23146, 23179, 23211, 23244,
+    23276, 23309, 23341, 23373, 23406, 23438, 23470, 23503, 23535, 23567,
+    23600, 23632, 23664, 23696, 23728, 23760, 23792, 23824, 23856, 23888,
+    23920, 23952, 23984, 24016, 24048, 24080, 24112, 24143, 24175, 24207,
+    24239, 24270, 24302, 24333, 24365, 24396, 24428, 24459, 24491, 24522,
+    24554, 24585, 24616, 24648, 24679, 24710, 24741, 24772, 24803, 24835,
+    24866, 24897, 24928, 24958, 24989, 25020, 25051, 25082, 25113, 25143,
+    25174, 25205, 25235, 25266, 25297, 25327, 25358, 25388, 25418, 25449,
+    25479, 25509, 25540, 25570, 25600, 25630, 25660, 25690, 25720, 25750,
+    25780, 25810, 25840, 25870, 25900, 25929, 25959, 25989, 26018, 26048,
+    26077, 26107, 26136, 26166, 26195, 26224, 26254, 26283, 26312, 26341,
+    26370, 26399, 26428, 26457, 26486, 26515, 26544, 26573, 26602, 26630,
+    26659, 26688, 26716, 26745, 26773, 26802, 26830, 26858, 26887, 26915,
+    26943, 26971, 26999, 27027, 27055, 27083, 27111, 27139, 27167, 27195,
+    27222, 27250, 27278, 27305, 27333, 27360, 27387, 27415, 27442, 27469,
+    27497, 27524, 27551, 27578, 27605, 27632, 27659, 27686, 27712, 27739,
+    27766, 27792, 27819, 27845, 27872, 27898, 27925, 27951, 27977, 28003,
+    28030, 28056, 28082, 28108, 28134, 28159, 28185, 28211, 28237, 28262,
+    28288, 28313, 28339, 28364, 28390, 28415, 28440, 28465, 28491, 28516,
+    28541, 28566, 28590, 28615, 28640, 28665, 28689, 28714, 28739, 28763,
+    28787, 28812, 28836, 28860, 28884, 28909, 28933, 28957, 28980, 29004,
+    29028, 29052, 29076, 29099, 29123, 29146, 29170, 29193, 29216, 29240,
+    29263, 29286, 29309, 29332, 29355, 29378, 29400, 29423, 29446, 29468,
+    29491, 29513, 29536, 29558, 29580, 29603, 29625, 29647, 29669, 29691,
+    29713, 29734, 29756, 29778, 29799, 29821, 29842, 29864, 29885, 29906,
+    29928, 29949, 29970, 29991, 30012, 30032, 30053, 30074, 30095, 30115,
+    30136, 30156, 30176, 30197, 30217, 30237, 30257, 30277, 30297, 30317,
+    30337, 30356, 30376, 30396, 30415, 30435, 30454, 30473, 30493, 30512,
+    30531, 30550, 30569, 30588, 30606, 30625, 30644, 30662, 30681, 30699,
+    30717, 30736, 30754, 30772, 30790, 30808, 30826, 30844, 30861, 30879,
+    30897, 30914, 30932, 30949, 30966, 30984, 31001, 31018, 31035, 31052,
+    31068, 31085, 31102, 31119, 31135, 31151, 31168, 31184, 31200, 31216,
+    31233, 31249, 31264, 31280, 31296, 31312, 31327, 31343, 31358, 31374,
+    31389, 31404, 31419, 31434, 31449, 31464, 31479, 31494, 31508, 31523,
+    31537, 31552, 31566, 31580, 31594, 31608, 31622, 31636, 31650, 31664,
+    31678, 31691, 31705, 31718, 31731, 31745, 31758, 31771, 31784, 31797,
+    31810, 31823, 31835, 31848, 31860, 31873, 31885, 31898, 31910, 31922,
+    31934, 31946, 31958, 31969, 31981, 31993, 32004, 32016, 32027, 32038,
+    32050, 32061, 32072, 32083, 32094, 32104, 32115, 32126, 32136, 32147,
+    32157, 32167, 32177, 32187, 32198, 32207, 32217, 32227, 32237, 32246,
+    32256, 32265, 32275, 32284, 32293, 32302, 32311, 32320, 32329, 32337,
+    32346, 32355, 32363, 32372, 32380, 32388, 32396, 32404, 32412, 32420,
+    32428, 32436, 32443, 32451, 32458, 32465, 32473, 32480, 32487, 32494,
+    32501, 32508, 32514, 32521, 32528, 32534, 32541, 32547, 32553, 32559,
+    32565, 32571, 32577, 32583, 32588, 32594, 32600, 32605, 32610, 32616,
+    32621, 32626, 32631, 32636, 32640, 32645, 32650, 32654, 32659, 32663,
+    32667, 32672, 32676, 32680, 32684, 32687, 32691, 32695, 32698, 32702,
+    32705, 32709, 32712, 32715, 32718, 32721, 32724, 32726, 32729, 32732,
+    32734, 32737, 32739, 32741, 32743, 32745, 32747, 32749, 32751, 32753,
+    32754, 32756, 32757, 32759, 32760, 32761, 32762, 32763, 32764, 32765,
+    32765, 32766, 32767, 32767, 32767, 32767, 32767, 32767,
+};
+static const q15_t flat_top_half[SAMPLE_SIZE / 2] = {
+    -14, -14, -14, -14, -14, -14, -14, -14, -14, -14,
+    -14, -14, -14, -14, -14, -14, -14, -14, -15, -15,
+    -15, -15, -15, -15, -15, -15, -15, -15, -15, -16,
+    -16, -16, -16, -16, -16, -16, -17, -17, -17, -17,
+    -17, -17, -17, -18, -18, -18, -18, -18, -19, -19,
+    -19, -19, -19, -20, -20, -20, -20, -21, -21, -21,
+    -21, -22, -22, -22, -22, -23, -23, -23, -23, -24,
+    -24, -24, -25, -25, -25, -25, -26, -26, -26, -27,
+    -27, -27, -28, -28, -28, -29, -29, -30, -30, -30,
+    -31, -31, -31, -32, -32, -33, -33, -33, -34, -34,
+    -35, -35, -36, -36, -37, -37, -37, -38, -38, -39,
+    -39, -40, -40, -41, -41, -42, -42, -43, -43, -44,
+    -44, -45, -45, -46, -46, -47, -48, -48, -49, -49,
+    -50, -50, -51, -52, -52, -53, -53, -54, -55, -55,
+    -56, -57, -57, -58, -59, -59, -60, -61, -61, -62,
+    -63, -63, -64, -65, -65, -66, -67, -68, -68, -69,
+    -70, -71, -71, -72, -73, -74, -75, -75, -76, -77,
+    -78, -79, -79, -80, -81, -82, -83, -84, -84, -85,
+    -86, -87, -88, -89, -90, -91, -92, -93, -93, -94,
+    -95, -96, -97, -98, -99, -100, -101, -102, -103, -104,
+    -105, -106, -107, -108, -109, -110, -111, -112, -114, -115,
+    -116, -117, -118, -119, -120, -121, -122, -123, -125, -126,
+    -127, -128, -129, -130, -132, -133, -134, -135, -136, -138,
+    -139, -140, -141, -143, -144, -145, -147, -148, -149, -150,
+    -152, -153, -154, -156, -157, -158, -160, -161, -163, -164,
+    -165, -167, -168, -170, -171, -173, -174, -175, -177, -178,
+    -180, -181, -183, -184, -186, -187, -189, -191, -192, -194,
+    -195, -197, -198, -200, -202, -203, -205, -206, -208, -210,
+    -211, -213, -215, -217, -218, -220, -222, -223, -225, -227,
+    -229, -230, -232, -234, -236, -238, -239, -241, -243, -245,
+    -247, -249, -251, -252, -254, -256, -258, -260, -262, -264,
+    -266, -268, -270, -272, -274, -276, -278, -280, -282, -284,
+    -286, -288, -290, -292, -294, -296, -299, -301, -303, -305,
+    -307, -309, -311, -314, -316, -318, -320, -322, -325, -327,
+    -329, -332, -334, -336, -338, -341, -343, -345, -348, -350,
+    -352, -355, -357, -360, -362, -364, -367, -369, -372, -374,
+    -377, -379, -382, -384, -387, -389, -392, -394, -397, -400,
+    -402, -405, -407, -410, -413, -415, -418, -421, -423, -426,
+    -429, -431, -434, -437, -440, -442, -445, -448, -451, -454,
+    -456, -459, -462, -465, -468, -471, -473, -476, -479, -482,
+    -485, -488, -491, -494, -497, -500, -503, -506, -509, -512,
+    -515, -518, -521, -524, -527, -530, -534, -537, -540, -543,
+    -546, -549, -552, -556, -559, -562, -565, -569, -572, -575,
+    -578, -582, -585, -588, -591, -595, -598, -602, -605, -608,
+    -612, -615, -618, -622, -625, -629, -632, -636, -639, -643,
+    -646, -650, -653, -657, -660, -664, -667, -671, -674, -678,
+    -682, -685, -689, -693, -696, -700, -704, -707, -711, -715,
+    -718, -722, -726, -730, -733, -737, -741, -745, -749, -752,
+    -756, -760, -764, -768, -772, -775, -779, -783, -787, -791,
+    -795, -799, -803, -807, -811, -815, -819, -823, -827, -831,
+    -835, -839, -843, -847, -851, -855, -859, -864, -868, -872,
+    -876, -880, -884, -888, -893, -897, -901, -905, -909, -914,
+    -918, -922, -926, -931, -935, -939, -943, -948, -952, -956,
+    -961, -965, -969, -974, -978, -982, -987, -991, -996, -1000,
+    -1004, -1009, -1013, -1018, -1022, -1027, -1031, -1035, -1040, -1044,
+    -1049, -1053, -1058, -1062, -1067, -1071, -1076, -1081, -1085, -1090,
+    -1094, -1099, -1103, -1108, -1113, -1117, -1122, -1126, -1131, -1136,
+    -1140, -1145, -1150, -1154, -1159, -1164, -1168, -1173, -1178, -1182,
+    -1187, -1192, -1196, -1201, -1206, -1211, -1215, -1220, -1225, -1230,
+    -1234, -1239, -1244, -1249, -1253, -1258, -1263, -1268, -1272, -1277,
+    -1282, -1287, -1292, -1297, -1301, -1306, -1311, -1316, -1321, -1325,
+    -1330, -1335, -1340, -1345, -1350, -1355, -1359, -1364, -1369, -1374,
+    -1379, -1384, -1389, -1393, -1398, -1403, -1408, -1413, -1418, -1423,
+    -1428, -1432, -1437, -1442, -1447, -1452, -1457, -1462, -1467, -1472,
+    -1476, -1481, -1486, -1491, -1496, -1501, -1506, -1511, -1516, -1520,
+    -1525, -1530, -1535, -1540, -1545, -1550, -1555, -1560, -1564, -1569,
+    -1574, -1579, -1584, -1589, -1594, -1599, -1603, -1608, -1613, -1618,
+    -1623, -1628, -1632, -1637, -1642, -1647, -1652, -1657, -1661, -1666,
+    -1671, -1676, -1681, -1685, -1690, -1695, -1700, -1704, -1709, -1714,
+    -1719, -1723, -1728, -1733, -1738, -1742, -1747, -1752, -1756, -1761,
+    -1766, -1771, -1775, -1780, -1784, -1789, -1794, -1798, -1803, -1808,
+    -1812, -1817, -1821, -1826, -1830, -1835, -1840, -1844, -1849, -1853,
+    -1858, -1862, -1867, -1871, -1875, -1880, -1884, -1889, -1893, -1898,
+    -1902, -1906, -1911, -1915, -1919, -1924, -1928, -1932, -1937, -1941,
+    -1945, -1949, -1953, -1958, -1962, -1966, -1970, -1974, -1978, -1983,
+    -1987, -1991, -1995, -1999, -2003, -2007, -2011, -2015, -2019, -2023,
+    -2027, -2031, -2035, -2038, -2042, -2046, -2050, -2054, -2058, -2061,
+    -2065, -2069, -2072, -2076, -2080, -2083, -2087, -2091, -2094, -2098,
+    -2101, -2105, -2108, -2112, -2115, -2119, -2122, -2125, -2129, -2132,
+    -2135, -2139, -2142, -2145, -2148, -2152, -2155, -2158, -2161, -2164,
+    -2167, -2170, -2173, -2176, -2179, -2182, -2185, -2188, -2191, -2194,
+    -2196, -2199, -2202, -2205, -2207, -2210, -2213, -2215, -2218, -2220,
+    -2223, -2225, -2228, -2230, -2233, -2235, -2237, -2240, -2242, -2244,
+    -2246, -2249, -2251, -2253, -2255, -2257, -2259, -2261, -2263, -2265,
+    -2267, -2268, -2270, -2272, -2274, -2275, -2277, -2279, -2280, -2282,
+    -2283, -2285, -2286, -2288, -2289, -2290, -2292, -2293, -2294, -2295,
+    -2297, -2298, -2299, -2300, -2301, -2302, -2303, -2304, -2304, -2305,
+    -2306, -2307, -2307, -2308, -2308, -2309, -2310, -2310, -2310, -2311,
+    -2311, -2311, -2312, -2312, -2312, -2312, -2312, -2312, -2312, -2312,
+    -2312, -2312, -2312, -2311, -2311, -2311, -2310, -2310, -2309, -2309,
+    -2308, -2308, -2307, -2306, -2305, -2305, -2304, -2303, -2302, -2301,
+    -2300, -2299, -2297, -2296, -2295, -2294, -2292, -2291, -2289, -2288,
+    -2286, -2284, -2283, -2281, -2279, -2277, -2275, -2273, -2271, -2269,
+    -2267, -2265, -2263, -2261, -2258, -2256, -2253, -2251, -2248, -2246,
+    -2243, -2240, -2237, -2234, -2231, -2229, -2225, -2222, -2219, -2216,
+    -2213, -2209, -2206, -2202, -2199, -2195, -2192, -2188, -2184, -2180,
+    -2177, -2173, -2169, -2164, -2160, -2156, -2152, -2148, -2143, -2139,
+    -2134, -2130, -2125, -2120, -2115, -2111, -2106, -2101, -2096, -2090,
+    -2085, -2080, -2075, -2069, -2064, -2058, -2053, -2047, -2041, -2036,
+    -2030, -2024, -2018, -2012, -2005, -1999, -1993, -1987, -1980, -1974,
+    -1967, -1960, -1954, -1947, -1940, -1933, -1926, -1919, -1912, -1905,
+    -1897, -1890, -1883, -1875, -1867, -1860, -1852, -1844, -1836, -1828,
+    -1820, -1812, -1804, -1796, -1787, -1779, -1770, -1762, -1753, -1744,
+    -1736, -1727, -1718, -1709, -1700, -1690, -1681, -1672, -1662, -1653,
+    -1643, -1633, -1624, -1614, -1604, -1594, -1584, -1573, -1563, -1553,
+    -1542, -1532, -1521, -1511, -1500, -1489, -1478, -1467, -1456, -1445,
+    -1434, -1422, -1411, -1399, -1388, -1376, -1364, -1352, -1340, -1328,
+    -1316, -1304, -1292, -1279, -1267, -1254, -1242, -1229, -1216, -1203,
+    -1190, -1177, -1164, -1151, -1137, -1124, -1110, -1097, -1083, -1069,
+    -1055, -1042, -1027, -1013, -999, -985, -970, -956, -941, -926,
+    -912, -897, -882, -867, -852, -836, -821, -806, -790, -774,
+    -759, -743, -727, -711, -695, -679, -662, -646, -630, -613,
+    -596, -580, -563, -546, -529, -512, -494, -477, -460, -442,
+    -425, -407, -389, -371, -353, -335, -317, -299, -280, -262,
+    -243, -225, -206, -187, -168, -149, -130, -110, -91, -72,
+    -52, -32, -13, 7, 27, 47, 67, 88, 108, 128,
+    149, 170, 190, 211, 232, 253, 274, 296, 317, 338,
+    360, 382, 403, 425, 447, 469, 491, 514, 536, 559,
+    581, 604, 626, 649, 672, 695, 719, 742, 765, 789,
+    812, 836, 860, 884, 908, 932, 956, 980, 1005, 1029,
+    1054, 1078, 1103, 1128, 1153, 1178, 1204, 1229, 1254, 1280,
+    1305, 1331, 1357, 1383, 1409, 1435, 1461, 1488, 1514, 1541,
+    1567, 1594, 1621, 1648, 1675, 1702, 1730, 1757, 1785, 1812,
+    1840, 1868, 1896, 1924, 1952, 1980, 2008, 2037, 2065, 2094,
+    2123, 2151, 2180, 2209, 2239, 2268, 2297, 2327, 2356, 2386,
+    2416, 2446, 2475, 2506, 2536, 2566, 2596, 2627, 2658, 2688,
+    2719, 2750, 2781, 2812, 2843, 2875, 2906, 2938, 2969, 3001,
+    3033, 3065, 3097, 3129, 3161, 3193, 3226, 3258, 3291, 3324,
+    3357, 3390, 3423, 3456, 3489, 3522, 3556, 3589, 3623, 3657,
+    3691, 3725, 3759, 3793, 3827, 3861, 3896, 3931, 3965, 4000,
+    4035, 4070, 4105, 4140, 4175, 4211, 4246, 4282, 4317, 4353,
+    4389, 4425, 4461, 4497, 4533, 4570, 4606, 4643, 4679, 4716,
+    4753, 4790, 4827, 4864, 4901, 4939, 4976, 5013, 5051, 5089,
+    5127, 5164, 5202, 5241, 5279, 5317, 5355, 5394, 5432, 5471,
+    5510, 5549, 5588, 5627, 5666, 5705, 5744, 5784, 5823, 5863,
+    5902, 5942, 5982, 6022, 6062, 6102, 6143, 6183, 6223, 6264,
+    6304, 6345, 6386, 6427, 6468, 6509, 6550, 6591, 6632, 6674,
+    6715, 6757, 6798, 6840, 6882, 6924, 6966, 7008, 7050, 7092,
+    7135, 7177, 7220, 7262, 7305, 7348, 7391, 7434, 7477, 7520,
+    7563, 7606, 7650, 7693, 7737, 7780, 7824, 7868, 7911, 7955,
+    7999, 8043, 8088, 8132, 8176, 8221, 8265, 8310, 8354, 8399,
+    8444, 8489, 8534, 8579, 8624, 8669, 8714, 8759, 8805, 8850,
+    8896, 8941, 8987, 9033, 9079, 9125, 9171, 9217, 9263, 9309,
+    9355, 9402, 9448, 9495, 9541, 9588, 9634, 9681, 9728, 9775,
+    9822, 9869, 9916, 9963, 10010, 10058, 10105, 10153, 10200, 10248,
+    10295, 10343, 10391, 10438, 10486, 10534, 10582, 10630, 10678, 10727,
+    10775, 10823, 10871, 10920, 10968, 11017, 11065, 11114, 11163, 11212,
+    11260, 11309, 11358, 11407, 11456, 11505, 11554, 11604, 11653, 11702,
+    11752, 11801, 11850, 11900, 11950, 11999, 12049, 12098, 12148, 12198,
+    12248, 12298, 12348, 12398, 12448, 12498, 12548, 12598, 12648, 12699,
+    12749, 12799, 12850, 12900, 12951, 13001, 13052, 13102, 13153, 13204,
+    13255, 13305, 13356, 13407, 13458, 13509, 13560, 13611, 13662, 13713,
+    13764, 13815, 13866, 13917, 13969, 14020, 14071, 14122, 14174, 14225,
+    14277, 14328, 14379, 14431, 14483, 14534, 14586, 14637, 14689, 14741,
+    14792, 14844, 14896, 14947, 14999, 15051, 15103, 15155, 15207, 15259,
+    15310, 15362, 15414, 15466, 15518, 15570, 15622, 15674, 15726, 15778,
+    15831, 15883, 15935, 15987, 16039, 16091, 16143, 16196, 16248, 16300,
+    16352, 16404, 16457, 16509, 16561, 16613, 16666, 16718, 16770, 16822,
+    16875, 16927, 16979, 17031, 17084, 17136, 17188, 17241, 17293, 17345,
+    17398, 17450, 17502, 17554, 17607, 17659, 17711, 17764, 17816, 17868,
+    17920, 17973, 18025, 18077, 18129, 18182, 18234, 18286, 18338, 18390,
+    18442, 18495, 18547, 18599, 18651, 18703, 18755, 18807, 18859, 18911,
+    18963, 19015, 19067, 19119, 19171, 19223, 19275, 19327, 19379, 19431,
+    19483, 19534, 19586, 19638, 19690, 19741, 19793, 19845, 19896, 19948,
+    19999, 20051, 20103, 20154, 20205, 20257, 20308, 20360, 20411, 20462,
+    20513, 20565, 20616, 20667, 20718, 20769, 20820, 20871, 20922, 20973,
+    21024, 21075, 21126, 21176, 21227, 21278, 21328, 21379, 21430, 21480,
+    21531, 21581, 21631, 21682, 21732, 21782, 21832, 21882, 21932, 21983,
+    22032, 22082, 22132, 22182, 22232, 22282, 22331, 22381, 22430, 22480,
+    22529, 22579, 22628, 22677, 22726, 22776, 22825, 22874, 22923, 22972,
+    23020, 23069, 23118, 23167, 23215, 23264, 23312, 23360, 23409, 23457,
+    23505, 23553, 23601, 23649, 23697, 23745, 23793, 23841, 23888, 23936,
+    23983, 24031, 24078, 24125, 24172, 24219, 24266, 24313, 24360, 24407,
+    24454, 24500, 24547, 24593, 24640, 24686, 24732, 24778, 24824, 24870,
+    24916, 24962, 25008, 25053, 25099, 25144, 25190, 25235, 25280, 25325,
+    25370, 25415, 25460, 25505, 25549, 25594, 25638, 25683, 25727, 25771,
+    25815, 25859, 25903, 25947, 25991, 26034, 26078, 26121, 26165, 26208,
+    26251, 26294, 26337, 26379, 26422, 26465, 26507, 26550, 26592, 26634,
+    26676, 26718, 26760, 26802, 26843, 26885, 26926, 26967, 27009, 27050,
+    27091, 27132, 27172, 27213, 27254, 27294, 27334, 27374, 27414, 27454,
+    27494, 27534, 27574, 27613, 27652, 27692, 27731, 27770, 27809, 27847,
+    27886, 27925, 27963, 28001, 28039, 28077, 28115, 28153, 28191, 28228,
+    28266, 28303, 28340, 28377, 28414, 28451, 28488, 28524, 28560, 28597,
+    28633, 28669, 28705, 28740, 28776, 28812, 28847, 28882, 28917, 28952,
+    28987, 29022, 29056, 29090, 29125, 29159, 29193, 29227, 29260, 29294,
+    29327, 29361, 29394, 29427, 29460, 29492, 29525, 29557, 29590, 29622,
+    29654, 29686, 29717, 29749, 29780, 29812, 29843, 29874, 29905, 29935,
+    29966, 29996, 30027, 30057, 30087, 30117, 30146, 30176, 30205, 30234,
+    30263, 30292, 30321, 30350, 30378, 30406, 30435, 30463, 30490, 30518,
+    30546, 30573, 30600, 30627, 30654, 30681, 30708, 30734, 30760, 30786,
+    30812, 30838, 30864, 30889, 30915, 30940, 30965, 30990, 31014, 31039,
+    31063, 31087, 31111, 31135, 31159, 31183, 31206, 31229, 31252, 31275,
+    31298, 31320, 31343, 31365, 31387, 31409, 31431, 31452, 31474, 31495,
+    31516, 31537, 31558, 31578, 31599, 31619, 31639, 31659, 31679, 31698,
+    31718, 31737, 31756, 31775, 31793, 31812, 31830, 31848, 31866, 31884,
+    31902, 31919, 31937, 31954, 31971, 31988, 32004, 32021, 32037, 32053,
+    32069, 32085, 32100, 32116, 32131, 32146, 32161, 32176, 32190, 32205,
+    32219, 32233, 32247, 32260, 32274, 32287, 32300, 32313, 32326, 32338,
+    32351, 32363, 32375, 32387, 32398, 32410, 32421, 32432, 32443, 32454,
+    32465, 32475, 32485, 32495, 32505, 32515, 32525, 32534, 32543, 32552,
+    32561, 32569, 32578, 32586, 32594, 32602, 32610, 32617, 32625, 32632,
+    32639, 32646, 32652, 32659, 32665, 32671, 32677, 32682, 32688, 32693,
+    32698, 32703, 32708, 32713, 32717, 32721, 32725, 32729, 32733, 32737,
+    32740, 32743, 32746, 32749, 32751, 32754, 32756, 32758, 32760, 32761,
+    32763, 32764, 32765, 32766, 32767, 32767, 32767, 32767,
+};
+const WindowInfo gWindows[WINDOW_COUNT] = {
+    [WINDOW_HANN] = {hann_half, 16388, 6143}, // CG=0.5001, ENBW=1.500
+    [WINDOW_BLACKMAN_HARRIS] = {blackman_harris_half, 11758, 8208}, // CG=0.3588, ENBW=2.004
+    [WINDOW_FLAT_TOP] = {flat_top_half, 7066, 15439}, // CG=0.2156, ENBW=3.769
+    [WINDOW_RECTANGULAR] = {NULL, 32768, 4096}, // CG=1.0000, ENBW=1.000
+};
+#elif SAMPLE_SIZE == 2048
+static const q15_t hann_half[SAMPLE_SIZE / 2] = {
+    0, 0, 1, 1, 2, 3, 4, 5, 6, 8,
+    9, 11, 13, 15, 17, 20, 22, 25, 28, 31,
+    34, 37, 41, 44, 48, 52, 56, 60, 65, 69,
+    74, 79, 84, 89, 94, 100, 105, 111, 117, 123,
+    129, 136, 142, 149, 156, 163, 170, 177, 185, 192,
+    200, 208, 216, 224, 232, 241, 250, 258, 267, 277,
+    286, 295, 305, 315, 324, 334, 345, 355, 365, 376,
+    387, 398, 409, 420, 431, 443, 455, 466, 478, 491,
+    503, 515, 528, 541, 553, 566, 580, 593, 606, 620,
+    634, 648, 662, 676, 690, 705, 719, 734, 749, 764,
+    780, 795, 810, 826, 842, 858, 874, 890, 907, 923,
+    940, 957, 974, 991, 1008, 1026, 1043, 1061, 1079, 1097,
+    1115, 1133, 1152, 1170, 1189, 1208, 1227, 1246, 1265, 1285,
+    1304, 1324, 1344, 1364, 1384, 1404, 1425, 1445, 1466, 1487,
+    1508, 1529, 1550, 1572, 1593, 1615, 1637, 1659, 1681, 1703,
+    1725, 1748, 1770, 1793, 1816, 1839, 1862, 1886, 1909, 1933,
+    1956, 1980, 2004, 2029, 2053, 2077, 2102, 2126, 2151, 2176,
+    2201, 2227, 2252, 2277, 2303, 2329, 2355, 2381, 2407, 2433,
+    2459, 2486, 2513, 2540, 2566, 2593, 2621, 2648, 2675, 2703,
+    2731, 2759, 2787, 2815, 2843, 2871, 2900, 2928, 2957, 2986,
+    3015, 3044, 3073, 3103, 3132, 3162, 3191, 3221, 3251, 3281,
+    3312, 3342, 3372, 3403, 3434, 3464, 3495, 3527, 3558, 3589,
+    3620, 3652, 3684, 3716, 3747, 3779, 3812, 3844, 3876, 3909,
+    3941, 3974, 4007, 4040, 4073, 4106, 4140, 4173, 4207, 4240,
+    4274, 4308, 4342, 4376, 4410, 4445, 4479, 4514, 4548, 4583,
+    4618, 4653, 4688, 4724, 4759, 4794, 4830, 4866, 4901, 4937,
+    4973, 5009, 5046, 5082, 5118, 5155, 5191, 5228, 5265, 5302,
+    5339, 5376, 5413, 5451, 5488, 5526, 5564, 5601, 5639, 5677,
+    5715, 5753, 5792, 5830, 5869, 5907, 5946, 5985, 6024, 6062,
+    6102, 6141, 6180, 6219, 6259, 6298, 6338, 6378, 6418, 6457,
+    6497, 6538, 6578, 6618, 6658, 6699, 6740, 6780, 6821, 6862,
+    6903, 6944, 6985, 7026, 7067, 7109, 7150, 7192, 7233, 7275,
+    7317, 7359, 7401, 7443, 7485, 7527, 7569, 7612, 7654, 7697,
+    7739, 7782, 7825, 7868, 7911, 7954, 7997, 8040, 8083, 8127,
+    8170, 8214, 8257, 8301, 8345, 8389, 8432, 8476, 8520, 8565,
+    8609, 8653, 8697, 8742, 8786, 8831, 8875, 8920, 8965, 9010,
+    9055, 9100, 9145, 9190, 9235, 9280, 9325, 9371, 9416, 9462,
+    9507, 9553, 9599, 9644, 9690, 9736, 9782, 9828, 9874, 9920,
+    9966, 10013, 10059, 10105, 10152, 10198, 10245, 10292, 10338, 10385,
+    10432, 10479, 10525, 10572, 10619, 10666, 10714, 10761, 10808, 10855,
+    10902, 10950, 10997, 11045, 11092, 11140, 11187, 11235, 11283, 11331,
+    11378, 11426, 11474, 11522, 11570, 11618, 11666, 11714, 11763, 11811,
+    11859, 11907, 11956, 12004, 12053, 12101, 12150, 12198, 12247, 12295,
+    12344, 12393, 12441, 12490, 12539, 12588, 12637, 12686, 12735, 12784,
+    12833, 12882, 12931, 12980, 13029, 13078, 13128, 13177, 13226, 13275,
+    13325, 13374, 13424, 13473, 13522, 13572, 13621, 13671, 13721, 13770,
+    13820, 13869, 13919, 13969, 14018, 14068, 14118, 14168, 14217, 14267,
+    14317, 14367, 14417, 14467, 14517, 14567, 14616, 14666, 14716, 14766,
+    14816, 14866, 14916, 14966, 15017, 15067, 15117, 15167, 15217, 15267,
+    15317, 15367, 15417, 15468, 15518, 15568, 15618, 15668, 15718, 15769,
+    15819, 15869, 15919, 15970, 16020, 16070, 16120, 16170, 16221, 16271,
+    16321, 16371, 16422, 16472, 16522, 16572, 16623, 16673, 16723, 16773,
+    16824, 16874, 16924, 16974, 17024, 17075, 17125, 17175, 17225, 17275,
+    17325, 17376, 17426, 17476, 17526, 17576, 17626, 17676, 17726, 17777,
+    17827, 17877, 17927, 17977, 18027, 18077, 18127, 18177, 18226, 18276,
+    18326, 18376, 18426, 18476, 18526, 18575, 18625, 18675, 18725, 18774,
+    18824, 18874, 18923, 18973, 19023, 19072, 19122, 19171, 19221, 19270,
+    19320, 19369, 19419, 19468, 19517, 19566, 19616, 19665, 19714, 19763,
+    19813, 19862, 19911, 19960, 20009, 20058, 20107, 20156, 20204, 20253,
+    20302, 20351, 20400, 20448, 20497, 20546, 20594, 20643, 20691, 20740,
+    20788, 20836, 20885, 20933, 20981, 21029, 21078, 21126, 21174, 21222,
+    21270, 21318, 21366, 21413, 21461, 21509, 21557, 21604, 21652, 21699,
+    21747, 21794, 21842, 21889, 21936, 21984, 22031, 22078, 22125, 22172,
+    22219, 22266, 22313, 22360, 22406, 22453, 22500, 22546, 22593, 22639,
+    22686, 22732, 22778, 22825, 22871, 22917, 22963, 23009, 23055, 23101,
+    23147, 23192, 23238, 23284, 23329, 23375, 23420, 23465, 23511, 23556,
+    23601, 23646, 23691, 23736, 23781, 23826, 23870, 23915, 23960, 24004,
+    24048, 24093, 24137, 24181, 24225, 24270, 24314, 24357, 24401, 24445,
+    24489, 24532, 24576, 24619, 24663, 24706, 24749, 24793, 24836, 24879,
+    24922, 24964, 25007, 25050, 25092, 25135, 25177, 25220, 25262, 25304,
+    25346, 25388, 25430, 25472, 25514, 25556, 25597, 25639, 25680, 25721,
+    25763, 25804, 25845, 25886, 25927, 25967, 26008, 26049, 26089, 26130,
+    26170, 26210, 26250, 26291, 26331, 26370, 26410, 26450, 26489, 26529,
+    26568, 26608, 26647, 26686, 26725, 26764, 26803, 26841, 26880, 26919,
+    26957, 26995, 27034, 27072, 27110, 27148, 27186, 27223, 27261, 27298,
+    27336, 27373, 27410, 27447, 27484, 27521, 27558, 27595, 27631, 27668,
+    27704, 27741, 27777, 27813, 27849, 27885, 27920, 27956, 27991, 28027,
+    28062, 28097, 28132, 28167, 28202, 28237, 28272, 28306, 28340, 28375,
+    28409, 28443, 28477, 28511, 28545, 28578, 28612, 28645, 28678, 28711,
+    28744, 28777, 28810, 28843, 28875, 28908, 28940, 28972, 29005, 29037,
+    29068, 29100, 29132, 29163, 29195, 29226, 29257, 29288, 29319, 29350,
+    29380, 29411, 29441, 29472, 29502, 29532, 29562, 29592, 29621, 29651,
+    29680, 29709, 29739, 29768, 29797, 29825, 29854, 29883, 29911, 29939,
+    29967, 29995, 30023, 30051, 30079, 30106, 30134, 30161, 30188, 30215,
+    30242, 30269, 30295, 30322, 30348, 30374, 30400, 30426, 30452, 30478,
+    30503, 30529, 30554, 30579, 30604, 30629, 30654, 30679, 30703, 30727,
+    30752, 30776, 30800, 30823, 30847, 30871, 30894, 30917, 30940, 30963,
+    30986, 31009, 31032, 31054, 31076, 31098, 31120, 31142, 31164, 31186,
+    31207, 31229, 31250, 31271, 31292, 31312, 31333, 31354, 31374, 31394,
+    31414, 31434, 31454, 31474, 31493, 31512, 31532, 31551, 31570, 31588,
+    31607, 31626, 31644, 31662, 31680, 31698, 31716, 31734, 31751, 31768,
+    31786, 31803, 31820, 31836, 31853, 31870, 31886, 31902, 31918, 31934,
+    31950, 31965, 31981, 31996, 32011, 32026, 32041, 32056, 32070, 32085,
+    32099, 32113, 32127, 32141, 32155, 32168, 32182, 32195, 32208, 32221,
+    32234, 32246, 32259, 32271, 32284, 32296, 32308, 32319, 32331, 32342,
+    32354, 32365, 32376, 32387, 32397, 32408, 32418, 32429, 32439, 32449,
+    32458, 32468, 32478, 32487, 32496, 32505, 32514, 32523, 32531, 32540,
+    32548, 32556, 32564, 32572, 32580, 32587, 32595, 32602, 32609, 32616,
+    32622, 32629, 32636, 32642, 32648, 32654, 32660, 32665, 32671, 32676,
+    32682, 32687, 32692, 32696, 32701, 32705, 32710, 32714, 32718, 32722,
+    32725, 32729, 32732, 32736, 32739, 32742, 32744, 32747, 32749, 32752,
+    32754, 32756, 32758, 32760, 32761, 32762, 32764, 32765, 32766, 32766,
+    32767, 32767, 32767, 32767,
+};
+static const q15_t blackman_harris_half[SAMPLE_SIZE / 2] = {
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 3, 3, 3, 3, 3, 3, 3, 4, 4,
+    4, 4, 4, 5, 5, 5, 5, 5, 6, 6,
+    6, 7, 7, 7, 7, 8, 8, 8, 9, 9,
+    10, 10, 10, 11, 11, 12, 12, 13, 13, 13,
+    14, 14, 15, 16, 16, 17, 17, 18, 18, 19,
+    20, 20, 21, 21, 22, 23, 24, 24, 25, 26,
+    26, 27, 28, 29, 30, 30, 31, 32, 33, 34,
+    35, 36, 37, 38, 39, 40, 41, 42, 43, 44,
+    45, 46, 47, 48, 49, 51, 52, 53, 54, 56,
+    57, 58, 59, 61, 62, 64, 65, 66, 68, 69,
+    71, 72, 74, 75, 77, 79, 80, 82, 84, 85,
+    87, 89, 91, 93, 94, 96, 98, 100, 102, 104,
+    106, 108, 110, 112, 114, 117, 119, 121, 123, 126,
+    128, 130, 133, 135, 138, 140, 143, 145, 148, 150,
+    153, 156, 159, 161, 164, 167, 170, 173, 176, 179,
+    182, 185, 188, 191, 194, 198, 201, 204, 208, 211,
+    214, 218, 222, 225, 229, 232, 236, 240, 244, 248,
+    251, 255, 259, 263, 268, 272, 276, 280, 284, 289,
+    293, 298, 302, 307, 311, 316, 321, 325, 330, 335,
+    340, 345, 350, 355, 360, 366, 371, 376, 382, 387,
+    393, 398, 404, 410, 415, 421, 427, 433, 439, 445,
+    451, 457, 464, 470, 476, 483, 489, 496, 503, 510,
+    516, 523, 530, 537, 544, 552, 559, 566, 573, 581,
+    589, 596, 604, 612, 619, 627, 635, 644, 652, 660,
+    668, 677, 685, 694, 702, 711, 720, 729, 738, 747,
+    756, 765, 775, 784, 794, 803, 813, 823, 833, 842,
+    853, 863, 873, 883, 894, 904, 915, 925, 936, 947,
+    958, 969, 980, 992, 1003, 1015, 1026, 1038, 1050, 1061,
+    1073, 1085, 1098, 1110, 1122, 1135, 1147, 1160, 1173, 1186,
+    1199, 1212, 1225, 1239, 1252, 1266, 1279, 1293, 1307, 1321,
+    1335, 1349, 1364, 1378, 1393, 1408, 1422, 1437, 1452, 1468,
+    1483, 1498, 1514, 1529, 1545, 1561, 1577, 1593, 1610, 1626,
+    1642, 1659, 1676, 1693, 1710, 1727, 1744, 1762, 1779, 1797,
+    1814, 1832, 1850, 1869, 1887, 1905, 1924, 1943, 1961, 1980,
+    1999, 2019, 2038, 2057, 2077, 2097, 2117, 2137, 2157, 2177,
+    2198, 2218, 2239, 2260, 2281, 2302, 2324, 2345, 2367, 2388,
+    2410, 2432, 2454, 2477, 2499, 2522, 2545, 2567, 2591, 2614,
+    2637, 2661, 2684, 2708, 2732, 2756, 2780, 2805, 2829, 2854,
+    2879, 2904, 2929, 2954, 2980, 3006, 3031, 3057, 3083, 3110,
+    3136, 3163, 3189, 3216, 3243, 3271, 3298, 3326, 3353, 3381,
+    3409, 3437, 3466, 3494, 3523, 3552, 3581, 3610, 3639, 3669,
+    3698, 3728, 3758, 3788, 3818, 3849, 3880, 3910, 3941, 3973,
+    4004, 4035, 4067, 4099, 4131, 4163, 4195, 4228, 4260, 4293,
+    4326, 4359, 4393, 4426, 4460, 4494, 4528, 4562, 4596, 4631,
+    4666, 4701, 4736, 4771, 4806, 4842, 4878, 4914, 4950, 4986,
+    5022, 5059, 5096, 5133, 5170, 5207, 5245, 5283, 5320, 5358,
+    5397, 5435, 5474, 5512, 5551, 5590, 5630, 5669, 5709, 5748,
+    5788, 5829, 5869, 5909, 5950, 5991, 6032, 6073, 6114, 6156,
+    6198, 6240, 6282, 6324, 6366, 6409, 6452, 6495, 6538, 6581,
+    6625, 6668, 6712, 6756, 6800, 6845, 6889, 6934, 6979, 7024,
+    7069, 7115, 7160, 7206, 7252, 7298, 7344, 7391, 7437, 7484,
+    7531, 7578, 7626, 7673, 7721, 7769, 7817, 7865, 7913, 7962,
+    8010, 8059, 8108, 8157, 8207, 8256, 8306, 8356, 8406, 8456,
+    8507, 8557, 8608, 8659, 8710, 8761, 8812, 8864, 8916, 8967,
+    9019, 9072, 9124, 9176, 9229, 9282, 9335, 9388, 9441, 9495,
+    9548, 9602, 9656, 9710, 9765, 9819, 9874, 9928, 9983, 10038,
+    10093, 10149, 10204, 10260, 10316, 10372, 10428, 10484, 10540, 10597,
+    10654, 10710, 10767, 10824, 10882, 10939, 10997, 11054, 11112, 11170,
+    11228, 11287, 11345, 11403, 11462, 11521, 11580, 11639, 11698, 11758,
+    11817, 11877, 11936, 11996, 12056, 12116, 12177, 12237, 12298, 12358,
+    12419, 12480, 12541, 12602, 12663, 12725, 12786, 12848, 12910, 12971,
+    13033, 13095, 13158, 13220, 13282, 13345, 13408, 13470, 13533, 13596,
+    13659, 13722, 13786, 13849, 13913, 13976, 14040, 14104, 14167, 14231,
+    14296, 14360, 14424, 14488, 14553, 14617, 14682, 14747, 14811, 14876,
+    14941, 15006, 15071, 15137, 15202, 15267, 15333, 15398, 15464, 15530,
+    15595, 15661, 15727, 15793, 15859, 15925, 15991, 16058, 16124, 16190,
+    16257, 16323, 16390, 16456, 16523, 16590, 16657, 16723, 16790, 16857,
+    16924, 16991, 17058, 17125, 17192, 17260, 17327, 17394, 17461, 17529,
+    17596, 17664, 17731, 17798, 17866, 17933, 18001, 18069, 18136, 18204,
+    18271, 18339, 18407, 18475, 18542, 18610, 18678, 18745, 18813, 18881,
+    18949, 19017, 19084, 19152, 19220, 19288, 19356, 19423, 19491, 19559,
+    19627, 19694, 19762, 19830, 19898, 19965, 20033, 20101, 20168, 20236,
+    20303, 20371, 20439, 20506, 20574, 20641, 20708, 20776, 20843, 20911,
+    20978, 21045, 21112, 21179, 21247, 21314, 21381, 21448, 21515, 21581,
+    21648, 21715, 21782, 21848, 21915, 21981, 22048, 22114, 22181, 22247,
+    22313, 22379, 22445, 22511, 22577, 22643, 22709, 22774, 22840, 22905,
+    22971, 23036, 23101, 23166, 23231, 23296, 23361, 23426, 23491, 23555,
+    23619, 23684, 23748, 23812, 23876, 23940, 24004, 24068, 24131, 24195,
+    24258, 24321, 24384, 24447, 24510, 24573, 24635, 24698, 24760, 24822,
+    24884, 24946, 25008, 25070, 25131, 25193, 25254, 25315, 25376, 25437,
+    25497, 25558, 25618, 25678, 25738, 25798, 25858, 25917, 25977, 26036,
+    26095, 26154, 26213, 26271, 26330, 26388, 26446, 26504, 26561, 26619,
+    26676, 26733, 26790, 26847, 26903, 26960, 27016, 27072, 27128, 27183,
+    27239, 27294, 27349, 27404, 27458, 27513, 27567, 27621, 27674, 27728,
+    27781, 27834, 27887, 27940, 27993, 28045, 28097, 28149, 28200, 28252,
+    28303, 28354, 28404, 28455, 28505, 28555, 28605, 28654, 28704, 28753,
+    28801, 28850, 28898, 28946, 28994, 29042, 29089, 29136, 29183, 29230,
+    29276, 29322, 29368, 29413, 29459, 29504, 29548, 29593, 29637, 29681,
+    29725, 29768, 29811, 29854, 29897, 29939, 29981, 30023, 30065, 30106,
+    30147, 30188, 30228, 30268, 30308, 30348, 30387, 30426, 30465, 30503,
+    30541, 30579, 30617, 30654, 30691, 30728, 30764, 30800, 30836, 30871,
+    30906, 30941, 30976, 31010, 31044, 31078, 31111, 31144, 31177, 31209,
+    31241, 31273, 31305, 31336, 31367, 31397, 31427, 31457, 31487, 31516,
+    31545, 31574, 31602, 31630, 31658, 31685, 31712, 31739, 31765, 31791,
+    31817, 31842, 31867, 31892, 31916, 31940, 31964, 31987, 32010, 32033,
+    32056, 32078, 32099, 32121, 32142, 32162, 32183, 32203, 32222, 32242,
+    32261, 32279, 32298, 32316, 32333, 32351, 32368, 32384, 32400, 32416,
+    32432, 32447, 32462, 32476, 32491, 32504, 32518, 32531, 32544, 32556,
+    32568, 32580, 32591, 32602, 32613, 32623, 32633, 32643, 32652, 32661,
+    32670, 32678, 32686, 32693, 32700, 32707, 32713, 32719, 32725, 32730,
+    32735, 32740, 32744, 32748, 32752, 32755, 32758, 32760, 32763, 32764,
+    32766, 32767, 32767, 32767,
+};
+static const q15_t flat_top_half[SAMPLE_SIZE / 2] = {
+    -14, -14, -14, -14, -14, -14, -14, -14, -14, -15,
+    -15, -15, -15, -15, -16, -16, -16, -16, -17, -17,
+    -17, -18, -18, -18, -19, -19, -20, -20, -21, -21,
+    -22, -22, -23, -23, -24, -24, -25, -25, -26, -27,
+    -27, -28, -29, -30, -30, -31, -32, -33, -33, -34,
+    -35, -36, -37, -38, -39, -40, -41, -42, -43, -44,
+    -45, -46, -47, -48, -49, -50, -52, -53, -54, -55,
+    -57, -58, -59, -61, -62, -63, -65, -66, -68, -69,
+    -71, -72, -74, -75, -77, -79, -80, -82, -84, -85,
+    -87, -89, -91, -92, -94, -96, -98, -100, -102, -104,
+    -106, -108, -110, -112, -115, -117, -119, -121, -123, -126,
+    -128, -130, -133, -135, -138, -140, -143, -145, -148, -150,
+    -153, -156, -158, -161, -164, -167, -170, -172, -175, -178,
+    -181, -184, -187, -190, -194, -197, -200, -203, -206, -210,
+    -213, -216, -220, -223, -227, -230, -234, -237, -241, -245,
+    -248, -252, -256, -260, -264, -268, -272, -276, -280, -284,
+    -288, -292, -296, -300, -305, -309, -313, -318, -322, -327,
+    -331, -336, -341, -345, -350, -355, -359, -364, -369, -374,
+    -379, -384, -389, -394, -399, -405, -410, -415, -420, -426,
+    -431, -437, -442, -448, -453, -459, -465, -470, -476, -482,
+    -488, -494, -500, -506, -512, -518, -524, -530, -536, -543,
+    -549, -555, -562, -568, -575, -581, -588, -594, -601, -608,
+    -615, -621, -628, -635, -642, -649, -656, -663, -671, -678,
+    -685, -692, -699, -707, -714, -722, -729, -737, -744, -752,
+    -760, -767, -775, -783, -791, -799, -806, -814, -822, -830,
+    -839, -847, -855, -863, -871, -880, -888, -896, -905, -913,
+    -921, -930, -939, -947, -956, -964, -973, -982, -991, -999,
+    -1008, -1017, -1026, -1035, -1044, -1053, -1062, -1071, -1080, -1089,
+    -1098, -1107, -1117, -1126, -1135, -1144, -1154, -1163, -1172, -1182,
+    -1191, -1200, -1210, -1219, -1229, -1238, -1248, -1257, -1267, -1277,
+    -1286, -1296, -1305, -1315, -1325, -1334, -1344, -1354, -1364, -1373,
+    -1383, -1393, -1402, -1412, -1422, -1432, -1441, -1451, -1461, -1471,
+    -1481, -1490, -1500, -1510, -1520, -1529, -1539, -1549, -1559, -1569,
+    -1578, -1588, -1598, -1607, -1617, -1627, -1636, -1646, -1656, -1665,
+    -1675, -1685, -1694, -1704, -1713, -1723, -1732, -1742, -1751, -1760,
+    -1770, -1779, -1788, -1798, -1807, -1816, -1825, -1834, -1843, -1852,
+    -1861, -1870, -1879, -1888, -1897, -1906, -1914, -1923, -1931, -1940,
+    -1949, -1957, -1965, -1974, -1982, -1990, -1998, -2006, -2014, -2022,
+    -2030, -2038, -2045, -2053, -2061, -2068, -2075, -2083, -2090, -2097,
+    -2104, -2111, -2118, -2125, -2132, -2138, -2145, -2151, -2157, -2164,
+    -2170, -2176, -2182, -2187, -2193, -2199, -2204, -2210, -2215, -2220,
+    -2225, -2230, -2235, -2239, -2244, -2248, -2252, -2256, -2260, -2264,
+    -2268, -2272, -2275, -2278, -2282, -2285, -2287, -2290, -2293, -2295,
+    -2297, -2300, -2302, -2303, -2305, -2306, -2308, -2309, -2310, -2311,
+    -2311, -2312, -2312, -2312, -2312, -2312, -2311, -2311, -2310, -2309,
+    -2308, -2306, -2305, -2303, -2301, -2299, -2296, -2294, -2291, -2288,
+    -2285, -2281, -2278, -2274, -2270, -2266, -2261, -2256, -2251, -2246,
+    -2241, -2235, -2229, -2223, -2217, -2210, -2203, -2196, -2189, -2181,
+    -2174, -2165, -2157, -2149, -2140, -2131, -2121, -2112, -2102, -2092,
+    -2081, -2071, -2060, -2048, -2037, -2025, -2013, -2001, -1988, -1975,
+    -1962, -1949, -1935, -1921, -1907, -1892, -1877, -1862, -1846, -1830,
+    -1814, -1798, -1781, -1764, -1747, -1729, -1711, -1693, -1674, -1655,
+    -1636, -1616, -1596, -1576, -1555, -1535, -1513, -1492, -1470, -1448,
+    -1425, -1402, -1379, -1355, -1332, -1307, -1283, -1258, -1232, -1207,
+    -1181, -1154, -1128, -1100, -1073, -1045, -1017, -989, -960, -930,
+    -901, -871, -840, -810, -779, -747, -715, -683, -651, -618,
+    -584, -551, -516, -482, -447, -412, -376, -340, -304, -267,
+    -230, -192, -154, -116, -77, -38, 2, 42, 82, 123,
+    164, 205, 247, 290, 332, 375, 419, 463, 507, 552,
+    597, 643, 689, 735, 782, 829, 877, 925, 973, 1022,
+    1071, 1121, 1171, 1221, 1272, 1324, 1375, 1427, 1480, 1533,
+    1586, 1640, 1694, 1749, 1804, 1859, 1915, 1971, 2028, 2085,
+    2143, 2201, 2259, 2318, 2377, 2436, 2496, 2557, 2618, 2679,
+    2740, 2802, 2865, 2928, 2991, 3055, 3119, 3183, 3248, 3314,
+    3379, 3445, 3512, 3579, 3646, 3714, 3782, 3851, 3920, 3989,
+    4059, 4129, 4199, 4270, 4342, 4413, 4485, 4558, 4631, 4704,
+    4778, 4852, 4926, 5001, 5077, 5152, 5228, 5305, 5381, 5458,
+    5536, 5614, 5692, 5771, 5850, 5929, 6009, 6089, 6169, 6250,
+    6331, 6413, 6495, 6577, 6660, 6743, 6826, 6910, 6994, 7078,
+    7163, 7248, 7333, 7419, 7505, 7592, 7678, 7765, 7853, 7940,
+    8028, 8117, 8205, 8294, 8384, 8473, 8563, 8653, 8744, 8835,
+    8926, 9017, 9109, 9201, 9293, 9385, 9478, 9571, 9665, 9758,
+    9852, 9947, 10041, 10136, 10231, 10326, 10421, 10517, 10613, 10709,
+    10806, 10903, 10999, 11097, 11194, 11292, 11390, 11488, 11586, 11684,
+    11783, 11882, 11981, 12080, 12180, 12280, 12380, 12480, 12580, 12680,
+    12781, 12882, 12983, 13084, 13185, 13287, 13388, 13490, 13592, 13694,
+    13796, 13898, 14001, 14103, 14206, 14309, 14412, 14515, 14618, 14721,
+    14825, 14928, 15032, 15135, 15239, 15343, 15447, 15551, 15655, 15759,
+    15863, 15967, 16071, 16176, 16280, 16384, 16489, 16593, 16698, 16802,
+    16907, 17011, 17116, 17220, 17325, 17430, 17534, 17639, 17743, 17848,
+    17952, 18057, 18161, 18265, 18370, 18474, 18578, 18683, 18787, 18891,
+    18995, 19099, 19203, 19306, 19410, 19514, 19617, 19721, 19824, 19927,
+    20030, 20133, 20236, 20339, 20442, 20544, 20646, 20749, 20851, 20952,
+    21054, 21156, 21257, 21358, 21459, 21560, 21661, 21762, 21862, 21962,
+    22062, 22162, 22261, 22360, 22459, 22558, 22657, 22755, 22853, 22951,
+    23049, 23146, 23243, 23340, 23437, 23533, 23629, 23725, 23821, 23916,
+    24011, 24105, 24200, 24294, 24387, 24481, 24574, 24666, 24759, 24851,
+    24943, 25034, 25125, 25216, 25306, 25396, 25486, 25575, 25664, 25752,
+    25840, 25928, 26016, 26103, 26189, 26275, 26361, 26446, 26531, 26616,
+    26700, 26783, 26867, 26949, 27032, 27114, 27195, 27276, 27357, 27437,
+    27517, 27596, 27674, 27753, 27830, 27908, 27984, 28061, 28136, 28212,
+    28286, 28361, 28435, 28508, 28581, 28653, 28724, 28796, 28866, 28936,
+    29006, 29075, 29143, 29211, 29279, 29346, 29412, 29478, 29543, 29607,
+    29671, 29735, 29798, 29860, 29921, 29983, 30043, 30103, 30162, 30221,
+    30279, 30337, 30393, 30450, 30505, 30560, 30615, 30669, 30722, 30774,
+    30826, 30877, 30928, 30978, 31027, 31076, 31124, 31172, 31218, 31264,
+    31310, 31355, 31399, 31442, 31485, 31527, 31569, 31609, 31650, 31689,
+    31728, 31766, 31803, 31840, 31876, 31911, 31946, 31980, 32013, 32045,
+    32077, 32108, 32139, 32169, 32198, 32226, 32254, 32281, 32307, 32332,
+    32357, 32381, 32404, 32427, 32449, 32470, 32491, 32510, 32529, 32548,
+    32565, 32582, 32598, 32614, 32628, 32642, 32655, 32668, 32680, 32691,
+    32701, 32711, 32719, 32727, 32735, 32741, 32747, 32752, 32757, 32761,
+    32763, 32766, 32767, 32767,
+};
+const WindowInfo gWindows[WINDOW_COUNT] = {
+    [WINDOW_HANN] = {hann_half, 16392, 6141}, // CG=0.5002, ENBW=1.499
+    [WINDOW_BLACKMAN_HARRIS] = {blackman_harris_half, 11761, 8206}, // CG=0.3589, ENBW=2.003
+    [WINDOW_FLAT_TOP] = {flat_top_half, 7068, 15435}, // CG=0.2157, ENBW=3.768
+    [WINDOW_RECTANGULAR] = {NULL, 32768, 4096}, // CG=1.0000, ENBW=1.000
+};
+#elif SAMPLE_SIZE == 1024
+static const q15_t hann_half[SAMPLE_SIZE / 2] = {
+    0, 1, 3, 5, 8, 11, 15, 20, 25, 31,
+    37, 44, 52, 60, 69, 79, 89, 100, 111, 123,
+    136, 149, 163, 177, 192, 208, 224, 241, 258, 276,
+    295, 314, 334, 355, 376, 397, 420, 442, 466, 490,
+    515, 540, 566, 592, 619, 647, 675, 704, 734, 764,
+    794, 825, 857, 889, 922, 956, 990, 1025, 1060, 1096,
+    1132, 1169, 1207, 1245, 1283, 1323, 1363, 1403, 1444, 1485,
+    1527, 1570, 1613, 1657, 1701, 1746, 1791, 1837, 1884, 1931,
+    1978, 2027, 2075, 2124, 2174, 2224, 2275, 2327, 2378, 2431,
+    2484, 2537, 2591, 2646, 2700, 2756, 2812, 2868, 2926, 2983,
+    3041, 3100, 3159, 3218, 3278, 3339, 3400, 3461, 3523, 3586,
+    3649, 3712, 3776, 3840, 3905, 3970, 4036, 4102, 4169, 4236,
+    4304, 4372, 4441, 4510, 4579, 4649, 4719, 4790, 4861, 4933,
+    5005, 5077, 5150, 5223, 5297, 5371, 5446, 5521, 5596, 5672,
+    5748, 5825, 5902, 5979, 6057, 6135, 6214, 6293, 6372, 6452,
+    6532, 6612, 6693, 6774, 6856, 6937, 7020, 7102, 7185, 7268,
+    7352, 7436, 7520, 7605, 7690, 7775, 7861, 7947, 8033, 8120,
+    8207, 8294, 8381, 8469, 8557, 8645, 8734, 8823, 8912, 9002,
+    9092, 9182, 9272, 9363, 9454, 9545, 9636, 9728, 9820, 9912,
+    10004, 10097, 10190, 10283, 10376, 10470, 10563, 10657, 10752, 10846,
+    10941, 11035, 11130, 11226, 11321, 11417, 11512, 11608, 11705, 11801,
+    11897, 11994, 12091, 12188, 12285, 12382, 12480, 12578, 12675, 12773,
+    12871, 12969, 13068, 13166, 13265, 13363, 13462, 13561, 13660, 13759,
+    13858, 13957, 14057, 14156, 14256, 14355, 14455, 14555, 14655, 14755,
+    14855, 14955, 15055, 15155, 15255, 15355, 15455, 15556, 15656, 15756,
+    15857, 15957, 16058, 16158, 16258, 16359, 16459, 16560, 16660, 16761,
+    16861, 16961, 17062, 17162, 17262, 17363, 17463, 17563, 17663, 17763,
+    17863, 17963, 18063, 18163, 18263, 18363, 18462, 18562, 18661, 18761,
+    18860, 18959, 19059, 19158, 19257, 19355, 19454, 19553, 19651, 19749,
+    19848, 19946, 20044, 20142, 20239, 20337, 20434, 20531, 20629, 20725,
+    20822, 20919, 21015, 21111, 21208, 21303, 21399, 21495, 21590, 21685,
+    21780, 21875, 21969, 22064, 22158, 22252, 22345, 22439, 22532, 22625,
+    22718, 22810, 22902, 22994, 23086, 23178, 23269, 23360, 23451, 23541,
+    23631, 23721, 23811, 23900, 23989, 24078, 24167, 24255, 24343, 24431,
+    24518, 24605, 24692, 24778, 24864, 24950, 25035, 25121, 25205, 25290,
+    25374, 25458, 25541, 25624, 25707, 25789, 25872, 25953, 26035, 26116,
+    26196, 26276, 26356, 26436, 26515, 26594, 26672, 26750, 26828, 26905,
+    26982, 27058, 27134, 27210, 27285, 27359, 27434, 27508, 27581, 27654,
+    27727, 27799, 27871, 27943, 28014, 28084, 28154, 28224, 28293, 28362,
+    28430, 28498, 28565, 28632, 28699, 28765, 28830, 28895, 28960, 29024,
+    29088, 29151, 29214, 29276, 29338, 29399, 29460, 29520, 29580, 29639,
+    29698, 29756, 29814, 29871, 29928, 29984, 30040, 30095, 30150, 30204,
+    30258, 30311, 30363, 30416, 30467, 30518, 30569, 30619, 30668, 30717,
+    30766, 30813, 30861, 30907, 30954, 30999, 31044, 31089, 31133, 31176,
+    31219, 31262, 31303, 31345, 31385, 31425, 31465, 31504, 31542, 31580,
+    31617, 31654, 31690, 31726, 31761, 31795, 31829, 31862, 31895, 31927,
+    31958, 31989, 32020, 32049, 32078, 32107, 32135, 32162, 32189, 32215,
+    32241, 32266, 32290, 32314, 32337, 32360, 32382, 32403, 32424, 32444,
+    32464, 32482, 32501, 32519, 32536, 32552, 32568, 32584, 32598, 32612,
+    32626, 32639, 32651, 32663, 32674, 32684, 32694, 32703, 32712, 32720,
+    32727, 32734, 32740, 32746, 32751, 32755, 32759, 32762, 32764, 32766,
+    32767, 32767,
+};
+static const q15_t blackman_harris_half[SAMPLE_SIZE / 2] = {
+    2, 2, 2, 2, 2, 3, 3, 3, 3, 4,
+    4, 5, 5, 5, 6, 7, 7, 8, 8, 9,
+    10, 11, 12, 13, 13, 14, 16, 17, 18, 19,
+    20, 21, 23, 24, 26, 27, 29, 30, 32, 34,
+    36, 38, 40, 42, 44, 46, 48, 51, 53, 55,
+    58, 61, 63, 66, 69, 72, 75, 79, 82, 85,
+    89, 92, 96, 100, 104, 108, 112, 117, 121, 125,
+    130, 135, 140, 145, 150, 156, 161, 167, 173, 179,
+    185, 191, 197, 204, 211, 218, 225, 232, 240, 247,
+    255, 263, 271, 280, 288, 297, 306, 316, 325, 335,
+    345, 355, 365, 376, 387, 398, 409, 420, 432, 444,
+    457, 469, 482, 495, 509, 522, 536, 551, 565, 580,
+    595, 611, 626, 643, 659, 676, 693, 710, 728, 746,
+    764, 783, 802, 821, 841, 861, 882, 903, 924, 946,
+    968, 990, 1013, 1036, 1060, 1084, 1108, 1133, 1158, 1184,
+    1210, 1237, 1264, 1291, 1319, 1347, 1376, 1405, 1435, 1465,
+    1496, 1527, 1559, 1591, 1623, 1656, 1690, 1724, 1759, 1794,
+    1829, 1865, 1902, 1939, 1977, 2015, 2054, 2093, 2133, 2174,
+    2215, 2256, 2298, 2341, 2384, 2428, 2473, 2518, 2563, 2609,
+    2656, 2704, 2752, 2800, 2849, 2899, 2950, 3001, 3052, 3105,
+    3157, 3211, 3265, 3320, 3375, 3432, 3488, 3546, 3604, 3663,
+    3722, 3782, 3843, 3904, 3966, 4029, 4092, 4156, 4221, 4286,
+    4352, 4419, 4486, 4555, 4623, 4693, 4763, 4834, 4906, 4978,
+    5051, 5125, 5199, 5274, 5350, 5426, 5503, 5581, 5660, 5739,
+    5819, 5900, 5981, 6063, 6146, 6230, 6314, 6399, 6484, 6571,
+    6658, 6745, 6834, 6923, 7013, 7103, 7195, 7286, 7379, 7472,
+    7566, 7661, 7756, 7852, 7949, 8047, 8145, 8243, 8343, 8443,
+    8544, 8645, 8747, 8850, 8953, 9057, 9162, 9268, 9374, 9480,
+    9587, 9695, 9804, 9913, 10023, 10133, 10244, 10356, 10468, 10581,
+    10694, 10808, 10923, 11038, 11153, 11270, 11387, 11504, 11622, 11740,
+    11859, 11979, 12099, 12219, 12340, 12462, 12584, 12706, 12829, 12953,
+    13077, 13201, 13326, 13451, 13577, 13703, 13829, 13956, 14084, 14211,
+    14340, 14468, 14597, 14726, 14856, 14986, 15116, 15246, 15377, 15509,
+    15640, 15772, 15904, 16036, 16169, 16301, 16435, 16568, 16701, 16835,
+    16969, 17103, 17237, 17372, 17506, 17641, 17776, 17911, 18046, 18181,
+    18316, 18451, 18587, 18722, 18858, 18993, 19129, 19264, 19400, 19535,
+    19670, 19806, 19941, 20077, 20212, 20347, 20482, 20617, 20752, 20886,
+    21021, 21155, 21289, 21423, 21557, 21690, 21824, 21957, 22090, 22222,
+    22355, 22487, 22618, 22750, 22881, 23011, 23142, 23272, 23401, 23531,
+    23659, 23788, 23916, 24043, 24170, 24297, 24423, 24548, 24674, 24798,
+    24922, 25046, 25169, 25291, 25413, 25534, 25654, 25774, 25894, 26012,
+    26130, 26248, 26364, 26480, 26595, 26710, 26824, 26937, 27049, 27160,
+    27271, 27381, 27490, 27598, 27706, 27812, 27918, 28023, 28127, 28230,
+    28332, 28434, 28534, 28633, 28732, 28829, 28926, 29021, 29116, 29210,
+    29302, 29394, 29484, 29574, 29662, 29749, 29836, 29921, 30005, 30088,
+    30170, 30251, 30330, 30409, 30486, 30562, 30637, 30711, 30784, 30855,
+    30926, 30995, 31062, 31129, 31195, 31259, 31322, 31383, 31444, 31503,
+    31561, 31617, 31672, 31726, 31779, 31830, 31880, 31929, 31976, 32023,
+    32067, 32111, 32153, 32193, 32233, 32271, 32307, 32342, 32376, 32409,
+    32440, 32470, 32498, 32525, 32550, 32574, 32597, 32618, 32638, 32657,
+    32674, 32689, 32704, 32717, 32728, 32738, 32746, 32754, 32759, 32764,
+    32766, 32767,
+};
+static const q15_t flat_top_half[SAMPLE_SIZE / 2] = {
+    -14, -14, -14, -14, -15, -15, -15, -16, -16, -17,
+    -18, -18, -19, -20, -21, -22, -23, -24, -25, -27,
+    -28, -30, -31, -33, -34, -36, -38, -40, -42, -44,
+    -46, -48, -50, -53, -55, -58, -61, -63, -66, -69,
+    -72, -75, -78, -82, -85, -89, -92, -96, -100, -104,
+    -108, -112, -117, -121, -126, -130, -135, -140, -145, -150,
+    -156, -161, -167, -172, -178, -184, -190, -196, -203, -209,
+    -216, -223, -230, -237, -245, -252, -260, -267, -275, -283,
+    -292, -300, -309, -317, -326, -336, -345, -354, -364, -374,
+    -384, -394, -404, -415, -425, -436, -447, -458, -470, -481,
+    -493, -505, -517, -529, -542, -555, -568, -581, -594, -607,
+    -621, -635, -648, -663, -677, -691, -706, -721, -736, -751,
+    -766, -782, -798, -813, -829, -846, -862, -878, -895, -912,
+    -929, -946, -963, -981, -998, -1016, -1034, -1052, -1070, -1088,
+    -1106, -1124, -1143, -1162, -1180, -1199, -1218, -1237, -1256, -1275,
+    -1294, -1314, -1333, -1352, -1372, -1391, -1411, -1430, -1450, -1469,
+    -1489, -1508, -1528, -1547, -1567, -1586, -1606, -1625, -1645, -1664,
+    -1683, -1702, -1721, -1740, -1759, -1777, -1796, -1814, -1833, -1851,
+    -1869, -1886, -1904, -1921, -1938, -1955, -1972, -1989, -2005, -2021,
+    -2036, -2052, -2067, -2081, -2096, -2110, -2124, -2137, -2150, -2162,
+    -2175, -2186, -2198, -2208, -2219, -2229, -2238, -2247, -2256, -2264,
+    -2271, -2278, -2284, -2290, -2295, -2299, -2303, -2306, -2309, -2311,
+    -2312, -2312, -2312, -2311, -2309, -2307, -2303, -2299, -2294, -2289,
+    -2282, -2275, -2267, -2257, -2247, -2236, -2225, -2212, -2198, -2183,
+    -2167, -2151, -2133, -2114, -2094, -2073, -2051, -2028, -2004, -1978,
+    -1952, -1924, -1896, -1866, -1834, -1802, -1768, -1733, -1697, -1660,
+    -1621, -1581, -1540, -1497, -1453, -1408, -1362, -1314, -1264, -1213,
+    -1161, -1108, -1053, -996, -938, -879, -818, -756, -692, -627,
+    -560, -491, -422, -350, -277, -203, -127, -49, 30, 111,
+    193, 277, 363, 450, 539, 630, 722, 815, 911, 1008,
+    1106, 1206, 1308, 1412, 1517, 1624, 1732, 1843, 1954, 2068,
+    2183, 2300, 2418, 2538, 2660, 2783, 2908, 3035, 3163, 3293,
+    3425, 3558, 3693, 3829, 3967, 4106, 4248, 4390, 4535, 4681,
+    4828, 4977, 5128, 5280, 5433, 5588, 5745, 5903, 6062, 6223,
+    6386, 6550, 6715, 6882, 7050, 7219, 7390, 7562, 7736, 7910,
+    8086, 8264, 8442, 8622, 8803, 8985, 9169, 9353, 9539, 9726,
+    9913, 10102, 10292, 10483, 10675, 10868, 11062, 11257, 11452, 11649,
+    11846, 12044, 12243, 12443, 12644, 12845, 13047, 13249, 13452, 13656,
+    13860, 14065, 14270, 14476, 14682, 14889, 15096, 15303, 15511, 15719,
+    15927, 16136, 16344, 16553, 16762, 16971, 17180, 17389, 17598, 17807,
+    18016, 18225, 18433, 18642, 18850, 19058, 19265, 19473, 19679, 19886,
+    20092, 20298, 20503, 20707, 20911, 21115, 21317, 21519, 21721, 21921,
+    22121, 22320, 22518, 22715, 22911, 23106, 23300, 23493, 23685, 23876,
+    24065, 24254, 24441, 24627, 24812, 24995, 25177, 25358, 25537, 25714,
+    25890, 26065, 26238, 26409, 26579, 26747, 26913, 27078, 27241, 27402,
+    27561, 27718, 27873, 28027, 28178, 28328, 28475, 28621, 28764, 28905,
+    29044, 29181, 29315, 29448, 29578, 29706, 29832, 29955, 30076, 30194,
+    30310, 30424, 30535, 30644, 30750, 30854, 30955, 31054, 31150, 31243,
+    31334, 31422, 31507, 31590, 31670, 31748, 31822, 31894, 31964, 32030,
+    32094, 32154, 32212, 32268, 32320, 32369, 32416, 32460, 32501, 32539,
+    32574, 32606, 32635, 32662, 32685, 32706, 32724, 32738, 32750, 32759,
+    32765, 32767,
+};
+const WindowInfo gWindows[WINDOW_COUNT] = {
+    [WINDOW_HANN] = {hann_half, 16400, 6138}, // CG=0.5005, ENBW=1.499
+    [WINDOW_BLACKMAN_HARRIS] = {blackman_harris_half, 11767, 8202}, // CG=0.3591, ENBW=2.002
+    [WINDOW_FLAT_TOP] = {flat_top_half, 7071, 15428}, // CG=0.2158, ENBW=3.767
+    [WINDOW_RECTANGULAR] = {NULL, 32768, 4096}, // CG=1.0000, ENBW=1.000
 };
 #elif SAMPLE_SIZE == 512
-const double gHanningWindow[SAMPLE_SIZE] = {
-    0.0000375024, 0.0001500042, 0.0003374883, 0.0005999266, 0.0009372799,
-    0.0013494974, 0.0018365174, 0.0023982668, 0.0030346613, 0.0037456055,
-    0.0045309927, 0.0053907051, 0.0063246137, 0.0073325785, 0.0084144482,
-    0.0095700605, 0.0107992422, 0.0121018087, 0.0134775647, 0.0149263039,
-    0.0164478088, 0.0180418513, 0.0197081923, 0.0214465817, 0.0232567588,
-    0.0251384520, 0.0270913791, 0.0291152472, 0.0312097526, 0.0333745811,
-    0.0356094079, 0.0379138979, 0.0402877054, 0.0427304741, 0.0452418378,
-    0.0478214197, 0.0504688327, 0.0531836798, 0.0559655538, 0.0588140372,
-    0.0617287029, 0.0647091136, 0.0677548221, 0.0708653716, 0.0740402956,
-    0.0772791176, 0.0805813520, 0.0839465032, 0.0873740665, 0.0908635278,
-    0.0944143635, 0.0980260410, 0.1016980186, 0.1054297453, 0.1092206614,
-    0.1130701983, 0.1169777784, 0.1209428156, 0.1249647151, 0.1290428736,
-    0.1331766792, 0.1373655120, 0.1416087434, 0.1459057371, 0.1502558483,
-    0.1546584246, 0.1591128055, 0.1636183228, 0.1681743007, 0.1727800557,
-    0.1774348968, 0.1821381259, 0.1868890374, 0.1916869185, 0.1965310497,
-    0.2014207041, 0.2063551484, 0.2113336423, 0.2163554390, 0.2214197851,
-    0.2265259209, 0.2316730806, 0.2368604919, 0.2420873767, 0.2473529510,
-    0.2526564247, 0.2579970025, 0.2633738830, 0.2687862598, 0.2742333208,
-    0.2797142491, 0.2852282225, 0.2907744136, 0.2963519907, 0.3019601170,
-    0.3075979512, 0.3132646475, 0.3189593560, 0.3246812224, 0.3304293883,
-    0.3362029915, 0.3420011658, 0.3478230414, 0.3536677451, 0.3595344001,
-    0.3654221263, 0.3713300405, 0.3772572564, 0.3832028850, 0.3891660342,
-    0.3951458097, 0.4011413143, 0.4071516486, 0.4131759112, 0.4192131982,
-    0.4252626040, 0.4313232211, 0.4373941404, 0.4434744512, 0.4495632414,
-    0.4556595977, 0.4617626054, 0.4678713490, 0.4739849123, 0.4801023782,
-    0.4862228288, 0.4923453462, 0.4984690118, 0.5045929071, 0.5107161134,
-    0.5168377122, 0.5229567852, 0.5290724145, 0.5351836825, 0.5412896727,
-    0.5473894691, 0.5534821565, 0.5595668211, 0.5656425501, 0.5717084321,
-    0.5777635571, 0.5838070168, 0.5898379047, 0.5958553160, 0.6018583480,
-    0.6078461003, 0.6138176746, 0.6197721752, 0.6257087088, 0.6316263848,
-    0.6375243156, 0.6434016164, 0.6492574055, 0.6550908046, 0.6609009385,
-    0.6666869357, 0.6724479283, 0.6781830520, 0.6838914464, 0.6895722554,
-    0.6952246267, 0.7008477123, 0.7064406689, 0.7120026573, 0.7175328432,
-    0.7230303971, 0.7284944943, 0.7339243150, 0.7393190448, 0.7446778745,
-    0.7500000000, 0.7552846231, 0.7605309510, 0.7657381967, 0.7709055791,
-    0.7760323230, 0.7811176593, 0.7861608253, 0.7911610643, 0.7961176263,
-    0.8010297678, 0.8058967519, 0.8107178484, 0.8154923343, 0.8202194932,
-    0.8248986161, 0.8295290009, 0.8341099533, 0.8386407858, 0.8431208189,
-    0.8475493806, 0.8519258064, 0.8562494399, 0.8605196326, 0.8647357437,
-    0.8688971409, 0.8730032000, 0.8770533049, 0.8810468481, 0.8849832306,
-    0.8888618618, 0.8926821600, 0.8964435519, 0.9001454735, 0.9037873693,
-    0.9073686931, 0.9108889076, 0.9143474847, 0.9177439057, 0.9210776610,
-    0.9243482505, 0.9275551836, 0.9306979793, 0.9337761661, 0.9367892822,
-    0.9397368756, 0.9426185042, 0.9454337357, 0.9481821478, 0.9508633281,
-    0.9534768746, 0.9560223951, 0.9584995078, 0.9609078410, 0.9632470336,
-    0.9655167346, 0.9677166035, 0.9698463104, 0.9719055357, 0.9738939706,
-    0.9758113167, 0.9776572865, 0.9794316031, 0.9811340002, 0.9827642224,
-    0.9843220254, 0.9858071753, 0.9872194493, 0.9885586357, 0.9898245335,
-    0.9910169529, 0.9921357149, 0.9931806517, 0.9941516066, 0.9950484339,
-    0.9958709992, 0.9966191789, 0.9972928609, 0.9978919440, 0.9984163386,
-    0.9988659658, 0.9992407582, 0.9995406597, 0.9997656251, 0.9999156208,
-    0.9999906243, 0.9999906243, 0.9999156208, 0.9997656251, 0.9995406597,
-    0.9992407582, 0.9988659658, 0.9984163386, 0.9978919440, 0.9972928609,
-    0.9966191789, 0.9958709992, 0.9950484339, 0.9941516066, 0.9931806517,
-    0.9921357149, 0.9910169529, 0.9898245335, 0.9885586357, 0.9872194493,
-    0.9858071753, 0.9843220254, 0.9827642224, 0.9811340002, 0.9794316031,
-    0.9776572865, 0.9758113167, 0.9738939706, 0.9719055357, 0.9698463104,
-    0.9677166035, 0.9655167346, 0.9632470336, 0.9609078410, 0.9584995078,
-    0.9560223951, 0.9534768746, 0.9508633281, 0.9481821478, 0.9454337357,
-    0.9426185042, 0.9397368756, 0.9367892822, 0.9337761661, 0.9306979793,
-    0.9275551836, 0.9243482505, 0.9210776610, 0.9177439057, 0.9143474847,
-    0.9108889076, 0.9073686931, 0.9037873693, 0.9001454735, 0.8964435519,
-    0.8926821600, 0.8888618618, 0.8849832306, 0.8810468481, 0.8770533049,
-    0.8730032000, 0.8688971409, 0.8647357437, 0.8605196326, 0.8562494399,
-    0.8519258064, 0.8475493806, 0.8431208189, 0.8386407858, 0.8341099533,
-    0.8295290009, 0.8248986161, 0.8202194932, 0.8154923343, 0.8107178484,
-    0.8058967519, 0.8010297678, 0.7961176263, 0.7911610643, 0.7861608253,
-    0.7811176593, 0.7760323230, 0.7709055791, 0.7657381967, 0.7605309510,
-    0.7552846231, 0.7500000000, 0.7446778745, 0.7393190448, 0.7339243150,
-    0.7284944943, 0.7230303971, 0.7175328432, 0.7120026573, 0.7064406689,
-    0.7008477123, 0.6952246267, 0.6895722554, 0.6838914464, 0.6781830520,
-    0.6724479283, 0.6666869357, 0.6609009385, 0.6550908046, 0.6492574055,
-    0.6434016164, 0.6375243156, 0.6316263848, 0.6257087088, 0.6197721752,
-    0.6138176746, 0.6078461003, 0.6018583480, 0.5958553160, 0.5898379047,
-    0.5838070168, 0.5777635571, 0.5717084321, 0.5656425501, 0.5595668211,
-    0.5534821565, 0.5473894691, 0.5412896727, 0.5351836825, 0.5290724145,
-    0.5229567852, 0.5168377122, 0.5107161134, 0.5045929071, 0.4984690118,
-    0.4923453462, 0.4862228288, 0.4801023782, 0.4739849123, 0.4678713490,
-    0.4617626054, 0.4556595977, 0.4495632414, 0.4434744512, 0.4373941404,
-    0.4313232211, 0.4252626040, 0.4192131982, 0.4131759112, 0.4071516486,
-    0.4011413143, 0.3951458097, 0.3891660342, 0.3832028850, 0.3772572564,
-    0.3713300405, 0.3654221263, 0.3595344001, 0.3536677451, 0.3478230414,
-    0.3420011658, 0.3362029915, 0.3304293883, 0.3246812224, 0.3189593560,
-    0.3132646475, 0.3075979512, 0.3019601170, 0.2963519907, 0.2907744136,
-    0.2852282225, 0.2797142491, 0.2742333208, 0.2687862598, 0.2633738830,
-    0.2579970025, 0.2526564247, 0.2473529510, 0.2420873767, 0.2368604919,
-    0.2316730806, 0.2265259209, 0.2214197851, 0.2163554390, 0.2113336423,
-    0.2063551484, 0.2014207041, 0.1965310497, 0.1916869185, 0.1868890374,
-    0.1821381259, 0.1774348968, 0.1727800557, 0.1681743007, 0.1636183228,
-    0.1591128055, 0.1546584246, 0.1502558483, 0.1459057371, 0.1416087434,
-    0.1373655120, 0.1331766792, 0.1290428736, 0.1249647151, 0.1209428156,
-    0.1169777784, 0.1130701983, 0.1092206614, 0.1054297453, 0.1016980186,
-    0.0980260410, 0.0944143635, 0.0908635278, 0.0873740665, 0.0839465032,
-    0.0805813520, 0.0772791176, 0.0740402956, 0.0708653716, 0.0677548221,
-    0.0647091136, 0.0617287029, 0.0588140372, 0.0559655538, 0.0531836798,
-    0.0504688327, 0.0478214197, 0.0452418378, 0.0427304741, 0.0402877054,
-    0.0379138979, 0.0356094079, 0.0333745811, 0.0312097526, 0.0291152472,
-    0.0270913791, 0.0251384520, 0.0232567588, 0.0214465817, 0.0197081923,
-    0.0180418513, 0.0164478088, 0.0149263039, 0.0134775647, 0.0121018087,
-    0.0107992422, 0.0095700605, 0.0084144482, 0.0073325785, 0.0063246137,
-    0.0053907051, 0.0045309927, 0.0037456055, 0.0030346613, 0.0023982668,
-    0.0018365174, 0.0013494974, 0.0009372799, 0.0005999266, 0.0003374883,
-    0.0001500042, 0.0000375024,
+static const q15_t hann_half[SAMPLE_SIZE / 2] = {
+    1, 5, 11, 20, 31, 44, 60, 79, 99, 123,
+    148, 177, 207, 240, 276, 314, 354, 397, 442, 489,
+    539, 591, 646, 703, 762, 824, 888, 954, 1023, 1094,
+    1167, 1242, 1320, 1400, 1482, 1567, 1654, 1743, 1834, 1927,
+    2023, 2120, 2220, 2322, 2426, 2532, 2640, 2751, 2863, 2977,
+    3094, 3212, 3332, 3455, 3579, 3705, 3833, 3963, 4095, 4228,
+    4364, 4501, 4640, 4781, 4924, 5068, 5214, 5361, 5511, 5662,
+    5814, 5968, 6124, 6281, 6440, 6600, 6762, 6925, 7090, 7255,
+    7423, 7591, 7761, 7933, 8105, 8279, 8454, 8630, 8808, 8986,
+    9166, 9346, 9528, 9711, 9895, 10079, 10265, 10452, 10639, 10828,
+    11017, 11207, 11397, 11589, 11781, 11974, 12168, 12362, 12557, 12752,
+    12948, 13145, 13342, 13539, 13737, 13935, 14134, 14333, 14532, 14731,
+    14931, 15131, 15331, 15532, 15732, 15933, 16133, 16334, 16535, 16735,
+    16936, 17136, 17337, 17537, 17737, 17937, 18137, 18336, 18535, 18734,
+    18932, 19130, 19328, 19525, 19722, 19918, 20114, 20309, 20503, 20697,
+    20890, 21083, 21275, 21466, 21656, 21846, 22035, 22223, 22410, 22596,
+    22781, 22965, 23149, 23331, 23512, 23692, 23871, 24049, 24226, 24402,
+    24576, 24749, 24921, 25092, 25261, 25429, 25596, 25761, 25925, 26087,
+    26248, 26408, 26566, 26722, 26877, 27030, 27182, 27332, 27481, 27627,
+    27772, 27916, 28058, 28198, 28336, 28472, 28607, 28739, 28870, 28999,
+    29126, 29251, 29375, 29496, 29615, 29733, 29848, 29961, 30073, 30182,
+    30289, 30394, 30497, 30598, 30697, 30793, 30888, 30980, 31070, 31158,
+    31244, 31327, 31408, 31487, 31564, 31638, 31710, 31780, 31847, 31913,
+    31975, 32036, 32094, 32150, 32203, 32254, 32303, 32349, 32393, 32435,
+    32474, 32510, 32545, 32576, 32606, 32633, 32657, 32679, 32699, 32716,
+    32731, 32743, 32753, 32760, 32765, 32767,
+};
+static const q15_t blackman_harris_half[SAMPLE_SIZE / 2] = {
+    2, 2, 3, 3, 4, 5, 5, 7, 8, 9,
+    11, 13, 14, 17, 19, 21, 24, 27, 30, 34,
+    38, 42, 46, 50, 55, 61, 66, 72, 78, 85,
+    92, 100, 108, 116, 125, 135, 145, 155, 166, 178,
+    190, 203, 217, 231, 247, 262, 279, 296, 315, 334,
+    354, 375, 396, 419, 443, 468, 494, 521, 549, 578,
+    609, 641, 674, 708, 743, 780, 819, 859, 900, 943,
+    987, 1033, 1080, 1129, 1180, 1233, 1287, 1343, 1401, 1460,
+    1522, 1586, 1651, 1718, 1788, 1859, 1933, 2009, 2087, 2167,
+    2249, 2333, 2420, 2509, 2601, 2695, 2791, 2890, 2991, 3094,
+    3200, 3309, 3420, 3534, 3650, 3769, 3891, 4015, 4142, 4272,
+    4405, 4540, 4678, 4818, 4962, 5108, 5257, 5409, 5563, 5721,
+    5881, 6044, 6210, 6378, 6550, 6724, 6901, 7081, 7263, 7449,
+    7637, 7828, 8021, 8218, 8417, 8618, 8823, 9029, 9239, 9451,
+    9666, 9883, 10102, 10324, 10549, 10776, 11005, 11236, 11470, 11706,
+    11943, 12183, 12425, 12669, 12915, 13163, 13413, 13664, 13917, 14172,
+    14428, 14685, 14944, 15205, 15466, 15729, 15993, 16258, 16524, 16791,
+    17058, 17326, 17595, 17865, 18135, 18405, 18675, 18946, 19217, 19487,
+    19758, 20029, 20299, 20568, 20838, 21106, 21374, 21642, 21908, 22173,
+    22437, 22700, 22962, 23223, 23481, 23739, 23994, 24248, 24500, 24750,
+    24997, 25243, 25486, 25727, 25965, 26201, 26434, 26664, 26891, 27115,
+    27336, 27554, 27768, 27979, 28187, 28391, 28591, 28788, 28981, 29170,
+    29354, 29535, 29712, 29884, 30052, 30215, 30374, 30529, 30678, 30823,
+    30964, 31099, 31230, 31355, 31476, 31591, 31702, 31807, 31907, 32001,
+    32090, 32174, 32253, 32326, 32393, 32455, 32512, 32563, 32608, 32648,
+    32682, 32710, 32733, 32750, 32762, 32767,
+};
+static const q15_t flat_top_half[SAMPLE_SIZE / 2] = {
+    -14, -14, -15, -16, -17, -18, -20, -22, -24, -27,
+    -30, -33, -36, -40, -44, -48, -53, -58, -63, -69,
+    -75, -82, -89, -96, -104, -112, -121, -130, -140, -150,
+    -161, -172, -184, -196, -209, -223, -237, -251, -267, -283,
+    -299, -317, -335, -353, -373, -393, -414, -435, -457, -480,
+    -504, -528, -553, -579, -606, -633, -661, -690, -719, -749,
+    -780, -812, -844, -876, -910, -944, -978, -1013, -1049, -1085,
+    -1122, -1159, -1196, -1234, -1272, -1311, -1349, -1388, -1427, -1466,
+    -1505, -1544, -1583, -1622, -1661, -1699, -1737, -1774, -1811, -1848,
+    -1883, -1918, -1952, -1986, -2018, -2049, -2079, -2107, -2134, -2160,
+    -2184, -2206, -2227, -2245, -2262, -2276, -2289, -2298, -2306, -2310,
+    -2312, -2311, -2307, -2300, -2290, -2277, -2260, -2239, -2215, -2187,
+    -2155, -2119, -2078, -2034, -1985, -1931, -1873, -1810, -1742, -1669,
+    -1592, -1508, -1420, -1326, -1227, -1122, -1011, -895, -773, -645,
+    -510, -370, -224, -71, 88, 253, 425, 603, 788, 979,
+    1177, 1381, 1592, 1809, 2033, 2264, 2501, 2745, 2995, 3252,
+    3516, 3786, 4062, 4345, 4633, 4929, 5230, 5537, 5851, 6170,
+    6495, 6826, 7162, 7504, 7851, 8203, 8560, 8922, 9289, 9660,
+    10035, 10415, 10799, 11187, 11578, 11972, 12370, 12771, 13174, 13580,
+    13989, 14399, 14811, 15225, 15640, 16056, 16473, 16890, 17308, 17725,
+    18143, 18559, 18975, 19390, 19804, 20215, 20625, 21032, 21437, 21839,
+    22238, 22633, 23025, 23413, 23796, 24175, 24549, 24917, 25281, 25638,
+    25990, 26335, 26674, 27006, 27331, 27649, 27959, 28262, 28556, 28842,
+    29120, 29388, 29648, 29899, 30140, 30372, 30594, 30806, 31008, 31200,
+    31381, 31552, 31711, 31861, 31999, 32126, 32241, 32346, 32439, 32521,
+    32591, 32649, 32696, 32731, 32755, 32767,
+};
+const WindowInfo gWindows[WINDOW_COUNT] = {
+    [WINDOW_HANN] = {hann_half, 16416, 6132}, // CG=0.5010, ENBW=1.497
+    [WINDOW_BLACKMAN_HARRIS] = {blackman_harris_half, 11778, 8194}, // CG=0.3595, ENBW=2.000
+    [WINDOW_FLAT_TOP] = {flat_top_half, 7078, 15413}, // CG=0.2160, ENBW=3.763
+    [WINDOW_RECTANGULAR] = {NULL, 32768, 4096}, // CG=1.0000, ENBW=1.000
 };
 #elif SAMPLE_SIZE == 256
-const double gHanningWindow[SAMPLE_SIZE] = {
-    0.0001494211, 0.0005975950, 0.0013442539, 0.0023889515, 0.0037310635,
-    0.0053697876, 0.0073041444, 0.0095329778, 0.0120549557, 0.0148685707,
-    0.0179721411, 0.0213638119, 0.0250415562, 0.0290031756, 0.0332463025,
-    0.0377684007, 0.0425667675, 0.0476385350, 0.0529806718, 0.0585899850,
-    0.0644631221, 0.0705965728, 0.0769866711, 0.0836295979, 0.0905213828,
-    0.0976579065, 0.1050349039, 0.1126479657, 0.1204925417, 0.1285639434,
-    0.1368573466, 0.1453677944, 0.1540902004, 0.1630193512, 0.1721499101,
-    0.1814764198, 0.1909933060, 0.2006948808, 0.2105753455, 0.2206287947,
-    0.2308492198, 0.2412305121, 0.2517664668, 0.2624507868, 0.2732770862,
-    0.2842388944, 0.2953296596, 0.3065427531, 0.3178714729, 0.3293090481,
-    0.3408486426, 0.3524833594, 0.3642062445, 0.3760102914, 0.3878884451,
-    0.3998336060, 0.4118386349, 0.4238963564, 0.4359995639, 0.4481410234,
-    0.4603134782, 0.4725096530, 0.4847222584, 0.4969439950, 0.5091675582,
-    0.5213856421, 0.5335909441, 0.5457761693, 0.5579340348, 0.5700572741,
-    0.5821386412, 0.5941709154, 0.6061469050, 0.6180594524, 0.6299014374,
-    0.6416657824, 0.6533454560, 0.6649334774, 0.6764229206, 0.6878069187,
-    0.6990786675, 0.7102314301, 0.7212585406, 0.7321534084, 0.7429095218,
-    0.7535204519, 0.7639798569, 0.7742814852, 0.7844191798, 0.7943868815,
-    0.8041786328, 0.8137885813, 0.8232109833, 0.8324402071, 0.8414707366,
-    0.8502971745, 0.8589142452, 0.8673167985, 0.8754998123, 0.8834583958,
-    0.8911877922, 0.8986833817, 0.9059406845, 0.9129553629, 0.9197232244,
-    0.9262402239, 0.9325024662, 0.9385062087, 0.9442478628, 0.9497239970,
-    0.9549313382, 0.9598667741, 0.9645273548, 0.9689102948, 0.9730129745,
-    0.9768329417, 0.9803679134, 0.9836157767, 0.9865745904, 0.9892425862,
-    0.9916181693, 0.9936999199, 0.9954865939, 0.9969771233, 0.9981706173,
-    0.9990663624, 0.9996638235, 0.9999626433, 0.9999626433, 0.9996638235,
-    0.9990663624, 0.9981706173, 0.9969771233, 0.9954865939, 0.9936999199,
-    0.9916181693, 0.9892425862, 0.9865745904, 0.9836157767, 0.9803679134,
-    0.9768329417, 0.9730129745, 0.9689102948, 0.9645273548, 0.9598667741,
-    0.9549313382, 0.9497239970, 0.9442478628, 0.9385062087, 0.9325024662,
-    0.9262402239, 0.9197232244, 0.9129553629, 0.9059406845, 0.8986833817,
-    0.8911877922, 0.8834583958, 0.8754998123, 0.8673167985, 0.8589142452,
-    0.8502971745, 0.8414707366, 0.8324402071, 0.8232109833, 0.8137885813,
-    0.8041786328, 0.7943868815, 0.7844191798, 0.7742814852, 0.7639798569,
-    0.7535204519, 0.7429095218, 0.7321534084, 0.7212585406, 0.7102314301,
-    0.6990786675, 0.6878069187, 0.6764229206, 0.6649334774, 0.6533454560,
-    0.6416657824, 0.6299014374, 0.6180594524, 0.6061469050, 0.5941709154,
-    0.5821386412, 0.5700572741, 0.5579340348, 0.5457761693, 0.5335909441,
-    0.5213856421, 0.5091675582, 0.4969439950, 0.4847222584, 0.4725096530,
-    0.4603134782, 0.4481410234, 0.4359995639, 0.4238963564, 0.4118386349,
-    0.3998336060, 0.3878884451, 0.3760102914, 0.3642062445, 0.3524833594,
-    0.3408486426, 0.3293090481, 0.3178714729, 0.3065427531, 0.2953296596,
-    0.2842388944, 0.2732770862, 0.2624507868, 0.2517664668, 0.2412305121,
-    0.2308492198, 0.2206287947, 0.2105753455, 0.2006948808, 0.1909933060,
-    0.1814764198, 0.1721499101, 0.1630193512, 0.1540902004, 0.1453677944,
-    0.1368573466, 0.1285639434, 0.1204925417, 0.1126479657, 0.1050349039,
-    0.0976579065, 0.0905213828, 0.0836295979, 0.0769866711, 0.0705965728,
-    0.0644631221, 0.0585899850, 0.0529806718, 0.0476385350, 0.0425667675,
-    0.0377684007, 0.0332463025, 0.0290031756, 0.0250415562, 0.0213638119,
-    0.0179721411, 0.0148685707, 0.0120549557, 0.0095329778, 0.0073041444,
-    0.0053697876, 0.0037310635, 0.0023889515, 0.0013442539, 0.0005975950,
-    0.0001494211,
+static const q15_t hann_half[SAMPLE_SIZE / 2] = {
+    5, 20, 44, 78, 122, 176, 239, 312, 395, 487,
+    589, 700, 821, 950, 1089, 1238, 1395, 1561, 1736, 1920,
+    2112, 2313, 2523, 2740, 2966, 3200, 3442, 3691, 3948, 4213,
+    4485, 4763, 5049, 5342, 5641, 5947, 6258, 6576, 6900, 7230,
+    7564, 7905, 8250, 8600, 8955, 9314, 9677, 10045, 10416, 10791,
+    11169, 11550, 11934, 12321, 12710, 13102, 13495, 13890, 14287, 14685,
+    15084, 15483, 15883, 16284, 16684, 17085, 17485, 17884, 18282, 18680,
+    19076, 19470, 19862, 20253, 20641, 21026, 21409, 21789, 22165, 22538,
+    22907, 23273, 23634, 23991, 24344, 24691, 25034, 25372, 25704, 26030,
+    26351, 26666, 26975, 27277, 27573, 27863, 28145, 28420, 28688, 28949,
+    29202, 29448, 29686, 29916, 30137, 30351, 30556, 30753, 30941, 31121,
+    31291, 31453, 31606, 31749, 31884, 32009, 32125, 32231, 32328, 32416,
+    32493, 32562, 32620, 32669, 32708, 32737, 32757, 32767,
+};
+static const q15_t blackman_harris_half[SAMPLE_SIZE / 2] = {
+    2, 3, 4, 7, 9, 12, 17, 21, 27, 34,
+    41, 50, 60, 72, 85, 99, 116, 134, 154, 177,
+    202, 230, 261, 295, 332, 372, 417, 465, 518, 575,
+    637, 704, 776, 853, 937, 1026, 1122, 1225, 1334, 1451,
+    1575, 1707, 1847, 1996, 2152, 2318, 2493, 2677, 2871, 3074,
+    3287, 3511, 3745, 3989, 4244, 4510, 4787, 5075, 5373, 5684,
+    6005, 6337, 6681, 7036, 7401, 7778, 8166, 8565, 8974, 9393,
+    9823, 10262, 10711, 11169, 11636, 12112, 12596, 13088, 13587, 14092,
+    14604, 15121, 15644, 16171, 16702, 17237, 17774, 18312, 18852, 19393,
+    19933, 20472, 21009, 21544, 22075, 22602, 23124, 23641, 24150, 24653,
+    25147, 25632, 26107, 26571, 27024, 27464, 27892, 28306, 28705, 29089,
+    29458, 29809, 30144, 30461, 30759, 31039, 31299, 31539, 31759, 31958,
+    32135, 32292, 32426, 32539, 32629, 32697, 32742, 32765,
+};
+static const q15_t flat_top_half[SAMPLE_SIZE / 2] = {
+    -14, -16, -18, -22, -27, -33, -40, -48, -58, -69,
+    -81, -96, -112, -130, -149, -171, -195, -222, -250, -282,
+    -315, -352, -391, -433, -478, -526, -576, -630, -686, -746,
+    -808, -872, -939, -1009, -1080, -1154, -1229, -1305, -1382, -1460,
+    -1538, -1616, -1693, -1768, -1841, -1912, -1980, -2043, -2102, -2155,
+    -2202, -2242, -2274, -2296, -2309, -2312, -2302, -2280, -2244, -2194,
+    -2127, -2045, -1945, -1826, -1688, -1530, -1351, -1150, -927, -680,
+    -409, -114, 206, 551, 923, 1320, 1744, 2193, 2669, 3172,
+    3700, 4254, 4833, 5436, 6064, 6714, 7387, 8082, 8796, 9529,
+    10280, 11047, 11829, 12624, 13430, 14246, 15069, 15897, 16729, 17563,
+    18396, 19226, 20050, 20868, 21675, 22471, 23252, 24016, 24762, 25486,
+    26187, 26862, 27510, 28128, 28715, 29268, 29786, 30267, 30709, 31111,
+    31472, 31791, 32066, 32297, 32482, 32622, 32715, 32762,
+};
+const WindowInfo gWindows[WINDOW_COUNT] = {
+    [WINDOW_HANN] = {hann_half, 16448, 6120}, // CG=0.5020, ENBW=1.494
+    [WINDOW_BLACKMAN_HARRIS] = {blackman_harris_half, 11801, 8178}, // CG=0.3602, ENBW=1.997
+    [WINDOW_FLAT_TOP] = {flat_top_half, 7092, 15383}, // CG=0.2164, ENBW=3.756
+    [WINDOW_RECTANGULAR] = {NULL, 32768, 4096}, // CG=1.0000, ENBW=1.000
 };
-#else
-#error "Unsupported SAMPLE_SIZE for arm_cfft_q15."
 #endif
 
+uint16_t
+    gCurrentSamples[DUAL_CHANNEL_SUPPORTED ? SAMPLE_SIZE + ADC_DISCARD_SAMPLES
+                                           : 2] __attribute__((aligned(4)));
+
 // 自动生成的测试信号数据
 // 包含10种信号类型，每种1024点，范围0-4095
 // 使用前请定义以下宏之一来选择信号类型:
@@ -399,7 +1559,7 @@ const double gHanningWindow[SAMPLE_SIZE] = {
 // TWO_SINE_SIGNAL
 
 #ifdef NO_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -493,7 +1653,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef DC_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -587,7 +1747,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef SINE_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -681,7 +1841,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef TRIANGLE_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -775,7 +1935,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef SAWTOOTH_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -869,7 +2029,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef SQUARE_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -963,7 +2123,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef UNKNOWN_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -1057,7 +2217,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef SINE_DC_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -1151,7 +2311,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef TRIANGLE_DC_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -1245,7 +2405,7 @@ uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
 #endif
 
 #ifdef TWO_SINE_SIGNAL
-uint16_t gADCRealSamples[SAMPLE_SIZE + 50] = {
+uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES] = {
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
     0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
@@ -1,18 +1,164 @@
 #ifndef MYCONSTS_H
 #define MYCONSTS_H
+#include "arm_math.h"
+#include <stdbool.h>
 #include <ti/iqmath/include/IQmathLib.h>
 
-// 不超过u16
+// 不超过u16, 可选 256/512/1024/2048/4096; 主机测试 (tests/) 在编译命令中
+// 同时指定 SAMPLE_SIZE 与 SAMPLE_SIZE_LOG2, 按多种点数编译同一份源码
+#ifndef SAMPLE_SIZE
 #define SAMPLE_SIZE 1024
+// log2(SAMPLE_SIZE), 修改 SAMPLE_SIZE 时同步修改
+#define SAMPLE_SIZE_LOG2 10
+#endif
+// 每帧开头丢弃的采样数 (ADC 启动后的不稳定数据)
+#define ADC_DISCARD_SAMPLES 50
+
+// RAM 复用 (scratch arena), 按一帧内的生命周期划分:
+//   1. 采集: DMA 写入 gADCRealSamples
+//   2. 上传: 原始采样经 UART 发出
+//   3. 分析: 加窗 -> FFT -> 幅度谱 (q31, 与 FFT 输出原地重叠)
+//            -> 功率谱平均 (power_acc, 跨帧保留) -> 谐波查找
+// SAMPLE_SIZE <= 1024 时 FFT 使用独立的工作区, 原始采样保留到分析结束;
+// 更大点数时 RAM 不够再放一份工作区, 第 3 步直接在采集缓冲区上原地进行,
+// 因此第 2 步必须在 FFT 之前完成, 且只能使用原地基4 Q15 FFT
+// (arm_rfft_q15 需要 2 倍长度输出缓冲区, Q31 需要 4 倍).
+// 各点数下的 RAM 占用见 readme
+#define SPECTRUM_IN_CAPTURE_BUFFER (SAMPLE_SIZE > 1024)
+// 双通道采集需要第二个采集缓冲区和 SAMPLE_SIZE 点复数 FFT 的独立工作区
+#define DUAL_CHANNEL_SUPPORTED (!SPECTRUM_IN_CAPTURE_BUFFER)
 #define UART_PACKET_SIZE 8
-// 不超过u8
-#define NUM_HARMONICS 5
+// 上报的谐波数量上限(含基波), 不超过u8
+#define MAX_HARMONICS 40
+// 上报的谐波数量下限, 波形识别需要用到二~五次谐波
+#define MIN_HARMONICS 5
 #define CLK_CYCLE_NS 31.25
+// 各分辨率的转换时间 (ADCCLK 32MHz 下 6/5/4 个时钟)
 #define CONVERSION_TIME_NS 187.5
+#define CONVERSION_TIME_NS_10BIT 156.25
+#define CONVERSION_TIME_NS_8BIT 125.0
+
+// ADC 转换分辨率
+typedef enum {
+  ADC_RESOLUTION_12BIT = 0,
+  ADC_RESOLUTION_10BIT = 1, // 转换更快, 采样率上限更高
+  ADC_RESOLUTION_8BIT = 2,
+  // 按基波频率自动选择 (默认): 12 位无法维持每帧 5 个周期时依次降到 10/8 位
+  ADC_RESOLUTION_AUTO = 3
+} AdcResolution;
+
+// 降低分辨率的无符号采样换算到 12 位码值需左移的位数
+#define ADC_RESOLUTION_SHIFT(res) (2 * (res))
+
+// 硬件平均的最大过采样倍数 (ADC12 平均器最多累加 128 次)
+#define ADC_MAX_OVERSAMPLING 128
+
+// ADC 结果格式
+typedef enum {
+  ADC_DATA_FORMAT_UNSIGNED = 0, // 12 位无符号右对齐 (默认)
+  // 有符号左对齐: 硬件减去中点并左移, 采样即为 Q15 (等于无符号码值
+  // 减 ADC_MIDPOINT 后乘 PRE_FFT_SCALE)
+  ADC_DATA_FORMAT_SIGNED_Q15 = 1
+} AdcDataFormat;
+
+// 12 位 ADC 中点码值
+#define ADC_MIDPOINT 2048
+// 预处理缩放因子 u12 -> u16 (4096 -> 65536), 等于有符号左对齐格式的左移量
+#define PRE_FFT_SCALE 16
+#define ADC_SIGNED_SHIFT 4
+// 有符号左对齐采样换算回 12 位无符号码值
+#define ADC_Q15_TO_CODE(x)                                                     \
+  ((uint16_t)(((int16_t)(x) >> ADC_SIGNED_SHIFT) + ADC_MIDPOINT))
+
+// 采样时钟来源
+typedef enum {
+  // ADC 连续转换, 采样率由采样窗口 (gADCCLKS) 决定, 按基波频率自动调整
+  SAMPLING_CLOCK_ADC = 0,
+  // 相干采样: 定时器事件逐点触发转换, 采样率按基波频率计算,
+  // 使一帧恰好包含整数个周期 (见 sampling.c)
+  SAMPLING_CLOCK_COHERENT = 1
+} SamplingClockMode;
+
+// ADC0 可选的外部输入通道数 (A0_0 ~ A0_7) 与默认输入通道
+#define ADC_INPUT_CHANNEL_COUNT 8
+#define ADC_DEFAULT_INPUT_CHANNEL 4
+
+// 电平触发的边沿
+typedef enum {
+  TRIGGER_EDGE_NONE = 0,    // 不触发, 启动后立即采集 (默认)
+  TRIGGER_EDGE_RISING = 1,  // 上升沿越过触发电平
+  TRIGGER_EDGE_FALLING = 2  // 下降沿越过触发电平
+} TriggerEdge;
+
+// 电平触发配置 (见 trigger.c)
+typedef struct {
+  TriggerEdge edge;
+  uint16_t level;       // 触发电平, 12 位码值 0 ~ 4095
+  uint8_t pre_percent;  // 触发点之前的采样占一帧的百分比 0 ~ 100
+  uint16_t timeout_ms;  // 超时未触发时直接采集一帧
+} TriggerConfig;
+
+// 采集配置
+typedef struct {
+  AdcDataFormat data_format;
+  SamplingClockMode clock_mode;
+  // 转换分辨率设置, 实际使用的分辨率见 get_adc_resolution
+  AdcResolution resolution;
+  // 硬件平均的过采样倍数 1/2/4/.../ADC_MAX_OVERSAMPLING, 1 为关闭;
+  // 只在 ADC 连续转换时生效 (见 get_oversampling_ratio)
+  uint8_t oversampling;
+  // 抽取前端的抽取倍数 1/2/4/.../DECIMATION_MAX_RATIO, 1 为关闭;
+  // 只在 ADC0 连续转换且未开启电平触发时生效 (见 decimate.h)
+  uint8_t decimation;
+  // ADC0/ADC1 交织采集: 两个 ADC 错开半个采样间隔交替转换同一输入,
+  // 采样率上限翻倍 (见 sampling.c 与 interleave.c)
+  bool interleaved;
+  // 电压/电流双通道采集: ADC0 采电压, ADC1 同时采电流, 与交织采集互斥
+  bool dual_channel;
+  // ADC0 的输入通道 0 ~ ADC_INPUT_CHANNEL_COUNT-1, 多通道扫描时由 scan.c 切换
+  uint8_t input_channel;
+  // 电平触发 (窗口比较器 + 预触发环形缓冲区), 只用于 ADC0 单独采集
+  TriggerConfig trigger;
+  // 等效时间采样每次重建累加的帧数, 0 为关闭 (见 ets.c)
+  uint8_t ets_frames;
+  // 短时频谱流的跳步 STFT_MIN_HOP ~ STFT_MAX_HOP, 0 为关闭; 只在 ADC0 连续
+  // 转换且未开启电平触发、抽取与等效时间采样时生效 (见 stft.h)
+  uint8_t stft_hop;
+  // 短时频谱流每次采集输出的行数, 0 表示一直输出到收到新命令
+  uint16_t stft_rows;
+} AcquisitionConfig;
+
+extern AcquisitionConfig gAcquisitionConfig;
+
+// 窗函数类型
+typedef enum {
+  WINDOW_HANN = 0,            // 汉宁窗 (默认)
+  WINDOW_BLACKMAN_HARRIS = 1, // 4 项 Blackman-Harris 窗, 旁瓣 -92dB
+  WINDOW_FLAT_TOP = 2,        // 平顶窗, 幅度误差最小
+  WINDOW_RECTANGULAR = 3,     // 矩形窗 (不加窗), 仅适合整周期采样
+  WINDOW_COUNT
+} WindowType;
+
+// 窗函数系数及修正常数
+typedef struct {
+  const q15_t *half_table;    // 前 SAMPLE_SIZE/2 点系数, 后半按对称取
+                              // 矩形窗为 NULL (系数全为 1)
+  uint16_t coherent_gain_q15; // 相干增益 sum(w)/N, Q15
+  uint16_t enbw_q12;          // 等效噪声带宽 (频点), Q12
+} WindowInfo;
 
-extern const float gHanningWindow[SAMPLE_SIZE];
-extern uint16_t gADCRealSamples[SAMPLE_SIZE + 50];
+extern const WindowInfo gWindows[WINDOW_COUNT];
+// FFT 旋转因子表, 四分之一周期正弦 (Q15)
+extern const q15_t gFftSinTable[SAMPLE_SIZE / 4 + 1];
+// 4 字节对齐, 以便作为 q31 幅度谱缓冲区复用
+extern uint16_t gADCRealSamples[SAMPLE_SIZE + ADC_DISCARD_SAMPLES]
+    __attribute__((aligned(4)));
 extern uint16_t *VALID_ADC_DATA;
+// 双通道采集时 ADC1 (电流通道) 的采集缓冲区, 不支持双通道时只占位
+extern uint16_t
+    gCurrentSamples[DUAL_CHANNEL_SUPPORTED ? SAMPLE_SIZE + ADC_DISCARD_SAMPLES
+                                           : 2] __attribute__((aligned(4)));
+extern uint16_t *VALID_CURRENT_DATA;
 extern uint16_t gADCCLKS;
 extern uint8_t gRxPacket[UART_PACKET_SIZE];
 
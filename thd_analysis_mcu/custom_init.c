@@ -1,5 +1,8 @@
 #include "custom_init.h"
 #include "consts.h"
+#include "interleave.h"
+#include "sampling.h"
+#include "trigger.h"
 #include "ti/driverlib/m0p/dl_core.h"
 #include "ti_msp_dl_config.h"
 #include "utils.h"
@@ -10,28 +13,270 @@ static const DL_ADC12_ClockConfig gADC12_0ClockConfig = {
     .freqRange = DL_ADC12_CLOCK_FREQ_RANGE_24_TO_32,
 };
 
-SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_0_init(uint16_t adcclks) {
-  DL_ADC12_setClockConfig(ADC12_0_INST,
-                          (DL_ADC12_ClockConfig *)&gADC12_0ClockConfig);
+// ADC0 输入通道号到 DriverLib 通道选择的映射
+static const uint32_t gADC12_0InputChannels[ADC_INPUT_CHANNEL_COUNT] = {
+    DL_ADC12_INPUT_CHAN_0, DL_ADC12_INPUT_CHAN_1, DL_ADC12_INPUT_CHAN_2,
+    DL_ADC12_INPUT_CHAN_3, DL_ADC12_INPUT_CHAN_4, DL_ADC12_INPUT_CHAN_5,
+    DL_ADC12_INPUT_CHAN_6, DL_ADC12_INPUT_CHAN_7,
+};
+
+// 硬件平均的累加次数与除数, 按 log2 索引 (1 为不平均)
+static const uint32_t gHwAvgNumAcc[] = {
+    0,
+    DL_ADC12_HW_AVG_NUM_ACC_2,
+    DL_ADC12_HW_AVG_NUM_ACC_4,
+    DL_ADC12_HW_AVG_NUM_ACC_8,
+    DL_ADC12_HW_AVG_NUM_ACC_16,
+    DL_ADC12_HW_AVG_NUM_ACC_32,
+    DL_ADC12_HW_AVG_NUM_ACC_64,
+    DL_ADC12_HW_AVG_NUM_ACC_128,
+};
+static const uint32_t gHwAvgDen[] = {
+    DL_ADC12_HW_AVG_DEN_DIV_BY_1,  DL_ADC12_HW_AVG_DEN_DIV_BY_2,
+    DL_ADC12_HW_AVG_DEN_DIV_BY_4,  DL_ADC12_HW_AVG_DEN_DIV_BY_8,
+    DL_ADC12_HW_AVG_DEN_DIV_BY_16, DL_ADC12_HW_AVG_DEN_DIV_BY_32,
+    DL_ADC12_HW_AVG_DEN_DIV_BY_64, DL_ADC12_HW_AVG_DEN_DIV_BY_128,
+};
+_Static_assert(sizeof(gHwAvgNumAcc) / sizeof(gHwAvgNumAcc[0]) ==
+                   sizeof(gHwAvgDen) / sizeof(gHwAvgDen[0]),
+               "averaging tables must match");
+
+static uint32_t log2_u32(uint32_t v) {
+  uint32_t n = 0;
+  while (v > 1) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+}
+
+// ADC1 是否参与采集 (交织或双通道)
+static bool adc1_in_use(void) {
+  return gAcquisitionConfig.interleaved || gAcquisitionConfig.dual_channel;
+}
+
+/**
+ * @brief 按当前采集配置初始化一个 ADC
+ * @param trigger_channel 定时器触发时订阅的事件通道
+ * @param frame_interrupt 是否以该 ADC 的 DMA 完成中断作为一帧结束
+ * @param window_comp 是否开启窗口比较器 (电平触发), 阈值与中断由 trigger.c 设置
+ */
+static void init_adc(ADC12_Regs *adc, uint32_t input_chan, uint16_t adcclks,
+                     bool timer_triggered, uint8_t trigger_channel,
+                     bool frame_interrupt, bool window_comp) {
+  DL_ADC12_setClockConfig(adc, (DL_ADC12_ClockConfig *)&gADC12_0ClockConfig);
+  // 硬件平均只用于连续转换: 每点由 ratio 次转换累加, 除以 ratio / 2^extra,
+  // 结果比转换分辨率多 extra 位, 且只能为无符号格式
+  const uint32_t ratio = timer_triggered ? 1 : gAcquisitionConfig.oversampling;
+  const uint32_t ratio_log2 = log2_u32(ratio);
+  const bool averaging = ratio > 1;
+  if (averaging) {
+    DL_ADC12_configHwAverage(
+        adc, gHwAvgNumAcc[ratio_log2],
+        gHwAvgDen[ratio_log2 - oversampling_extra_bits(ratio)]);
+  }
+  uint32_t resolution;
+  switch (get_adc_resolution()) {
+  case ADC_RESOLUTION_10BIT:
+    resolution = DL_ADC12_SAMP_CONV_RES_10_BIT;
+    break;
+  case ADC_RESOLUTION_8BIT:
+    resolution = DL_ADC12_SAMP_CONV_RES_8_BIT;
+    break;
+  default:
+    resolution = DL_ADC12_SAMP_CONV_RES_12_BIT;
+    break;
+  }
+  // 定时器触发时每个事件只转换一次, 否则软件启动后连续转换
   DL_ADC12_initSingleSample(
-      ADC12_0_INST, DL_ADC12_REPEAT_MODE_ENABLED, DL_ADC12_SAMPLING_SOURCE_AUTO,
-      DL_ADC12_TRIG_SRC_SOFTWARE, DL_ADC12_SAMP_CONV_RES_12_BIT,
-      DL_ADC12_SAMP_CONV_DATA_FORMAT_UNSIGNED);
+      adc, DL_ADC12_REPEAT_MODE_ENABLED, DL_ADC12_SAMPLING_SOURCE_AUTO,
+      timer_triggered ? DL_ADC12_TRIG_SRC_EVENT : DL_ADC12_TRIG_SRC_SOFTWARE,
+      resolution,
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15 &&
+              !averaging
+          ? DL_ADC12_SAMP_CONV_DATA_FORMAT_SIGNED
+          : DL_ADC12_SAMP_CONV_DATA_FORMAT_UNSIGNED);
   DL_ADC12_configConversionMem(
-      ADC12_0_INST, ADC12_0_ADCMEM_0, DL_ADC12_INPUT_CHAN_4,
-      DL_ADC12_REFERENCE_VOLTAGE_VDDA, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
-      DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
-      DL_ADC12_TRIGGER_MODE_AUTO_NEXT, DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
-  DL_ADC12_enableFIFO(ADC12_0_INST);
-  DL_ADC12_setPowerDownMode(ADC12_0_INST, DL_ADC12_POWER_DOWN_MODE_MANUAL);
-  DL_ADC12_setSampleTime0(ADC12_0_INST, adcclks);
-  DL_ADC12_enableDMA(ADC12_0_INST);
-  DL_ADC12_setDMASamplesCnt(ADC12_0_INST, 6);
-  DL_ADC12_enableDMATrigger(ADC12_0_INST, (DL_ADC12_DMA_MEM10_RESULT_LOADED));
+      adc, DL_ADC12_MEM_IDX_0, input_chan, DL_ADC12_REFERENCE_VOLTAGE_VDDA,
+      DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+      averaging ? DL_ADC12_AVERAGING_MODE_ENABLED
+                : DL_ADC12_AVERAGING_MODE_DISABLED,
+      DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+      timer_triggered ? DL_ADC12_TRIGGER_MODE_TRIGGER_NEXT
+                      : DL_ADC12_TRIGGER_MODE_AUTO_NEXT,
+      window_comp ? DL_ADC12_WINDOWS_COMP_MODE_ENABLED
+                  : DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
+  if (timer_triggered) {
+    DL_ADC12_setSubscriberChanID(adc, trigger_channel);
+  }
+  DL_ADC12_setPowerDownMode(adc, DL_ADC12_POWER_DOWN_MODE_MANUAL);
+  DL_ADC12_setSampleTime0(adc, adcclks);
+  DL_ADC12_enableDMA(adc);
+  DL_ADC12_disableDMATrigger(adc, (DL_ADC12_DMA_MEM0_RESULT_LOADED |
+                                   DL_ADC12_DMA_MEM10_RESULT_LOADED));
+  if (gAcquisitionConfig.interleaved) {
+    // 两路隔点写入同一帧, 每个结果单独搬运 (半字)
+    DL_ADC12_disableFIFO(adc);
+    DL_ADC12_setDMASamplesCnt(adc, 1);
+    DL_ADC12_enableDMATrigger(adc, (DL_ADC12_DMA_MEM0_RESULT_LOADED));
+  } else {
+    DL_ADC12_enableFIFO(adc);
+    DL_ADC12_setDMASamplesCnt(adc, 6);
+    DL_ADC12_enableDMATrigger(adc, (DL_ADC12_DMA_MEM10_RESULT_LOADED));
+  }
   /* Enable ADC12 interrupt */
-  DL_ADC12_clearInterruptStatus(ADC12_0_INST, (DL_ADC12_INTERRUPT_DMA_DONE));
-  DL_ADC12_enableInterrupt(ADC12_0_INST, (DL_ADC12_INTERRUPT_DMA_DONE));
-  DL_ADC12_enableConversions(ADC12_0_INST);
+  DL_ADC12_clearInterruptStatus(adc, (DL_ADC12_INTERRUPT_DMA_DONE));
+  if (frame_interrupt) {
+    DL_ADC12_enableInterrupt(adc, (DL_ADC12_INTERRUPT_DMA_DONE));
+  } else {
+    DL_ADC12_disableInterrupt(adc, (DL_ADC12_INTERRUPT_DMA_DONE));
+  }
+  DL_ADC12_enableConversions(adc);
+}
+
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_0_init(uint16_t adcclks,
+                                                 bool timer_triggered) {
+  // 交织时 ADC1 的采样晚半个间隔, 以其 DMA 完成作为一帧结束;
+  // 双通道时两路同时触发, 同样以 ADC1 为准
+  init_adc(ADC12_0_INST,
+           gADC12_0InputChannels[gAcquisitionConfig.input_channel], adcclks,
+           timer_triggered, ADC0_TRIGGER_CHANNEL, !adc1_in_use(),
+           is_trigger_enabled());
+}
+
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_1_init(uint16_t adcclks) {
+  // ADC1 不在 syscfg 中, 首次使用时上电
+  if (!DL_ADC12_isPowerEnabled(ADC12_1_INST)) {
+    DL_ADC12_reset(ADC12_1_INST);
+    DL_ADC12_enablePower(ADC12_1_INST);
+    delay_cycles(POWER_STARTUP_DELAY);
+  }
+  init_adc(ADC12_1_INST,
+           gAcquisitionConfig.dual_channel ? ADC12_1_CURRENT_CHAN
+                                           : ADC12_1_INPUT_CHAN,
+           adcclks, true, ADC1_TRIGGER_CHANNEL, true, false);
+}
+
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC_DMA_init(void) {
+  DL_DMA_disableChannel(DMA, DMA_CH0_CHAN_ID);
+  DL_DMA_disableChannel(DMA, DMA_CH2_CHAN_ID);
+  if (!gAcquisitionConfig.interleaved) {
+    // FIFO 中两个 12 位结果拼成一个字, 一次搬运两点
+    DL_DMA_Config config = {
+        .trigger = DMA_ADC0_EVT_GEN_BD_TRIG,
+        .triggerType = DL_DMA_TRIGGER_TYPE_EXTERNAL,
+        .transferMode = DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE,
+        .extendedMode = DL_DMA_NORMAL_MODE,
+        .destWidth = DL_DMA_WIDTH_WORD,
+        .srcWidth = DL_DMA_WIDTH_WORD,
+        .destIncrement = DL_DMA_ADDR_INCREMENT,
+        .srcIncrement = DL_DMA_ADDR_UNCHANGED,
+    };
+    DL_DMA_initChannel(DMA, DMA_CH0_CHAN_ID, &config);
+    DL_DMA_setSrcAddr(DMA, DMA_CH0_CHAN_ID,
+                      (uint32_t)DL_ADC12_getFIFOAddress(ADC12_0_INST));
+    DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)gADCRealSamples);
+    DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID,
+                           ((SAMPLE_SIZE + ADC_DISCARD_SAMPLES) >> 1));
+    DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+
+    if (gAcquisitionConfig.dual_channel) {
+      // 双通道: ADC1 的电流采样以同样方式写入电流缓冲区
+      config.trigger = DMA_ADC1_EVT_GEN_BD_TRIG;
+      DL_DMA_initChannel(DMA, DMA_CH2_CHAN_ID, &config);
+      DL_DMA_setSrcAddr(DMA, DMA_CH2_CHAN_ID,
+                        (uint32_t)DL_ADC12_getFIFOAddress(ADC12_1_INST));
+      DL_DMA_setDestAddr(DMA, DMA_CH2_CHAN_ID, (uint32_t)gCurrentSamples);
+      DL_DMA_setTransferSize(DMA, DMA_CH2_CHAN_ID,
+                             ((SAMPLE_SIZE + ADC_DISCARD_SAMPLES) >> 1));
+      DL_DMA_enableChannel(DMA, DMA_CH2_CHAN_ID);
+    }
+    return;
+  }
+
+  // 交织: 每个结果一个半字, 目的地址步进 2 点, ADC0 写偶数点, ADC1 写奇数点
+  DL_DMA_Config config = {
+      .trigger = DMA_ADC0_EVT_GEN_BD_TRIG,
+      .triggerType = DL_DMA_TRIGGER_TYPE_EXTERNAL,
+      .transferMode = DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE,
+      .extendedMode = DL_DMA_NORMAL_MODE,
+      .destWidth = DL_DMA_WIDTH_HALF_WORD,
+      .srcWidth = DL_DMA_WIDTH_HALF_WORD,
+      .destIncrement = DL_DMA_ADDR_STRIDE_2,
+      .srcIncrement = DL_DMA_ADDR_UNCHANGED,
+  };
+  const uint32_t per_adc =
+      (SAMPLE_SIZE + ADC_DISCARD_SAMPLES) / INTERLEAVE_ADC_COUNT;
+  DL_DMA_initChannel(DMA, DMA_CH0_CHAN_ID, &config);
+  DL_DMA_setSrcAddr(DMA, DMA_CH0_CHAN_ID,
+                    (uint32_t)DL_ADC12_getMemResultAddress(ADC12_0_INST,
+                                                           ADC12_0_ADCMEM_0));
+  DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)&gADCRealSamples[0]);
+  DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, per_adc);
+  DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+
+  config.trigger = DMA_ADC1_EVT_GEN_BD_TRIG;
+  DL_DMA_initChannel(DMA, DMA_CH2_CHAN_ID, &config);
+  DL_DMA_setSrcAddr(DMA, DMA_CH2_CHAN_ID,
+                    (uint32_t)DL_ADC12_getMemResultAddress(ADC12_1_INST,
+                                                           ADC12_1_ADCMEM_0));
+  DL_DMA_setDestAddr(DMA, DMA_CH2_CHAN_ID, (uint32_t)&gADCRealSamples[1]);
+  DL_DMA_setTransferSize(DMA, DMA_CH2_CHAN_ID, per_adc);
+  DL_DMA_enableChannel(DMA, DMA_CH2_CHAN_ID);
+}
+
+static const DL_TimerG_ClockConfig gSamplingTimerClockConfig = {
+    .clockSel = DL_TIMER_CLOCK_BUSCLK,
+    .divideRatio = DL_TIMER_CLOCK_DIVIDE_1,
+    .prescale = 0,
+};
+
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_SAMPLING_TIMER_init(
+    uint16_t prescale, uint16_t period, SamplingTriggerMode mode) {
+  // 定时器不在 syscfg 中, 首次使用时上电
+  if (!DL_TimerG_isPowerEnabled(SAMPLING_TIMER_INST)) {
+    DL_TimerG_reset(SAMPLING_TIMER_INST);
+    DL_TimerG_enablePower(SAMPLING_TIMER_INST);
+    delay_cycles(POWER_STARTUP_DELAY);
+  }
+  DL_TimerG_stopCounter(SAMPLING_TIMER_INST);
+
+  DL_TimerG_ClockConfig clock_config = gSamplingTimerClockConfig;
+  clock_config.prescale = (uint8_t)(prescale - 1);
+  DL_TimerG_setClockConfig(SAMPLING_TIMER_INST, &clock_config);
+
+  // 向下周期计数, 每次过零发布一个事件触发 ADC0 转换
+  const uint32_t adc_count =
+      mode == SAMPLING_TRIGGER_INTERLEAVED ? INTERLEAVE_ADC_COUNT : 1;
+  DL_TimerG_TimerConfig timer_config = {
+      .timerMode = DL_TIMER_TIMER_MODE_PERIODIC,
+      .period = (uint32_t)period * adc_count - 1,
+      .startTimer = DL_TIMER_STOP,
+  };
+  DL_TimerG_initTimerMode(SAMPLING_TIMER_INST, &timer_config);
+  DL_TimerG_enableEvent(SAMPLING_TIMER_INST, DL_TIMERG_EVENT_ROUTE_1,
+                        DL_TIMERG_EVENT_ZERO_EVENT);
+  DL_TimerG_setPublisherChanID(SAMPLING_TIMER_INST, DL_TIMERG_PUBLISHER_INDEX_0,
+                               ADC0_TRIGGER_CHANNEL);
+  DL_TimerG_disableEvent(SAMPLING_TIMER_INST, DL_TIMERG_EVENT_ROUTE_2,
+                         DL_TIMERG_EVENT_CC0_DN_EVENT |
+                             DL_TIMERG_EVENT_ZERO_EVENT);
+  if (mode == SAMPLING_TRIGGER_INTERLEAVED) {
+    // 计数减到 period (过零后 period 个时钟) 时触发 ADC1, 与 ADC0 错开半个间隔
+    DL_TimerG_setCaptureCompareValue(SAMPLING_TIMER_INST, period,
+                                     DL_TIMER_CC_0_INDEX);
+    DL_TimerG_enableEvent(SAMPLING_TIMER_INST, DL_TIMERG_EVENT_ROUTE_2,
+                          DL_TIMERG_EVENT_CC0_DN_EVENT);
+  } else if (mode == SAMPLING_TRIGGER_SIMULTANEOUS) {
+    // 同一个过零事件经第二路发布给 ADC1, 电压/电流同时采样
+    DL_TimerG_enableEvent(SAMPLING_TIMER_INST, DL_TIMERG_EVENT_ROUTE_2,
+                          DL_TIMERG_EVENT_ZERO_EVENT);
+  }
+  if (mode != SAMPLING_TRIGGER_ADC0) {
+    DL_TimerG_setPublisherChanID(SAMPLING_TIMER_INST,
+                                 DL_TIMERG_PUBLISHER_INDEX_1,
+                                 ADC1_TRIGGER_CHANNEL);
+  }
 }
 
 SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_init(uint16_t adcclks) {
@@ -40,6 +285,7 @@ SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_init(uint16_t adcclks) {
   /* Module-Specific Initializations*/
   SYSCFG_DL_SYSCTL_init();
   SYSCFG_DL_UART_0_init();
-  CUSTOM_SYSCFG_DL_ADC12_0_init(adcclks);
+  CUSTOM_SYSCFG_DL_ADC12_0_init(adcclks, false);
   SYSCFG_DL_DMA_init();
+  CUSTOM_SYSCFG_DL_ADC_DMA_init();
 }
@@ -2,7 +2,40 @@
 #define CUSTOM_INIT
 #include "ti/driverlib/m0p/dl_core.h"
 #include "ti_msp_dl_config.h"
+#include <stdbool.h>
 
-SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_0_init(uint16_t adcclks);
+// 相干采样、交织与双通道采集时逐点触发 ADC 转换的定时器
+#define SAMPLING_TIMER_INST TIMG0
+
+// 定时器触发哪些 ADC
+typedef enum {
+  SAMPLING_TRIGGER_ADC0 = 0,        // 只触发 ADC0
+  SAMPLING_TRIGGER_INTERLEAVED = 1, // ADC0/ADC1 错开半个间隔轮流触发
+  SAMPLING_TRIGGER_SIMULTANEOUS = 2 // ADC0/ADC1 同时触发 (双通道采集)
+} SamplingTriggerMode;
+
+// 交织/双通道采集的第二个 ADC 及其 DMA 通道 (不在 syscfg 中)
+#define ADC12_1_INST ADC1
+#define ADC12_1_INST_INT_IRQN ADC1_INT_IRQn
+#define ADC12_1_INST_IRQHandler ADC1_IRQHandler
+#define ADC12_1_ADCMEM_0 DL_ADC12_MEM_IDX_0
+// ADC1 的输入通道, 硬件上需与 ADC0 的通道 4 接同一信号
+#define ADC12_1_INPUT_CHAN DL_ADC12_INPUT_CHAN_4
+// 双通道采集时 ADC1 的输入通道, 接电流信号 (电流互感器/采样电阻调理后的输出)
+#define ADC12_1_CURRENT_CHAN DL_ADC12_INPUT_CHAN_2
+#define DMA_CH2_CHAN_ID 2
+
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_0_init(uint16_t adcclks,
+                                                 bool timer_triggered);
+// 交织采集时 ADC1 由定时器半周期事件触发, 双通道时与 ADC0 同时触发,
+// 其 DMA 完成表示一帧采完
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC12_1_init(uint16_t adcclks);
+// 配置 ADC 结果的 DMA: 单 ADC 时 FIFO 成对搬运, 交织时两路隔点写入同一帧,
+// 双通道时两路各自成对搬运到电压/电流缓冲区
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_ADC_DMA_init(void);
+// 每 prescale * period 个时钟触发一次采样; 交织时两个 ADC 轮流触发,
+// 各自的触发间隔为 2 * period
+SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_SAMPLING_TIMER_init(
+    uint16_t prescale, uint16_t period, SamplingTriggerMode mode);
 SYSCONFIG_WEAK void CUSTOM_SYSCFG_DL_init(uint16_t adcclks);
-#endif
\ No newline at end of file
+#endif
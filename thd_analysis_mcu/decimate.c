@@ -0,0 +1,215 @@
+#include "decimate.h"
+#include "sampling.h"
+#include "custom_init.h"
+#include "ti_msp_dl_config.h"
+#include <math.h>
+
+#define RING_WORDS (DECIMATION_RING_SAMPLES / 2)
+_Static_assert((DECIMATION_RING_SAMPLES & (DECIMATION_RING_SAMPLES - 1)) == 0,
+               "DECIMATION_RING_SAMPLES must be a power of two");
+#if DECIMATION_SUPPORTED
+_Static_assert(DECIMATION_RING_SAMPLES <=
+                   sizeof(gCurrentSamples) / sizeof(gCurrentSamples[0]),
+               "decimation ring must fit in the current-channel buffer");
+#endif
+
+// CIC 积分器与梳状级的延迟单元, 按 32 位回绕运算 (输出范围在 32 位以内时,
+// 积分器的溢出在梳状级中抵消)
+static uint32_t integrator[CIC_ORDER];
+static uint32_t comb_delay[CIC_ORDER];
+// 距下一个输出还需的输入点数
+static uint32_t phase = 0;
+// 本帧开头尚需丢弃的输入点数 (ADC 启动) 与输出点数 (滤波器建立)
+static uint32_t skip_inputs = 0;
+static uint32_t skip_outputs = 0;
+// 已处理的输入点数与已输出的点数
+static uint32_t consumed = 0;
+static uint32_t outputs = 0;
+static uint32_t restarts = 0;
+static uint32_t overruns = 0;
+// 环形缓冲区写满的圈数
+static volatile uint32_t laps = 0;
+static bool running = false;
+static bool decimated = false;
+static bool ring_in_use = false;
+
+// 本帧的换算参数, 由 decimation_begin 按当前格式与分辨率确定
+static uint32_t ratio = 1;
+static bool raw_signed = false;
+static bool out_signed = false;
+static uint32_t raw_shift = 0;   // 无符号原始采样换算到 12 位刻度的左移
+static int32_t raw_offset = 0;   // 无符号原始采样的中点 (含硬件平均多出的位)
+static uint32_t out_shift = 0;   // CIC 输出右移位数
+static int32_t out_round = 0;
+static uint32_t out_q15_scale = 0; // 有符号输出换算到 Q15 的倍数
+
+static uint32_t log2_u32(uint32_t v) {
+  uint32_t n = 0;
+  while (v > 1) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+}
+
+// 清空滤波器, 本帧从头开始输出
+static void restart_frame(void) {
+  for (uint32_t i = 0; i < CIC_ORDER; i++) {
+    integrator[i] = 0;
+    comb_delay[i] = 0;
+  }
+  phase = ratio;
+  skip_outputs = CIC_ORDER;
+  outputs = 0;
+}
+
+void decimation_begin(bool enable) {
+  running = false;
+  decimated = enable;
+  if (!enable) {
+    if (ring_in_use) {
+      // 恢复为一帧直接写入采集缓冲区
+      CUSTOM_SYSCFG_DL_ADC_DMA_init();
+      ring_in_use = false;
+    }
+    return;
+  }
+
+  ratio = get_decimation_ratio();
+  // 输入: 有符号原始采样取 12 位码值; 无符号原始采样保留硬件平均多出的位
+  raw_signed = is_raw_data_signed();
+  const uint32_t in_extra =
+      raw_signed ? 0 : oversampling_extra_bits(get_oversampling_ratio());
+  raw_shift = raw_signed ? 0 : ADC_RESOLUTION_SHIFT(get_adc_resolution());
+  raw_offset = ADC_MIDPOINT << in_extra;
+  // 输出: 有符号 Q15 格式保留过采样 (硬件平均与抽取合计) 多出的位,
+  // 无符号格式四舍五入到 12 位码值
+  out_signed = gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  uint32_t out_extra =
+      out_signed ? oversampling_extra_bits(get_oversampling_ratio() * ratio)
+                 : 0;
+  if (out_extra > ADC_SIGNED_SHIFT) {
+    out_extra = ADC_SIGNED_SHIFT;
+  }
+  out_shift = CIC_ORDER * log2_u32(ratio) + in_extra - out_extra;
+  out_round = out_shift != 0 ? (int32_t)(1U << (out_shift - 1)) : 0;
+  out_q15_scale = 1U << (ADC_SIGNED_SHIFT - out_extra);
+
+  restart_frame();
+  consumed = 0;
+  restarts = 0;
+  skip_inputs = ADC_DISCARD_SAMPLES;
+  laps = 0;
+
+  DL_DMA_disableChannel(DMA, DMA_CH0_CHAN_ID);
+  DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)gCurrentSamples);
+  DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, RING_WORDS);
+  DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+  ring_in_use = true;
+  running = true;
+}
+
+bool decimation_running(void) { return running; }
+
+bool is_frame_decimated(void) { return decimated; }
+
+void decimation_on_dma_done(void) { laps++; }
+
+uint32_t decimation_overruns(void) { return overruns; }
+
+/**
+ * @brief 一段连续的原始采样送入 CIC 滤波器
+ * @return true 表示一帧已输出完
+ */
+static bool filter_block(const uint16_t *samples, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    int32_t x = raw_signed
+                    ? ((int16_t)samples[i] >> ADC_SIGNED_SHIFT)
+                    : (((int32_t)samples[i] << raw_shift) - raw_offset);
+    integrator[0] += (uint32_t)x;
+    for (uint32_t k = 1; k < CIC_ORDER; k++) {
+      integrator[k] += integrator[k - 1];
+    }
+    if (--phase != 0) {
+      continue;
+    }
+    phase = ratio;
+
+    uint32_t y = integrator[CIC_ORDER - 1];
+    for (uint32_t k = 0; k < CIC_ORDER; k++) {
+      uint32_t delayed = comb_delay[k];
+      comb_delay[k] = y;
+      y -= delayed;
+    }
+    if (skip_outputs != 0) {
+      skip_outputs--;
+      continue;
+    }
+
+    int32_t v = ((int32_t)y + out_round) >> out_shift;
+    VALID_ADC_DATA[outputs] =
+        out_signed ? (uint16_t)(int16_t)(v * (int32_t)out_q15_scale)
+                   : (uint16_t)(v + ADC_MIDPOINT);
+    if (++outputs == SAMPLE_SIZE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool decimation_poll(void) {
+  if (!running) {
+    return false;
+  }
+  // 读取剩余字数期间若恰好写满一圈, 重新读取
+  uint32_t lap_count;
+  uint32_t remaining;
+  do {
+    lap_count = laps;
+    remaining = DL_DMA_getTransferSize(DMA, DMA_CH0_CHAN_ID);
+  } while (lap_count != laps);
+  // DMA 已重装而完成中断尚未执行时, 算出的位置会落后于已处理的位置
+  uint32_t written = lap_count * DECIMATION_RING_SAMPLES +
+                     (RING_WORDS - remaining) * 2;
+  if ((int32_t)(written - consumed) <= 0) {
+    return false;
+  }
+  if (written - consumed > DECIMATION_RING_SAMPLES) {
+    // 未处理的数据已被覆盖: 本帧重新开始, 次数过多时接受缺口继续输出
+    overruns++;
+    if (restarts < DECIMATION_MAX_RESTARTS) {
+      restarts++;
+      restart_frame();
+    }
+    consumed = written - DECIMATION_RING_SAMPLES / 2;
+  }
+
+  if (skip_inputs != 0) {
+    uint32_t n = written - consumed;
+    n = n < skip_inputs ? n : skip_inputs;
+    skip_inputs -= n;
+    consumed += n;
+  }
+  while (consumed != written) {
+    // 每次处理到环形缓冲区末尾为止
+    uint32_t pos = consumed & (DECIMATION_RING_SAMPLES - 1);
+    uint32_t n = written - consumed;
+    if (n > DECIMATION_RING_SAMPLES - pos) {
+      n = DECIMATION_RING_SAMPLES - pos;
+    }
+    consumed += n;
+    if (filter_block(&gCurrentSamples[pos], n)) {
+      running = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+double decimation_gain(double x) {
+  const uint32_t r = get_decimation_ratio();
+  if (r <= 1 || x <= 0) {
+    return 1.0;
+  }
+  return pow(sin(PI * x) / (r * sin(PI * x / r)), CIC_ORDER);
+}
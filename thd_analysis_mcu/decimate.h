@@ -0,0 +1,63 @@
+#ifndef DECIMATE_H
+#define DECIMATE_H
+
+#include "consts.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 抽取前端: ADC 以 R 倍的采样率连续转换, DMA 循环写入一个小的环形缓冲区,
+// 主循环按 DMA 进度边采集边用 CIC 滤波器抽取, 输出低采样率的一帧.
+// 低频信号不必把采样窗口拉得很长, 抽取前的滤波同时抑制混叠和宽带噪声
+
+// 环形缓冲区借用电流通道的采集缓冲区 (抽取只用于 ADC0 单独采集,
+// 与双通道采集互斥); 大点数时没有这块缓冲区, 不支持抽取
+#define DECIMATION_SUPPORTED DUAL_CHANNEL_SUPPORTED
+// 环形缓冲区点数 (2 的幂), 主循环两次处理之间 DMA 写入的点数不能超过它
+#define DECIMATION_RING_SAMPLES SAMPLE_SIZE
+// 最大抽取倍数: 12 位输入 (硬件平均时最多 15 位) 经 CIC 增益 R^3 后
+// 须在 32 位累加器内不溢出
+#define DECIMATION_MAX_RATIO 32
+// CIC 滤波器阶数 (积分/梳状级数)
+#define CIC_ORDER 3
+// 抽取前 (硬件平均后) 的输入采样率上限, 保证主循环来得及处理
+#define DECIMATION_MAX_INPUT_RATE_HZ 200000.0
+// 一帧中因来不及处理而重新开始的次数上限, 超过后接受数据缺口,
+// 避免主循环一直停在采样状态
+#define DECIMATION_MAX_RESTARTS 2
+
+/**
+ * @brief 开始一帧采集时调用
+ * @param enable 本帧是否抽取; true 时 DMA 改为循环写入环形缓冲区,
+ * false 时若上一帧在抽取则恢复为直接写入采集缓冲区
+ * @note 在启动 ADC 转换之前调用
+ */
+void decimation_begin(bool enable);
+
+// 本帧是否在抽取且尚未完成, 此时主循环不应休眠
+bool decimation_running(void);
+
+// 最近一帧是否为抽取的输出 (已是设定的格式, 不再需要归一化)
+bool is_frame_decimated(void);
+
+/**
+ * @brief 环形缓冲区写满一圈, 在 ADC0 的 DMA 完成中断中调用
+ */
+void decimation_on_dma_done(void);
+
+/**
+ * @brief 抽取 DMA 新写入的采样, 输出写入 VALID_ADC_DATA
+ * @return true 表示一帧 SAMPLE_SIZE 点已输出, 应停止采集并分析
+ * @note 在主循环的采样状态下反复调用
+ */
+bool decimation_poll(void);
+
+/**
+ * @brief CIC 滤波器在某频率处的幅度响应 (直流为 1)
+ * @param x 频率与抽取后采样率之比
+ */
+double decimation_gain(double x);
+
+// 因来不及处理而丢失数据的累计次数
+uint32_t decimation_overruns(void);
+
+#endif /* DECIMATE_H */
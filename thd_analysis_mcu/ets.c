@@ -0,0 +1,214 @@
+#include "ets.h"
+#include "capture_stats.h"
+#include "fft.h"
+#include "sampling.h"
+#include <math.h>
+#include <string.h>
+
+#define ETS_PERIOD_LOG2 (SAMPLE_SIZE_LOG2 - 2)
+_Static_assert(ETS_PERIOD_POINTS == (1UL << ETS_PERIOD_LOG2),
+               "ETS_PERIOD_LOG2 must match ETS_TILE_PERIODS");
+
+// 相位测量把一帧分成前后两半, 由两半的相位差修正基波频率
+#define HALF_LEN (SAMPLE_SIZE / 2)
+#define Q32_ONE 4294967296.0
+
+// 一个基波周期内各相位区间的采样和与点数
+static int32_t bin_sum[ETS_PERIOD_POINTS];
+static uint16_t bin_count[ETS_PERIOD_POINTS];
+static uint8_t frames = 0;
+// 本轮第一帧的基波幅度, 后续帧明显变小说明信号已改变
+static double first_amplitude = 0;
+// 基波频率估计 (Hz), 0 表示没有可用的估计
+static double f0_hz = 0;
+static bool reconstructed = false;
+
+// 归一化后的采样换算成 12 位码值
+static int32_t sample_code(uint16_t raw) {
+  return gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15
+             ? ADC_Q15_TO_CODE(raw)
+             : raw;
+}
+
+// 12 位码值换算回当前格式的采样
+static uint16_t code_to_sample(int32_t code) {
+  if (gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15) {
+    return (uint16_t)(int16_t)((code - ADC_MIDPOINT) * PRE_FFT_SCALE);
+  }
+  return (uint16_t)code;
+}
+
+static void clear_bins(void) {
+  memset(bin_sum, 0, sizeof(bin_sum));
+  memset(bin_count, 0, sizeof(bin_count));
+  frames = 0;
+}
+
+bool is_ets_enabled(void) { return gAcquisitionConfig.ets_frames != 0; }
+
+/**
+ * @brief 标记送去分析的是原始帧还是重建帧
+ * @note 两者的采样率不同, 切换时丢弃频谱平均, 不混合不同频率分辨率的频谱
+ */
+static bool emit_frame(bool rebuilt) {
+  if (rebuilt != reconstructed) {
+    reset_spectrum_average();
+  }
+  reconstructed = rebuilt;
+  return true;
+}
+
+void ets_reset(void) {
+  clear_bins();
+  f0_hz = 0;
+  emit_frame(false);
+}
+
+bool ets_frame_reconstructed(void) { return reconstructed; }
+
+double ets_sample_rate_hz(void) { return f0_hz * ETS_PERIOD_POINTS; }
+
+uint8_t ets_accumulated_frames(void) { return frames; }
+
+void ets_update_from_result(const AnalysisResult *result) {
+  if (reconstructed) {
+    return;
+  }
+  bool valid = result->waveform != WAVEFORM_NONE &&
+               result->waveform != WAVEFORM_DC &&
+               result->fundamental_freq_mhz != 0;
+  f0_hz = valid ? result->fundamental_freq_mhz / 1000.0 : 0;
+}
+
+/**
+ * @brief 半帧在参考频率上的单频点 DFT (汉宁窗)
+ * @param begin 半帧在一帧中的起点, 参考相位从一帧的第 0 点算起
+ * @param step_q32 参考频率 (周期/采样, Q32)
+ * @param magnitude 输出幅度 (码值 * 2^30 * sum(w) / 2)
+ * @return 基波相对参考余弦的相位 (rad)
+ */
+static double half_phase(const uint16_t *samples, uint32_t begin,
+                         int32_t mean, uint32_t step_q32, double *magnitude) {
+  const q15_t *hann = gWindows[WINDOW_HANN].half_table;
+  int64_t re = 0;
+  int64_t im = 0;
+  uint32_t phase = begin * step_q32;
+  for (uint32_t m = 0; m < HALF_LEN; m++, phase += step_q32) {
+    // HALF_LEN 点汉宁窗取整帧窗表的偶数点, 按中心对称
+    uint32_t k = m < HALF_LEN / 2 ? m : HALF_LEN - 1 - m;
+    int32_t v = (sample_code(samples[begin + m]) - mean) * hann[2 * k];
+    int32_t c, s;
+    fft_sin_cos_q15((phase + (1U << (31 - SAMPLE_SIZE_LOG2))) >>
+                        (32 - SAMPLE_SIZE_LOG2),
+                    &c, &s);
+    re += (int64_t)v * c;
+    im -= (int64_t)v * s;
+  }
+  *magnitude = hypot((double)re, (double)im);
+  return atan2((double)im, (double)re);
+}
+
+/**
+ * @brief 各相位区间取平均, 空区间由两侧有数据的区间线性插值 (按周期回绕),
+ * 结果以码值存回 bin_sum
+ */
+static void average_bins(void) {
+  uint32_t first = ETS_PERIOD_POINTS;
+  for (uint32_t b = 0; b < ETS_PERIOD_POINTS; b++) {
+    if (bin_count[b] != 0) {
+      bin_sum[b] = (bin_sum[b] + bin_count[b] / 2) / bin_count[b];
+      if (first == ETS_PERIOD_POINTS) {
+        first = b;
+      }
+    }
+  }
+  if (first == ETS_PERIOD_POINTS) {
+    return;
+  }
+
+  uint32_t prev = first;
+  for (uint32_t i = 1; i <= ETS_PERIOD_POINTS; i++) {
+    uint32_t b = (first + i) & (ETS_PERIOD_POINTS - 1);
+    if (bin_count[b] == 0) {
+      continue;
+    }
+    uint32_t gap = (b + ETS_PERIOD_POINTS - prev) & (ETS_PERIOD_POINTS - 1);
+    if (gap == 0) {
+      gap = ETS_PERIOD_POINTS; // 只有一个区间有数据
+    }
+    for (uint32_t j = 1; j < gap; j++) {
+      bin_sum[(prev + j) & (ETS_PERIOD_POINTS - 1)] =
+          bin_sum[prev] +
+          (bin_sum[b] - bin_sum[prev]) * (int32_t)j / (int32_t)gap;
+    }
+    prev = b;
+  }
+}
+
+bool ets_process_frame(uint16_t *samples) {
+  const double fs = get_sample_rate_hz();
+  if (f0_hz <= 0 || f0_hz >= fs / 2) {
+    // 尚无基波估计, 本帧按普通帧分析
+    clear_bins();
+    return emit_frame(false);
+  }
+
+  int64_t total = 0;
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    total += sample_code(samples[n]);
+  }
+  const int32_t mean = (int32_t)(total / SAMPLE_SIZE);
+
+  // 以上一次的估计为参考频率, 测量前后两半的基波相位
+  const double ref = f0_hz / fs;
+  const uint32_t ref_q32 = (uint32_t)(ref * Q32_ONE);
+  double mag1, mag2;
+  double arg1 = half_phase(samples, 0, mean, ref_q32, &mag1);
+  double arg2 = half_phase(samples, HALF_LEN, mean, ref_q32, &mag2);
+  double amplitude =
+      2.0 * (mag1 + mag2) / ((double)HALF_LEN * (1UL << 30));
+  if (amplitude < ETS_MIN_AMPLITUDE_CODES ||
+      (frames != 0 && amplitude < first_amplitude / 2)) {
+    // 基波太弱或信号已改变, 放弃本轮, 本帧按普通帧重新估计基波
+    ets_reset();
+    return emit_frame(false);
+  }
+  if (frames == 0) {
+    first_amplitude = amplitude;
+  }
+
+  // 两半中心相隔 HALF_LEN 点, 相位差即为参考频率的误差;
+  // 由前半中心的相位推回第 0 点的相位
+  const double delta =
+      remainder(arg2 - arg1, 2 * PI) / (2 * PI * HALF_LEN);
+  const double r = ref + delta;
+  const double phase0 = arg1 / (2 * PI) - delta * (HALF_LEN - 1) / 2;
+
+  // 按每点相对基波的相位 (Q32 周期) 折叠进一个周期
+  const uint32_t step_q32 = (uint32_t)(r * Q32_ONE);
+  uint32_t phase = (uint32_t)(int64_t)llround(phase0 * Q32_ONE);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++, phase += step_q32) {
+    uint32_t b = (phase + (1U << (31 - ETS_PERIOD_LOG2))) >>
+                 (32 - ETS_PERIOD_LOG2);
+    if (bin_count[b] != UINT16_MAX) {
+      bin_sum[b] += sample_code(samples[n]);
+      bin_count[b]++;
+    }
+  }
+  f0_hz = r * fs;
+
+  if (++frames < gAcquisitionConfig.ets_frames) {
+    return false;
+  }
+
+  // 重建一个周期 (第 0 点为基波余弦的峰值), 平铺成一帧
+  average_bins();
+  for (uint32_t t = 0; t < ETS_TILE_PERIODS; t++) {
+    for (uint32_t b = 0; b < ETS_PERIOD_POINTS; b++) {
+      samples[t * ETS_PERIOD_POINTS + b] = code_to_sample(bin_sum[b]);
+    }
+  }
+  clear_bins();
+  capture_stats_invalidate(); // 采集期间的统计量属于最后一帧原始采样
+  return emit_frame(true);
+}
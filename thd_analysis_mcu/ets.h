@@ -0,0 +1,63 @@
+#ifndef ETS_H
+#define ETS_H
+
+#include "analysis.h"
+#include "consts.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 等效时间采样 (随机交织): 周期信号每帧的采样相对基波的相位不同,
+// 按相位把多帧采样折叠进一个周期, 得到远高于实际采样率的等效采样率,
+// 高于奈奎斯特频率的谐波也能正确分析. 基波本身须低于奈奎斯特频率
+// (由普通的一帧测出)
+
+// 重建的一个周期平铺成一帧时的周期数 (基波落在第 ETS_TILE_PERIODS 个频点,
+// 须不小于 MIN_FUNDAMENTAL_IDX)
+#define ETS_TILE_PERIODS 4
+// 重建的一个周期的点数
+#define ETS_PERIOD_POINTS (SAMPLE_SIZE / ETS_TILE_PERIODS)
+// 每次重建累加的帧数范围
+#define ETS_MIN_FRAMES 2
+#define ETS_MAX_FRAMES 64
+// 基波幅度低于此值 (12 位码值) 时相位测不准, 放弃本轮累加
+#define ETS_MIN_AMPLITUDE_CODES 16
+// 相位累加器占用的 RAM (字节), 计入 analysis.c 的 RAM 预算
+#define ETS_RAM_BYTES (ETS_PERIOD_POINTS * (sizeof(int32_t) + sizeof(uint16_t)))
+
+/**
+ * @brief 是否开启等效时间采样
+ * @note 只用于单通道分析 (与双通道采集、多通道扫描互斥, 由命令处理保证)
+ */
+bool is_ets_enabled(void);
+
+/**
+ * @brief 丢弃已累加的帧和基波频率估计, 下一帧重新按普通帧分析
+ * @note 开关或帧数改变、切换输入信号时调用
+ */
+void ets_reset(void);
+
+/**
+ * @brief 处理一帧已归一化的采样
+ * @param samples 一帧 SAMPLE_SIZE 点采样 (VALID_ADC_DATA)
+ * @return true 表示本帧应送去分析: 尚无基波频率估计时为原始的一帧,
+ * 累加够 gAcquisitionConfig.ets_frames 帧时 samples 被改写为重建的波形
+ * (一个周期平铺 ETS_TILE_PERIODS 次); false 表示已累加, 需继续采样
+ */
+bool ets_process_frame(uint16_t *samples);
+
+/**
+ * @brief 用普通帧的分析结果更新基波频率估计
+ * @note 重建帧的结果不用于更新 (其频率已由各帧的相位精确测得)
+ */
+void ets_update_from_result(const AnalysisResult *result);
+
+// 最近一次 ets_process_frame 是否输出了重建的波形
+bool ets_frame_reconstructed(void);
+
+// 重建波形的等效采样率 (基波频率 * ETS_PERIOD_POINTS)
+double ets_sample_rate_hz(void);
+
+// 本轮已累加的帧数
+uint8_t ets_accumulated_frames(void);
+
+#endif /* ETS_H */
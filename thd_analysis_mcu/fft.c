@@ -0,0 +1,307 @@
+#include "fft.h"
+#include "consts.h"
+
+// 旋转因子表的点数, 表中索引 i 对应角度 2*pi*i/FFT_TABLE_LEN
+#define FFT_TABLE_LEN SAMPLE_SIZE
+#define FFT_TABLE_QUARTER (FFT_TABLE_LEN / 4)
+
+// 块浮点缩放: 每级输出分量的上界 = 输入分量最大绝对值 * 级增益 (Q5),
+// 只按本级实际可能的增长右移. 带旋转因子的基4 蝶形 |y| <= 4*sqrt(2)*max;
+// 末级基4 (组长 4) 与末级基2 没有旋转因子, 分别为 4*max 与 2*max;
+// 实数分离级 |X| <= |E| + |W*O| <= (1 + sqrt(2))*max
+#define RADIX4_GAIN_Q5 182
+#define RADIX4_LAST_GAIN_Q5 128
+#define RADIX2_GAIN_Q5 64
+#define SPLIT_GAIN_Q5 78
+// 两次舍入最多带来约 1.5 LSB 误差, 留出余量
+#define STAGE_OUTPUT_LIMIT 32760
+
+// 带舍入的算术右移, shift 为 0 时不改变数值
+#define ROUND_SHIFT(v, shift) (((v) + ((1 << (shift)) >> 1)) >> (shift))
+
+static inline uint32_t abs_max(uint32_t max_abs, int32_t value) {
+  uint32_t a = (uint32_t)(value < 0 ? -value : value);
+  return a > max_abs ? a : max_abs;
+}
+
+/**
+ * @brief 根据上一级输出的最大绝对值决定本级需要右移的位数
+ */
+static uint32_t stage_shift(uint32_t max_abs, uint32_t gain_q5) {
+  uint32_t bound = (max_abs * gain_q5) >> 5;
+  uint32_t shift = 0;
+  while (bound > ((uint32_t)STAGE_OUTPUT_LIMIT << shift)) {
+    shift++;
+  }
+  return shift;
+}
+
+/**
+ * @brief 查表得到 W = cos(a) - j*sin(a), a = 2*pi*idx/FFT_TABLE_LEN
+ * @note 表中只存 [0, pi/2] 的正弦, 其余由象限对称得到
+ */
+static inline void twiddle(uint32_t idx, int32_t *cos_val, int32_t *sin_val) {
+  uint32_t r = idx & (FFT_TABLE_QUARTER - 1);
+  switch (idx / FFT_TABLE_QUARTER) {
+  case 0:
+    *cos_val = gFftSinTable[FFT_TABLE_QUARTER - r];
+    *sin_val = gFftSinTable[r];
+    break;
+  case 1:
+    *cos_val = -gFftSinTable[r];
+    *sin_val = gFftSinTable[FFT_TABLE_QUARTER - r];
+    break;
+  case 2:
+    *cos_val = -gFftSinTable[FFT_TABLE_QUARTER - r];
+    *sin_val = -gFftSinTable[r];
+    break;
+  default:
+    *cos_val = gFftSinTable[r];
+    *sin_val = -gFftSinTable[FFT_TABLE_QUARTER - r];
+    break;
+  }
+}
+
+void fft_sin_cos_q15(uint32_t idx, int32_t *cos_val, int32_t *sin_val) {
+  twiddle(idx & (FFT_TABLE_LEN - 1), cos_val, sin_val);
+}
+
+/**
+ * @brief 末级基2 DIF 蝶形 (组长 2, 旋转因子均为 1), 仅在复数点数为 2 的
+ * 奇数次幂时使用
+ * @note 放在末级而不是首级: 首级的旋转因子使上界多出 sqrt(2), 而实际增长
+ * 往往不到 2 倍, 首级会多右移一位
+ * @return 本级右移位数
+ */
+static uint32_t radix2_stage(q15_t *buf, uint32_t fft_len,
+                             uint32_t *max_abs) {
+  const uint32_t shift = stage_shift(*max_abs, RADIX2_GAIN_Q5);
+  uint32_t out_max = 0;
+
+  for (uint32_t i = 0; i < fft_len; i += 2) {
+    q15_t *p0 = &buf[2 * i];
+    q15_t *p1 = p0 + 2;
+    int32_t ar = p0[0], ai = p0[1];
+    int32_t br = p1[0], bi = p1[1];
+
+    int32_t y0r = ROUND_SHIFT(ar + br, shift);
+    int32_t y0i = ROUND_SHIFT(ai + bi, shift);
+    int32_t y1r = ROUND_SHIFT(ar - br, shift);
+    int32_t y1i = ROUND_SHIFT(ai - bi, shift);
+
+    p0[0] = (q15_t)y0r;
+    p0[1] = (q15_t)y0i;
+    p1[0] = (q15_t)y1r;
+    p1[1] = (q15_t)y1i;
+    out_max = abs_max(out_max, y0r);
+    out_max = abs_max(out_max, y0i);
+    out_max = abs_max(out_max, y1r);
+    out_max = abs_max(out_max, y1i);
+  }
+
+  *max_abs = out_max;
+  return shift;
+}
+
+/**
+ * @brief 一级基4 DIF 蝶形, 组长 group_len
+ * @note 第1/2路输出交换存放, 使整个变换的输出顺序为普通的位反转顺序,
+ * 最后只需一次位反转重排. 同一旋转因子的蝶形放在内层循环, 每个因子只查一次表
+ * @return 本级右移位数
+ */
+static uint32_t radix4_stage(q15_t *buf, uint32_t fft_len, uint32_t group_len,
+                             uint32_t *max_abs) {
+  const uint32_t quarter = group_len / 4;
+  const uint32_t tw_step = FFT_TABLE_LEN / group_len;
+  const uint32_t shift = stage_shift(
+      *max_abs, quarter == 1 ? RADIX4_LAST_GAIN_Q5 : RADIX4_GAIN_Q5);
+  uint32_t out_max = 0;
+
+  for (uint32_t j = 0; j < quarter; j++) {
+    int32_t c1 = 32767, s1 = 0, c2 = 32767, s2 = 0, c3 = 32767, s3 = 0;
+    if (j != 0) {
+      twiddle(j * tw_step, &c1, &s1);
+      twiddle(2 * j * tw_step, &c2, &s2);
+      twiddle(3 * j * tw_step, &c3, &s3);
+    }
+
+    for (uint32_t g = j; g < fft_len; g += group_len) {
+      q15_t *p0 = &buf[2 * g];
+      q15_t *p1 = p0 + 2 * quarter;
+      q15_t *p2 = p1 + 2 * quarter;
+      q15_t *p3 = p2 + 2 * quarter;
+
+      int32_t t1r = p0[0] + p2[0], t1i = p0[1] + p2[1];
+      int32_t t2r = p0[0] - p2[0], t2i = p0[1] - p2[1];
+      int32_t t3r = p1[0] + p3[0], t3i = p1[1] + p3[1];
+      int32_t t4r = p1[0] - p3[0], t4i = p1[1] - p3[1];
+
+      int32_t y0r = ROUND_SHIFT(t1r + t3r, shift);
+      int32_t y0i = ROUND_SHIFT(t1i + t3i, shift);
+      int32_t y2r = ROUND_SHIFT(t1r - t3r, shift);
+      int32_t y2i = ROUND_SHIFT(t1i - t3i, shift);
+      // y1 = t2 - j*t4, y3 = t2 + j*t4
+      int32_t y1r = ROUND_SHIFT(t2r + t4i, shift);
+      int32_t y1i = ROUND_SHIFT(t2i - t4r, shift);
+      int32_t y3r = ROUND_SHIFT(t2r - t4i, shift);
+      int32_t y3i = ROUND_SHIFT(t2i + t4r, shift);
+
+      if (j != 0) {
+        int32_t r;
+        r = (y1r * c1 + y1i * s1 + 0x4000) >> 15;
+        y1i = (y1i * c1 - y1r * s1 + 0x4000) >> 15;
+        y1r = r;
+        r = (y2r * c2 + y2i * s2 + 0x4000) >> 15;
+        y2i = (y2i * c2 - y2r * s2 + 0x4000) >> 15;
+        y2r = r;
+        r = (y3r * c3 + y3i * s3 + 0x4000) >> 15;
+        y3i = (y3i * c3 - y3r * s3 + 0x4000) >> 15;
+        y3r = r;
+      }
+
+      p0[0] = (q15_t)y0r;
+      p0[1] = (q15_t)y0i;
+      p1[0] = (q15_t)y2r;
+      p1[1] = (q15_t)y2i;
+      p2[0] = (q15_t)y1r;
+      p2[1] = (q15_t)y1i;
+      p3[0] = (q15_t)y3r;
+      p3[1] = (q15_t)y3i;
+      out_max = abs_max(out_max, y0r);
+      out_max = abs_max(out_max, y0i);
+      out_max = abs_max(out_max, y1r);
+      out_max = abs_max(out_max, y1i);
+      out_max = abs_max(out_max, y2r);
+      out_max = abs_max(out_max, y2i);
+      out_max = abs_max(out_max, y3r);
+      out_max = abs_max(out_max, y3i);
+    }
+  }
+
+  *max_abs = out_max;
+  return shift;
+}
+
+/**
+ * @brief 复数点位反转重排 (Gold-Rader)
+ * @note 缓冲区只保证 2 字节对齐, 按 q15 逐个交换
+ */
+static void bit_reverse(q15_t *buf, uint32_t fft_len) {
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < fft_len - 1; i++) {
+    if (i < j) {
+      q15_t tr = buf[2 * i], ti = buf[2 * i + 1];
+      buf[2 * i] = buf[2 * j];
+      buf[2 * i + 1] = buf[2 * j + 1];
+      buf[2 * j] = tr;
+      buf[2 * j + 1] = ti;
+    }
+    uint32_t k = fft_len >> 1;
+    while (k <= j) {
+      j -= k;
+      k >>= 1;
+    }
+    j += k;
+  }
+}
+
+/**
+ * @brief 原地复数 FFT, 输出为自然顺序
+ * @return 各级右移位数之和
+ */
+static uint32_t cfft_stages(q15_t *buf, uint32_t fft_len,
+                            uint32_t *max_abs) {
+  uint32_t log2_len = 0;
+  while ((1UL << log2_len) < fft_len) {
+    log2_len++;
+  }
+
+  uint32_t exponent = 0;
+  for (uint32_t group_len = fft_len; group_len >= 4; group_len >>= 2) {
+    exponent += radix4_stage(buf, fft_len, group_len, max_abs);
+  }
+  if (log2_len & 1) {
+    exponent += radix2_stage(buf, fft_len, max_abs);
+  }
+
+  bit_reverse(buf, fft_len);
+  return exponent;
+}
+
+/**
+ * @brief 实数分离级: 由 N/2 点复数 FFT 结果 Z 得到 N 点实数 FFT 的前半部分
+ * X[k] = E + W^k*O, X[N/2-k] = conj(E - W^k*O),
+ * 其中 E = (Z[k] + conj(Z[N/2-k]))/2, O = (Z[k] - conj(Z[N/2-k]))/(2j)
+ * @return 本级右移位数
+ */
+static uint32_t real_split_stage(q15_t *buf, uint32_t fft_len,
+                                 uint32_t max_abs) {
+  const uint32_t half = fft_len / 2;
+  const uint32_t tw_step = FFT_TABLE_LEN / fft_len;
+  const uint32_t shift = stage_shift(max_abs, SPLIT_GAIN_Q5);
+
+  // 直流与奈奎斯特频点都是实数, 合并存放在第 0 个复数位置
+  int32_t z0r = buf[0], z0i = buf[1];
+  buf[0] = (q15_t)ROUND_SHIFT(z0r + z0i, shift);
+  buf[1] = (q15_t)ROUND_SHIFT(z0r - z0i, shift);
+
+  // E、W*O 都以 2^14 为单位保留在 32 位中间值里 (E/O 的 1/2 系数不单独
+  // 舍入), 每个输出只在最后舍入一次. 2*O 的两个分量最大 65535, 乘 Q15
+  // 旋转因子后各自先右移 2 位, 两项之和不会溢出
+  for (uint32_t k = 1; k <= half / 2; k++) {
+    q15_t *pa = &buf[2 * k];
+    q15_t *pb = &buf[2 * (half - k)];
+    int32_t ar = pa[0], ai = pa[1];
+    int32_t br = pb[0], bi = -pb[1];
+
+    int32_t er = (ar + br) * 8192;
+    int32_t ei = (ai + bi) * 8192;
+    // 2*O = (A - B) / j = (Im(A - B), -Re(A - B))
+    int32_t or_ = ai - bi;
+    int32_t oi = br - ar;
+
+    int32_t c, s;
+    twiddle(k * tw_step, &c, &s);
+    int32_t wr = ((or_ * c) >> 2) + ((oi * s) >> 2);
+    int32_t wi = ((oi * c) >> 2) - ((or_ * s) >> 2);
+
+    // k == half/2 时两处写入同一位置且数值相同
+    pa[0] = (q15_t)ROUND_SHIFT(er + wr, shift + 14);
+    pa[1] = (q15_t)ROUND_SHIFT(ei + wi, shift + 14);
+    pb[0] = (q15_t)ROUND_SHIFT(er - wr, shift + 14);
+    pb[1] = (q15_t)ROUND_SHIFT(wi - ei, shift + 14);
+  }
+
+  return shift;
+}
+
+uint32_t rfft_q15_inplace(q15_t *buffer, uint32_t fft_len) {
+  uint32_t max_abs = 0;
+  for (uint32_t i = 0; i < fft_len; i++) {
+    max_abs = abs_max(max_abs, buffer[i]);
+  }
+
+  // 相邻两个实数采样视为一个复数点: z[n] = x[2n] + j*x[2n+1]
+  uint32_t exponent = cfft_stages(buffer, fft_len / 2, &max_abs);
+  exponent += real_split_stage(buffer, fft_len, max_abs);
+  return exponent;
+}
+
+uint32_t cfft_q15_inplace(q15_t *buffer, uint32_t fft_len) {
+  uint32_t max_abs = 0;
+  for (uint32_t i = 0; i < 2 * fft_len; i++) {
+    max_abs = abs_max(max_abs, buffer[i]);
+  }
+  return cfft_stages(buffer, fft_len, &max_abs);
+}
+
+void cfft_split_real_q15(const q15_t *buffer, uint32_t fft_len, uint32_t k,
+                         int32_t x[2], int32_t y[2]) {
+  const uint32_t m = (fft_len - k) & (fft_len - 1);
+  const int32_t ar = buffer[2 * k], ai = buffer[2 * k + 1];
+  const int32_t br = buffer[2 * m], bi = buffer[2 * m + 1];
+  x[0] = ar + br;
+  x[1] = ai - bi;
+  y[0] = ai + bi;
+  y[1] = br - ar;
+}
@@ -0,0 +1,47 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "arm_math.h"
+#include <stdint.h>
+
+/**
+ * @brief 原地 Q15 实数 FFT (基4 + 基2 混合基, 块浮点缩放)
+ * @param buffer 输入 fft_len 个实数采样; 输出 fft_len/2 个复数频点,
+ * 实部/虚部交替存放. 直流和奈奎斯特频点都是实数, 分别存放在 buffer[0] 与
+ * buffer[1]
+ * @param fft_len 实数 FFT 点数, 2 的幂, 16 ~ SAMPLE_SIZE
+ * @return 块浮点指数 e, 真实频谱 X[k] = 输出 * 2^e
+ * @note 与 arm_rfft_q15 不同, 不需要 2*fft_len 的输出缓冲区,
+ * 且只在数据确实可能溢出的级做缩放, 小信号保留更多有效位
+ */
+uint32_t rfft_q15_inplace(q15_t *buffer, uint32_t fft_len);
+
+/**
+ * @brief 原地 Q15 复数 FFT (基4 + 基2 混合基, 块浮点缩放)
+ * @param buffer 输入/输出 fft_len 个复数点, 实部/虚部交替存放, 输出为自然顺序
+ * @param fft_len 复数点数, 2 的幂, 4 ~ SAMPLE_SIZE
+ * @return 块浮点指数 e, 真实频谱 Z[k] = 输出 * 2^e
+ * @note 双通道采集用一次复数 FFT 同时变换两路实数信号 (见 analysis.c)
+ */
+uint32_t cfft_q15_inplace(q15_t *buffer, uint32_t fft_len);
+
+/**
+ * @brief 由两路实数信号合成的 z = x + j*y 的复数 FFT 结果 Z 拆分出第 k 点的
+ * 两路频谱: 2X[k] = Z[k] + conj(Z[N-k]), 2Y[k] = (Z[k] - conj(Z[N-k])) / j
+ * @param buffer cfft_q15_inplace 的输出
+ * @param fft_len 复数点数
+ * @param k 频点, 0 ~ fft_len - 1
+ * @param x 输出 2X[k] 的实部与虚部, 与 buffer 同一刻度 (乘以 2^e)
+ * @param y 输出 2Y[k] 的实部与虚部
+ */
+void cfft_split_real_q15(const q15_t *buffer, uint32_t fft_len, uint32_t k,
+                         int32_t x[2], int32_t y[2]);
+
+/**
+ * @brief 查旋转因子表得到 cos / sin(2*pi*idx/SAMPLE_SIZE), Q15
+ * @param idx 角度索引, 按 SAMPLE_SIZE 取模
+ * @note 供单频点 DFT 等不做完整 FFT 的场合复用同一张表
+ */
+void fft_sin_cos_q15(uint32_t idx, int32_t *cos_val, int32_t *sin_val);
+
+#endif /* FFT_H */
@@ -0,0 +1,77 @@
+#include "interleave.h"
+#include "consts.h"
+#include <math.h>
+
+// 估计时限制增益失配的范围, 超出说明输入不满足条件 (如无信号)
+#define MIN_GAIN_RATIO 0.5
+#define MAX_GAIN_RATIO 1.5
+
+/**
+ * @brief 采样换算为以中点为零的 Q15 (与有符号左对齐格式同一刻度)
+ */
+static inline int32_t centered_q15(uint16_t sample, bool is_signed) {
+  return is_signed ? (int16_t)sample
+                   : ((int32_t)sample - ADC_MIDPOINT) * PRE_FFT_SCALE;
+}
+
+void interleave_estimate_mismatch(const uint16_t *frame, bool is_signed,
+                                  InterleaveCalibration *cal) {
+  // 一路 SAMPLE_SIZE / 2 点, 平方和最大约 2^11 * 2^30, 需 64 位累加
+  int32_t sum[INTERLEAVE_ADC_COUNT] = {0};
+  int64_t sum_sq[INTERLEAVE_ADC_COUNT] = {0};
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    int32_t x = centered_q15(frame[i], is_signed);
+    sum[i & 1] += x;
+    sum_sq[i & 1] += (int64_t)x * x;
+  }
+
+  const double n = SAMPLE_SIZE / INTERLEAVE_ADC_COUNT;
+  double var0 = sum_sq[0] / n - (sum[0] / n) * (sum[0] / n);
+  double var1 = sum_sq[1] / n - (sum[1] / n) * (sum[1] / n);
+  // 均值在同一时间段内比较: ADC1 的第 j 点位于 ADC0 第 j, j+1 点的中间,
+  // ADC0 按梯形求平均. 一帧不是整周期时两路均值差约为幅度 / N 量级
+  int32_t first0 = centered_q15(frame[0], is_signed);
+  int32_t last0 = centered_q15(frame[SAMPLE_SIZE - 2], is_signed);
+  int32_t last1 = centered_q15(frame[SAMPLE_SIZE - 1], is_signed);
+  double mean0 = (sum[0] - (first0 + last0) / 2.0) / (n - 1);
+  double mean1 = (sum[1] - last1) / (n - 1);
+
+  double gain = 1.0;
+  if (var0 > 0 && var1 > 0) {
+    gain = sqrt(var0 / var1);
+    if (gain < MIN_GAIN_RATIO || gain > MAX_GAIN_RATIO) {
+      gain = 1.0;
+    }
+  }
+  // 校正后 ADC1 的均值与 ADC0 相同
+  double offset = mean0 - mean1 * gain;
+
+  cal->gain_q14 = (uint16_t)(gain * INTERLEAVE_GAIN_ONE + 0.5);
+  cal->offset_q15 = (int16_t)(offset < 0 ? offset - 0.5 : offset + 0.5);
+}
+
+void interleave_correct_frame(uint16_t *frame, bool is_signed,
+                              const InterleaveCalibration *cal) {
+  if (cal->gain_q14 == INTERLEAVE_GAIN_ONE && cal->offset_q15 == 0) {
+    return;
+  }
+  const int32_t gain = cal->gain_q14;
+  const int32_t offset = cal->offset_q15;
+  for (uint32_t i = 1; i < SAMPLE_SIZE; i += 2) {
+    // |x| <= 2^15, gain < 1.5 * 2^14, 乘积在 32 位以内
+    int32_t x = centered_q15(frame[i], is_signed);
+    int32_t y = ((x * gain + (1 << (INTERLEAVE_GAIN_FRAC_BITS - 1))) >>
+                 INTERLEAVE_GAIN_FRAC_BITS) +
+                offset;
+    if (is_signed) {
+      frame[i] = (uint16_t)(int16_t)(y > INT16_MAX
+                                         ? INT16_MAX
+                                         : (y < INT16_MIN ? INT16_MIN : y));
+    } else {
+      const int32_t max_code = 2 * ADC_MIDPOINT - 1;
+      int32_t code =
+          ((y + PRE_FFT_SCALE / 2) >> ADC_SIGNED_SHIFT) + ADC_MIDPOINT;
+      frame[i] = (uint16_t)(code < 0 ? 0 : (code > max_code ? max_code : code));
+    }
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef INTERLEAVE_H
+#define INTERLEAVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 交织采集的 ADC 数: ADC0 采偶数点, ADC1 晚半个采样间隔采奇数点
+#define INTERLEAVE_ADC_COUNT 2
+// 增益校正系数的小数位数
+#define INTERLEAVE_GAIN_FRAC_BITS 14
+#define INTERLEAVE_GAIN_ONE (1 << INTERLEAVE_GAIN_FRAC_BITS)
+
+// ADC1 相对 ADC0 的失配校正: y = x * gain + offset (Q15 刻度, 以中点为零)
+typedef struct {
+  uint16_t gain_q14;
+  int16_t offset_q15;
+} InterleaveCalibration;
+
+/**
+ * @brief 由一帧未校正的交织采样估计 ADC1 相对 ADC0 的偏置与增益失配
+ * @param frame SAMPLE_SIZE 个交织采样, 偶数点来自 ADC0, 奇数点来自 ADC1
+ * @param is_signed 采样为有符号左对齐 (Q15) 格式, 否则为 12 位无符号码值
+ * @param cal 输出校正参数
+ * @note 两路对同一信号交替采样, 一帧内各自的均值与交流有效值应相同,
+ * 差异即为失配. 要求输入稳定且一帧包含多个周期; 信号恰好位于
+ * 单路采样率的 1/4 或其倍数时两路看到的波形不同, 估计不可靠.
+ * 纯计算, 不访问硬件
+ */
+void interleave_estimate_mismatch(const uint16_t *frame, bool is_signed,
+                                  InterleaveCalibration *cal);
+
+/**
+ * @brief 按校正参数原地修正一帧中 ADC1 的采样 (奇数点)
+ * @note 修正后仍为原格式, 分析与上传无需区分是否交织
+ */
+void interleave_correct_frame(uint16_t *frame, bool is_signed,
+                              const InterleaveCalibration *cal);
+
+#endif /* INTERLEAVE_H */
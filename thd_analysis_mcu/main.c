@@ -1,12 +1,19 @@
 #include "analysis.h"
 #include "arm_const_structs.h"
 #include "arm_math.h"
+#include "capture_stats.h"
 #include "command.h" // 添加命令处理模块头文件
 #include "consts.h"
 #include "custom_init.h"
+#include "decimate.h"
+#include "ets.h"
 #include "ti/driverlib/dl_adc12.h"
 #include "ti/driverlib/m0p/dl_core.h"
 #include "ti_msp_dl_config.h"
+#include "sampling.h"
+#include "scan.h"
+#include "stft.h"
+#include "trigger.h"
 #include "uart_comm.h"
 #include "utils.h"
 #include <sys/cdefs.h>
@@ -15,6 +22,7 @@
 // 进入adc中断后, 不会自动关闭Conversion, 需要手动关闭, 否则会一直采集并触发中断
 // 当手动关闭后, 如果想再次开启, 需要先调用enableConversions,
 // 然后再调用startConversion才会继续采集并触发下一个adc中断
+// (相干采样时改为启动触发定时器, 见 sampling.c 中的 sampling_start)
 
 // uart 进入中断后需要手动重新配置DMA通道, 才能继续接收数据并触发中断
 
@@ -23,6 +31,8 @@ SystemState gSystemState = STATE_IDLE;     // 当前系统状态
 OperationMode gCurrentMode = MODE_TRIGGER; // 默认触发模式
 bool gTriggerSampling = false;             // 触发采样标志
 volatile bool gUARTCommandReady = false;   // 新增：UART命令接收标志
+// 双通道采集时电流通道的结果与功率参数 (结构体较大, 不放在栈上)
+static PowerAnalysis gPowerAnalysis;
 
 int main(void) {
   // 根据要采集的信号的频率来初始化
@@ -31,12 +41,10 @@ int main(void) {
 
   // ADC
   // 默认是触发模式，不自动启动ADC
-  DL_DMA_setSrcAddr(DMA, DMA_CH0_CHAN_ID,
-                    (uint32_t)DL_ADC12_getFIFOAddress(ADC12_0_INST));
-  DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)gADCRealSamples);
-  DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, ((SAMPLE_SIZE + 50) >> 1));
-  DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+  // ADC 的 DMA 通道已在 CUSTOM_SYSCFG_DL_ADC_DMA_init 中配置
   NVIC_EnableIRQ(ADC12_0_INST_INT_IRQN);
+  // 交织/双通道采集时以 ADC1 的 DMA 完成作为一帧结束
+  NVIC_EnableIRQ(ADC12_1_INST_INT_IRQN);
 
   // UART
   DL_DMA_setSrcAddr(DMA, DMA_CH1_CHAN_ID, (uint32_t)(&UART_0_INST->RXDATA));
@@ -64,8 +72,7 @@ int main(void) {
       // 在空闲状态检查是否需要开始采样
       if (gCurrentMode == MODE_AUTO || gTriggerSampling) {
         // 启动ADC采样
-        DL_ADC12_enableConversions(ADC12_0_INST);
-        DL_ADC12_startConversion(ADC12_0_INST);
+        sampling_start();
         gSystemState = STATE_SAMPLING;
 
         // 如果是触发模式，重置触发标志
@@ -77,25 +84,100 @@ int main(void) {
 
     case STATE_SAMPLING:
       // ADC正在采样，等待中断完成
-      // 由ADC中断处理函数更新状态
+      // 由ADC中断处理函数更新状态; 期间按 DMA 进度累加已采到的部分
+      capture_stats_poll();
+      // 短时频谱流: 每有一个跳步的新采样就发出一行, 行数够了或收到命令时
+      // 结束采集 (命令只在空闲状态处理), 不做整帧分析
+      if (stft_running()) {
+        StftRow row;
+        if (stft_poll(&row)) {
+          send_stft_row(&row);
+        }
+        if (!stft_running() || gUARTCommandReady) {
+          stft_stop();
+          sampling_stop();
+          if (gCurrentMode == MODE_AUTO && !gUARTCommandReady) {
+            delay_ms(gAutoModeDelayMs);
+          }
+          gSystemState = STATE_IDLE;
+        }
+        break;
+      }
+      // 抽取时由主循环滤波输出, 输出满一帧即结束采集
+      if (decimation_poll()) {
+        sampling_stop();
+        gSystemState = STATE_ANALYZING;
+      }
       break;
 
     case STATE_ANALYZING: {
-      // 分析ADC数据
-      AnalysisResult result = analyze_harmonics(VALID_ADC_DATA);
-      uint16_t adcclks_output = calculate_adcclks(result.fundamental_freq, 5.0);
-      if (gADCCLKS != adcclks_output) {
-        gADCCLKS = adcclks_output;
-        CUSTOM_SYSCFG_DL_ADC12_0_init(adcclks_output);
+      // 触发采集先把环形缓冲区排成以触发点为准的一帧; 低分辨率采样
+      // 换算到 12 位码值刻度, 交织时校正 ADC1 的失配,
+      // 分析与上传都按单个 12 位 ADC 处理
+      sampling_normalize_frame(VALID_ADC_DATA);
+
+      // 等效时间采样: 按相位把各帧折叠进一个周期, 累加够帧数才分析重建的波形
+      if (is_ets_enabled() && !ets_process_frame(VALID_ADC_DATA)) {
+        sampling_start();
+        gSystemState = STATE_SAMPLING;
+        break;
+      }
+
+      // 大点数时 FFT 在采集缓冲区上原地进行, 原始采样需在分析前发出
+      bool samples_sent = false;
+      if (SPECTRUM_IN_CAPTURE_BUFFER && will_next_frame_report()) {
+        send_adc_samples(gAnalysisProfile.num_harmonics);
+        samples_sent = true;
+      }
+
+      // 分析ADC数据, 双通道时一次 FFT 同时分析电压与电流
+      const bool dual_channel = gAcquisitionConfig.dual_channel;
+      AnalysisResult result =
+          dual_channel ? analyze_dual_channel(VALID_ADC_DATA,
+                                              VALID_CURRENT_DATA,
+                                              &gPowerAnalysis)
+                       : analyze_harmonics(VALID_ADC_DATA);
+
+      // 频谱平均尚未累加够 K 帧，继续采样下一帧
+      if (is_spectrum_average_pending()) {
+        sampling_start();
+        gSystemState = STATE_SAMPLING;
+        break;
+      }
+
+      // 普通帧的基波频率作为等效时间采样折叠各帧的参考
+      if (is_ets_enabled()) {
+        ets_update_from_result(&result);
+      }
+
+      // 按基波频率调整采样率 (采样窗口或相干采样定时器)
+      if (update_sampling_clock(&result)) {
+        // 采样率改变后频率分辨率不同，之前累加的频谱不能再用
+        reset_spectrum_average();
+        // 包头和原始采样已发出时，必须补全这个数据包
+        if (samples_sent) {
+          send_analysis_result(&result);
+        }
 
         // 启动ADC采样
-        DL_ADC12_enableConversions(ADC12_0_INST);
-        DL_ADC12_startConversion(ADC12_0_INST);
+        sampling_start();
+        gSystemState = STATE_SAMPLING;
         break;
       }
 
       // 发送分析结果
-      send_adc_result(result);
+      if (dual_channel) {
+        send_dual_channel_result(&result, &gPowerAnalysis);
+      } else if (samples_sent) {
+        send_analysis_result(&result);
+      } else {
+        send_adc_result(&result);
+      }
+
+      // 多通道扫描: 结果上报后才换到下一个通道, 各通道的频谱平均互不混合
+      if (is_scan_enabled()) {
+        scan_next_channel();
+      }
 
       // 根据模式决定下一步操作
       if (gCurrentMode == MODE_AUTO) {
@@ -108,24 +190,61 @@ int main(void) {
     }
     }
 
-    __WFI();
+    // 边采集边累加、抽取或输出短时频谱流时不休眠, 否则要等整帧采完
+    // (环形缓冲区时为写满一圈) 才会被中断唤醒
+    if (gSystemState != STATE_SAMPLING ||
+        !(capture_stats_running() || decimation_running() ||
+          stft_running())) {
+      __WFI();
+    }
   }
 }
 
-void ADC12_0_INST_IRQHandler(void) {
-  if (DL_ADC12_getPendingInterrupt(ADC12_0_INST) == DL_ADC12_IIDX_DMA_DONE) {
+/**
+ * @brief 一帧采集完成 (单 ADC 时为 ADC0, 交织/双通道时为 ADC1 的 DMA 完成)
+ */
+static void handle_frame_captured(ADC12_Regs *adc) {
+  switch (DL_ADC12_getPendingInterrupt(adc)) {
+  case DL_ADC12_IIDX_WINDOW_COMP_LOW:
+  case DL_ADC12_IIDX_WINDOW_COMP_HIGH:
+    // 电平触发 (只在 ADC0 上开启)
+    trigger_on_window_comp();
+    break;
+
+  case DL_ADC12_IIDX_DMA_DONE:
     // 清除中断标志
-    DL_ADC12_clearInterruptStatus(ADC12_0_INST, DL_ADC12_IIDX_DMA_DONE);
-    // 禁用ADC转换，防止数据在分析期间继续采集导致覆盖
-    DL_ADC12_disableConversions(ADC12_0_INST);
+    DL_ADC12_clearInterruptStatus(adc, DL_ADC12_IIDX_DMA_DONE);
+    // 抽取或短时频谱流时 DMA 循环写入环形缓冲区, 由主循环决定何时结束
+    if (decimation_running()) {
+      decimation_on_dma_done();
+      break;
+    }
+    if (stft_running()) {
+      stft_on_dma_done();
+      break;
+    }
+    // 电平触发时 DMA 循环写入, 触发后采够点数 (或超时) 才算一帧结束
+    if (is_trigger_enabled() && !trigger_on_dma_done()) {
+      break;
+    }
+    // 禁用ADC转换(及触发定时器)，防止数据在分析期间继续采集导致覆盖
+    sampling_stop();
 
     // 更新状态为分析阶段
     if (gSystemState == STATE_SAMPLING) {
       gSystemState = STATE_ANALYZING;
     }
+    break;
+
+  default:
+    break;
   }
 }
 
+void ADC12_0_INST_IRQHandler(void) { handle_frame_captured(ADC12_0_INST); }
+
+void ADC12_1_INST_IRQHandler(void) { handle_frame_captured(ADC12_1_INST); }
+
 void UART_0_INST_IRQHandler(void) {
   switch (DL_UART_Main_getPendingInterrupt(UART_0_INST)) {
   case DL_UART_MAIN_IIDX_DMA_DONE_RX:
@@ -0,0 +1,66 @@
+#include "resample.h"
+#include "consts.h"
+
+// 插值位置 μ 的小数位数 (Q15)
+#define MU_FRAC_BITS 15
+
+/**
+ * @brief 读取一个采样, 换算为以中点为零的 12 位码值
+ */
+static inline int32_t centered_code(const uint16_t *src, int32_t idx,
+                                    bool src_signed) {
+  if (idx < 0) {
+    idx = 0;
+  } else if (idx > SAMPLE_SIZE - 1) {
+    idx = SAMPLE_SIZE - 1;
+  }
+  return src_signed ? ((int16_t)src[idx] >> ADC_SIGNED_SHIFT)
+                    : ((int32_t)src[idx] - ADC_MIDPOINT);
+}
+
+/**
+ * @brief Catmull-Rom 三次插值, 输出放大 PRE_FFT_SCALE 倍 (Q15)
+ * @details y = p1 + μ/2 * (p2 - p0 + μ * (2p0 - 5p1 + 4p2 - p3
+ *              + μ * (3(p1 - p2) + p3 - p0)))
+ * 码值 |p| <= 2048 时逐级的乘积上界约为 2^14 * 2^15, 2^16 * 2^15,
+ * 45056 * 2^15, 均在 32 位以内
+ */
+static inline q15_t catmull_rom(int32_t p0, int32_t p1, int32_t p2, int32_t p3,
+                                int32_t mu) {
+  int32_t t = 3 * (p1 - p2) + p3 - p0;
+  t = 2 * p0 - 5 * p1 + 4 * p2 - p3 + ((t * mu) >> MU_FRAC_BITS);
+  t = p2 - p0 + ((t * mu) >> MU_FRAC_BITS);
+  // μ/2 与放大 16 倍合并为右移 MU_FRAC_BITS + 1 - 4 位
+  int32_t y = p1 * PRE_FFT_SCALE + ((t * mu) >> (MU_FRAC_BITS + 1 -
+                                                  ADC_SIGNED_SHIFT));
+  return (q15_t)(y > INT16_MAX ? INT16_MAX : (y < INT16_MIN ? INT16_MIN : y));
+}
+
+void resample_frame(const uint16_t *src, bool src_signed, uint32_t step_q20,
+                    q15_t *dst) {
+  // step <= 1 时输出第 n 点的插值区间 [i-1, i+2] 满足 i <= n,
+  // 从帧尾向前计算时区间每次最多左移一点, 只有新进入的 p0 需要读取,
+  // 且它总在尚未被输出覆盖的位置
+  uint32_t pos = (uint32_t)(SAMPLE_SIZE - 1) * step_q20;
+  int32_t i = (int32_t)(pos >> RESAMPLE_STEP_FRAC_BITS);
+  int32_t p0 = centered_code(src, i - 1, src_signed);
+  int32_t p1 = centered_code(src, i, src_signed);
+  int32_t p2 = centered_code(src, i + 1, src_signed);
+  int32_t p3 = centered_code(src, i + 2, src_signed);
+
+  for (int32_t n = SAMPLE_SIZE - 1; n >= 0; n--) {
+    pos = (uint32_t)n * step_q20;
+    int32_t idx = (int32_t)(pos >> RESAMPLE_STEP_FRAC_BITS);
+    if (idx != i) {
+      // 步长不超过 1, 区间只会左移一点
+      i = idx;
+      p3 = p2;
+      p2 = p1;
+      p1 = p0;
+      p0 = centered_code(src, i - 1, src_signed);
+    }
+    int32_t mu = (int32_t)((pos >> (RESAMPLE_STEP_FRAC_BITS - MU_FRAC_BITS)) &
+                           ((1 << MU_FRAC_BITS) - 1));
+    dst[n] = catmull_rom(p0, p1, p2, p3, mu);
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include "arm_math.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 重采样步长的小数位数: 输出第 n 点取自输入的 n * step 处
+#define RESAMPLE_STEP_FRAC_BITS 20
+#define RESAMPLE_STEP_ONE (1UL << RESAMPLE_STEP_FRAC_BITS)
+
+/**
+ * @brief 同步重采样 (阶次跟踪): 按固定步长对一帧 ADC 采样做 Catmull-Rom
+ * 三次插值, 使输出的 SAMPLE_SIZE 点恰好覆盖整数个基波周期
+ * @param src 输入 SAMPLE_SIZE 个 ADC 采样
+ * @param src_signed 输入为有符号左对齐 (Q15) 格式, 否则为 12 位无符号码值
+ * @param step_q20 步长 (Q20), 必须 <= RESAMPLE_STEP_ONE
+ * @param dst 输出 SAMPLE_SIZE 个以中点为零的 Q15 采样
+ * (与有符号左对齐格式同一刻度, 插值结果保留 4 位小数)
+ * @note 从帧尾向帧头计算并用寄存器缓存插值邻点, dst 可以与 src 相同
+ * (原地重采样)
+ */
+void resample_frame(const uint16_t *src, bool src_signed, uint32_t step_q20,
+                    q15_t *dst);
+
+#endif /* RESAMPLE_H */
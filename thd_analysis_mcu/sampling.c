@@ -0,0 +1,503 @@
+#include "sampling.h"
+#include "capture_stats.h"
+#include "custom_init.h"
+#include "decimate.h"
+#include "ets.h"
+#include "stft.h"
+#include "trigger.h"
+#include "ti/driverlib/m0p/dl_core.h"
+#include "ti_msp_dl_config.h"
+#include "utils.h"
+#include <math.h>
+
+// 已锁定时, 当前定时器参数下一帧偏离整周期的程度 (周期数) 超过此值,
+// 且换用新参数能更相干时才重新锁定. 矩形窗下 0.01 个周期的偏差
+// 泄漏到二次谐波处约 -52dB; 容差过小时频率估计的噪声会使采样率
+// 每帧变化, 频谱平均永远无法完成
+#define COHERENT_RETUNE_TOLERANCE 0.01
+
+// 非相干采样时每帧希望包含的基波周期数
+#define AUTORANGE_PERIODS 5.0
+
+// 交织/双通道采集未找到基波时逐帧把采样率降低的倍数, 每点时钟数超过
+// TIMER_SEARCH_MAX_TICKS (采样率约 2kHz) 后回到最高采样率
+#define TIMER_SEARCH_STEP 16
+#define TIMER_SEARCH_MAX_TICKS 16384
+
+// 定时器触发时的参数 (相干采样锁定, 或交织/双通道采集)
+static CoherentTiming coherent_timing = {0};
+// ADC 由定时器逐点触发, 而不是连续转换
+static bool timer_driven = false;
+// 当前定时器触发的 ADC
+static SamplingTriggerMode timer_trigger_mode = SAMPLING_TRIGGER_ADC0;
+static AdcResolution active_resolution = ADC_RESOLUTION_12BIT;
+static InterleaveCalibration interleave_cal = {INTERLEAVE_GAIN_ONE, 0};
+static bool interleave_calibrated = false;
+
+// 当前采集配置需要的定时器触发方式
+static SamplingTriggerMode configured_trigger_mode(void) {
+  if (gAcquisitionConfig.interleaved) {
+    return SAMPLING_TRIGGER_INTERLEAVED;
+  }
+  if (gAcquisitionConfig.dual_channel) {
+    return SAMPLING_TRIGGER_SIMULTANEOUS;
+  }
+  return SAMPLING_TRIGGER_ADC0;
+}
+
+// 一个采样间隔内轮流触发的 ADC 数, 决定每个 ADC 的最短触发间隔
+static uint32_t configured_adc_count(void) {
+  return configured_trigger_mode() == SAMPLING_TRIGGER_INTERLEAVED
+             ? INTERLEAVE_ADC_COUNT
+             : 1;
+}
+
+// 当前一帧是否由两个 ADC 交织采集
+static bool frame_interleaved(void) {
+  return timer_driven && timer_trigger_mode == SAMPLING_TRIGGER_INTERLEAVED;
+}
+
+// 当前一帧是否同时采集了电压/电流两个通道
+static bool frame_dual_channel(void) {
+  return timer_driven && timer_trigger_mode == SAMPLING_TRIGGER_SIMULTANEOUS;
+}
+
+/**
+ * @brief 选择转换分辨率: 固定设置直接使用; 自动时选取以最短采样窗口
+ * (1 个时钟) 仍能维持每帧 period_wanted 个周期的最高分辨率
+ */
+static AdcResolution select_resolution(uint32_t signal_freq,
+                                       double period_wanted) {
+  if (gAcquisitionConfig.resolution != ADC_RESOLUTION_AUTO) {
+    return gAcquisitionConfig.resolution;
+  }
+  if (signal_freq == 0) {
+    return ADC_RESOLUTION_12BIT;
+  }
+  double sample_period_ns = 1e9 / signal_freq / SAMPLE_SIZE * period_wanted;
+  for (uint32_t res = ADC_RESOLUTION_12BIT; res < ADC_RESOLUTION_8BIT;
+       res++) {
+    if (adc_conversion_time_ns((AdcResolution)res) + CLK_CYCLE_NS <=
+        sample_period_ns) {
+      return (AdcResolution)res;
+    }
+  }
+  return ADC_RESOLUTION_8BIT;
+}
+
+/**
+ * @brief 按给定定时器参数采样时, 一帧内基波周期数偏离整数的程度
+ */
+static double coherence_error(double f0_hz, const CoherentTiming *timing) {
+  double ticks = (double)timing->prescale * timing->period;
+  double cycles = f0_hz * SAMPLE_SIZE * ticks / CPUCLK_FREQ;
+  return fabs(cycles - timing->cycles);
+}
+
+/**
+ * @brief 把相邻两点间的理想时钟数量化为预分频与计数值
+ * @return false 表示超出 ADC 能力或定时器范围
+ */
+static bool quantize_timing(double ticks, uint32_t adc_count,
+                            CoherentTiming *timing) {
+  if (ticks * adc_count < COHERENT_MIN_PERIOD_TICKS) {
+    return false; // 采样率超出 ADC 能力
+  }
+  // 交织时定时器一个周期内触发每个 ADC 各一次
+  uint32_t max_period = TIMER_MAX_PERIOD / adc_count;
+  uint32_t prescale = (uint32_t)(ticks / max_period) + 1;
+  if (prescale > TIMER_MAX_PRESCALE) {
+    return false; // 采样率过低, 定时器计不到这么长
+  }
+  timing->prescale = (uint16_t)prescale;
+  timing->period = (uint16_t)(ticks / prescale + 0.5);
+  return true;
+}
+
+bool compute_coherent_timing(double f0_hz, uint32_t adc_count,
+                             CoherentTiming *timing) {
+  if (f0_hz <= 0) {
+    return false;
+  }
+
+  bool found = false;
+  double best_error = 0;
+  for (uint32_t cycles = COHERENT_MIN_CYCLES; cycles <= COHERENT_MAX_CYCLES;
+       cycles++) {
+    // 理想的每点时钟数 = CPUCLK / fs, fs = f0 * N / M
+    double ticks = (double)CPUCLK_FREQ * cycles / (f0_hz * SAMPLE_SIZE);
+    CoherentTiming candidate;
+    if (!quantize_timing(ticks, adc_count, &candidate)) {
+      continue;
+    }
+    candidate.cycles = (uint8_t)cycles;
+    double error = coherence_error(f0_hz, &candidate);
+    if (!found || error < best_error) {
+      *timing = candidate;
+      best_error = error;
+      found = true;
+    }
+  }
+  return found && best_error <= COHERENT_MAX_ERROR;
+}
+
+/**
+ * @brief 交织/双通道采集 (非相干) 时按基波频率选择定时器参数, 使每帧约
+ * AUTORANGE_PERIODS 个周期
+ * @param signal_freq 基波频率, 为 0 (未找到基波) 时在当前采样率基础上
+ * 逐级降低搜索, 尚未按当前方式触发时从最高采样率开始
+ */
+static void timer_autorange_timing(uint32_t signal_freq,
+                                   CoherentTiming *timing) {
+  const uint32_t adc_count = configured_adc_count();
+  const double min_ticks = (double)COHERENT_MIN_PERIOD_TICKS / adc_count;
+  const double max_ticks =
+      (double)TIMER_MAX_PRESCALE * (TIMER_MAX_PERIOD / adc_count);
+  double ticks = min_ticks;
+  if (signal_freq != 0) {
+    ticks = (double)CPUCLK_FREQ * AUTORANGE_PERIODS /
+            ((double)signal_freq * SAMPLE_SIZE);
+  } else if (timer_driven && timer_trigger_mode == configured_trigger_mode()) {
+    ticks = (double)coherent_timing.prescale * coherent_timing.period *
+            TIMER_SEARCH_STEP;
+    if (ticks > TIMER_SEARCH_MAX_TICKS) {
+      ticks = min_ticks;
+    }
+  }
+  ticks = ticks < min_ticks ? min_ticks
+                            : (ticks > max_ticks ? max_ticks : ticks);
+  quantize_timing(ticks, adc_count, timing);
+  timing->cycles = 0;
+}
+
+/**
+ * @brief 定时器触发时 ADC 的采样窗口: 在触发间隔内尽量长, 给输入充分的建立时间
+ */
+static uint16_t coherent_sample_clks(const CoherentTiming *timing,
+                                     uint32_t adc_count) {
+  uint32_t ticks = (uint32_t)timing->prescale * timing->period * adc_count;
+  uint32_t clks = ticks > COHERENT_SAMPLE_MARGIN_TICKS
+                      ? ticks - COHERENT_SAMPLE_MARGIN_TICKS
+                      : 1;
+  return clks > ADC_MAX_SAMPLE_CLKS ? ADC_MAX_SAMPLE_CLKS : (uint16_t)clks;
+}
+
+/**
+ * @brief 按给定定时器参数配置定时器, ADC 改为事件触发
+ */
+static void start_timer_driven(const CoherentTiming *timing) {
+  const SamplingTriggerMode mode = configured_trigger_mode();
+  const uint32_t adc_count = configured_adc_count();
+  coherent_timing = *timing;
+  timer_driven = true;
+  timer_trigger_mode = mode;
+  // 触发周期按 12 位转换时间计算, 自动模式下不降低分辨率
+  active_resolution = gAcquisitionConfig.resolution == ADC_RESOLUTION_AUTO
+                          ? ADC_RESOLUTION_12BIT
+                          : gAcquisitionConfig.resolution;
+  gADCCLKS = coherent_sample_clks(timing, adc_count);
+  CUSTOM_SYSCFG_DL_SAMPLING_TIMER_init(timing->prescale, timing->period,
+                                       mode);
+  CUSTOM_SYSCFG_DL_ADC12_0_init(gADCCLKS, true);
+  if (mode != SAMPLING_TRIGGER_ADC0) {
+    CUSTOM_SYSCFG_DL_ADC12_1_init(gADCCLKS);
+  }
+}
+
+/**
+ * @brief ADC 连续转换时采样窗口的下限: 抽取时使抽取前的输入采样率
+ * 不超过 DECIMATION_MAX_INPUT_RATE_HZ, 主循环来得及滤波; 不抽取时为 1
+ */
+static uint16_t min_sample_clks(AdcResolution resolution) {
+  if (get_decimation_ratio() == 1) {
+    return 1;
+  }
+  double clks = (1e9 / DECIMATION_MAX_INPUT_RATE_HZ / get_oversampling_ratio() -
+                 adc_conversion_time_ns(resolution)) /
+                CLK_CYCLE_NS;
+  return clks < 1 ? 1 : (uint16_t)ceil(clks);
+}
+
+/**
+ * @brief 停止定时器触发, 回到 ADC0 连续转换
+ */
+static void stop_timer_driven(void) {
+  if (timer_driven) {
+    DL_TimerG_stopCounter(SAMPLING_TIMER_INST);
+  }
+  timer_driven = false;
+  timer_trigger_mode = SAMPLING_TRIGGER_ADC0;
+  coherent_timing.cycles = 0;
+  uint16_t min_clks = min_sample_clks(active_resolution);
+  if (gADCCLKS < min_clks) {
+    gADCCLKS = min_clks;
+  }
+  CUSTOM_SYSCFG_DL_ADC12_0_init(gADCCLKS, false);
+}
+
+void apply_sampling_clock(void) {
+  // 自动分辨率由下一帧的基波频率决定
+  if (gAcquisitionConfig.resolution != ADC_RESOLUTION_AUTO) {
+    active_resolution = gAcquisitionConfig.resolution;
+  }
+  CUSTOM_SYSCFG_DL_ADC_DMA_init();
+  const SamplingTriggerMode mode = configured_trigger_mode();
+  if (mode == SAMPLING_TRIGGER_ADC0 && DL_ADC12_isPowerEnabled(ADC12_1_INST)) {
+    DL_ADC12_disableConversions(ADC12_1_INST);
+  }
+
+  // 触发方式不变时沿用当前定时器参数, 离开相干模式后不再视为整周期
+  CoherentTiming timing = coherent_timing;
+  bool keep = timer_driven && timer_trigger_mode == mode;
+  if (gAcquisitionConfig.clock_mode != SAMPLING_CLOCK_COHERENT) {
+    timing.cycles = 0;
+  }
+  if (mode != SAMPLING_TRIGGER_ADC0) {
+    if (!keep) {
+      // 从最高采样率开始, 由下一帧的基波频率调整
+      timer_autorange_timing(0, &timing);
+    }
+    start_timer_driven(&timing);
+  } else if (keep && timing.cycles != 0) {
+    start_timer_driven(&timing);
+  } else {
+    // 相干采样未锁定时按 ADC 连续转换采集, 由下一帧的基波频率锁定
+    stop_timer_driven();
+  }
+}
+
+void sampling_start(void) {
+  // 抽取或短时频谱流时 DMA 循环写入环形缓冲区, 由主循环边采集边处理;
+  // 两者共用环形缓冲区, 先关闭不用的一个 (恢复 DMA 设置) 再开始另一个
+  const bool decimating = get_decimation_ratio() > 1;
+  const bool streaming = get_stft_hop() != 0;
+  if (streaming) {
+    decimation_begin(false);
+    stft_begin(true);
+  } else {
+    stft_begin(false);
+    decimation_begin(decimating);
+  }
+  // ADC0 单独连续写入一帧时, 直流/无信号检测的统计量边采集边累加
+  capture_stats_begin(!frame_interleaved() && !frame_dual_channel() &&
+                      !is_trigger_enabled() && !decimating && !streaming);
+  DL_ADC12_enableConversions(ADC12_0_INST);
+  if (timer_driven && timer_trigger_mode != SAMPLING_TRIGGER_ADC0) {
+    // 上一帧停止前 ADC0 可能多转换了一点, 重新装载两个 DMA 通道,
+    // 保证偶数点与奇数点 (双通道时电压与电流) 一一对应
+    CUSTOM_SYSCFG_DL_ADC_DMA_init();
+    DL_ADC12_enableConversions(ADC12_1_INST);
+  } else if (is_trigger_enabled()) {
+    // 上一帧触发后 DMA 改成了单次传输, 恢复为循环写入整个缓冲区
+    CUSTOM_SYSCFG_DL_ADC_DMA_init();
+    trigger_arm();
+  }
+  if (timer_driven) {
+    // 从过零前 period 个时钟开始计数, 第一个事件总是触发 ADC0
+    DL_TimerG_setTimerCount(SAMPLING_TIMER_INST, coherent_timing.period - 1);
+    DL_TimerG_startCounter(SAMPLING_TIMER_INST);
+  } else {
+    DL_ADC12_startConversion(ADC12_0_INST);
+  }
+}
+
+void sampling_stop(void) {
+  if (timer_driven) {
+    DL_TimerG_stopCounter(SAMPLING_TIMER_INST);
+  }
+  DL_ADC12_disableConversions(ADC12_0_INST);
+  if (timer_driven && timer_trigger_mode != SAMPLING_TRIGGER_ADC0) {
+    DL_ADC12_disableConversions(ADC12_1_INST);
+  }
+  if (is_trigger_enabled()) {
+    trigger_disarm();
+  }
+}
+
+bool update_sampling_clock(const AnalysisResult *result) {
+  const uint32_t adc_count = configured_adc_count();
+  if (gAcquisitionConfig.clock_mode == SAMPLING_CLOCK_COHERENT &&
+      result->fundamental_freq_mhz != 0) {
+    double f0_hz = result->fundamental_freq_mhz / 1000.0;
+    CoherentTiming timing;
+    if (compute_coherent_timing(f0_hz, adc_count, &timing)) {
+      if (is_coherent_locked()) {
+        double error = coherence_error(f0_hz, &coherent_timing);
+        if (error <= COHERENT_RETUNE_TOLERANCE ||
+            error <= coherence_error(f0_hz, &timing)) {
+          return false; // 当前参数仍足够相干
+        }
+      }
+      start_timer_driven(&timing);
+      return true;
+    }
+  }
+
+  // 无法相干采样 (未找到基波或频率超出范围)
+  if (configured_trigger_mode() != SAMPLING_TRIGGER_ADC0) {
+    // 交织/双通道采集始终由定时器触发, 按基波频率调整触发间隔
+    CoherentTiming timing;
+    timer_autorange_timing(result->fundamental_freq, &timing);
+    if (timer_driven && coherent_timing.cycles == 0 &&
+        coherent_timing.prescale == timing.prescale &&
+        coherent_timing.period == timing.period) {
+      return false;
+    }
+    start_timer_driven(&timing);
+    return true;
+  }
+
+  // 回到按采样窗口调整采样率
+  bool changed = false;
+  if (timer_driven) {
+    stop_timer_driven();
+    changed = true;
+  }
+  // 硬件平均与抽取时每点包含 ratio 次转换, 每次转换的时间相应缩短;
+  // 两者都是为了提高分辨率, 自动模式下不再降低转换分辨率
+  const uint32_t ratio = get_oversampling_ratio() * get_decimation_ratio();
+  AdcResolution resolution =
+      ratio > 1 && gAcquisitionConfig.resolution == ADC_RESOLUTION_AUTO
+          ? ADC_RESOLUTION_12BIT
+          : select_resolution(result->fundamental_freq, AUTORANGE_PERIODS);
+  uint16_t adcclks_output =
+      calculate_adcclks(result->fundamental_freq, AUTORANGE_PERIODS / ratio,
+                        adc_conversion_time_ns(resolution));
+  uint16_t min_clks = min_sample_clks(resolution);
+  if (adcclks_output < min_clks) {
+    adcclks_output = min_clks;
+  }
+  if (gADCCLKS != adcclks_output || active_resolution != resolution) {
+    gADCCLKS = adcclks_output;
+    active_resolution = resolution;
+    CUSTOM_SYSCFG_DL_ADC12_0_init(adcclks_output, false);
+    changed = true;
+  }
+  return changed;
+}
+
+/**
+ * @brief 硬件平均的无符号结果 (比 12 位多 extra 位) 换算成设定的格式:
+ * 无符号格式四舍五入到 12 位码值, 有符号 Q15 格式保留多出的位
+ */
+static void normalize_oversampled(uint16_t *samples, bool is_signed) {
+  const uint32_t shift = ADC_RESOLUTION_SHIFT(active_resolution);
+  const uint32_t extra = oversampling_extra_bits(get_oversampling_ratio());
+  const uint32_t half = (1U << extra) >> 1;
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    int32_t v = (int32_t)samples[i] << shift;
+    samples[i] = is_signed ? (uint16_t)(int16_t)((v - (ADC_MIDPOINT << extra)) *
+                                                 (1 << (ADC_SIGNED_SHIFT - extra)))
+                           : (uint16_t)((v + half) >> extra);
+  }
+}
+
+void sampling_normalize_frame(uint16_t *samples) {
+  // 触发采集的环形缓冲区先按时间顺序排好 (在换算之前, 按原始刻度找触发点)
+  trigger_align_frame();
+
+  // 抽取的输出已是设定的格式
+  if (is_frame_decimated()) {
+    return;
+  }
+
+  // 有符号格式在任何分辨率下都是左对齐的 Q15, 无需换算
+  const bool is_signed =
+      gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15;
+  if (get_oversampling_ratio() > 1) {
+    normalize_oversampled(samples, is_signed);
+  } else if (!is_signed && active_resolution != ADC_RESOLUTION_12BIT) {
+    const uint32_t shift = ADC_RESOLUTION_SHIFT(active_resolution);
+    const bool dual = frame_dual_channel();
+    for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+      samples[i] <<= shift;
+      if (dual) {
+        VALID_CURRENT_DATA[i] <<= shift;
+      }
+    }
+  }
+
+  if (frame_interleaved()) {
+    if (!interleave_calibrated) {
+      interleave_estimate_mismatch(samples, is_signed, &interleave_cal);
+      interleave_calibrated = true;
+    }
+    interleave_correct_frame(samples, is_signed, &interleave_cal);
+  }
+}
+
+void sampling_save_state(SamplingState *state) {
+  state->adcclks = gADCCLKS;
+  state->resolution = active_resolution;
+  state->timing = coherent_timing;
+  if (!timer_driven) {
+    state->timing.cycles = 0;
+  }
+}
+
+void sampling_restore_state(const SamplingState *state) {
+  gADCCLKS = state->adcclks;
+  active_resolution = state->resolution;
+  if (gAcquisitionConfig.clock_mode == SAMPLING_CLOCK_COHERENT &&
+      state->timing.cycles != 0) {
+    start_timer_driven(&state->timing);
+  } else {
+    stop_timer_driven();
+  }
+}
+
+void request_interleave_calibration(void) { interleave_calibrated = false; }
+
+bool get_interleave_calibration(InterleaveCalibration *cal) {
+  *cal = interleave_cal;
+  return interleave_calibrated;
+}
+
+AdcResolution get_adc_resolution(void) { return active_resolution; }
+
+uint32_t get_oversampling_ratio(void) {
+  return timer_driven ? 1 : gAcquisitionConfig.oversampling;
+}
+
+uint32_t oversampling_extra_bits(uint32_t ratio) {
+  uint32_t extra = 0;
+  while (ratio >= 4) {
+    ratio >>= 2;
+    extra++;
+  }
+  return extra;
+}
+
+uint32_t get_decimation_ratio(void) {
+  return !DECIMATION_SUPPORTED || timer_driven || is_trigger_enabled()
+             ? 1
+             : gAcquisitionConfig.decimation;
+}
+
+uint32_t get_stft_hop(void) {
+  return !STFT_SUPPORTED || timer_driven || is_trigger_enabled() ||
+                 gAcquisitionConfig.decimation != 1 || is_ets_enabled()
+             ? 0
+             : gAcquisitionConfig.stft_hop;
+}
+
+bool is_raw_data_signed(void) {
+  return gAcquisitionConfig.data_format == ADC_DATA_FORMAT_SIGNED_Q15 &&
+         get_oversampling_ratio() == 1;
+}
+
+double get_sample_rate_hz(void) {
+  if (timer_driven) {
+    return (double)CPUCLK_FREQ /
+           ((double)coherent_timing.prescale * coherent_timing.period);
+  }
+  return 1e9 / (get_oversampling_ratio() * get_decimation_ratio() *
+                ((double)gADCCLKS * CLK_CYCLE_NS +
+                 adc_conversion_time_ns(active_resolution)));
+}
+
+bool is_coherent_locked(void) {
+  return timer_driven && coherent_timing.cycles != 0;
+}
+
+CoherentTiming get_coherent_timing(void) { return coherent_timing; }
@@ -0,0 +1,154 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+#include "analysis.h"
+#include "consts.h"
+#include "interleave.h"
+#include <stdbool.h>
+
+// 相干采样时每帧的基波周期数范围, 下限保证基波高于直流判定频点
+// (MIN_FUNDAMENTAL_IDX), 上限保证 N=256 时仍能看到五次谐波
+#define COHERENT_MIN_CYCLES 4
+#define COHERENT_MAX_CYCLES 16
+// 定时器触发周期下限 (CPU 时钟数): 12 位转换 6 个时钟 + 采样窗口 + 余量
+#define COHERENT_MIN_PERIOD_TICKS 8
+// 定时器量化后仍偏离整周期超过此值 (基波高、触发周期只有几十个时钟时)
+// 不再使用相干采样, 回到非相干采样加窗分析
+#define COHERENT_MAX_ERROR 0.05
+// 定时器为 16 位计数 (装载值 = period * ADC 数 - 1), 预分频为 8 位
+#define TIMER_MAX_PERIOD 65535
+#define TIMER_MAX_PRESCALE 256
+// 采样窗口与转换之间留出的时钟数
+#define COHERENT_SAMPLE_MARGIN_TICKS 8
+// ADC 采样窗口寄存器 (SCOMP0) 上限
+#define ADC_MAX_SAMPLE_CLKS 1023
+// 定时器输出给 ADC0 / ADC1 (交织或双通道采集) 的事件通道
+#define ADC0_TRIGGER_CHANNEL 1
+#define ADC1_TRIGGER_CHANNEL 2
+
+// 定时器触发采样的参数: fs = CPUCLK_FREQ / (prescale * period)
+// 交织采集时 fs 为合成后的采样率, 每个 ADC 的触发间隔为 2 * period
+typedef struct {
+  uint16_t prescale; // 预分频 1~256
+  uint16_t period;   // 相邻两点之间的计数值 (分频后的时钟数)
+  uint8_t cycles;    // 一帧 SAMPLE_SIZE 点内的基波周期数 M, 非相干时为 0
+} CoherentTiming;
+
+// 一个输入通道的采样时钟状态, 多通道扫描时按通道缓存, 切换回来时
+// 直接沿用, 不必重新搜索采样率
+typedef struct {
+  uint16_t adcclks;         // ADC 连续转换时的采样窗口 (gADCCLKS)
+  AdcResolution resolution; // 实际使用的转换分辨率
+  CoherentTiming timing;    // 相干采样锁定参数, 未锁定时 cycles 为 0
+} SamplingState;
+
+/**
+ * @brief 计算使一帧恰好包含整数个基波周期的定时器参数
+ * @param f0_hz 基波频率估计值
+ * @param adc_count 轮流触发的 ADC 数 (1 或 INTERLEAVE_ADC_COUNT),
+ * 每个 ADC 的触发间隔不能短于 COHERENT_MIN_PERIOD_TICKS
+ * @param timing 输出定时器参数
+ * @return false 表示该频率无法相干采样 (过高、过低或定时器量化误差过大)
+ * @note 纯计算, 不访问硬件. 在 COHERENT_MIN_CYCLES ~ COHERENT_MAX_CYCLES 中
+ * 选取定时器量化误差最小的周期数
+ */
+bool compute_coherent_timing(double f0_hz, uint32_t adc_count,
+                             CoherentTiming *timing);
+
+/**
+ * @brief 按当前采样时钟模式配置 ADC 与定时器 (切换模式后调用)
+ * @note 非相干模式下解除锁定; 相干模式未锁定时按 ADC 连续转换采集,
+ * 由下一帧的基波频率锁定
+ */
+void apply_sampling_clock(void);
+
+// 开始一帧采集
+void sampling_start(void);
+
+// 停止采集, 在 ADC DMA 完成中断中调用
+void sampling_stop(void);
+
+/**
+ * @brief 根据本帧分析结果调整采样时钟
+ * @return true 表示采样率已改变, 已累加的频谱需作废并重新采样
+ */
+bool update_sampling_clock(const AnalysisResult *result);
+
+/**
+ * @brief 整理刚采完的一帧: 降低分辨率的无符号采样左移到 12 位码值刻度,
+ * 硬件平均的结果换算成设定的格式 (有符号 Q15 格式保留平均多出的位);
+ * 交织采集时校正 ADC1 的偏置与增益失配 (需要时先由本帧估计失配);
+ * 双通道采集时电流缓冲区 VALID_CURRENT_DATA 同样换算
+ * @note 每帧采集完成后、分析和上传之前原地调用一次, 之后的分析与上传
+ * 都按单个 12 位 ADC 的码值处理
+ */
+void sampling_normalize_frame(uint16_t *samples);
+
+/**
+ * @brief 保存当前的采样时钟状态
+ */
+void sampling_save_state(SamplingState *state);
+
+/**
+ * @brief 恢复保存的采样时钟状态, 并按当前输入通道重新配置 ADC
+ * @note 只用于 ADC0 单独采集; 非相干模式或未锁定时回到 ADC 连续转换
+ */
+void sampling_restore_state(const SamplingState *state);
+
+// 当前实际使用的转换分辨率 (不会是 ADC_RESOLUTION_AUTO)
+AdcResolution get_adc_resolution(void);
+
+/**
+ * @brief 当前实际使用的硬件平均过采样倍数
+ * @return 1 表示不平均. 定时器逐点触发 (相干采样锁定、交织/双通道采集)
+ * 时每个事件只转换一次, 固定为 1
+ */
+uint32_t get_oversampling_ratio(void);
+
+/**
+ * @brief 平均结果比转换分辨率多保留的位数
+ * @note 噪声足以抖动最低位时, 每 4 倍过采样有效分辨率提高 1 位,
+ * 平均器除以 ratio >> extra 而不是 ratio, 多出的位留在结果中
+ */
+uint32_t oversampling_extra_bits(uint32_t ratio);
+
+/**
+ * @brief 当前实际使用的抽取倍数
+ * @return 1 表示不抽取. 只用于 ADC0 连续转换且未开启电平触发时
+ * (见 decimate.h), 其余情况固定为 1
+ */
+uint32_t get_decimation_ratio(void);
+
+/**
+ * @brief 当前实际使用的短时频谱流跳步
+ * @return 0 表示不输出短时频谱流. 只用于 ADC0 连续转换且未开启电平触发、
+ * 抽取与等效时间采样时 (见 stft.h), 其余情况固定为 0
+ */
+uint32_t get_stft_hop(void);
+
+/**
+ * @brief 采集缓冲区中 (归一化之前) 的采样是否为有符号左对齐格式
+ * @note 硬件平均时 ADC 固定输出无符号结果, 由 sampling_normalize_frame
+ * 换算成设定的格式
+ */
+bool is_raw_data_signed(void);
+
+/**
+ * @brief 下一帧交织采集时重新估计两个 ADC 的失配
+ */
+void request_interleave_calibration(void);
+
+// 当前交织校正参数, 是否已估计过
+bool get_interleave_calibration(InterleaveCalibration *cal);
+
+// 当前采样率 (Hz)
+double get_sample_rate_hz(void);
+
+/**
+ * @brief 相干采样是否已锁定到基波 (锁定后分析使用矩形窗)
+ */
+bool is_coherent_locked(void);
+
+// 当前相干采样参数, 未锁定时 cycles 为 0
+CoherentTiming get_coherent_timing(void);
+
+#endif
@@ -0,0 +1,95 @@
+#include "scan.h"
+#include "consts.h"
+#include "sampling.h"
+
+// 扫描列表中一个位置的状态
+typedef struct {
+  uint8_t channel;          // ADC0 输入通道号
+  SamplingState sampling;   // 上次离开该通道时的采样时钟状态
+  AnalysisProfile profile;  // 该通道的分析配置
+} ScanSlot;
+
+static ScanSlot scan_slots[SCAN_MAX_CHANNELS];
+static uint8_t scan_count = 0;
+static uint8_t active_slot = 0;
+static uint8_t edit_slot = 0;
+
+/**
+ * @brief 切换到指定位置: 恢复该通道的分析配置与采样时钟状态
+ * @note 频谱平均与阶次跟踪的状态属于上一个通道, 一并丢弃
+ */
+static void enter_slot(uint8_t slot) {
+  active_slot = slot;
+  gAnalysisProfile = scan_slots[slot].profile;
+  gAcquisitionConfig.input_channel = scan_slots[slot].channel;
+  sampling_restore_state(&scan_slots[slot].sampling);
+  reset_spectrum_average();
+  reset_order_tracking();
+}
+
+bool scan_configure(const uint8_t *channels, uint8_t count) {
+  if (count > SCAN_MAX_CHANNELS) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (channels[i] >= ADC_INPUT_CHANNEL_COUNT) {
+      return false;
+    }
+  }
+
+  if (count == 0) {
+    // 停止扫描: 保留当前通道的分析配置, 回到默认输入通道
+    scan_count = 0;
+    active_slot = 0;
+    edit_slot = 0;
+    gAcquisitionConfig.input_channel = ADC_DEFAULT_INPUT_CHANNEL;
+    reset_order_tracking();
+    return true;
+  }
+
+  // 各通道从当前状态开始, 之后各自调整
+  SamplingState sampling;
+  sampling_save_state(&sampling);
+  for (uint8_t i = 0; i < count; i++) {
+    scan_slots[i].channel = channels[i];
+    scan_slots[i].sampling = sampling;
+    scan_slots[i].profile = gAnalysisProfile;
+  }
+  scan_count = count;
+  edit_slot = 0;
+  enter_slot(0);
+  return true;
+}
+
+bool is_scan_enabled(void) { return scan_count != 0; }
+
+uint8_t scan_channel_count(void) { return scan_count; }
+
+uint8_t scan_active_slot(void) { return active_slot; }
+
+void scan_next_channel(void) {
+  if (scan_count == 0) {
+    return;
+  }
+  ScanSlot *current = &scan_slots[active_slot];
+  sampling_save_state(&current->sampling);
+  current->profile = gAnalysisProfile;
+  enter_slot((uint8_t)((active_slot + 1) % scan_count));
+}
+
+bool scan_select_edit_slot(uint8_t slot) {
+  if (slot >= scan_count) {
+    return false;
+  }
+  edit_slot = slot;
+  return true;
+}
+
+uint8_t scan_edit_slot(void) { return edit_slot; }
+
+AnalysisProfile *scan_edit_profile(void) {
+  if (scan_count == 0 || edit_slot == active_slot) {
+    return &gAnalysisProfile;
+  }
+  return &scan_slots[edit_slot].profile;
+}
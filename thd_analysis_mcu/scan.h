@@ -0,0 +1,53 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "analysis.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 扫描列表最多包含的输入通道数 (受命令包 4 个数据字节限制)
+#define SCAN_MAX_CHANNELS 4
+
+/**
+ * @brief 设置多通道轮流扫描的输入通道列表
+ * @param channels ADC0 输入通道号 (0 ~ ADC_INPUT_CHANNEL_COUNT-1), 可重复
+ * @param count 通道数, 0 表示停止扫描并回到默认输入通道
+ * @return false 表示参数无效, 设置不变
+ * @note 开始扫描时各通道的采样时钟状态与分析配置都从当前状态复制,
+ * 并立即切换到列表中的第一个通道
+ */
+bool scan_configure(const uint8_t *channels, uint8_t count);
+
+// 是否正在多通道扫描
+bool is_scan_enabled(void);
+
+// 扫描列表中的通道数, 未扫描时为 0
+uint8_t scan_channel_count(void);
+
+// 当前采集的通道在扫描列表中的位置
+uint8_t scan_active_slot(void);
+
+/**
+ * @brief 切换到扫描列表中的下一个通道
+ * @note 在一帧结果上报之后调用 (频谱平均完成后才会上报, 因此平均不会
+ * 跨通道混合). 保存当前通道的采样时钟状态与分析配置, 恢复下一个通道的
+ */
+void scan_next_channel(void);
+
+/**
+ * @brief 选择之后的分析配置命令作用于扫描列表中的哪个位置
+ * @return false 表示未在扫描或 slot 超出列表
+ */
+bool scan_select_edit_slot(uint8_t slot);
+
+// 分析配置命令作用的位置
+uint8_t scan_edit_slot(void);
+
+/**
+ * @brief 分析配置命令应修改的配置
+ * @return 未扫描或所选位置正在采集时为 gAnalysisProfile, 否则为该位置
+ * 缓存的配置 (切换到该通道时生效)
+ */
+AnalysisProfile *scan_edit_profile(void);
+
+#endif /* SCAN_H */
@@ -0,0 +1,250 @@
+#include "stft.h"
+#include "custom_init.h"
+#include "fft.h"
+#include "sampling.h"
+#include "ti_msp_dl_config.h"
+#include <math.h>
+
+#define RING_SAMPLES DECIMATION_RING_SAMPLES
+#define RING_WORDS (RING_SAMPLES / 2)
+// 计算一行时从环形缓冲区复制 STFT_FFT_LEN 点, 复制期间 DMA 继续写入;
+// 一行的起点落后写入位置超过 RING_SAMPLES - STFT_RING_GUARD 时视为已被覆盖
+#define STFT_RING_GUARD STFT_FFT_LEN
+// 基波最低频点: 汉宁窗下直流占第 0、1 点, 基波与各次谐波的 3 点窗口互不重叠
+#define STFT_MIN_FUNDAMENTAL_BIN 3
+// 基波频点的功率须为直流区以外平均功率的倍数 (12dB), 纯噪声的行中
+// 最大频点超过平均值 16 倍的概率约为 10^-5
+#define STFT_MIN_PEAK_RATIO 16
+#define STFT_FFT_LEN_LOG2 7
+// 满量程正弦 (Q15 幅度 2^15) 加汉宁窗 (相干增益 1/2) 后频点幅度为
+// 2^15 * STFT_FFT_LEN / 4, 其平方的 log2
+#define STFT_FULL_SCALE_LOG2 (2 * (15 + STFT_FFT_LEN_LOG2 - 2))
+
+_Static_assert((1 << STFT_FFT_LEN_LOG2) == STFT_FFT_LEN,
+               "STFT_FFT_LEN_LOG2 must match STFT_FFT_LEN");
+_Static_assert(SAMPLE_SIZE >= STFT_FFT_LEN,
+               "SAMPLE_SIZE too small for the STFT frame");
+_Static_assert(RING_SAMPLES >= STFT_FFT_LEN + STFT_MAX_HOP + STFT_RING_GUARD,
+               "STFT ring too small for one frame and one hop");
+
+// 环形缓冲区写满的圈数
+static volatile uint32_t laps = 0;
+// 下一行最后一个采样之后的位置 (从本次采集开头算起的采样数)
+static uint32_t next_end = 0;
+static uint32_t hop = STFT_FFT_LEN / 2;
+static uint16_t seq = 0;
+// 本次还需输出的行数, 0 表示一直输出到收到新命令
+static uint16_t rows_left = 0;
+static bool continuous = false;
+static uint32_t dropped = 0;
+static uint32_t sample_rate_hz = 0;
+static bool running = false;
+static bool ring_in_use = false;
+
+// 原始采样换算到 Q15 的参数, 由 stft_begin 按当前格式与分辨率确定
+static bool raw_signed = false;
+static uint32_t raw_shift = 0;  // 无符号原始采样换算到 12 位刻度的左移
+static int32_t raw_offset = 0;  // 无符号原始采样的中点 (含硬件平均多出的位)
+static uint32_t q15_shift = 0;  // 去中点后换算到 Q15 的左移
+
+void stft_begin(bool enable) {
+  running = false;
+  if (!enable) {
+    if (ring_in_use) {
+      // 恢复为一帧直接写入采集缓冲区
+      CUSTOM_SYSCFG_DL_ADC_DMA_init();
+      ring_in_use = false;
+    }
+    return;
+  }
+
+  raw_signed = is_raw_data_signed();
+  const uint32_t in_extra =
+      raw_signed ? 0 : oversampling_extra_bits(get_oversampling_ratio());
+  raw_shift = raw_signed ? 0 : ADC_RESOLUTION_SHIFT(get_adc_resolution());
+  raw_offset = ADC_MIDPOINT << in_extra;
+  q15_shift = ADC_SIGNED_SHIFT - in_extra;
+
+  hop = get_stft_hop();
+  rows_left = gAcquisitionConfig.stft_rows;
+  continuous = rows_left == 0;
+  seq = 0;
+  sample_rate_hz = (uint32_t)lround(get_sample_rate_hz());
+  // 丢弃 ADC 启动的采样
+  next_end = ADC_DISCARD_SAMPLES + STFT_FFT_LEN;
+  laps = 0;
+
+  DL_DMA_disableChannel(DMA, DMA_CH0_CHAN_ID);
+  DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)gCurrentSamples);
+  DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, RING_WORDS);
+  DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+  ring_in_use = true;
+  running = true;
+}
+
+bool stft_running(void) { return running; }
+
+void stft_stop(void) { running = false; }
+
+void stft_on_dma_done(void) { laps++; }
+
+uint32_t stft_dropped_rows(void) { return dropped; }
+
+static uint32_t bit_length(uint32_t v) {
+  uint32_t n = 0;
+  while (v != 0) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+}
+
+// log2(1 + i/16), Q8
+static const uint16_t log2_table[17] = {0,   22,  44,  63,  82,  100,
+                                        118, 134, 150, 165, 179, 193,
+                                        207, 220, 232, 244, 256};
+
+/**
+ * @brief log2(v), Q8; 尾数按高 4 位查表, 其余位线性插值 (误差约 0.002)
+ * @param v 大于 0
+ */
+static int32_t log2_q8(uint32_t v) {
+  const uint32_t n = bit_length(v) - 1;
+  // 归一化到 [2^16, 2^17)
+  const uint32_t m = n >= 16 ? v >> (n - 16) : v << (16 - n);
+  const uint32_t frac = m - (1U << 16);
+  const uint32_t i = frac >> 12;
+  const uint32_t r = frac & 0xFFF;
+  return (int32_t)(n << 8) + log2_table[i] +
+         (int32_t)(((log2_table[i + 1] - log2_table[i]) * r) >> 12);
+}
+
+/**
+ * @brief 频点功率换算为 0.5dB 一档的幅度 (255 为 0dBFS)
+ * @param exponent FFT 的块浮点指数, 真实功率 = power * 4^exponent
+ */
+static uint8_t encode_level(uint32_t power, uint32_t exponent) {
+  if (power == 0) {
+    return 0;
+  }
+  // log2(P / 满量程功率), Q8; 20*log10(2) * 2 档 / 256 = 1541 / 65536
+  const int32_t l8 = log2_q8(power) +
+                     ((int32_t)(2 * exponent) - STFT_FULL_SCALE_LOG2) * 256;
+  const int32_t level = 255 + ((l8 * 1541 + 32768) >> 16);
+  return (uint8_t)(level < 0 ? 0 : (level > 255 ? 255 : level));
+}
+
+/**
+ * @brief 由一行的功率谱估计基波位置与 THD
+ * @details 基波取直流区以外最大的频点, 按汉宁窗主瓣的幅度比求小数偏移;
+ * 基波与各次谐波的功率各取中心频点及左右各一点之和 (汉宁窗主瓣能量的
+ * 95% 以上), 谐波中心为基波小数频点的整数倍
+ */
+static void row_thd(const uint32_t *power, StftRow *row) {
+  uint64_t total = 0;
+  uint32_t k = STFT_MIN_FUNDAMENTAL_BIN;
+  for (uint32_t i = 2; i < STFT_BINS; i++) {
+    total += power[i];
+    if (i >= STFT_MIN_FUNDAMENTAL_BIN && i < STFT_BINS - 1 &&
+        power[i] > power[k]) {
+      k = i;
+    }
+  }
+  row->fundamental_q8 = 0;
+  row->thd = STFT_THD_NONE;
+  if (power[k] == 0 ||
+      (uint64_t)power[k] * (STFT_BINS - 2) < STFT_MIN_PEAK_RATIO * total) {
+    return;
+  }
+
+  // 汉宁窗: 相邻频点幅度比 r = (1 + d) / (2 - d), d = (2r - 1) / (1 + r)
+  const double left = sqrt((double)power[k - 1]);
+  const double peak = sqrt((double)power[k]);
+  const double right = sqrt((double)power[k + 1]);
+  const double side = right >= left ? right : left;
+  double d = (2 * side - peak) / (peak + side);
+  d = d < 0 ? 0 : (d > 0.5 ? 0.5 : d);
+  const double fundamental = right >= left ? k + d : k - d;
+
+  const uint64_t p1 = (uint64_t)power[k - 1] + power[k] + power[k + 1];
+  uint64_t harmonics = 0;
+  for (uint32_t h = 2;; h++) {
+    const uint32_t c = (uint32_t)lround(h * fundamental);
+    if (c + 1 >= STFT_BINS) {
+      break;
+    }
+    harmonics += (uint64_t)power[c - 1] + power[c] + power[c + 1];
+  }
+  const double thd = sqrt((double)harmonics / (double)p1) * 10000.0;
+  row->fundamental_q8 = (uint16_t)lround(fundamental * 256);
+  row->thd = thd < STFT_THD_NONE - 1 ? (uint16_t)lround(thd)
+                                     : STFT_THD_NONE - 1;
+}
+
+/**
+ * @brief 从环形缓冲区取 start 起的 STFT_FFT_LEN 点, 加窗做 FFT, 得到一行
+ */
+static void compute_row(uint32_t start, StftRow *row) {
+  q15_t *buffer = (q15_t *)VALID_ADC_DATA;
+  for (uint32_t n = 0; n < STFT_FFT_LEN; n++) {
+    const uint16_t raw = gCurrentSamples[(start + n) & (RING_SAMPLES - 1)];
+    int32_t x = raw_signed
+                    ? (int32_t)(int16_t)raw
+                    : (((int32_t)raw << raw_shift) - raw_offset) << q15_shift;
+    x = x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+    // 周期汉宁窗 (1 - cos(2*pi*n/L)) / 2, 相邻行重叠一半时权重之和恒定
+    int32_t c, s;
+    fft_sin_cos_q15(n * (SAMPLE_SIZE / STFT_FFT_LEN), &c, &s);
+    const int32_t w = (32768 - c) >> 1;
+    buffer[n] = (q15_t)((x * w + 0x4000) >> 15);
+  }
+  const uint32_t exponent = rfft_q15_inplace(buffer, STFT_FFT_LEN);
+
+  // 直流频点为实数, 放在 buffer[0] (buffer[1] 为奈奎斯特频点, 不上报)
+  uint32_t power[STFT_BINS];
+  power[0] = (uint32_t)(buffer[0] * buffer[0]);
+  for (uint32_t k = 1; k < STFT_BINS; k++) {
+    const int32_t re = buffer[2 * k];
+    const int32_t im = buffer[2 * k + 1];
+    power[k] = (uint32_t)(re * re) + (uint32_t)(im * im);
+  }
+  for (uint32_t k = 0; k < STFT_BINS; k++) {
+    row->levels[k] = encode_level(power[k], exponent);
+  }
+  row_thd(power, row);
+}
+
+bool stft_poll(StftRow *row) {
+  if (!running) {
+    return false;
+  }
+  // 读取剩余字数期间若恰好写满一圈, 重新读取
+  uint32_t lap_count;
+  uint32_t remaining;
+  do {
+    lap_count = laps;
+    remaining = DL_DMA_getTransferSize(DMA, DMA_CH0_CHAN_ID);
+  } while (lap_count != laps);
+  // DMA 已重装而完成中断尚未执行时, 算出的位置会落后, 等下一次
+  const uint32_t written =
+      lap_count * RING_SAMPLES + (RING_WORDS - remaining) * 2;
+  if ((int32_t)(written - next_end) < 0) {
+    return false;
+  }
+  if (written - (next_end - STFT_FFT_LEN) > RING_SAMPLES - STFT_RING_GUARD) {
+    // 发送跟不上: 跳到最新的完整一行, 行号随之跳过
+    const uint32_t skip = (written - next_end) / hop;
+    next_end += skip * hop;
+    seq += (uint16_t)skip;
+    dropped += skip;
+  }
+
+  compute_row(next_end - STFT_FFT_LEN, row);
+  row->seq = seq++;
+  row->sample_rate_hz = sample_rate_hz;
+  next_end += hop;
+  if (!continuous && --rows_left == 0) {
+    running = false;
+  }
+  return true;
+}
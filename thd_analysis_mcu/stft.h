@@ -0,0 +1,72 @@
+#ifndef STFT_H
+#define STFT_H
+
+#include "consts.h"
+#include "decimate.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 短时频谱 (STFT) 流: ADC0 连续转换, DMA 循环写入环形缓冲区 (与抽取前端
+// 共用), 主循环每凑够一个跳步的新采样, 就对最近 STFT_FFT_LEN 点加汉宁窗做一次
+// 实数 FFT, 把压缩的幅度谱与本行的 THD 作为一行发出, 上位机拼成瀑布图.
+// 电机起动、负载突变等非平稳信号在整帧分析中只剩一个平均的 THD
+
+// 与抽取前端相同, 环形缓冲区借用电流通道的采集缓冲区
+#define STFT_SUPPORTED DECIMATION_SUPPORTED
+// 每行 FFT 的点数与上报的频点数 (0 ~ STFT_BINS-1, 不含奈奎斯特频点)
+#define STFT_FFT_LEN 128
+#define STFT_BINS (STFT_FFT_LEN / 2)
+// 跳步 (相邻两行起点相差的采样数) 范围; 跳步为 STFT_FFT_LEN / 2 时相邻两行
+// 重叠一半, 汉宁窗下每个采样的权重之和恒定
+#define STFT_MIN_HOP 8
+#define STFT_MAX_HOP STFT_FFT_LEN
+// 一行数据包的字节数: 包头 5 + 行号 2 + 采样率 4 + 基波位置 2 + THD 2
+// + 幅度 STFT_BINS + 包尾 5
+#define STFT_ROW_PACKET_SIZE (20 + STFT_BINS)
+// 行中 THD 的取值: 未找到基波
+#define STFT_THD_NONE 0xFFFF
+
+// 一行短时频谱
+typedef struct {
+  uint16_t seq;           // 行号, 每次开始采集从 0 计, 丢行时跳号
+  uint32_t sample_rate_hz;
+  uint16_t fundamental_q8; // 基波位置 (频点, Q8), 0 表示未找到
+  // 单位 0.01% (不用分析结果的 RATIO_SCALE): 行 THD 只是趋势指示, 精度
+  // 远不到 0.001%, 16 位可表示到 655.34%. 未找到基波时为 STFT_THD_NONE
+  uint16_t thd;
+  // 各频点幅度, 0.5dB 一档: 255 为满量程正弦 (0dBFS), 每减 1 低 0.5dB,
+  // 0 表示不高于 -127.5dBFS
+  uint8_t levels[STFT_BINS];
+} StftRow;
+
+/**
+ * @brief 开始一次采集时调用
+ * @param enable 本次是否输出短时频谱流; true 时 DMA 改为循环写入环形缓冲区,
+ * false 时若上一次在输出则恢复为直接写入采集缓冲区
+ * @note 在启动 ADC 转换之前调用; 与 decimation_begin 互斥,
+ * 先关闭不用的一个 (见 sampling_start)
+ */
+void stft_begin(bool enable);
+
+// 是否在输出短时频谱流 (设定的行数尚未输出完), 此时主循环不应休眠
+bool stft_running(void);
+
+// 提前结束本次输出 (收到新命令时)
+void stft_stop(void);
+
+/**
+ * @brief 环形缓冲区写满一圈, 在 ADC0 的 DMA 完成中断中调用
+ */
+void stft_on_dma_done(void);
+
+/**
+ * @brief 有一个跳步的新采样时计算一行
+ * @return true 表示 row 中有新的一行待发送
+ * @note 在主循环的采样状态下反复调用; 采集缓冲区此时空闲, 用作 FFT 缓冲区
+ */
+bool stft_poll(StftRow *row);
+
+// 因来不及处理而跳过的累计行数
+uint32_t stft_dropped_rows(void);
+
+#endif /* STFT_H */
@@ -0,0 +1,78 @@
+// fft.c 的耗时测量: 各点数的 rfft_q15_inplace / cfft_q15_inplace 以及
+// 0x0F 命令的 FFT 阶段和双通道两路频谱的两种做法 (合成一次复数 FFT 再拆分,
+// 两路各做一次实数 FFT).
+// 计时来自模拟的 SysTick, 即主机耗时按 CPUCLK_FREQ 折算的周期数,
+// 只用于比较不同点数或修改前后的相对开销; 器件上的周期数以 0x0F 命令为准
+#include "analysis.h"
+#include "consts.h"
+#include "fft.h"
+#include "support.h"
+#include "utils.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define REPEATS 200
+
+static q15_t buffer[2 * SAMPLE_SIZE];
+
+static void fill(uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    buffer[i] = (q15_t)lround(16000 * test_random());
+  }
+}
+
+// 多次运行取平均, 每次重新填充输入 (不计时)
+static double average_cycles(bool complex_fft, uint32_t len) {
+  uint32_t total = 0;
+  for (uint32_t r = 0; r < REPEATS; r++) {
+    fill(complex_fft ? 2 * len : len);
+    const uint32_t start = get_cycle_count();
+    if (complex_fft) {
+      cfft_q15_inplace(buffer, len);
+    } else {
+      rfft_q15_inplace(buffer, len);
+    }
+    total += get_cycle_count() - start;
+  }
+  return (double)total / REPEATS;
+}
+
+// 0x0F 命令一个阶段 (基4 Q15) 多次运行的最小周期数 (与 bench_frontend 相同,
+// 排除主机调度的干扰)
+static double stage_cycles(BenchmarkStage stage) {
+  uint32_t best = UINT32_MAX;
+  for (uint32_t r = 0; r < REPEATS; r++) {
+    const uint32_t cycles =
+        benchmark_analysis_stage(stage, FFT_ENGINE_RADIX4, FFT_PRECISION_Q15);
+    best = cycles < best ? cycles : best;
+  }
+  return best;
+}
+
+int main(void) {
+  printf("SAMPLE_SIZE %u, host cycles @ %u Hz (not device cycles)\n",
+         SAMPLE_SIZE, CPUCLK_FREQ);
+  printf("%6s %12s %12s\n", "len", "rfft", "cfft");
+  for (uint32_t len = 16; len <= SAMPLE_SIZE; len *= 2) {
+    printf("%6u %12.0f %12.0f\n", len, average_cycles(false, len),
+           average_cycles(true, len));
+  }
+
+  // 0x0F 的 FFT 阶段 (基4 Q15), 采集缓冲区为 consts.c 中的测试数据
+  if (!BENCHMARK_SUPPORTED) {
+    printf("0x0F not supported at this SAMPLE_SIZE\n");
+    return 0;
+  }
+  printf("0x0F FFT stage (radix-4 Q15): %.0f\n",
+         stage_cycles(BENCHMARK_STAGE_FFT));
+  // 电流通道为同一帧延迟 1/4 帧, 两路都有信号
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    VALID_CURRENT_DATA[i] = VALID_ADC_DATA[(i + SAMPLE_SIZE / 4) % SAMPLE_SIZE];
+  }
+  const double dual = stage_cycles(BENCHMARK_STAGE_DUAL);
+  const double separate = stage_cycles(BENCHMARK_STAGE_DUAL_SEPARATE);
+  printf("0x0F dual channel: complex FFT + split %.0f, two real FFTs %.0f "
+         "(%.2f x)\n",
+         dual, separate, dual / separate);
+  return 0;
+}
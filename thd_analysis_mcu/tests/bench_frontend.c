@@ -0,0 +1,108 @@
+// FFT 之前各前端处理的耗时测量: 阶次跟踪重采样 (resample_frame),
+// 0x0F 命令的前端阶段在两种 ADC 结果格式下的耗时, 以及细化一个单音.
+// 计时来自模拟的 SysTick, 即主机耗时按 CPUCLK_FREQ 折算的周期数,
+// 只用于比较不同点数或修改前后的相对开销; 器件上的周期数以 0x0F 命令为准
+#include "analysis.h"
+#include "consts.h"
+#include "resample.h"
+#include "support.h"
+#include "utils.h"
+#include "zoom.h"
+#include <math.h>
+
+#define REPEATS 200
+
+static uint16_t source[SAMPLE_SIZE];
+static q15_t resampled[SAMPLE_SIZE];
+
+static void fill(void) {
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    source[i] = (uint16_t)lround(ADC_MIDPOINT + 1800 * test_random());
+  }
+}
+
+// 与 0x0F 阶段 0x02 尚未重采样过时相同的步长 0.99
+static double resample_cycles(void) {
+  const uint32_t step_q20 = (uint32_t)(0.99 * RESAMPLE_STEP_ONE);
+  uint32_t total = 0;
+  for (uint32_t r = 0; r < REPEATS; r++) {
+    fill();
+    const uint32_t start = get_cycle_count();
+    resample_frame(source, false, step_q20, resampled);
+    total += get_cycle_count() - start;
+  }
+  return (double)total / REPEATS;
+}
+
+// 0x0F 的前端阶段 (去直流、缩放与加窗), 采集缓冲区按格式填入采样.
+// 一次只有 1~2us, 取多次中的最小值以排除主机调度的干扰
+static uint32_t preprocess_cycles(AdcDataFormat format,
+                                  FftPrecision precision) {
+  gAcquisitionConfig.data_format = format;
+  uint32_t best = UINT32_MAX;
+  for (uint32_t r = 0; r < REPEATS; r++) {
+    fill();
+    for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+      VALID_ADC_DATA[i] =
+          format == ADC_DATA_FORMAT_SIGNED_Q15
+              ? (uint16_t)(((int16_t)source[i] - ADC_MIDPOINT)
+                           << ADC_SIGNED_SHIFT)
+              : source[i];
+    }
+    const uint32_t cycles = benchmark_analysis_stage(
+        BENCHMARK_STAGE_PREPROCESS, FFT_ENGINE_RADIX4, precision);
+    if (cycles < best) {
+      best = cycles;
+    }
+  }
+  return best;
+}
+
+// 对一帧 37.3 个周期的正弦执行 0x0F 的某一阶段 (基4 Q15), 取多次中的最小值
+static uint32_t tone_stage_cycles(BenchmarkStage stage) {
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    VALID_ADC_DATA[i] = (uint16_t)lround(
+        ADC_MIDPOINT + 1800 * sin(2 * M_PI * 37.3 * i / SAMPLE_SIZE));
+  }
+  uint32_t best = UINT32_MAX;
+  for (uint32_t r = 0; r < REPEATS; r++) {
+    const uint32_t cycles =
+        benchmark_analysis_stage(stage, FFT_ENGINE_RADIX4, FFT_PRECISION_Q15);
+    if (cycles < best) {
+      best = cycles;
+    }
+  }
+  return best;
+}
+
+int main(void) {
+  printf("SAMPLE_SIZE %u, host cycles @ %u Hz (not device cycles)\n",
+         SAMPLE_SIZE, CPUCLK_FREQ);
+  printf("resample (step 0.99): %.0f\n", resample_cycles());
+
+  if (!BENCHMARK_SUPPORTED) {
+    printf("0x0F not supported at this SAMPLE_SIZE\n");
+    return 0;
+  }
+  printf("%-20s %10s %10s\n", "0x0F preprocess", "unsigned", "signed");
+  printf("%-20s %10u %10u\n", "Q15",
+         preprocess_cycles(ADC_DATA_FORMAT_UNSIGNED, FFT_PRECISION_Q15),
+         preprocess_cycles(ADC_DATA_FORMAT_SIGNED_Q15, FFT_PRECISION_Q15));
+  printf("%-20s %10u %10u\n", "Q31",
+         preprocess_cycles(ADC_DATA_FORMAT_UNSIGNED, FFT_PRECISION_Q31),
+         preprocess_cycles(ADC_DATA_FORMAT_SIGNED_Q15, FFT_PRECISION_Q31));
+
+  // 0x0F 的细化阶段: 一个单音, 各细化倍数, 以及相对 FFT 阶段的倍数
+  // (readme 中细化的耗时预算按此比值给出)
+  gAcquisitionConfig.data_format = ADC_DATA_FORMAT_UNSIGNED;
+  const uint32_t fft = tone_stage_cycles(BENCHMARK_STAGE_FFT);
+  printf("0x0F fft (radix-4 Q15): %u\n", fft);
+  for (uint8_t factor = ZOOM_MIN_FACTOR; factor <= ZOOM_MAX_FACTOR;
+       factor *= 2) {
+    gAnalysisProfile.zoom_factor = factor;
+    const uint32_t zoom = tone_stage_cycles(BENCHMARK_STAGE_ZOOM);
+    printf("zoom one tone, Z = %2u: %u (%.2f x fft)\n", factor, zoom,
+           (double)zoom / fft);
+  }
+  return 0;
+}
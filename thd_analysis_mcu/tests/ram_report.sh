@@ -0,0 +1,64 @@
+#!/bin/sh
+# 按主机构建的目标文件生成 readme "采样点数与 RAM 占用" 中的静态 RAM 表:
+# 用 nm 读出固件各目标文件 (含 main.c, 不含测试与模拟层) 中 .bss/.data 符号
+# (含 static) 的大小, 每种 SAMPLE_SIZE 一行. 大块缓冲区单独列出, 其余各模块的
+# 静态变量 (短时频谱、抽取、采集统计、扫描通道表等) 合为一列. 缓冲区都是定长
+# 数组, 大小与器件上相同; 主机上指针为 8 字节, 其余一列略大于器件. 栈与堆
+# 不在表中, 器件上的总 RAM 占用仍以 CCS 生成的 .map 文件为准
+#
+#   tests/ram_report.sh build          # 输出表格
+#   tests/ram_report.sh build --check  # 合计超过 RAM_BUFFER_BUDGET 时返回非零
+set -e
+
+build=${1:-build}
+check=${2:-}
+firmware_dir=$(cd "$(dirname "$0")/.." && pwd)
+symbols="gADCRealSamples gCurrentSamples workspace power_acc \
+harmonic_magnitudes bin_sum+bin_count droop_compensation"
+# 预算与 analysis.c 中的 _Static_assert 相同
+budget=$(sed -n 's/^#define RAM_BUFFER_BUDGET (\([0-9]*\) \* 1024)$/\1/p' \
+  "$firmware_dir/analysis.c")
+budget=$((budget * 1024))
+
+# 固件源码 (目录下的 .c) 编译出的目标文件
+firmware_objects() {
+  find "$build/CMakeFiles/firmware_$1.dir" "$build/CMakeFiles/main_$1.dir" \
+    -name '*.c.o' 2>/dev/null | while read -r object; do
+    source=$(basename "$object" .o)
+    case "$object" in
+    */tests/*) ;;
+    *) [ -f "$firmware_dir/$source" ] && echo "$object" ;;
+    esac
+  done
+}
+
+rows=$(for dir in "$build"/CMakeFiles/firmware_*.dir; do
+  size=${dir##*firmware_}
+  size=${size%.dir}
+  objects=$(firmware_objects "$size")
+  [ -n "$objects" ] || continue
+  echo "$size $(echo "$objects" | xargs nm -S --radix=d | awk -v symbols="$symbols" '
+    NF == 4 && $3 ~ /^[bBdD]$/ { bytes[$4] = $2 + 0; all += $2 }
+    END {
+      n = split(symbols, list, " ")
+      row = ""
+      for (i = 1; i <= n; i++) {
+        m = split(list[i], parts, "+")
+        sum = 0
+        for (j = 1; j <= m; j++) sum += bytes[parts[j]]
+        row = row " | " sum
+        listed += sum
+      }
+      print row " | " all - listed " | " all + 0 " |"
+    }')"
+done | sort -n)
+
+if [ "$check" != "--check" ]; then
+  echo "$rows" | sed 's/^\([0-9]*\) /| \1/'
+  exit 0
+fi
+# 每行最后一列为合计
+echo "$rows" | awk -v budget="$budget" '
+  { total = $(NF - 1); print "SAMPLE_SIZE " $1 ": " total " bytes (budget " budget ")" }
+  total > budget { over = 1 }
+  END { exit over || NR == 0 }'
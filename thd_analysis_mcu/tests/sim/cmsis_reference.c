@@ -0,0 +1,107 @@
+// CMSIS-DSP 替身: 以双精度 DFT 实现固件用到的函数, 输出缩放与定点格式
+// 与 CMSIS 相同 (实数 FFT 输出 X[k] / N, 按四舍五入饱和到 q15 / q31)
+#include "arm_math.h"
+#include <stdlib.h>
+
+static double saturate(double v, double limit) {
+  v = round(v);
+  if (v > limit - 1) {
+    return limit - 1;
+  }
+  if (v < -limit) {
+    return -limit;
+  }
+  return v;
+}
+
+// 实数 DFT, 输出 N 个复数频点 (实部/虚部交替), 缩放 1/N
+static void real_dft(const double *in, uint32_t n, double *out) {
+  double *c = malloc(sizeof(double) * n);
+  double *s = malloc(sizeof(double) * n);
+  for (uint32_t i = 0; i < n; i++) {
+    c[i] = cos(2 * M_PI * i / n);
+    s[i] = sin(2 * M_PI * i / n);
+  }
+  for (uint32_t k = 0; k < n; k++) {
+    double re = 0, im = 0;
+    uint32_t idx = 0;
+    for (uint32_t i = 0; i < n; i++) {
+      re += in[i] * c[idx];
+      im -= in[i] * s[idx];
+      idx += k;
+      if (idx >= n) {
+        idx -= n;
+      }
+    }
+    out[2 * k] = re / n;
+    out[2 * k + 1] = im / n;
+  }
+  free(c);
+  free(s);
+}
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, uint32_t fftLenReal,
+                             uint32_t ifftFlagR, uint32_t bitReverseFlag) {
+  S->fftLenReal = fftLenReal;
+  S->ifftFlagR = (uint8_t)ifftFlagR;
+  S->bitReverseFlagR = (uint8_t)bitReverseFlag;
+  return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_rfft_init_q31(arm_rfft_instance_q31 *S, uint32_t fftLenReal,
+                             uint32_t ifftFlagR, uint32_t bitReverseFlag) {
+  S->fftLenReal = fftLenReal;
+  S->ifftFlagR = (uint8_t)ifftFlagR;
+  S->bitReverseFlagR = (uint8_t)bitReverseFlag;
+  return ARM_MATH_SUCCESS;
+}
+
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst) {
+  const uint32_t n = S->fftLenReal;
+  double *in = calloc(n, sizeof(double));
+  double *out = calloc(2 * n, sizeof(double));
+  for (uint32_t i = 0; i < n; i++) {
+    in[i] = pSrc[i];
+  }
+  real_dft(in, n, out);
+  for (uint32_t i = 0; i < 2 * n; i++) {
+    pDst[i] = (q15_t)saturate(out[i], 32768.0);
+  }
+  free(in);
+  free(out);
+}
+
+void arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst) {
+  const uint32_t n = S->fftLenReal;
+  double *in = calloc(n, sizeof(double));
+  double *out = calloc(2 * n, sizeof(double));
+  for (uint32_t i = 0; i < n; i++) {
+    in[i] = pSrc[i];
+  }
+  real_dft(in, n, out);
+  for (uint32_t i = 0; i < 2 * n; i++) {
+    pDst[i] = (q31_t)saturate(out[i], 2147483648.0);
+  }
+  free(in);
+  free(out);
+}
+
+void arm_max_q31(const q31_t *pSrc, uint32_t blockSize, q31_t *pResult,
+                 uint32_t *pIndex) {
+  q31_t best = pSrc[0];
+  uint32_t index = 0;
+  for (uint32_t i = 1; i < blockSize; i++) {
+    if (pSrc[i] > best) {
+      best = pSrc[i];
+      index = i;
+    }
+  }
+  *pResult = best;
+  *pIndex = index;
+}
+
+void arm_fill_q31(q31_t value, q31_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) {
+    pDst[i] = value;
+  }
+}
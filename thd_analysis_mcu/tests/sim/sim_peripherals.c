@@ -0,0 +1,315 @@
+#include "sim_peripherals.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+ADC12_Regs gSimAdcRegs[SIM_ADC_COUNT] = {{0}, {1}};
+DMA_Regs gSimDmaRegs;
+UART_Regs gSimUartRegs;
+GPTIMER_Regs gSimTimerRegs;
+
+SimAdc gSimAdc[SIM_ADC_COUNT];
+SimDmaChannel gSimDma[SIM_DMA_CHANNELS];
+SimTimer gSimTimer;
+uint8_t gSimUartTx[SIM_UART_TX_CAPACITY];
+uint32_t gSimUartTxLength;
+SimConversion gSimTrace[SIM_MAX_TRACE];
+uint32_t gSimTraceLength;
+
+// 固件的 SysTick 中断 (utiils.c)
+void SysTick_Handler(void);
+
+// --- SysTick ---
+
+#define SYSTICK_PERIOD (CPUCLK_FREQ / 1000)
+
+static SysTick_Type systick = {0, SYSTICK_PERIOD - 1};
+static uint64_t systick_start_ns;
+static uint64_t systick_ms_delivered;
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+SysTick_Type *sim_systick(void) {
+  const uint64_t now = host_ns();
+  if (systick_start_ns == 0) {
+    systick_start_ns = now;
+  }
+  // 经过的时间折算成 CPUCLK_FREQ 计数, 每满一毫秒补发一次中断
+  const uint64_t ticks =
+      (now - systick_start_ns) * (CPUCLK_FREQ / 1000000) / 1000;
+  const uint64_t ms = ticks / SYSTICK_PERIOD;
+  while (systick_ms_delivered < ms) {
+    systick_ms_delivered++;
+    SysTick_Handler();
+  }
+  systick.VAL = (uint32_t)(SYSTICK_PERIOD - 1 - ticks % SYSTICK_PERIOD);
+  return &systick;
+}
+
+// --- 内存映射 ---
+
+#define SIM_MAX_REGIONS 8
+
+typedef struct {
+  uint8_t *base;
+  size_t bytes;
+} SimRegion;
+
+static SimRegion regions[SIM_MAX_REGIONS];
+static uint32_t region_count;
+
+void sim_map_memory(void *base, size_t bytes) {
+  if (region_count < SIM_MAX_REGIONS) {
+    regions[region_count++] = (SimRegion){(uint8_t *)base, bytes};
+  }
+}
+
+// 把固件写入 DMA 寄存器的 32 位地址还原为主机指针, 越界返回 NULL
+static uint8_t *resolve(uint32_t addr, uint32_t width) {
+  for (uint32_t i = 0; i < region_count; i++) {
+    const uint32_t base = (uint32_t)(uintptr_t)regions[i].base;
+    if (addr >= base && addr - base + width <= regions[i].bytes) {
+      return regions[i].base + (addr - base);
+    }
+  }
+  return NULL;
+}
+
+void sim_reset(void) {
+  memset(gSimAdc, 0, sizeof(gSimAdc));
+  memset(gSimDma, 0, sizeof(gSimDma));
+  memset(&gSimTimer, 0, sizeof(gSimTimer));
+  gSimUartTxLength = 0;
+  gSimTraceLength = 0;
+}
+
+// --- 外设行为 ---
+
+// 一次转换的结果 (与 ADC 的分辨率、格式及硬件平均设置一致)
+static uint16_t convert(const SimAdc *adc, double code12) {
+  if (code12 < 0) {
+    code12 = 0;
+  } else if (code12 > 4095) {
+    code12 = 4095;
+  }
+  const uint32_t bits = adc->resolution ? adc->resolution : 12;
+  const uint32_t code = (uint32_t)lround(code12) >> (12 - bits);
+  if (adc->averaging) {
+    // 硬件平均输出无符号结果: 累加 2^acc 次后除以 2^den
+    return (uint16_t)((code << adc->avg_acc_log2) >> adc->avg_den_log2);
+  }
+  if (adc->signed_format) {
+    const int32_t centered = (int32_t)code - (int32_t)(1u << (bits - 1));
+    return (uint16_t)(int16_t)(centered << (16 - bits));
+  }
+  return (uint16_t)code;
+}
+
+static bool dma_source_is_adc(const SimDmaChannel *ch, uint32_t adc) {
+  const uint32_t base = SIM_ADC_BASE + adc * SIM_ADC_STRIDE;
+  return ch->src >= base && ch->src < base + SIM_ADC_STRIDE;
+}
+
+static uint32_t dma_trigger_of(uint32_t adc) {
+  return adc == 0 ? DMA_ADC0_EVT_GEN_BD_TRIG : DMA_ADC1_EVT_GEN_BD_TRIG;
+}
+
+// 一次 DMA 传输; 传输次数用完时返回 true
+static bool dma_transfer(SimDmaChannel *ch, uint32_t value) {
+  const uint32_t width = ch->config.destWidth;
+  uint8_t *dest = resolve(ch->next, width);
+  if (dest != NULL) {
+    memcpy(dest, &value, width);
+  }
+  ch->next += width * ch->config.destIncrement;
+  ch->done++;
+  if (ch->remaining > 0) {
+    ch->remaining--;
+  }
+  if (ch->remaining != 0) {
+    return false;
+  }
+  if (ch->config.transferMode == DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE) {
+    ch->remaining = ch->size;
+    ch->next = ch->dest;
+  } else {
+    ch->enabled = false;
+  }
+  return true;
+}
+
+// 窗口比较器: 结果低于下阈值或高于上阈值时, 对应的中断 (已使能时)
+// 每次转换都挂起; 阈值与结果同一格式, 有符号格式按有符号比较
+static bool window_comp(SimAdc *adc, uint16_t result) {
+  if (!adc->window_comp || adc->pending != DL_ADC12_IIDX_NO_INT) {
+    return false;
+  }
+  int32_t v = result;
+  int32_t low = (int32_t)adc->win_low;
+  int32_t high = (int32_t)adc->win_high;
+  if (adc->signed_format) {
+    v = (int16_t)result;
+    low = (int16_t)adc->win_low;
+    high = (int16_t)adc->win_high;
+  }
+  if (v < low && (adc->interrupts & DL_ADC12_INTERRUPT_WINDOW_COMP_LOW)) {
+    adc->pending = DL_ADC12_IIDX_WINDOW_COMP_LOW;
+    return true;
+  }
+  if (v > high && (adc->interrupts & DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH)) {
+    adc->pending = DL_ADC12_IIDX_WINDOW_COMP_HIGH;
+    return true;
+  }
+  return false;
+}
+
+// 一个 ADC 完成一次转换: 结果经 FIFO (两次拼成一个字) 或结果寄存器交给
+// DMA; 返回 true 表示该 ADC 的 DMA 完成或窗口比较器中断已挂起
+static bool on_conversion(uint32_t index, uint16_t result) {
+  SimAdc *adc = &gSimAdc[index];
+  adc->conversions++;
+  if (adc->dma_trigger == 0) {
+    return window_comp(adc, result);
+  }
+  uint32_t value = result;
+  if (adc->fifo) {
+    if (!adc->fifo_half) {
+      adc->fifo_hold = result;
+      adc->fifo_half = true;
+      return window_comp(adc, result);
+    }
+    adc->fifo_half = false;
+    value = adc->fifo_hold | ((uint32_t)result << 16);
+  }
+  bool done = false;
+  for (uint32_t c = 0; c < SIM_DMA_CHANNELS; c++) {
+    SimDmaChannel *ch = &gSimDma[c];
+    if (ch->enabled && ch->config.trigger == dma_trigger_of(index) &&
+        dma_source_is_adc(ch, index)) {
+      done |= dma_transfer(ch, value);
+    }
+  }
+  if (done && (adc->interrupts & DL_ADC12_INTERRUPT_DMA_DONE)) {
+    adc->pending = DL_ADC12_IIDX_DMA_DONE;
+    return true;
+  }
+  return window_comp(adc, result);
+}
+
+static bool adc_converting(const SimAdc *adc) {
+  return adc->powered && adc->conversions_enabled;
+}
+
+// ADC 订阅的事件通道在 t 之后的下一个事件时刻 (定时器计数), 无事件返回 -1
+static int64_t next_timer_event(uint32_t subscriber, int64_t after) {
+  const SimTimer *tm = &gSimTimer;
+  const int64_t period = (int64_t)tm->load + 1;
+  int64_t best = -1;
+  for (uint32_t route = 0; route < 2; route++) {
+    if (tm->publisher[route] != subscriber || tm->events[route] == 0) {
+      continue;
+    }
+    // 计数从 count 开始向下: 第一次归零在 count 个计数之后, 之后每 period
+    // 个计数一次; 计数减到 cc0 时产生 CC0_DN 事件, 重装后比归零晚
+    // period - cc0 个计数
+    int64_t first[2];
+    uint32_t n = 0;
+    if (tm->events[route] & DL_TIMERG_EVENT_ZERO_EVENT) {
+      first[n++] = (int64_t)tm->count;
+    }
+    if ((tm->events[route] & DL_TIMERG_EVENT_CC0_DN_EVENT) &&
+        tm->cc0 <= tm->load) {
+      first[n++] = tm->count >= tm->cc0
+                       ? (int64_t)(tm->count - tm->cc0)
+                       : (int64_t)tm->count + period - (int64_t)tm->cc0;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      int64_t t = first[i];
+      if (t <= after) {
+        t += ((after - t) / period + 1) * period;
+      }
+      if (best < 0 || t < best) {
+        best = t;
+      }
+    }
+  }
+  return best;
+}
+
+bool sim_capture_frame(SimSignal signal, void *ctx, uint32_t max_conversions) {
+  gSimTraceLength = 0;
+
+  // 定时器触发: 按定时器计数推进, 每个事件触发订阅了该通道的 ADC
+  bool timer_driven = false;
+  for (uint32_t i = 0; i < SIM_ADC_COUNT; i++) {
+    timer_driven |= adc_converting(&gSimAdc[i]) && gSimAdc[i].event_triggered;
+  }
+  if (timer_driven) {
+    for (uint32_t i = 0; i < SIM_ADC_COUNT; i++) {
+      gSimAdc[i].fifo_half = false;
+    }
+    if (!gSimTimer.running || gSimTimer.prescale == 0) {
+      return false;
+    }
+    const double tick_s = gSimTimer.prescale / (double)CPUCLK_FREQ;
+    int64_t now = -1;
+    for (uint32_t n = 0; n < max_conversions;) {
+      int64_t next = -1;
+      for (uint32_t i = 0; i < SIM_ADC_COUNT; i++) {
+        const SimAdc *adc = &gSimAdc[i];
+        if (adc_converting(adc) && adc->event_triggered) {
+          const int64_t t = next_timer_event(adc->subscriber, now);
+          if (t >= 0 && (next < 0 || t < next)) {
+            next = t;
+          }
+        }
+      }
+      if (next < 0) {
+        return false;
+      }
+      now = next;
+      bool frame_done = false;
+      for (uint32_t i = 0; i < SIM_ADC_COUNT; i++) {
+        const SimAdc *adc = &gSimAdc[i];
+        if (!adc_converting(adc) || !adc->event_triggered ||
+            next_timer_event(adc->subscriber, now - 1) != now) {
+          continue;
+        }
+        const double t = now * tick_s;
+        if (gSimTraceLength < SIM_MAX_TRACE) {
+          gSimTrace[gSimTraceLength++] = (SimConversion){i, t};
+        }
+        frame_done |=
+            on_conversion(i, convert(adc, signal(i, adc->input_chan, t, ctx)));
+        n++;
+      }
+      if (frame_done) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 软件启动的连续转换 (ADC0): 间隔为采样窗口加转换时间, 时间从启动算起
+  SimAdc *adc = &gSimAdc[0];
+  if (!adc_converting(adc) || !adc->started) {
+    return false;
+  }
+  const double conversion_clks =
+      adc->resolution == 8 ? 4 : adc->resolution == 10 ? 5 : 6;
+  const double interval = (adc->sample_time + conversion_clks) / SIM_ADCCLK_HZ;
+  for (uint32_t n = 0; n < max_conversions; n++) {
+    const double t = (adc->conversions - adc->started_at) * interval;
+    if (gSimTraceLength < SIM_MAX_TRACE) {
+      gSimTrace[gSimTraceLength++] = (SimConversion){0, t};
+    }
+    if (on_conversion(0, convert(adc, signal(0, adc->input_chan, t, ctx)))) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,629 @@
+#ifndef SIM_PERIPHERALS_H
+#define SIM_PERIPHERALS_H
+// 主机测试用的外设模拟层: 以 DriverLib 的接口记录固件对 ADC、DMA、定时器
+// 的配置, 并按记录的配置模拟定时器事件、ADC 转换与 DMA 搬运.
+// 固件源码不做任何修改即可在主机上编译, 测试既可以检查寄存器配置,
+// 也可以让模拟的外设把一帧采样写进采集缓冲区
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SYSCONFIG_WEAK __attribute__((weak))
+#define CPUCLK_FREQ 32000000
+#define POWER_STARTUP_DELAY 16
+
+// --- 外设实例 ---
+typedef struct {
+  int id;
+} ADC12_Regs;
+typedef struct {
+  int id;
+} DMA_Regs;
+typedef struct {
+  volatile uint32_t RXDATA;
+} UART_Regs;
+typedef struct {
+  int id;
+} GPTIMER_Regs;
+typedef struct {
+  volatile uint32_t VAL;
+  uint32_t LOAD;
+} SysTick_Type;
+
+#define SIM_ADC_COUNT 2
+#define SIM_DMA_CHANNELS 3
+
+extern ADC12_Regs gSimAdcRegs[SIM_ADC_COUNT];
+extern DMA_Regs gSimDmaRegs;
+extern UART_Regs gSimUartRegs;
+extern GPTIMER_Regs gSimTimerRegs;
+
+#define ADC0 (&gSimAdcRegs[0])
+#define ADC1 (&gSimAdcRegs[1])
+#define DMA (&gSimDmaRegs)
+#define TIMG0 (&gSimTimerRegs)
+#define ADC12_0_INST ADC0
+#define UART_0_INST (&gSimUartRegs)
+#define ADC12_0_INST_IRQHandler ADC0_IRQHandler
+#define UART_0_INST_IRQHandler UART0_IRQHandler
+
+// SysTick 按主机时钟折算为 CPUCLK_FREQ 计数, 读取时补上经过的毫秒中断,
+// get_cycle_count 得到的是主机上的耗时 (以 1/CPUCLK_FREQ 为单位)
+SysTick_Type *sim_systick(void);
+#define SysTick (sim_systick())
+
+// --- 中断与系统 ---
+enum {
+  ADC12_0_INST_INT_IRQN = 1,
+  ADC1_INT_IRQn,
+  UART_0_INST_INT_IRQN,
+};
+#define NVIC_EnableIRQ(irq) ((void)(irq))
+#define NVIC_DisableIRQ(irq) ((void)(irq))
+#define __WFI() ((void)0)
+#define __BKPT(x) ((void)(x))
+#define __disable_irq() ((void)0)
+#define __enable_irq() ((void)0)
+#define delay_cycles(cycles) ((void)(cycles))
+#define DL_SYSCTL_disableSleepOnExit() ((void)0)
+#define SYSCFG_DL_GPIO_init() ((void)0)
+#define SYSCFG_DL_SYSCTL_init() ((void)0)
+#define SYSCFG_DL_UART_0_init() ((void)0)
+
+// --- ADC ---
+enum {
+  DL_ADC12_CLOCK_SYSOSC = 0,
+  DL_ADC12_CLOCK_DIVIDE_1 = 0,
+  DL_ADC12_CLOCK_FREQ_RANGE_24_TO_32 = 0,
+  DL_ADC12_REPEAT_MODE_ENABLED = 1,
+  DL_ADC12_SAMPLING_SOURCE_AUTO = 0,
+  DL_ADC12_REFERENCE_VOLTAGE_VDDA = 0,
+  DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0 = 0,
+  DL_ADC12_BURN_OUT_SOURCE_DISABLED = 0,
+  DL_ADC12_POWER_DOWN_MODE_MANUAL = 1,
+  DL_ADC12_MEM_IDX_0 = 0,
+  ADC12_0_ADCMEM_0 = DL_ADC12_MEM_IDX_0,
+};
+enum {
+  DL_ADC12_TRIG_SRC_SOFTWARE = 0,
+  DL_ADC12_TRIG_SRC_EVENT = 1,
+};
+enum {
+  DL_ADC12_SAMP_CONV_RES_12_BIT = 12,
+  DL_ADC12_SAMP_CONV_RES_10_BIT = 10,
+  DL_ADC12_SAMP_CONV_RES_8_BIT = 8,
+};
+enum {
+  DL_ADC12_SAMP_CONV_DATA_FORMAT_UNSIGNED = 0,
+  DL_ADC12_SAMP_CONV_DATA_FORMAT_SIGNED = 1,
+};
+enum {
+  DL_ADC12_INPUT_CHAN_0 = 0,
+  DL_ADC12_INPUT_CHAN_1,
+  DL_ADC12_INPUT_CHAN_2,
+  DL_ADC12_INPUT_CHAN_3,
+  DL_ADC12_INPUT_CHAN_4,
+  DL_ADC12_INPUT_CHAN_5,
+  DL_ADC12_INPUT_CHAN_6,
+  DL_ADC12_INPUT_CHAN_7,
+};
+enum {
+  DL_ADC12_AVERAGING_MODE_DISABLED = 0,
+  DL_ADC12_AVERAGING_MODE_ENABLED = 1,
+};
+enum {
+  DL_ADC12_TRIGGER_MODE_AUTO_NEXT = 0,
+  DL_ADC12_TRIGGER_MODE_TRIGGER_NEXT = 1,
+};
+enum {
+  DL_ADC12_WINDOWS_COMP_MODE_DISABLED = 0,
+  DL_ADC12_WINDOWS_COMP_MODE_ENABLED = 1,
+};
+// 硬件平均: 累加次数与除数均按 log2 编码
+enum {
+  DL_ADC12_HW_AVG_NUM_ACC_DISABLED = 0,
+  DL_ADC12_HW_AVG_NUM_ACC_2,
+  DL_ADC12_HW_AVG_NUM_ACC_4,
+  DL_ADC12_HW_AVG_NUM_ACC_8,
+  DL_ADC12_HW_AVG_NUM_ACC_16,
+  DL_ADC12_HW_AVG_NUM_ACC_32,
+  DL_ADC12_HW_AVG_NUM_ACC_64,
+  DL_ADC12_HW_AVG_NUM_ACC_128,
+};
+enum {
+  DL_ADC12_HW_AVG_DEN_DIV_BY_1 = 0,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_2,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_4,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_8,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_16,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_32,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_64,
+  DL_ADC12_HW_AVG_DEN_DIV_BY_128,
+};
+enum {
+  DL_ADC12_DMA_MEM0_RESULT_LOADED = 1u << 0,
+  DL_ADC12_DMA_MEM10_RESULT_LOADED = 1u << 10,
+};
+enum {
+  DL_ADC12_INTERRUPT_DMA_DONE = 1u << 0,
+  DL_ADC12_INTERRUPT_WINDOW_COMP_LOW = 1u << 1,
+  DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH = 1u << 2,
+};
+enum {
+  DL_ADC12_IIDX_NO_INT = 0,
+  DL_ADC12_IIDX_DMA_DONE,
+  DL_ADC12_IIDX_WINDOW_COMP_LOW,
+  DL_ADC12_IIDX_WINDOW_COMP_HIGH,
+};
+
+typedef struct {
+  uint32_t clockSel;
+  uint32_t divideRatio;
+  uint32_t freqRange;
+} DL_ADC12_ClockConfig;
+
+// 一个 ADC 的配置与状态
+typedef struct {
+  bool powered;
+  bool conversions_enabled;
+  bool started;          // 软件触发的连续转换已启动
+  bool event_triggered;  // 由事件通道触发, 每个事件转换一次
+  uint32_t resolution;   // 转换位数 12/10/8
+  bool signed_format;    // 有符号左对齐结果
+  uint32_t input_chan;
+  uint16_t sample_time;  // 采样窗口 (ADCCLK 数)
+  uint32_t subscriber;   // 订阅的事件通道
+  bool fifo;
+  uint32_t dma_trigger;  // DL_ADC12_DMA_*_RESULT_LOADED
+  uint32_t dma_samples;
+  bool averaging;
+  uint32_t avg_acc_log2;
+  uint32_t avg_den_log2;
+  bool window_comp;
+  uint32_t win_low;
+  uint32_t win_high;
+  uint32_t interrupts;   // 已使能的中断
+  uint32_t pending;      // 待处理的中断 (DL_ADC12_IIDX_*)
+  uint32_t conversions;  // 累计转换次数
+  uint32_t started_at;   // 软件启动时的累计转换次数, 连续转换的时间从此算起
+  uint16_t fifo_hold;    // FIFO 中等待拼成一个字的前一个结果
+  bool fifo_half;
+} SimAdc;
+
+extern SimAdc gSimAdc[SIM_ADC_COUNT];
+
+static inline SimAdc *sim_adc(const ADC12_Regs *adc) {
+  return &gSimAdc[adc->id];
+}
+
+// syscfg 中配置的外设 (ADC0) 由 SYSCFG_DL_initPower 上电
+static inline void SYSCFG_DL_initPower(void) { gSimAdc[0].powered = true; }
+
+static inline void DL_ADC12_setClockConfig(ADC12_Regs *adc,
+                                           DL_ADC12_ClockConfig *config) {
+  (void)adc;
+  (void)config;
+}
+static inline bool DL_ADC12_isPowerEnabled(ADC12_Regs *adc) {
+  return sim_adc(adc)->powered;
+}
+static inline void DL_ADC12_reset(ADC12_Regs *adc) {
+  SimAdc *s = sim_adc(adc);
+  bool powered = s->powered;
+  *s = (SimAdc){0};
+  s->powered = powered;
+}
+static inline void DL_ADC12_enablePower(ADC12_Regs *adc) {
+  sim_adc(adc)->powered = true;
+}
+static inline void DL_ADC12_initSingleSample(ADC12_Regs *adc,
+                                             uint32_t repeat_mode,
+                                             uint32_t sample_mode,
+                                             uint32_t trig_src,
+                                             uint32_t resolution,
+                                             uint32_t format) {
+  (void)repeat_mode;
+  (void)sample_mode;
+  SimAdc *s = sim_adc(adc);
+  s->event_triggered = trig_src == DL_ADC12_TRIG_SRC_EVENT;
+  s->resolution = resolution;
+  s->signed_format = format == DL_ADC12_SAMP_CONV_DATA_FORMAT_SIGNED;
+}
+static inline void DL_ADC12_configConversionMem(
+    ADC12_Regs *adc, uint32_t idx, uint32_t input_chan, uint32_t vref,
+    uint32_t stime, uint32_t avg, uint32_t burn_out, uint32_t trig_mode,
+    uint32_t win_comp) {
+  (void)idx;
+  (void)vref;
+  (void)stime;
+  (void)burn_out;
+  (void)trig_mode;
+  SimAdc *s = sim_adc(adc);
+  s->input_chan = input_chan;
+  s->averaging = avg == DL_ADC12_AVERAGING_MODE_ENABLED;
+  s->window_comp = win_comp == DL_ADC12_WINDOWS_COMP_MODE_ENABLED;
+}
+static inline void DL_ADC12_configHwAverage(ADC12_Regs *adc, uint32_t acc,
+                                            uint32_t den) {
+  sim_adc(adc)->avg_acc_log2 = acc;
+  sim_adc(adc)->avg_den_log2 = den;
+}
+static inline void DL_ADC12_setSubscriberChanID(ADC12_Regs *adc,
+                                                uint8_t chan) {
+  sim_adc(adc)->subscriber = chan;
+}
+static inline void DL_ADC12_setPowerDownMode(ADC12_Regs *adc,
+                                             uint32_t mode) {
+  (void)adc;
+  (void)mode;
+}
+static inline void DL_ADC12_setSampleTime0(ADC12_Regs *adc, uint16_t clks) {
+  sim_adc(adc)->sample_time = clks;
+}
+static inline void DL_ADC12_enableDMA(ADC12_Regs *adc) { (void)adc; }
+static inline void DL_ADC12_enableDMATrigger(ADC12_Regs *adc, uint32_t mask) {
+  sim_adc(adc)->dma_trigger |= mask;
+}
+static inline void DL_ADC12_disableDMATrigger(ADC12_Regs *adc,
+                                              uint32_t mask) {
+  sim_adc(adc)->dma_trigger &= ~mask;
+}
+static inline void DL_ADC12_enableFIFO(ADC12_Regs *adc) {
+  sim_adc(adc)->fifo = true;
+}
+static inline void DL_ADC12_disableFIFO(ADC12_Regs *adc) {
+  sim_adc(adc)->fifo = false;
+}
+static inline void DL_ADC12_setDMASamplesCnt(ADC12_Regs *adc, uint8_t n) {
+  sim_adc(adc)->dma_samples = n;
+}
+static inline void DL_ADC12_clearInterruptStatus(ADC12_Regs *adc,
+                                                 uint32_t mask) {
+  (void)mask;
+  sim_adc(adc)->pending = DL_ADC12_IIDX_NO_INT;
+}
+static inline void DL_ADC12_enableInterrupt(ADC12_Regs *adc, uint32_t mask) {
+  sim_adc(adc)->interrupts |= mask;
+}
+static inline void DL_ADC12_disableInterrupt(ADC12_Regs *adc, uint32_t mask) {
+  sim_adc(adc)->interrupts &= ~mask;
+}
+static inline uint32_t DL_ADC12_getPendingInterrupt(ADC12_Regs *adc) {
+  return sim_adc(adc)->pending;
+}
+static inline void DL_ADC12_enableConversions(ADC12_Regs *adc) {
+  sim_adc(adc)->conversions_enabled = true;
+}
+static inline void DL_ADC12_disableConversions(ADC12_Regs *adc) {
+  sim_adc(adc)->conversions_enabled = false;
+  sim_adc(adc)->started = false;
+}
+static inline void DL_ADC12_startConversion(ADC12_Regs *adc) {
+  SimAdc *s = sim_adc(adc);
+  s->started = true;
+  s->started_at = s->conversions;
+  s->fifo_half = false;
+}
+static inline void DL_ADC12_stopConversion(ADC12_Regs *adc) {
+  sim_adc(adc)->started = false;
+}
+static inline void DL_ADC12_configWinCompLowThld(ADC12_Regs *adc,
+                                                 uint16_t v) {
+  sim_adc(adc)->win_low = v;
+}
+static inline void DL_ADC12_configWinCompHighThld(ADC12_Regs *adc,
+                                                  uint16_t v) {
+  sim_adc(adc)->win_high = v;
+}
+
+// 外设寄存器的模拟地址, DMA 的源地址据此识别是哪个 ADC 的结果
+#define SIM_ADC_BASE 0x40000000u
+#define SIM_ADC_STRIDE 0x1000u
+#define SIM_ADC_MEMRES_OFFSET 0x100u
+#define SIM_ADC_FIFO_OFFSET 0x200u
+static inline uint32_t DL_ADC12_getMemResultAddress(ADC12_Regs *adc,
+                                                    uint32_t idx) {
+  return SIM_ADC_BASE + (uint32_t)adc->id * SIM_ADC_STRIDE +
+         SIM_ADC_MEMRES_OFFSET + idx * 4;
+}
+static inline uint32_t DL_ADC12_getFIFOAddress(ADC12_Regs *adc) {
+  return SIM_ADC_BASE + (uint32_t)adc->id * SIM_ADC_STRIDE +
+         SIM_ADC_FIFO_OFFSET;
+}
+
+// --- DMA ---
+enum {
+  DMA_CH0_CHAN_ID = 0,
+  DMA_CH1_CHAN_ID = 1,
+};
+enum {
+  DMA_ADC0_EVT_GEN_BD_TRIG = 1,
+  DMA_ADC1_EVT_GEN_BD_TRIG = 2,
+};
+enum {
+  DL_DMA_TRIGGER_TYPE_EXTERNAL = 0,
+};
+enum {
+  DL_DMA_SINGLE_TRANSFER_MODE = 0,
+  DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE = 1,
+};
+enum {
+  DL_DMA_NORMAL_MODE = 0,
+};
+enum {
+  DL_DMA_WIDTH_HALF_WORD = 2,
+  DL_DMA_WIDTH_WORD = 4,
+};
+// 目的地址每次的步进 (元素数)
+enum {
+  DL_DMA_ADDR_UNCHANGED = 0,
+  DL_DMA_ADDR_INCREMENT = 1,
+  DL_DMA_ADDR_STRIDE_2 = 2,
+};
+
+typedef struct {
+  uint32_t trigger;
+  uint32_t triggerType;
+  uint32_t transferMode;
+  uint32_t extendedMode;
+  uint32_t destWidth;
+  uint32_t srcWidth;
+  uint32_t destIncrement;
+  uint32_t srcIncrement;
+} DL_DMA_Config;
+
+// 一个 DMA 通道的配置与状态; 地址按固件写入的 32 位值保存
+typedef struct {
+  bool enabled;
+  DL_DMA_Config config;
+  uint32_t src;
+  uint32_t dest;
+  uint32_t size;      // 设定的传输次数
+  uint32_t remaining; // 剩余传输次数 (DL_DMA_getTransferSize)
+  uint32_t next;      // 下一次写入的地址
+  uint32_t done;      // 累计完成次数
+} SimDmaChannel;
+
+extern SimDmaChannel gSimDma[SIM_DMA_CHANNELS];
+
+static inline void DL_DMA_initChannel(DMA_Regs *dma, uint8_t ch,
+                                      DL_DMA_Config *config) {
+  (void)dma;
+  gSimDma[ch].config = *config;
+}
+// thd_analysis_mcu.syscfg 中的 DMA 配置: DMA_CH0 由 ADC0 触发, FIFO
+// 两个采样为一个字, 地址 f2b (固定到块), 整通道重复单次传输
+static inline void SYSCFG_DL_DMA_init(void) {
+  DL_DMA_Config adc_config = {
+      .trigger = DMA_ADC0_EVT_GEN_BD_TRIG,
+      .triggerType = DL_DMA_TRIGGER_TYPE_EXTERNAL,
+      .transferMode = DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE,
+      .extendedMode = DL_DMA_NORMAL_MODE,
+      .destWidth = DL_DMA_WIDTH_WORD,
+      .srcWidth = DL_DMA_WIDTH_WORD,
+      .destIncrement = DL_DMA_ADDR_INCREMENT,
+      .srcIncrement = DL_DMA_ADDR_UNCHANGED,
+  };
+  DL_DMA_initChannel(DMA, DMA_CH0_CHAN_ID, &adc_config);
+}
+static inline void DL_DMA_setSrcAddr(DMA_Regs *dma, uint8_t ch,
+                                     uint32_t addr) {
+  (void)dma;
+  gSimDma[ch].src = addr;
+}
+static inline void DL_DMA_setDestAddr(DMA_Regs *dma, uint8_t ch,
+                                      uint32_t addr) {
+  (void)dma;
+  gSimDma[ch].dest = addr;
+  gSimDma[ch].next = addr;
+}
+static inline void DL_DMA_setTransferSize(DMA_Regs *dma, uint8_t ch,
+                                          uint16_t size) {
+  (void)dma;
+  gSimDma[ch].size = size;
+  gSimDma[ch].remaining = size;
+}
+static inline uint16_t DL_DMA_getTransferSize(DMA_Regs *dma, uint8_t ch) {
+  (void)dma;
+  return (uint16_t)gSimDma[ch].remaining;
+}
+static inline void DL_DMA_setTransferMode(DMA_Regs *dma, uint8_t ch,
+                                          uint32_t mode) {
+  (void)dma;
+  gSimDma[ch].config.transferMode = mode;
+}
+static inline void DL_DMA_enableChannel(DMA_Regs *dma, uint8_t ch) {
+  (void)dma;
+  gSimDma[ch].enabled = true;
+}
+static inline void DL_DMA_disableChannel(DMA_Regs *dma, uint8_t ch) {
+  (void)dma;
+  gSimDma[ch].enabled = false;
+}
+
+// --- 定时器 ---
+enum {
+  DL_TIMER_CLOCK_BUSCLK = 0,
+  DL_TIMER_CLOCK_DIVIDE_1 = 0,
+  DL_TIMER_TIMER_MODE_PERIODIC = 0,
+  DL_TIMER_STOP = 0,
+  DL_TIMER_CC_0_INDEX = 0,
+};
+enum {
+  DL_TIMERG_EVENT_ROUTE_1 = 0,
+  DL_TIMERG_EVENT_ROUTE_2 = 1,
+};
+enum {
+  DL_TIMERG_EVENT_ZERO_EVENT = 1u << 0,
+  DL_TIMERG_EVENT_CC0_DN_EVENT = 1u << 1,
+};
+enum {
+  DL_TIMERG_PUBLISHER_INDEX_0 = 0,
+  DL_TIMERG_PUBLISHER_INDEX_1 = 1,
+};
+
+typedef struct {
+  uint32_t clockSel;
+  uint32_t divideRatio;
+  uint8_t prescale;
+} DL_TimerG_ClockConfig;
+
+typedef struct {
+  uint32_t timerMode;
+  uint32_t period;
+  uint32_t startTimer;
+} DL_TimerG_TimerConfig;
+
+// 定时器的配置与状态: 向下计数, 从 load 数到 0 后重装
+typedef struct {
+  bool powered;
+  bool running;
+  uint32_t prescale;    // 分频系数 (寄存器值 + 1)
+  uint32_t load;        // 装载值, 计数周期为 load + 1
+  uint32_t count;       // 启动时的计数值
+  uint32_t cc0;         // 比较值
+  uint32_t events[2];   // 两路事件各自使能的事件
+  uint32_t publisher[2]; // 两路事件发布到的通道
+} SimTimer;
+
+extern SimTimer gSimTimer;
+
+static inline bool DL_TimerG_isPowerEnabled(GPTIMER_Regs *t) {
+  (void)t;
+  return gSimTimer.powered;
+}
+static inline void DL_TimerG_reset(GPTIMER_Regs *t) {
+  (void)t;
+  bool powered = gSimTimer.powered;
+  gSimTimer = (SimTimer){0};
+  gSimTimer.powered = powered;
+}
+static inline void DL_TimerG_enablePower(GPTIMER_Regs *t) {
+  (void)t;
+  gSimTimer.powered = true;
+}
+static inline void DL_TimerG_setClockConfig(GPTIMER_Regs *t,
+                                            DL_TimerG_ClockConfig *config) {
+  (void)t;
+  gSimTimer.prescale = (uint32_t)config->prescale + 1;
+}
+static inline void DL_TimerG_initTimerMode(GPTIMER_Regs *t,
+                                           DL_TimerG_TimerConfig *config) {
+  (void)t;
+  gSimTimer.load = config->period;
+  gSimTimer.count = config->period;
+}
+static inline void DL_TimerG_enableEvent(GPTIMER_Regs *t, uint32_t route,
+                                         uint32_t mask) {
+  (void)t;
+  gSimTimer.events[route] |= mask;
+}
+static inline void DL_TimerG_disableEvent(GPTIMER_Regs *t, uint32_t route,
+                                          uint32_t mask) {
+  (void)t;
+  gSimTimer.events[route] &= ~mask;
+}
+static inline void DL_TimerG_setPublisherChanID(GPTIMER_Regs *t,
+                                                uint32_t index,
+                                                uint8_t chan) {
+  (void)t;
+  gSimTimer.publisher[index] = chan;
+}
+static inline void DL_TimerG_setCaptureCompareValue(GPTIMER_Regs *t,
+                                                    uint32_t value,
+                                                    uint32_t index) {
+  (void)t;
+  (void)index;
+  gSimTimer.cc0 = value;
+}
+static inline void DL_TimerG_setTimerCount(GPTIMER_Regs *t, uint32_t count) {
+  (void)t;
+  gSimTimer.count = count;
+}
+static inline void DL_TimerG_startCounter(GPTIMER_Regs *t) {
+  (void)t;
+  gSimTimer.running = true;
+}
+static inline void DL_TimerG_stopCounter(GPTIMER_Regs *t) {
+  (void)t;
+  gSimTimer.running = false;
+}
+
+// --- UART ---
+enum {
+  DL_UART_MAIN_IIDX_NO_INT = 0,
+  DL_UART_MAIN_IIDX_DMA_DONE_RX,
+};
+enum {
+  DL_UART_INTERRUPT_DMA_DONE_RX = 1u << 0,
+};
+
+// 发送的字节依次记录, 超出容量后丢弃 (gSimUartTxLength 仍累计)
+#define SIM_UART_TX_CAPACITY 65536
+extern uint8_t gSimUartTx[SIM_UART_TX_CAPACITY];
+extern uint32_t gSimUartTxLength;
+
+static inline bool DL_UART_Main_isTXFIFOEmpty(UART_Regs *uart) {
+  (void)uart;
+  return true;
+}
+static inline void DL_UART_Main_transmitData(UART_Regs *uart, uint8_t data) {
+  (void)uart;
+  if (gSimUartTxLength < SIM_UART_TX_CAPACITY) {
+    gSimUartTx[gSimUartTxLength] = data;
+  }
+  gSimUartTxLength++;
+}
+static inline uint32_t DL_UART_Main_getPendingInterrupt(UART_Regs *uart) {
+  (void)uart;
+  return DL_UART_MAIN_IIDX_NO_INT;
+}
+static inline void DL_UART_clearInterruptStatus(UART_Regs *uart,
+                                                uint32_t mask) {
+  (void)uart;
+  (void)mask;
+}
+
+// --- 模拟 ---
+
+// 模拟的输入信号: 返回 t 时刻 (秒) 第 adc 个 ADC 的输入通道上的电压,
+// 以 12 位码值为单位 (0 ~ 4095.x, 超出范围按满量程削顶)
+typedef double (*SimSignal)(uint32_t adc, uint32_t input_chan, double t,
+                            void *ctx);
+
+// 恢复全部外设到上电状态, 并登记固件的 DMA 目的缓冲区
+void sim_reset(void);
+
+/**
+ * @brief 登记一块 DMA 可写的内存: 固件把指针截断为 32 位写入 DMA 寄存器,
+ * 模拟层按登记的区间还原为主机指针
+ */
+void sim_map_memory(void *base, size_t bytes);
+
+/**
+ * @brief 按当前配置运行外设, 直到使能了 DMA 完成中断的 ADC 的 DMA
+ * 传输完成 (一帧采完), 或 ADC0 使能的窗口比较器中断挂起
+ * @param signal 输入信号
+ * @param max_conversions 转换次数上限, 防止配置错误时死循环
+ * @return false 表示达到上限仍未采完 (配置不完整或 ADC 未启动)
+ * @note 定时器触发时按定时器事件驱动订阅了对应通道的 ADC; 否则 ADC0
+ * 按采样窗口与转换时间连续转换, 时间从 DL_ADC12_startConversion 算起,
+ * 中断处理后再次调用时接着上次的时刻与 FIFO 状态继续 (环形缓冲区写满
+ * 一圈或窗口比较器中断后转换不停). 返回后 ADC 的待处理中断为 DMA 完成
+ * 或窗口比较器 (DMA 完成优先)
+ */
+bool sim_capture_frame(SimSignal signal, void *ctx, uint32_t max_conversions);
+
+// 最近一次 sim_capture_frame 中每次转换的时刻 (秒), 按转换顺序
+#define SIM_MAX_TRACE 8192
+typedef struct {
+  uint32_t adc;
+  double t;
+} SimConversion;
+extern SimConversion gSimTrace[SIM_MAX_TRACE];
+extern uint32_t gSimTraceLength;
+
+// ADC 转换时间 (ADCCLK 数), 与 consts.h 中的 CONVERSION_TIME_NS 一致
+#define SIM_ADCCLK_HZ 32000000.0
+
+#endif /* SIM_PERIPHERALS_H */
@@ -0,0 +1,4 @@
+#ifndef ARM_CONST_STRUCTS_H
+#define ARM_CONST_STRUCTS_H
+#include "arm_math.h"
+#endif /* ARM_CONST_STRUCTS_H */
@@ -0,0 +1,45 @@
+#ifndef ARM_MATH_H
+#define ARM_MATH_H
+// 主机测试用的 CMSIS-DSP 替身: 只声明固件用到的类型与函数, 由
+// sim/cmsis_reference.c 以双精度 DFT 实现 (输出缩放与 CMSIS 相同, 为 1/N)
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+
+typedef enum {
+  ARM_MATH_SUCCESS = 0,
+  ARM_MATH_ARGUMENT_ERROR = -1,
+} arm_status;
+
+typedef struct {
+  uint32_t fftLenReal;
+  uint8_t ifftFlagR;
+  uint8_t bitReverseFlagR;
+} arm_rfft_instance_q15;
+
+typedef struct {
+  uint32_t fftLenReal;
+  uint8_t ifftFlagR;
+  uint8_t bitReverseFlagR;
+} arm_rfft_instance_q31;
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, uint32_t fftLenReal,
+                             uint32_t ifftFlagR, uint32_t bitReverseFlag);
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst);
+arm_status arm_rfft_init_q31(arm_rfft_instance_q31 *S, uint32_t fftLenReal,
+                             uint32_t ifftFlagR, uint32_t bitReverseFlag);
+void arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst);
+void arm_max_q31(const q31_t *pSrc, uint32_t blockSize, q31_t *pResult,
+                 uint32_t *pIndex);
+void arm_fill_q31(q31_t value, q31_t *pDst, uint32_t blockSize);
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+#endif /* ARM_MATH_H */
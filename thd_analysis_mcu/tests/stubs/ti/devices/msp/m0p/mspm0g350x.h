@@ -0,0 +1,5 @@
+#ifndef TI_DEVICES_MSP_M0P_MSPM0G350X_H
+#define TI_DEVICES_MSP_M0P_MSPM0G350X_H
+// 主机测试: DriverLib 接口由外设模拟层提供
+#include "sim_peripherals.h"
+#endif /* TI_DEVICES_MSP_M0P_MSPM0G350X_H */
@@ -0,0 +1,5 @@
+#ifndef TI_DRIVERLIB_DL_ADC12_H
+#define TI_DRIVERLIB_DL_ADC12_H
+// 主机测试: DriverLib 接口由外设模拟层提供
+#include "sim_peripherals.h"
+#endif /* TI_DRIVERLIB_DL_ADC12_H */
@@ -0,0 +1,5 @@
+#ifndef TI_DRIVERLIB_M0P_SYSCTL_DL_SYSCTL_MSPM0G1X0X_G3X0X_H
+#define TI_DRIVERLIB_M0P_SYSCTL_DL_SYSCTL_MSPM0G1X0X_G3X0X_H
+// 主机测试: DriverLib 接口由外设模拟层提供
+#include "sim_peripherals.h"
+#endif /* TI_DRIVERLIB_M0P_SYSCTL_DL_SYSCTL_MSPM0G1X0X_G3X0X_H */
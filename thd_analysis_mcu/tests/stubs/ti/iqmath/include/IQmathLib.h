@@ -0,0 +1,15 @@
+#ifndef IQMATHLIB_H
+#define IQMATHLIB_H
+// 主机测试用的 IQmath 替身: 只实现固件用到的 Q16 运算, 转换与乘法的
+// 截断方式与 IQmath 相同
+#include <stdint.h>
+typedef int32_t _iq;
+typedef int32_t _iq16;
+
+#define _IQ16(A) ((_iq16)((A) * 65536.0f))
+#define _IQ16toF(A) ((float)(A) / 65536.0f)
+
+static inline _iq16 _IQ16mpy(_iq16 a, _iq16 b) {
+  return (_iq16)(((int64_t)a * b) >> 16);
+}
+#endif /* IQMATHLIB_H */
@@ -0,0 +1,5 @@
+#ifndef TI_MSP_DL_CONFIG_H
+#define TI_MSP_DL_CONFIG_H
+// 主机测试用的 SysConfig 生成头文件替身, 外设由 sim/sim_peripherals.h 模拟
+#include "sim_peripherals.h"
+#endif /* TI_MSP_DL_CONFIG_H */
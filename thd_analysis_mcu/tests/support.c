@@ -0,0 +1,64 @@
+#include "support.h"
+#include "consts.h"
+#include "sim_peripherals.h"
+#include <math.h>
+
+uint32_t gTestFailures;
+
+int test_finish(const char *name) {
+  if (gTestFailures == 0) {
+    printf("%s: PASS\n", name);
+    return 0;
+  }
+  printf("%s: %u FAILED\n", name, (unsigned)gTestFailures);
+  return 1;
+}
+
+void test_reset_peripherals(void) {
+  static bool mapped = false;
+  sim_reset();
+  if (!mapped) {
+    sim_map_memory(gADCRealSamples, sizeof(gADCRealSamples));
+    sim_map_memory(gCurrentSamples, sizeof(gCurrentSamples));
+    sim_map_memory(gRxPacket, sizeof(gRxPacket));
+    mapped = true;
+  }
+}
+
+static uint32_t random_state = 1;
+
+void test_random_seed(uint32_t seed) { random_state = seed ? seed : 1; }
+
+double test_random(void) {
+  // xorshift32
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state / 2147483648.0 - 1.0;
+}
+
+void reference_dft_bin(const double *re, const double *im, uint32_t len,
+                       uint32_t k, double *out_re, double *out_im) {
+  double sum_re = 0, sum_im = 0;
+  for (uint32_t n = 0; n < len; n++) {
+    const double phase = -2 * M_PI * (double)((uint64_t)k * n % len) / len;
+    const double c = cos(phase), s = sin(phase);
+    const double x_re = re[n], x_im = im ? im[n] : 0;
+    sum_re += x_re * c - x_im * s;
+    sum_im += x_re * s + x_im * c;
+  }
+  *out_re = sum_re;
+  *out_im = sum_im;
+}
+
+double error_snr_db(const double *ref, const double *test, uint32_t count) {
+  double signal = 0, error = 0;
+  for (uint32_t i = 0; i < 2 * count; i++) {
+    signal += ref[i] * ref[i];
+    error += (ref[i] - test[i]) * (ref[i] - test[i]);
+  }
+  if (error == 0) {
+    return INFINITY;
+  }
+  return 10 * log10(signal / error);
+}
@@ -0,0 +1,50 @@
+#ifndef TESTS_SUPPORT_H
+#define TESTS_SUPPORT_H
+// 主机测试的公共部分: 断言计数、参考计算与外设模拟的初始化
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+extern uint32_t gTestFailures;
+
+// 条件不成立时打印位置与说明, 计入失败数并继续执行
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      gTestFailures++;                                                         \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);                              \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+/**
+ * @brief 打印结果并返回进程退出码
+ * @return 0 表示全部通过
+ */
+int test_finish(const char *name);
+
+/**
+ * @brief 复位模拟外设并登记固件的 DMA 缓冲区 (采集、电流、UART 接收)
+ */
+void test_reset_peripherals(void);
+
+// 均匀分布的伪随机数 [-1, 1), 固定种子保证每次运行结果相同
+double test_random(void);
+void test_random_seed(uint32_t seed);
+
+/**
+ * @brief 双精度 DFT 的单个频点: sum x[n] * exp(-j*2*pi*k*n/len)
+ */
+void reference_dft_bin(const double *re, const double *im, uint32_t len,
+                       uint32_t k, double *out_re, double *out_im);
+
+/**
+ * @brief 误差的信噪比 10*log10(sum|ref|^2 / sum|ref - test|^2)
+ * @param ref 参考值 (实部/虚部交替)
+ * @param test 被测值, 与参考值同一刻度
+ * @param count 复数点数
+ */
+double error_snr_db(const double *ref, const double *test, uint32_t count);
+
+#endif /* TESTS_SUPPORT_H */
@@ -0,0 +1,68 @@
+// 0x0F 耗时测量命令的测试: 各阶段 (FFT、前端、重采样、细化、双通道)、FFT 实现
+// 与精度执行后最近一帧采样 (VALID_ADC_DATA) 保持不变; 非法的实现、精度或
+// 阶段编号以及当前点数不支持的组合返回错误, 大点数时 FFT 工作区就是
+// 采集缓冲区, 命令应返回错误且不改动采样
+#include "analysis.h"
+#include "command.h"
+#include "consts.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include <math.h>
+#include <string.h>
+
+static uint16_t snapshot[SAMPLE_SIZE];
+
+// 发送一条 0x0F 命令, 返回应答的状态码
+static uint8_t run_benchmark(uint8_t engine, uint8_t precision,
+                             uint8_t stage) {
+  uint8_t packet[UART_PACKET_SIZE] = {UART_PACKET_HEAD, CMD_RUN_BENCHMARK,
+                                      engine, precision, stage, 0, 0,
+                                      UART_PACKET_TAIL};
+  OperationMode mode = MODE_TRIGGER;
+  SystemState state = STATE_IDLE;
+  bool trigger = false;
+  gSimUartTxLength = 0;
+  process_uart_command(packet, &mode, &state, &trigger);
+  CHECK(gSimUartTxLength == UART_PACKET_SIZE, "response length %u",
+        (unsigned)gSimUartTxLength);
+  return gSimUartTx[2];
+}
+
+int main(void) {
+  test_reset_peripherals();
+  // 一帧 37 个整周期的正弦 (12 位无符号码值)
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    VALID_ADC_DATA[i] = (uint16_t)lround(
+        ADC_MIDPOINT + 1500 * sin(2 * M_PI * 37 * i / SAMPLE_SIZE));
+  }
+  memcpy(snapshot, VALID_ADC_DATA, sizeof(snapshot));
+
+  const uint8_t engines[] = {FFT_ENGINE_CMSIS, FFT_ENGINE_RADIX4};
+  const uint8_t precisions[] = {FFT_PRECISION_Q15, FFT_PRECISION_Q31};
+  for (uint32_t e = 0; e < 2; e++) {
+    for (uint32_t p = 0; p < 2; p++) {
+      const bool supported =
+          BENCHMARK_SUPPORTED &&
+          is_fft_config_supported((FftEngine)engines[e],
+                                  (FftPrecision)precisions[p]);
+      for (uint8_t stage = BENCHMARK_STAGE_FFT;
+           stage <= BENCHMARK_STAGE_DUAL_SEPARATE; stage++) {
+        const uint8_t status = run_benchmark(engines[e], precisions[p], stage);
+        CHECK(status == (supported ? RESP_OK : RESP_ERROR),
+              "engine %u precision %u stage %u: status %u", engines[e],
+              precisions[p], stage, status);
+        CHECK(memcmp(snapshot, VALID_ADC_DATA, sizeof(snapshot)) == 0,
+              "engine %u precision %u stage %u modified VALID_ADC_DATA",
+              engines[e], precisions[p], stage);
+      }
+    }
+  }
+  CHECK(run_benchmark(2, FFT_PRECISION_Q15, BENCHMARK_STAGE_FFT) == RESP_ERROR,
+        "invalid engine accepted");
+  CHECK(run_benchmark(FFT_ENGINE_RADIX4, 2, BENCHMARK_STAGE_FFT) == RESP_ERROR,
+        "invalid precision accepted");
+  CHECK(run_benchmark(FFT_ENGINE_RADIX4, FFT_PRECISION_Q15,
+                      BENCHMARK_STAGE_DUAL_SEPARATE + 1) == RESP_ERROR,
+        "invalid stage accepted");
+  return test_finish("test_benchmark");
+}
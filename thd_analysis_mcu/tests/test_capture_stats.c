@@ -0,0 +1,169 @@
+// capture_stats.c 边采集边处理的测试: 按模拟的 DMA 进度分块轮询一帧,
+// 检查 (1) 直流偏置与上一帧相同时, 采集期间预处理的结果与整帧采完后
+// 再分析逐位相同, 且分析时不再读取采样 (采完后改写缓冲区不影响频谱);
+// (2) 直流偏置改变超出容差时退回整帧预处理; (3) 电平改变后的第一帧
+// 按块重新得到参考电平, 不再遍历第二遍, 过零次数与占空比仍接近真值
+#include "analysis.h"
+#include "capture_stats.h"
+#include "consts.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPTURE_WORDS ((SAMPLE_SIZE + ADC_DISCARD_SAMPLES) / 2)
+// 测试信号: 一帧 TONE_CYCLES 个周期的正弦加三次谐波
+#define TONE_CYCLES 23.4
+#define TONE_AMPLITUDE 1500.0
+// 偏置改变在容差 (8 个码值) 以内与以外
+#define SMALL_SHIFT 3
+#define LARGE_SHIFT 40
+// 模拟主循环一次轮询时 DMA 多写入的点数 (不是 CAPTURE_STATS_CHUNK 的整数倍)
+#define POLL_STEP 100
+
+static uint16_t reference_frame[SAMPLE_SIZE];
+
+static void make_frame(double amplitude, int32_t offset) {
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * TONE_CYCLES * n / SAMPLE_SIZE;
+    const double v = amplitude * (sin(phase) + 0.05 * sin(3 * phase + 0.4));
+    reference_frame[n] = (uint16_t)lround(ADC_MIDPOINT + offset + v);
+  }
+}
+
+// 整帧采完后分析 (不经过边采集边处理)
+static AnalysisResult analyze_offline(void) {
+  capture_stats_invalidate();
+  memcpy(VALID_ADC_DATA, reference_frame, sizeof(reference_frame));
+  return analyze_harmonics(VALID_ADC_DATA);
+}
+
+// 按 DMA 进度分块写入并轮询, 最后一块在分析时处理
+static void capture_pipelined(void) {
+  capture_stats_begin(true);
+  for (uint32_t written = 0; written < SAMPLE_SIZE + ADC_DISCARD_SAMPLES;
+       written += POLL_STEP) {
+    for (uint32_t n = written;
+         n < written + POLL_STEP && n < SAMPLE_SIZE + ADC_DISCARD_SAMPLES;
+         n++) {
+      if (n >= ADC_DISCARD_SAMPLES) {
+        VALID_ADC_DATA[n - ADC_DISCARD_SAMPLES] =
+            reference_frame[n - ADC_DISCARD_SAMPLES];
+      }
+    }
+    const uint32_t done = written + POLL_STEP;
+    gSimDma[DMA_CH0_CHAN_ID].remaining =
+        done < 2 * CAPTURE_WORDS ? CAPTURE_WORDS - done / 2 : CAPTURE_WORDS;
+    capture_stats_poll();
+  }
+}
+
+static bool same_result(const AnalysisResult *a, const AnalysisResult *b) {
+  return a->thd == b->thd && a->num_harmonics == b->num_harmonics &&
+         memcmp(a->normalized_harmonics_amplitudes,
+                b->normalized_harmonics_amplitudes,
+                sizeof(a->normalized_harmonics_amplitudes)) == 0 &&
+         a->fundamental_freq_mhz == b->fundamental_freq_mhz &&
+         memcmp(&a->time_metrics, &b->time_metrics,
+                sizeof(a->time_metrics)) == 0 &&
+         memcmp(&a->spectral_metrics, &b->spectral_metrics,
+                sizeof(a->spectral_metrics)) == 0;
+}
+
+static const char *precision_name(FftPrecision precision) {
+  return precision == FFT_PRECISION_Q31 ? "Q31" : "Q15";
+}
+
+// 偏置不变: 与整帧分析逐位相同, 分析时只用采集期间预处理好的数据
+static void check_identical(FftPrecision precision) {
+  gAnalysisProfile.fft_precision = precision;
+  make_frame(TONE_AMPLITUDE, 0);
+  // 第一次分析得到本信号的参考电平与偏置, 第二次作为整帧分析的参考值
+  analyze_offline();
+  const AnalysisResult offline = analyze_offline();
+
+  capture_pipelined();
+  const AnalysisResult pipelined = analyze_harmonics(VALID_ADC_DATA);
+  CHECK(same_result(&pipelined, &offline),
+        "%s: pipelined thd %d, offline %d", precision_name(precision),
+        pipelined.thd, offline.thd);
+
+  // 采完后只改写最后一块之前的采样: 时域统计量与预处理都已完成,
+  // 结果不变说明分析没有再遍历这些采样
+  capture_pipelined();
+  memset(VALID_ADC_DATA, 0, SAMPLE_SIZE / 2 * sizeof(uint16_t));
+  const AnalysisResult overwritten = analyze_harmonics(VALID_ADC_DATA);
+  CHECK(same_result(&overwritten, &offline),
+        "%s: samples read again after capture (thd %d, expected %d)",
+        precision_name(precision), overwritten.thd, offline.thd);
+}
+
+// 偏置改变: 容差以内沿用上一帧的偏置, 以外退回整帧预处理
+static void check_offset_change(void) {
+  gAnalysisProfile.fft_precision = FFT_PRECISION_Q15;
+  make_frame(TONE_AMPLITUDE, 0);
+  analyze_offline();
+  make_frame(TONE_AMPLITUDE, LARGE_SHIFT);
+  const AnalysisResult expected = analyze_offline();
+  make_frame(TONE_AMPLITUDE, 0);
+  analyze_offline();
+  make_frame(TONE_AMPLITUDE, LARGE_SHIFT);
+  capture_pipelined();
+  const AnalysisResult fallback = analyze_harmonics(VALID_ADC_DATA);
+  CHECK(same_result(&fallback, &expected),
+        "offset %d: thd %d, offline %d", LARGE_SHIFT, fallback.thd,
+        expected.thd);
+
+  make_frame(TONE_AMPLITUDE, 0);
+  analyze_offline();
+  make_frame(TONE_AMPLITUDE, SMALL_SHIFT);
+  capture_pipelined();
+  const AnalysisResult shifted = analyze_harmonics(VALID_ADC_DATA);
+  const AnalysisResult offline = analyze_offline();
+  printf("offset %d: pipelined thd %d, offline %d\n", SMALL_SHIFT,
+         shifted.thd, offline.thd);
+  CHECK(abs(shifted.thd - offline.thd) <= offline.thd / 1000 + 1,
+        "offset %d: thd %d, offline %d", SMALL_SHIFT, shifted.thd,
+        offline.thd);
+}
+
+// 幅度与电平改变后的第一帧: 参考电平按块重新得到, 计数按点数比例换算
+static void check_level_change(void) {
+  gAnalysisProfile.fft_precision = FFT_PRECISION_Q15;
+  make_frame(TONE_AMPLITUDE / 8, 0);
+  analyze_offline();
+  make_frame(TONE_AMPLITUDE, 600);
+  capture_pipelined();
+  const AnalysisResult first = analyze_harmonics(VALID_ADC_DATA);
+  // 同一帧再分析一次, 参考电平已是本帧的
+  const AnalysisResult settled = analyze_offline();
+  const TimeDomainMetrics *t = &first.time_metrics;
+  const TimeDomainMetrics *s = &settled.time_metrics;
+  printf("level change: crossings %u (settled %u), duty %.2f%% (settled "
+         "%.2f%%)\n",
+         t->zero_crossings, s->zero_crossings,
+         100.0 * t->duty_cycle / RATIO_SCALE,
+         100.0 * s->duty_cycle / RATIO_SCALE);
+  CHECK(abs((int)t->zero_crossings - (int)s->zero_crossings) <= 2,
+        "crossings %u, settled %u", t->zero_crossings, s->zero_crossings);
+  CHECK(abs((int)t->duty_cycle - (int)s->duty_cycle) <= RATIO(0.03),
+        "duty %u, settled %u", t->duty_cycle, s->duty_cycle);
+  CHECK(t->min == s->min && t->max == s->max && t->mean == s->mean,
+        "min/max/mean differ from settled frame");
+}
+
+int main(void) {
+  test_reset_peripherals();
+  if (SPECTRUM_IN_CAPTURE_BUFFER) {
+    // 工作区就是采集缓冲区, 只在采集期间累加统计量
+    CHECK(!pipeline_preprocess_begin(), "pipelined at SAMPLE_SIZE %u",
+          SAMPLE_SIZE);
+    return test_finish("test_capture_stats");
+  }
+  check_identical(FFT_PRECISION_Q15);
+  check_identical(FFT_PRECISION_Q31);
+  check_offset_change();
+  check_level_change();
+  return test_finish("test_capture_stats");
+}
@@ -0,0 +1,170 @@
+// 相干采样定时器参数的测试: 在基波频率范围内扫描, 由固件按基波锁定
+// 采样时钟 (update_sampling_clock), 再让模拟的定时器触发 ADC 采一帧,
+// 按实际的转换时刻检查一帧内的基波周期数偏离整数不超过
+// COHERENT_MAX_ERROR; 并检查采样率上限 (ADC 转换能力) 与下限
+// (预分频与 16 位计数) 两侧 compute_coherent_timing 的返回值
+#include "analysis.h"
+#include "consts.h"
+#include "custom_init.h"
+#include "sampling.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include <math.h>
+
+// 扫描的相邻频率之比
+#define SWEEP_STEP 1.03
+
+static double midscale(uint32_t adc, uint32_t input_chan, double t,
+                       void *ctx) {
+  (void)adc;
+  (void)input_chan;
+  (void)t;
+  (void)ctx;
+  return ADC_MIDPOINT;
+}
+
+// 采样率上限对应的基波: 最多周期数、每点 COHERENT_MIN_PERIOD_TICKS 个时钟
+static double max_coherent_f0(uint32_t adc_count) {
+  return (double)CPUCLK_FREQ * COHERENT_MAX_CYCLES * adc_count /
+         ((double)COHERENT_MIN_PERIOD_TICKS * SAMPLE_SIZE);
+}
+
+// 采样率下限对应的基波: 最少周期数、最大预分频与计数
+static double min_coherent_f0(uint32_t adc_count) {
+  return (double)CPUCLK_FREQ * COHERENT_MIN_CYCLES /
+         ((double)SAMPLE_SIZE * TIMER_MAX_PRESCALE *
+          (TIMER_MAX_PERIOD / adc_count));
+}
+
+// 不分频时计数取整最多偏差半个时钟, 一帧的周期数偏差不超过
+// f0 * N * 0.5 / CPUCLK; 此频率以下必然能相干采样
+static double guaranteed_coherent_f0(void) {
+  return 2 * COHERENT_MAX_ERROR * CPUCLK_FREQ / SAMPLE_SIZE;
+}
+
+static void check_edges(uint32_t adc_count) {
+  CoherentTiming timing;
+  const double high = max_coherent_f0(adc_count);
+  const double low = min_coherent_f0(adc_count);
+
+  CHECK(compute_coherent_timing(high * (1 - 1e-6), adc_count, &timing),
+        "adc_count %u: %.3f Hz (ADC rate limit) rejected", adc_count, high);
+  CHECK((uint32_t)timing.prescale * timing.period * adc_count >=
+            COHERENT_MIN_PERIOD_TICKS,
+        "adc_count %u: %u x %u ticks below the ADC limit", adc_count,
+        timing.prescale, timing.period);
+  CHECK(!compute_coherent_timing(high * (1 + 1e-3), adc_count, &timing),
+        "adc_count %u: %.3f Hz above the ADC rate limit accepted", adc_count,
+        high * (1 + 1e-3));
+
+  CHECK(compute_coherent_timing(low * (1 + 1e-3), adc_count, &timing),
+        "adc_count %u: %.6f Hz (timer limit) rejected", adc_count, low);
+  CHECK(timing.prescale == TIMER_MAX_PRESCALE,
+        "adc_count %u: prescale %u at the timer limit", adc_count,
+        timing.prescale);
+  CHECK(!compute_coherent_timing(low * (1 - 1e-3), adc_count, &timing),
+        "adc_count %u: %.6f Hz below the timer limit accepted", adc_count,
+        low * (1 - 1e-3));
+
+  CHECK(!compute_coherent_timing(0, adc_count, &timing),
+        "adc_count %u: 0 Hz accepted", adc_count);
+  CHECK(!compute_coherent_timing(-50, adc_count, &timing),
+        "adc_count %u: negative frequency accepted", adc_count);
+}
+
+/**
+ * @brief 由固件锁定到 f0 并模拟采集一帧, 返回实际的周期数偏差
+ * @return 负数表示固件未锁定
+ */
+static double locked_frame_error(double f0_hz, CoherentTiming *timing) {
+  AnalysisResult result = {0};
+  result.fundamental_freq_mhz = (uint32_t)lround(f0_hz * 1000);
+  result.fundamental_freq = (uint32_t)lround(f0_hz);
+  update_sampling_clock(&result);
+  if (!is_coherent_locked()) {
+    return -1;
+  }
+  *timing = get_coherent_timing();
+
+  sampling_start();
+  const bool captured =
+      sim_capture_frame(midscale, NULL, 4 * (SAMPLE_SIZE + ADC_DISCARD_SAMPLES));
+  sampling_stop();
+  CHECK(captured, "%.3f Hz: frame not captured", f0_hz);
+  CHECK(gSimTraceLength == SAMPLE_SIZE + ADC_DISCARD_SAMPLES,
+        "%.3f Hz: %u conversions per frame", f0_hz, gSimTraceLength);
+  if (!captured || gSimTraceLength < 2) {
+    return INFINITY;
+  }
+
+  // 各点间隔应相同 (交织时为两个 ADC 轮流转换)
+  const double interval = (gSimTrace[gSimTraceLength - 1].t - gSimTrace[0].t) /
+                          (gSimTraceLength - 1);
+  for (uint32_t i = 1; i < gSimTraceLength; i++) {
+    const double dt = gSimTrace[i].t - gSimTrace[i - 1].t;
+    if (fabs(dt - interval) > interval * 1e-9) {
+      CHECK(false, "%.3f Hz: conversion %u spaced %.3g s, expected %.3g s",
+            f0_hz, i, dt, interval);
+      break;
+    }
+  }
+  return fabs(f0_hz * SAMPLE_SIZE * interval - timing->cycles);
+}
+
+static void sweep(uint32_t adc_count) {
+  gAcquisitionConfig.interleaved = adc_count == INTERLEAVE_ADC_COUNT;
+  apply_sampling_clock();
+
+  const double low = min_coherent_f0(adc_count);
+  const double high = max_coherent_f0(adc_count);
+  const double guaranteed = guaranteed_coherent_f0();
+  uint32_t locked = 0, total = 0;
+  double worst = 0;
+  for (double f = low * 1.01; f < high * 1.2; f *= SWEEP_STEP) {
+    // 固件以 mHz 接收基波频率, 以取整后的频率为准
+    const double f0 = round(f * 1000) / 1000;
+    if (f0 <= low) {
+      continue;
+    }
+    total++;
+    CoherentTiming expected;
+    const bool coherent = compute_coherent_timing(f0, adc_count, &expected);
+    CoherentTiming timing;
+    const double error = locked_frame_error(f0, &timing);
+    if (!coherent) {
+      CHECK(error < 0, "adc_count %u: %.3f Hz locked although rejected",
+            adc_count, f0);
+      CHECK(f0 > guaranteed,
+            "adc_count %u: %.3f Hz rejected inside the coherent range",
+            adc_count, f0);
+      continue;
+    }
+    locked++;
+    CHECK(error >= 0, "adc_count %u: %.3f Hz not locked", adc_count, f0);
+    CHECK(error <= COHERENT_MAX_ERROR,
+          "adc_count %u: %.3f Hz, M=%u, %u x %u: %.4f cycles off", adc_count,
+          f0, timing.cycles, timing.prescale, timing.period, error);
+    CHECK(timing.cycles >= COHERENT_MIN_CYCLES &&
+              timing.cycles <= COHERENT_MAX_CYCLES,
+          "adc_count %u: %.3f Hz, M=%u", adc_count, f0, timing.cycles);
+    if (error > worst) {
+      worst = error;
+    }
+  }
+  printf("adc_count %u: %.4f ~ %.1f Hz, %u/%u locked, worst %.4f cycles\n",
+         adc_count, low, high, locked, total, worst);
+}
+
+int main(void) {
+  test_reset_peripherals();
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  gAcquisitionConfig.clock_mode = SAMPLING_CLOCK_COHERENT;
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+
+  for (uint32_t adc_count = 1; adc_count <= INTERLEAVE_ADC_COUNT;
+       adc_count++) {
+    check_edges(adc_count);
+    sweep(adc_count);
+  }
+  return test_finish("test_coherent");
+}
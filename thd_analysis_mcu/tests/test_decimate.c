@@ -0,0 +1,233 @@
+// decimate.c 抽取前端的测试: 模拟的 ADC 与 DMA 循环写入环形缓冲区,
+// 测试按主循环分段轮询 decimation_poll. 检查 (1) 满量程随机输入下各抽取
+// 倍数的输出与 64 位参考 CIC (三级长度 R 的滑动和, 抽取后舍入) 逐点相同,
+// 含有符号 Q15 输出 (32 位积分器中途溢出须在梳状级抵消);
+// (2) 通带内单音与混叠到同一频点的单音的幅度与 decimation_gain 一致;
+// (3) 轮询间隔超过环形缓冲区时计入丢失并仍输出完整的一帧
+#include "consts.h"
+#include "custom_init.h"
+#include "decimate.h"
+#include "sampling.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include <math.h>
+#include <stdlib.h>
+
+// 模拟主循环一次轮询之间 ADC 转换的点数
+#define POLL_STEP 100
+// 单音测试: 抽取后的第 TONE_BIN 个频点 (矩形窗下无泄漏)
+#define TONE_BIN (SAMPLE_SIZE / 5)
+#define TONE_AMPLITUDE 1500.0
+// 误差上限比实测值 (通带 0.0004 dB, 混叠 0.02 dB) 留出余量; 混叠的单音
+// 只剩几十个码值, 误差主要来自输出的量化
+#define MAX_PASSBAND_ERR_DB 0.005
+#define MAX_ALIAS_ERR_DB 0.05
+
+typedef enum {
+  INPUT_RANDOM, // 满量程均匀随机码值
+  INPUT_TONE,   // 通带内的单音
+  INPUT_ALIAS,  // 混叠到同一频点的单音
+} InputKind;
+
+typedef struct {
+  InputKind kind;
+  uint32_t ratio;
+  uint32_t calls; // 已转换的点数
+} TestInput;
+
+// 随机输入按转换序号预先生成, 参考 CIC 与模拟的 ADC 使用同一序列
+static uint16_t random_codes[SAMPLE_SIZE * DECIMATION_MAX_RATIO +
+                             ADC_DISCARD_SAMPLES + 4 * DECIMATION_MAX_RATIO];
+#define RANDOM_CODES (sizeof(random_codes) / sizeof(random_codes[0]))
+
+static uint16_t input_code(const TestInput *in, uint32_t n) {
+  if (in->kind == INPUT_RANDOM) {
+    return random_codes[n % RANDOM_CODES];
+  }
+  // 抽取后第 TONE_BIN 点, 或抽取前采样率减去它 (混叠到同一点)
+  double cycles = (double)TONE_BIN / SAMPLE_SIZE;
+  if (in->kind == INPUT_ALIAS) {
+    cycles = 1 - cycles;
+  }
+  return (uint16_t)lround(ADC_MIDPOINT +
+                          TONE_AMPLITUDE *
+                              sin(2 * M_PI * cycles * n / in->ratio + 0.3));
+}
+
+static double test_input(uint32_t adc, uint32_t input_chan, double t,
+                         void *ctx) {
+  (void)adc;
+  (void)input_chan;
+  (void)t;
+  TestInput *in = ctx;
+  return input_code(in, in->calls++);
+}
+
+static void configure(uint32_t ratio, AdcDataFormat format) {
+  test_reset_peripherals();
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+  gAcquisitionConfig.data_format = format;
+  gAcquisitionConfig.decimation = ratio;
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  apply_sampling_clock();
+}
+
+/**
+ * @brief 按主循环采集一帧: DMA 完成中断随时处理, 每 POLL_STEP 次转换轮询一次
+ * @param first_poll 第一次轮询前转换的点数, 大于环形缓冲区时造成丢失
+ */
+static bool capture(TestInput *in, uint32_t first_poll) {
+  in->calls = 0;
+  sampling_start();
+  uint32_t next_poll = first_poll;
+  for (uint32_t i = 0; i < 4 * SAMPLE_SIZE * DECIMATION_MAX_RATIO; i++) {
+    if (sim_capture_frame(test_input, in, next_poll - in->calls)) {
+      DL_ADC12_clearInterruptStatus(ADC0, DL_ADC12_INTERRUPT_DMA_DONE);
+      decimation_on_dma_done();
+    }
+    if (in->calls < next_poll) {
+      continue;
+    }
+    next_poll = in->calls + POLL_STEP;
+    if (decimation_poll()) {
+      sampling_stop();
+      return true;
+    }
+  }
+  sampling_stop();
+  return false;
+}
+
+static uint32_t log2_u32(uint32_t v) {
+  uint32_t n = 0;
+  while (v > 1) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+}
+
+/**
+ * @brief 参考 CIC: 丢弃 ADC_DISCARD_SAMPLES 个输入后, 三级长度 R 的滑动和
+ * 每 R 点输出一次, 丢弃前 CIC_ORDER 个输出, 按增益舍入后换算为设定的格式
+ */
+static uint32_t reference_mismatches(const TestInput *in, bool out_signed,
+                                     uint32_t *first_bad) {
+  const uint32_t r = in->ratio;
+  const uint32_t extra = out_signed ? oversampling_extra_bits(r) : 0;
+  const uint32_t shift = CIC_ORDER * log2_u32(r) - extra;
+  const int64_t round = shift != 0 ? (int64_t)1 << (shift - 1) : 0;
+  int64_t sum[CIC_ORDER] = {0};
+  int64_t *history[CIC_ORDER];
+  const uint32_t len = (SAMPLE_SIZE + CIC_ORDER) * r;
+  for (uint32_t k = 0; k < CIC_ORDER; k++) {
+    history[k] = calloc(len, sizeof(int64_t));
+  }
+  uint32_t bad = 0;
+  *first_bad = SAMPLE_SIZE;
+  for (uint32_t n = 0; n < len; n++) {
+    int64_t x = (int64_t)input_code(in, ADC_DISCARD_SAMPLES + n) -
+                ADC_MIDPOINT;
+    for (uint32_t k = 0; k < CIC_ORDER; k++) {
+      history[k][n] = x;
+      sum[k] += x - (n >= r ? history[k][n - r] : 0);
+      x = sum[k];
+    }
+    if ((n + 1) % r != 0 || (n + 1) / r <= CIC_ORDER) {
+      continue;
+    }
+    const uint32_t m = (n + 1) / r - CIC_ORDER - 1;
+    // 算术右移即向下取整, 与固件相同
+    const int64_t v = (x + round) >> shift;
+    const uint16_t expected =
+        out_signed ? (uint16_t)(int16_t)(v * (1 << (ADC_SIGNED_SHIFT - extra)))
+                   : (uint16_t)(v + ADC_MIDPOINT);
+    if (VALID_ADC_DATA[m] != expected) {
+      if (bad++ == 0) {
+        *first_bad = m;
+      }
+    }
+  }
+  for (uint32_t k = 0; k < CIC_ORDER; k++) {
+    free(history[k]);
+  }
+  return bad;
+}
+
+static void check_exact(uint32_t ratio, AdcDataFormat format) {
+  const bool out_signed = format == ADC_DATA_FORMAT_SIGNED_Q15;
+  configure(ratio, format);
+  TestInput in = {.kind = INPUT_RANDOM, .ratio = ratio};
+  CHECK(capture(&in, POLL_STEP), "R %u: no frame", ratio);
+  CHECK(is_frame_decimated(), "R %u: frame not decimated", ratio);
+  uint32_t first_bad;
+  const uint32_t bad = reference_mismatches(&in, out_signed, &first_bad);
+  CHECK(bad == 0, "R %u %s: %u outputs differ (first at %u)", ratio,
+        out_signed ? "Q15" : "unsigned", bad, first_bad);
+}
+
+// 一帧在第 TONE_BIN 点的幅度 (码值)
+static double tone_amplitude(void) {
+  double re = 0, im = 0;
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * (double)TONE_BIN * n / SAMPLE_SIZE;
+    const double v = (double)VALID_ADC_DATA[n] - ADC_MIDPOINT;
+    re += v * cos(phase);
+    im -= v * sin(phase);
+  }
+  return 2 * hypot(re, im) / SAMPLE_SIZE;
+}
+
+static void check_response(uint32_t ratio) {
+  const double x = (double)TONE_BIN / SAMPLE_SIZE;
+  double err_db[2];
+  for (uint32_t alias = 0; alias < 2; alias++) {
+    configure(ratio, ADC_DATA_FORMAT_UNSIGNED);
+    TestInput in = {.kind = alias ? INPUT_ALIAS : INPUT_TONE, .ratio = ratio};
+    CHECK(capture(&in, POLL_STEP), "R %u: no frame", ratio);
+    const double expected = fabs(decimation_gain(alias ? 1 - x : x));
+    err_db[alias] =
+        fabs(20 * log10(tone_amplitude() / TONE_AMPLITUDE / expected));
+  }
+  printf("R %2u: passband %.4f dB, alias %.3f dB off decimation_gain\n", ratio,
+         err_db[0], err_db[1]);
+  CHECK(err_db[0] <= MAX_PASSBAND_ERR_DB, "R %u: passband off by %.4f dB",
+        ratio, err_db[0]);
+  CHECK(err_db[1] <= MAX_ALIAS_ERR_DB, "R %u: alias off by %.3f dB", ratio,
+        err_db[1]);
+}
+
+// 第一次轮询晚于环形缓冲区写满一圈以上: 计入丢失, 重新开始后仍输出一帧
+static void check_overrun(void) {
+  const uint32_t ratio = 4;
+  configure(ratio, ADC_DATA_FORMAT_UNSIGNED);
+  TestInput in = {.kind = INPUT_TONE, .ratio = ratio};
+  const uint32_t before = decimation_overruns();
+  CHECK(capture(&in, DECIMATION_RING_SAMPLES + 2 * POLL_STEP),
+        "overrun: no frame");
+  CHECK(decimation_overruns() == before + 1, "overrun: %u counted",
+        decimation_overruns() - before);
+  const double err =
+      fabs(20 * log10(tone_amplitude() / TONE_AMPLITUDE /
+                      decimation_gain((double)TONE_BIN / SAMPLE_SIZE)));
+  CHECK(err <= MAX_PASSBAND_ERR_DB, "overrun: tone off by %.4f dB", err);
+}
+
+int main(void) {
+  if (!DECIMATION_SUPPORTED) {
+    configure(4, ADC_DATA_FORMAT_UNSIGNED);
+    CHECK(get_decimation_ratio() == 1, "decimation at SAMPLE_SIZE %u",
+          SAMPLE_SIZE);
+    return test_finish("test_decimate");
+  }
+  for (uint32_t i = 0; i < RANDOM_CODES; i++) {
+    random_codes[i] = (uint16_t)lround((test_random() + 1) * 2047.5);
+  }
+  for (uint32_t ratio = 2; ratio <= DECIMATION_MAX_RATIO; ratio *= 2) {
+    check_exact(ratio, ADC_DATA_FORMAT_UNSIGNED);
+    check_exact(ratio, ADC_DATA_FORMAT_SIGNED_Q15);
+    check_response(ratio);
+  }
+  check_overrun();
+  return test_finish("test_decimate");
+}
@@ -0,0 +1,129 @@
+// ets.c 等效时间采样的测试: 基波低于奈奎斯特频率, 三次与五次谐波高于
+// fs/2 (普通的一帧中混叠到别处). 先按普通帧分析得到基波频率, 再把起始
+// 相位随机的若干帧折叠成一个周期, 检查重建的波形中谐波落在
+// 基波频点的整数倍上, 幅度 (相对基波) 与生成时相同, 其余频点没有
+// 明显的杂散; 并检查重建帧的分析结果 (谐波索引、谐波比与基波频率)
+#include "analysis.h"
+#include "consts.h"
+#include "custom_init.h"
+#include "ets.h"
+#include "sampling.h"
+#include "support.h"
+#include <math.h>
+
+// 基波相对采样率的频率: 三次谐波 0.58 fs, 五次谐波 0.97 fs
+#define F0_RATIO 0.1937
+#define TONE_AMPLITUDE 1500.0
+#define H3_DBC -20.0
+#define H5_DBC -34.0
+#define ETS_TEST_FRAMES 16
+// 误差上限比实测值 (各点数下最差约 0.003 dB, -70 dBc, 4e-8) 留出余量.
+// 谐波比的误差来自相位区间的宽度 (1/ETS_PERIOD_POINTS 周期) 与 12 位量化
+#define MAX_HARMONIC_ERR_DB 0.05
+#define MAX_SPUR_DBC -60.0
+#define MAX_F0_ERR 1e-6
+
+static uint16_t frame[SAMPLE_SIZE];
+static double reference[SAMPLE_SIZE];
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+// 从随机时刻开始的一帧: 各帧相对基波的相位不同, 谐波与基波锁相
+static void make_frame(double f0_ratio) {
+  const double start = (test_random() + 1) * 1000;
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * f0_ratio * (n + start);
+    const double v = TONE_AMPLITUDE *
+                     (sin(phase) + db_to_ratio(H3_DBC) * sin(3 * phase + 0.7) +
+                      db_to_ratio(H5_DBC) * sin(5 * phase + 1.9));
+    frame[n] = (uint16_t)lround(ADC_MIDPOINT + v);
+  }
+}
+
+static double bin_magnitude(uint32_t k) {
+  double re, im;
+  reference_dft_bin(reference, NULL, SAMPLE_SIZE, k, &re, &im);
+  return hypot(re, im);
+}
+
+// 重建帧中第 order 次谐波 (第 order * ETS_TILE_PERIODS 点) 相对基波的 dB 值
+static double harmonic_dbc(uint32_t order, double fundamental) {
+  return 20 * log10(bin_magnitude(order * ETS_TILE_PERIODS) / fundamental);
+}
+
+int main(void) {
+  test_reset_peripherals();
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  gAcquisitionConfig.ets_frames = ETS_TEST_FRAMES;
+  ets_reset();
+  const double fs = get_sample_rate_hz();
+  const double f0 = F0_RATIO * fs;
+
+  // 普通帧: 测出基波频率
+  make_frame(F0_RATIO);
+  CHECK(ets_process_frame(frame) && !ets_frame_reconstructed(),
+        "first frame not analyzed as a plain frame");
+  const AnalysisResult plain = analyze_harmonics(frame);
+  ets_update_from_result(&plain);
+
+  // 随机相位的各帧, 最后一帧输出重建的波形
+  for (uint32_t i = 1; i <= ETS_TEST_FRAMES; i++) {
+    make_frame(F0_RATIO);
+    const bool done = ets_process_frame(frame);
+    CHECK(done == (i == ETS_TEST_FRAMES), "frame %u: done %d", i, done);
+  }
+  CHECK(ets_frame_reconstructed(), "no reconstructed frame");
+  CHECK(ets_accumulated_frames() == 0, "%u frames left after rebuilding",
+        ets_accumulated_frames());
+
+  // 重建帧一个周期平铺 ETS_TILE_PERIODS 次, 频谱只在其整数倍上
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    reference[n] = (double)frame[n] - ADC_MIDPOINT;
+  }
+  const double fundamental = bin_magnitude(ETS_TILE_PERIODS);
+  const double h3_err = fabs(harmonic_dbc(3, fundamental) - H3_DBC);
+  const double h5_err = fabs(harmonic_dbc(5, fundamental) - H5_DBC);
+  double spur = -INFINITY;
+  uint32_t spur_order = 0;
+  for (uint32_t order = 2; order * ETS_TILE_PERIODS < SAMPLE_SIZE / 2;
+       order++) {
+    if (order == 3 || order == 5) {
+      continue;
+    }
+    const double dbc = harmonic_dbc(order, fundamental);
+    if (dbc > spur) {
+      spur = dbc;
+      spur_order = order;
+    }
+  }
+  const double f0_err =
+      fabs(ets_sample_rate_hz() / ETS_PERIOD_POINTS - f0) / f0;
+  printf("fs %.0f Hz, f0 %.3f Hz (plain frame %.3f Hz, rebuilt %.3f Hz)\n", fs,
+         f0, plain.fundamental_freq_mhz / 1000.0,
+         ets_sample_rate_hz() / ETS_PERIOD_POINTS);
+  printf("H3 %.3f dB, H5 %.3f dB off, largest spur %.1f dBc (order %u)\n",
+         h3_err, h5_err, spur, spur_order);
+  CHECK(h3_err <= MAX_HARMONIC_ERR_DB, "H3 off by %.3f dB", h3_err);
+  CHECK(h5_err <= MAX_HARMONIC_ERR_DB, "H5 off by %.3f dB", h5_err);
+  CHECK(spur <= MAX_SPUR_DBC, "spur %.1f dBc at order %u", spur, spur_order);
+  CHECK(f0_err <= MAX_F0_ERR, "rebuilt f0 off by %.2e", f0_err);
+
+  // 按重建的等效采样率分析: 谐波索引与谐波比
+  const AnalysisResult rebuilt = analyze_harmonics(frame);
+  CHECK(rebuilt.num_harmonics >= 5, "%u harmonics", rebuilt.num_harmonics);
+  for (uint32_t order = 3; order <= 5; order += 2) {
+    const double expected = order == 3 ? H3_DBC : H5_DBC;
+    const double dbc =
+        20 * log10((double)rebuilt.normalized_harmonics_amplitudes[order - 1] /
+                   RATIO_SCALE);
+    CHECK(rebuilt.harmonic_indices[order - 1] == order * ETS_TILE_PERIODS,
+          "H%u at bin %u", order, rebuilt.harmonic_indices[order - 1]);
+    CHECK(fabs(dbc - expected) <= MAX_HARMONIC_ERR_DB,
+          "analyzed H%u %.3f dBc, expected %.1f", order, dbc, expected);
+  }
+  CHECK(fabs(rebuilt.fundamental_freq_mhz / 1000.0 - f0) / f0 <= MAX_F0_ERR,
+        "analyzed f0 %.3f Hz, expected %.3f", rebuilt.fundamental_freq_mhz /
+        1000.0, f0);
+  return test_finish("test_ets");
+}
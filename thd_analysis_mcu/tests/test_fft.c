@@ -0,0 +1,301 @@
+// fft.c 的一致性测试: 以双精度 DFT 为参考, 比较 rfft_q15_inplace 与
+// CMSIS arm_rfft_q15 在各点数下的输出信噪比 (误差相对频谱的能量比).
+// 基4实现不得低于 CMSIS: 主机上的 arm_rfft_q15 是双精度 DFT 按 1/N 缩放后
+// 只舍入一次 (tests/sim/cmsis_reference.c), 不含 CMSIS 各级截断的误差,
+// 是器件上 CMSIS 精度的上限, 因此这是比实际 CMSIS 更严的要求.
+// cfft_q15_inplace 不得低于 CMSIS arm_cfft_q15 的缩放方式: 每级按基数
+// (4, 点数不是 4 的幂时第一级为 2) 缩小并截断到整数, 见 cmsis_cfft_model
+// 双通道采集把两路实数信号合成一次复数 FFT, cfft_split_real_q15 拆分出的
+// 两路频谱不得明显差于两路各做一次 rfft_q15_inplace, 见 dual_split_snr
+#include "consts.h"
+#include "fft.h"
+#include "support.h"
+#include <math.h>
+#include <stdlib.h>
+
+// 双通道拆分相对分别做实数 FFT 允许低出的信噪比 (dB)
+#define DUAL_MARGIN_DB 3.0
+
+// 测试信号: 满量程多音、小信号 (-40 dBFS) 与白噪声
+typedef enum {
+  SIGNAL_MULTITONE,
+  SIGNAL_SMALL,
+  SIGNAL_NOISE,
+  SIGNAL_COUNT,
+} TestSignal;
+
+static const char *const SIGNAL_NAMES[SIGNAL_COUNT] = {"multitone", "small",
+                                                       "noise"};
+
+static q15_t sample(TestSignal signal, uint32_t n, uint32_t len) {
+  const double t = (double)n / len;
+  double v;
+  switch (signal) {
+  case SIGNAL_MULTITONE:
+    // 基波 + 谐波 + 直流, 峰值约 0.9 满量程
+    v = 0.6 * sin(2 * M_PI * 3.3 * t) + 0.2 * sin(2 * M_PI * 6.6 * t + 1) +
+        0.05 * sin(2 * M_PI * 9.9 * t + 2) + 0.05;
+    break;
+  case SIGNAL_SMALL:
+    v = 0.01 * sin(2 * M_PI * 5.1 * t) + 0.001 * sin(2 * M_PI * 10.2 * t);
+    break;
+  default:
+    v = 0.5 * test_random();
+    break;
+  }
+  return (q15_t)lround(v * 32767);
+}
+
+/**
+ * @brief 两种实数 FFT 对同一输入的信噪比
+ * @note 只比较前 len/2 个频点, 基4实现的 [0] 为直流、[1] 为奈奎斯特
+ * (都是实数), CMSIS 的奈奎斯特频点在 [len]
+ */
+static void rfft_snr(TestSignal signal, uint32_t len, double *radix4_db,
+                     double *cmsis_db) {
+  q15_t *buf = malloc(sizeof(q15_t) * len);
+  q15_t *cmsis_in = malloc(sizeof(q15_t) * len);
+  q15_t *cmsis_out = malloc(sizeof(q15_t) * 2 * len);
+  double *x = malloc(sizeof(double) * len);
+  double *ref = malloc(sizeof(double) * len);
+  double *out = malloc(sizeof(double) * len);
+  for (uint32_t n = 0; n < len; n++) {
+    buf[n] = sample(signal, n, len);
+    cmsis_in[n] = buf[n];
+    x[n] = buf[n];
+  }
+  for (uint32_t k = 0; k < len / 2; k++) {
+    reference_dft_bin(x, NULL, len, k, &ref[2 * k], &ref[2 * k + 1]);
+  }
+  double nyquist_im;
+  reference_dft_bin(x, NULL, len, len / 2, &ref[1], &nyquist_im);
+
+  const uint32_t e = rfft_q15_inplace(buf, len);
+  const double scale = ldexp(1.0, (int)e);
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = buf[i] * scale;
+  }
+  *radix4_db = error_snr_db(ref, out, len / 2);
+
+  arm_rfft_instance_q15 instance;
+  arm_rfft_init_q15(&instance, len, 0, 1);
+  arm_rfft_q15(&instance, cmsis_in, cmsis_out);
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = (double)cmsis_out[i] * len;
+  }
+  out[1] = (double)cmsis_out[len] * len;
+  *cmsis_db = error_snr_db(ref, out, len / 2);
+
+  free(buf);
+  free(cmsis_in);
+  free(cmsis_out);
+  free(x);
+  free(ref);
+  free(out);
+}
+
+/**
+ * @brief arm_cfft_q15 的缩放模型: 按频率抽取, 每级输出除以基数后向下取整
+ * (与 CMSIS 中算术右移相同), 旋转因子不量化. 结果按 1/len 缩放, 顺序为
+ * 自然顺序
+ */
+static void cmsis_cfft_model(double *re, double *im, uint32_t len) {
+  if (len == 1) {
+    return;
+  }
+  const uint32_t radix = (len & 0x55555555u) != 0 ? 4 : 2;
+  const uint32_t m = len / radix;
+  double *sub_re = malloc(sizeof(double) * len);
+  double *sub_im = malloc(sizeof(double) * len);
+  for (uint32_t n = 0; n < m; n++) {
+    for (uint32_t r = 0; r < radix; r++) {
+      // 第 r 个子序列: sum_q x[n + q m] e^{-j 2 pi q r / radix},
+      // 再乘旋转因子 e^{-j 2 pi n r / len}
+      double acc_re = 0, acc_im = 0;
+      for (uint32_t q = 0; q < radix; q++) {
+        const double a = -2 * M_PI * (double)(q * r % radix) / radix;
+        acc_re += re[n + q * m] * cos(a) - im[n + q * m] * sin(a);
+        acc_im += re[n + q * m] * sin(a) + im[n + q * m] * cos(a);
+      }
+      const double w = -2 * M_PI * (double)(n * r) / len;
+      const double t_re = acc_re * cos(w) - acc_im * sin(w);
+      const double t_im = acc_re * sin(w) + acc_im * cos(w);
+      sub_re[r * m + n] = floor(t_re / radix);
+      sub_im[r * m + n] = floor(t_im / radix);
+    }
+  }
+  for (uint32_t r = 0; r < radix; r++) {
+    cmsis_cfft_model(&sub_re[r * m], &sub_im[r * m], m);
+  }
+  for (uint32_t r = 0; r < radix; r++) {
+    for (uint32_t k = 0; k < m; k++) {
+      re[k * radix + r] = sub_re[r * m + k];
+      im[k * radix + r] = sub_im[r * m + k];
+    }
+  }
+  free(sub_re);
+  free(sub_im);
+}
+
+/**
+ * @brief 复数 FFT 的信噪比, 实部与虚部放两路不同的信号
+ * @param cmsis_db cmsis_cfft_model 的信噪比
+ */
+static void cfft_snr(TestSignal signal, uint32_t len, double *radix4_db,
+                     double *cmsis_db) {
+  q15_t *buf = malloc(sizeof(q15_t) * 2 * len);
+  double *re = malloc(sizeof(double) * len);
+  double *im = malloc(sizeof(double) * len);
+  double *ref = malloc(sizeof(double) * 2 * len);
+  double *out = malloc(sizeof(double) * 2 * len);
+  for (uint32_t n = 0; n < len; n++) {
+    buf[2 * n] = sample(signal, n, len);
+    buf[2 * n + 1] = sample(signal, (n * 7 + 3) % len, len);
+    re[n] = buf[2 * n];
+    im[n] = buf[2 * n + 1];
+  }
+  for (uint32_t k = 0; k < len; k++) {
+    reference_dft_bin(re, im, len, k, &ref[2 * k], &ref[2 * k + 1]);
+  }
+
+  const uint32_t e = cfft_q15_inplace(buf, len);
+  const double scale = ldexp(1.0, (int)e);
+  for (uint32_t i = 0; i < 2 * len; i++) {
+    out[i] = buf[i] * scale;
+  }
+  *radix4_db = error_snr_db(ref, out, len);
+
+  cmsis_cfft_model(re, im, len);
+  for (uint32_t k = 0; k < len; k++) {
+    out[2 * k] = re[k] * len;
+    out[2 * k + 1] = im[k] * len;
+  }
+  *cmsis_db = error_snr_db(ref, out, len);
+
+  free(buf);
+  free(re);
+  free(im);
+  free(ref);
+  free(out);
+}
+
+/**
+ * @brief 两路实数信号合成一次复数 FFT 再拆分 (双通道采集) 的信噪比,
+ * 与两路各做一次实数 FFT 比较
+ * @param split_db 拆分出的 X 与 Y 的误差相对两路总功率的信噪比: 两路共用
+ * 块浮点指数, 舍入误差由合成信号的电平决定, 平均分到两路
+ * @param rfft_db x 与 y 分别做 rfft_q15_inplace 的信噪比
+ * @note 只比较 0 ~ len/2 - 1 点 (两路的幅度谱都只用这一半)
+ */
+static void dual_split_snr(TestSignal sx, TestSignal sy, uint32_t len,
+                           double split_db[2], double rfft_db[2]) {
+  q15_t *input[2] = {malloc(sizeof(q15_t) * len),
+                     malloc(sizeof(q15_t) * len)};
+  q15_t *z = malloc(sizeof(q15_t) * 2 * len);
+  q15_t *buf = malloc(sizeof(q15_t) * len);
+  double *x = malloc(sizeof(double) * len);
+  double *ref = malloc(sizeof(double) * len);
+  double *out = malloc(sizeof(double) * len);
+  for (uint32_t n = 0; n < len; n++) {
+    input[0][n] = sample(sx, n, len);
+    input[1][n] = sample(sy, n, len);
+    z[2 * n] = input[0][n];
+    z[2 * n + 1] = input[1][n];
+  }
+  const uint32_t e = cfft_q15_inplace(z, len);
+  // 拆分公式输出 2X[k], 换算回 X[k]
+  const double split_scale = ldexp(1.0, (int)e - 1);
+
+  double power[2];
+  for (uint32_t ch = 0; ch < 2; ch++) {
+    for (uint32_t n = 0; n < len; n++) {
+      buf[n] = input[ch][n];
+      x[n] = buf[n];
+    }
+    for (uint32_t k = 0; k < len / 2; k++) {
+      reference_dft_bin(x, NULL, len, k, &ref[2 * k], &ref[2 * k + 1]);
+    }
+    power[ch] = 0;
+    for (uint32_t i = 0; i < len; i++) {
+      power[ch] += ref[i] * ref[i];
+    }
+
+    for (uint32_t k = 0; k < len / 2; k++) {
+      int32_t a[2], b[2];
+      cfft_split_real_q15(z, len, k, a, b);
+      const int32_t *v = ch == 0 ? a : b;
+      out[2 * k] = v[0] * split_scale;
+      out[2 * k + 1] = v[1] * split_scale;
+    }
+    split_db[ch] = error_snr_db(ref, out, len / 2);
+
+    // 实数 FFT 的 [1] 为奈奎斯特频点, 直流的虚部为 0
+    const double rfft_scale = ldexp(1.0, (int)rfft_q15_inplace(buf, len));
+    for (uint32_t i = 0; i < len; i++) {
+      out[i] = buf[i] * rfft_scale;
+    }
+    out[1] = 0;
+    rfft_db[ch] = error_snr_db(ref, out, len / 2);
+  }
+  for (uint32_t ch = 0; ch < 2; ch++) {
+    split_db[ch] += 10 * log10((power[0] + power[1]) / power[ch]);
+  }
+  free(input[0]);
+  free(input[1]);
+  free(z);
+  free(buf);
+  free(x);
+  free(ref);
+  free(out);
+}
+
+int main(void) {
+  printf("SAMPLE_SIZE %u\n", SAMPLE_SIZE);
+  printf("%6s %-10s %10s %10s\n", "len", "signal", "rfft_dB", "cmsis_dB");
+  for (uint32_t len = 16; len <= SAMPLE_SIZE; len *= 2) {
+    for (uint32_t s = 0; s < SIGNAL_COUNT; s++) {
+      double r, c;
+      test_random_seed(len + s);
+      rfft_snr((TestSignal)s, len, &r, &c);
+      printf("%6u %-10s %10.1f %10.1f\n", len, SIGNAL_NAMES[s], r, c);
+      CHECK(r >= c, "rfft len %u %s: %.1f dB < CMSIS %.1f dB", len,
+            SIGNAL_NAMES[s], r, c);
+    }
+  }
+  printf("%6s %-10s %10s %10s\n", "len", "signal", "cfft_dB", "cmsis_dB");
+  for (uint32_t len = 4; len <= SAMPLE_SIZE; len *= 2) {
+    for (uint32_t s = 0; s < SIGNAL_COUNT; s++) {
+      double r, c;
+      test_random_seed(len + s);
+      cfft_snr((TestSignal)s, len, &r, &c);
+      printf("%6u %-10s %10.1f %10.1f\n", len, SIGNAL_NAMES[s], r, c);
+      CHECK(r >= c, "cfft len %u %s: %.1f dB < CMSIS %.1f dB", len,
+            SIGNAL_NAMES[s], r, c);
+    }
+  }
+  // 双通道拆分: 两路的误差 (相对两路总功率) 不低于分别做实数 FFT 时
+  // 较差一路的信噪比减去 DUAL_MARGIN_DB. 一路为小信号时该路相对自身的
+  // 信噪比按电平差降低, 这是共用块浮点指数的代价, 不是两路之间的串扰
+  printf("%6s %-20s %9s %9s %9s %9s\n", "len", "signals", "split_x",
+         "rfft_x", "split_y", "rfft_y");
+  const TestSignal pairs[][2] = {{SIGNAL_MULTITONE, SIGNAL_NOISE},
+                                 {SIGNAL_MULTITONE, SIGNAL_SMALL}};
+  for (uint32_t len = 16; len <= SAMPLE_SIZE; len *= 2) {
+    for (uint32_t p = 0; p < 2; p++) {
+      double split_db[2], rfft_db[2];
+      test_random_seed(len + p);
+      dual_split_snr(pairs[p][0], pairs[p][1], len, split_db, rfft_db);
+      printf("%6u %-9s+%-10s %9.1f %9.1f %9.1f %9.1f\n", len,
+             SIGNAL_NAMES[pairs[p][0]], SIGNAL_NAMES[pairs[p][1]],
+             split_db[0], rfft_db[0], split_db[1], rfft_db[1]);
+      const double worst = rfft_db[0] < rfft_db[1] ? rfft_db[0] : rfft_db[1];
+      for (uint32_t ch = 0; ch < 2; ch++) {
+        CHECK(split_db[ch] >= worst - DUAL_MARGIN_DB,
+              "dual split len %u %s+%s channel %u: %.1f dB < %.1f dB", len,
+              SIGNAL_NAMES[pairs[p][0]], SIGNAL_NAMES[pairs[p][1]], ch,
+              split_db[ch], worst - DUAL_MARGIN_DB);
+      }
+    }
+  }
+  return test_finish("test_fft");
+}
@@ -0,0 +1,211 @@
+// 交织采集的测试: 检查 ADC0/ADC1 的定时器触发与 DMA 配置, 让模拟的外设
+// 采一帧 (ADC1 带增益与偏置失配), 检查两路结果按时间顺序隔点写入
+// 同一帧 (ADC0 偶数点、ADC1 奇数点), 再检查固件估计的失配参数及校正后
+// 奇数点与偶数点的一致性 (fs/2 - f 处的镜像与 fs/2 处的偏置杂散)
+#include "consts.h"
+#include "custom_init.h"
+#include "interleave.h"
+#include "sampling.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include <math.h>
+
+// ADC1 相对 ADC0 的失配: code1 = mid + OFFSET + GAIN * (code0 - mid)
+#define ADC1_GAIN 1.03
+#define ADC1_OFFSET 12.0
+// 测试信号: 一帧 TONE_BIN 个整周期 (奇数, 避开单路采样率的 1/4)
+#define TONE_BIN 101
+#define TONE_AMPLITUDE 1800.0
+// 校正后镜像与偏置杂散相对基波的上限 (dBc); 未校正时约 -36 dBc
+#define MAX_SPUR_DBC -60.0
+
+typedef struct {
+  double freq_hz;
+} Tone;
+
+static double ideal_code(double t, const Tone *tone) {
+  return ADC_MIDPOINT + TONE_AMPLITUDE * sin(2 * M_PI * tone->freq_hz * t);
+}
+
+static double mismatched_signal(uint32_t adc, uint32_t input_chan, double t,
+                                void *ctx) {
+  (void)input_chan;
+  const double code = ideal_code(t, ctx);
+  if (adc == 0) {
+    return code;
+  }
+  return ADC_MIDPOINT + ADC1_OFFSET + ADC1_GAIN * (code - ADC_MIDPOINT);
+}
+
+// 采样换算为 12 位码值
+static double sample_code(uint16_t raw, bool is_signed) {
+  return is_signed ? (double)((int16_t)raw) / PRE_FFT_SCALE + ADC_MIDPOINT
+                   : raw;
+}
+
+static void check_configuration(void) {
+  const CoherentTiming timing = get_coherent_timing();
+  const uint32_t per_adc =
+      (SAMPLE_SIZE + ADC_DISCARD_SAMPLES) / INTERLEAVE_ADC_COUNT;
+
+  // 定时器: 一个周期触发两个 ADC 各一次, 过零触发 ADC0, 减到 period 触发 ADC1
+  CHECK(gSimTimer.load == (uint32_t)timing.period * INTERLEAVE_ADC_COUNT - 1,
+        "timer load %u, period %u", gSimTimer.load, timing.period);
+  CHECK(gSimTimer.cc0 == timing.period, "timer cc0 %u", gSimTimer.cc0);
+  CHECK(gSimTimer.prescale == timing.prescale, "timer prescale %u",
+        gSimTimer.prescale);
+  CHECK(gSimTimer.events[DL_TIMERG_EVENT_ROUTE_1] ==
+                DL_TIMERG_EVENT_ZERO_EVENT &&
+            gSimTimer.publisher[DL_TIMERG_PUBLISHER_INDEX_0] ==
+                ADC0_TRIGGER_CHANNEL,
+        "ADC0 trigger route");
+  CHECK(gSimTimer.events[DL_TIMERG_EVENT_ROUTE_2] ==
+                DL_TIMERG_EVENT_CC0_DN_EVENT &&
+            gSimTimer.publisher[DL_TIMERG_PUBLISHER_INDEX_1] ==
+                ADC1_TRIGGER_CHANNEL,
+        "ADC1 trigger route");
+
+  // ADC: 都由事件触发, 各自订阅一个通道, 只有 ADC1 的 DMA 完成结束一帧
+  for (uint32_t i = 0; i < INTERLEAVE_ADC_COUNT; i++) {
+    CHECK(gSimAdc[i].event_triggered, "ADC%u not event triggered", i);
+    CHECK(!gSimAdc[i].fifo, "ADC%u FIFO enabled", i);
+    CHECK(gSimAdc[i].dma_trigger == DL_ADC12_DMA_MEM0_RESULT_LOADED,
+          "ADC%u DMA trigger 0x%x", i, gSimAdc[i].dma_trigger);
+  }
+  CHECK(gSimAdc[0].subscriber == ADC0_TRIGGER_CHANNEL, "ADC0 subscriber %u",
+        gSimAdc[0].subscriber);
+  CHECK(gSimAdc[1].subscriber == ADC1_TRIGGER_CHANNEL, "ADC1 subscriber %u",
+        gSimAdc[1].subscriber);
+  CHECK(!(gSimAdc[0].interrupts & DL_ADC12_INTERRUPT_DMA_DONE),
+        "ADC0 DMA done interrupt enabled");
+  CHECK(gSimAdc[1].interrupts & DL_ADC12_INTERRUPT_DMA_DONE,
+        "ADC1 DMA done interrupt disabled");
+
+  // DMA: 两路半字搬运, 目的地址步进 2 点, 分别从第 0、1 点开始
+  const uint32_t channels[INTERLEAVE_ADC_COUNT] = {DMA_CH0_CHAN_ID,
+                                                   DMA_CH2_CHAN_ID};
+  for (uint32_t i = 0; i < INTERLEAVE_ADC_COUNT; i++) {
+    const SimDmaChannel *ch = &gSimDma[channels[i]];
+    CHECK(ch->enabled, "DMA channel %u disabled", channels[i]);
+    CHECK(ch->config.trigger ==
+              (i == 0 ? DMA_ADC0_EVT_GEN_BD_TRIG : DMA_ADC1_EVT_GEN_BD_TRIG),
+          "DMA channel %u trigger %u", channels[i], ch->config.trigger);
+    CHECK(ch->src == DL_ADC12_getMemResultAddress(&gSimAdcRegs[i],
+                                                  DL_ADC12_MEM_IDX_0),
+          "DMA channel %u source 0x%x", channels[i], ch->src);
+    CHECK(ch->dest == (uint32_t)(uintptr_t)&gADCRealSamples[i],
+          "DMA channel %u destination", channels[i]);
+    CHECK(ch->config.srcWidth == DL_DMA_WIDTH_HALF_WORD &&
+              ch->config.destWidth == DL_DMA_WIDTH_HALF_WORD,
+          "DMA channel %u width", channels[i]);
+    CHECK(ch->config.destIncrement == DL_DMA_ADDR_STRIDE_2,
+          "DMA channel %u destination increment %u", channels[i],
+          ch->config.destIncrement);
+    CHECK(ch->size == per_adc, "DMA channel %u size %u", channels[i],
+          ch->size);
+  }
+}
+
+// 采集缓冲区的第 i 点应为第 i 次转换 (两路交替) 的结果
+static void check_sample_order(bool is_signed, const Tone *tone) {
+  CHECK(gSimTraceLength == SAMPLE_SIZE + ADC_DISCARD_SAMPLES,
+        "%u conversions per frame", gSimTraceLength);
+  const double interval = gSimTrace[1].t - gSimTrace[0].t;
+  uint32_t misplaced = 0;
+  for (uint32_t i = 0; i < gSimTraceLength; i++) {
+    CHECK(gSimTrace[i].adc == (i & 1), "conversion %u from ADC%u", i,
+          gSimTrace[i].adc);
+    if (i > 0) {
+      CHECK(fabs(gSimTrace[i].t - gSimTrace[i - 1].t - interval) <
+                interval * 1e-9,
+            "conversion %u not half an ADC interval after the previous one", i);
+    }
+    double expected =
+        mismatched_signal(gSimTrace[i].adc, 0, gSimTrace[i].t, (void *)tone);
+    if (fabs(sample_code(gADCRealSamples[i], is_signed) - round(expected)) >
+        0.5) {
+      misplaced++;
+    }
+  }
+  CHECK(misplaced == 0, "%u samples not at their conversion's position",
+        misplaced);
+}
+
+// 频点 k 相对基波的幅度 (dBc)
+static double spur_dbc(const double *x, uint32_t k) {
+  double re, im, f_re, f_im;
+  reference_dft_bin(x, NULL, SAMPLE_SIZE, k, &re, &im);
+  reference_dft_bin(x, NULL, SAMPLE_SIZE, TONE_BIN, &f_re, &f_im);
+  return 10 * log10((re * re + im * im) / (f_re * f_re + f_im * f_im));
+}
+
+static void frame_codes(bool is_signed, double *x) {
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    x[i] = sample_code(VALID_ADC_DATA[i], is_signed) - ADC_MIDPOINT;
+  }
+}
+
+static void run(bool is_signed) {
+  const char *format = is_signed ? "signed" : "unsigned";
+  gAcquisitionConfig.data_format =
+      is_signed ? ADC_DATA_FORMAT_SIGNED_Q15 : ADC_DATA_FORMAT_UNSIGNED;
+  apply_sampling_clock();
+  check_configuration();
+
+  // 基波频率按当前采样率取整周期
+  Tone tone = {get_sample_rate_hz() * TONE_BIN / SAMPLE_SIZE};
+  sampling_start();
+  const bool captured =
+      sim_capture_frame(mismatched_signal, &tone,
+                        2 * (SAMPLE_SIZE + ADC_DISCARD_SAMPLES));
+  sampling_stop();
+  CHECK(captured, "%s: frame not captured", format);
+  CHECK(gSimAdc[1].pending == DL_ADC12_IIDX_DMA_DONE,
+        "%s: ADC1 DMA done not pending", format);
+  check_sample_order(is_signed, &tone);
+
+  static double before[SAMPLE_SIZE], after[SAMPLE_SIZE];
+  frame_codes(is_signed, before);
+  request_interleave_calibration();
+  sampling_normalize_frame(VALID_ADC_DATA);
+  frame_codes(is_signed, after);
+
+  InterleaveCalibration cal;
+  CHECK(get_interleave_calibration(&cal), "%s: not calibrated", format);
+  const double gain = (double)cal.gain_q14 / INTERLEAVE_GAIN_ONE;
+  const double offset_codes = (double)cal.offset_q15 / PRE_FFT_SCALE;
+  printf("%s: gain %.5f (ideal %.5f), offset %.2f codes (ideal %.2f)\n",
+         format, gain, 1 / ADC1_GAIN, offset_codes, -ADC1_OFFSET / ADC1_GAIN);
+  CHECK(fabs(gain * ADC1_GAIN - 1) < 1e-3, "%s: gain %.5f", format, gain);
+  CHECK(fabs(offset_codes + ADC1_OFFSET / ADC1_GAIN) < 0.5,
+        "%s: offset %.2f codes", format, offset_codes);
+
+  // 偶数点 (ADC0) 不变; 失配表现为 fs/2 - f 处的镜像和 fs/2 处的偏置杂散
+  uint32_t even_changed = 0;
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i += 2) {
+    even_changed += before[i] != after[i];
+  }
+  CHECK(even_changed == 0, "%s: %u ADC0 samples changed", format,
+        even_changed);
+  const uint32_t image = SAMPLE_SIZE / 2 - TONE_BIN;
+  const double image_before = spur_dbc(before, image);
+  const double image_after = spur_dbc(after, image);
+  const double offset_before = spur_dbc(before, SAMPLE_SIZE / 2);
+  const double offset_after = spur_dbc(after, SAMPLE_SIZE / 2);
+  printf("%s: image %.1f -> %.1f dBc, fs/2 %.1f -> %.1f dBc\n", format,
+         image_before, image_after, offset_before, offset_after);
+  CHECK(image_after < MAX_SPUR_DBC, "%s: image %.1f dBc", format, image_after);
+  CHECK(offset_after < MAX_SPUR_DBC, "%s: fs/2 spur %.1f dBc", format,
+        offset_after);
+}
+
+int main(void) {
+  test_reset_peripherals();
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+  gAcquisitionConfig.interleaved = true;
+
+  run(false);
+  run(true);
+  return test_finish("test_interleave");
+}
@@ -0,0 +1,172 @@
+// 噪声底估计的测试: (1) select_magnitude 与排序后取第 rank 个的结果比较,
+// 覆盖瑞利噪声加少数大峰值、跨 30 个二进制数量级的幅度、大量为 0 的频点
+// 与全部相等几种幅度谱, 误差不超过所在档宽度的一半;
+// (2) 已知噪声的一帧 (高斯白噪声加基波与一个已知电平的二次谐波) 经
+// analyze_harmonics 逐个裕量 (命令 0x30) 分析, 二次谐波恰好不再检出时的
+// 裕量给出噪声底的估计值, 与按噪声方差算出的单个频点噪声有效值比较
+#include "analysis.h"
+#include "consts.h"
+#include "support.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BINS (SAMPLE_SIZE / 2)
+// 已知噪声的帧: 基波与二次谐波为整周期 (汉宁窗下只占主瓣), 噪声为高斯分布
+#define TONE_CYCLES 37
+#define TONE_AMPLITUDE 1000.0
+// 噪声标准差 (码值) 随点数增大: 单个频点的噪声有效值与 sqrt(N) 成反比,
+// Q15 路径须保持在 FFT 输出最低位的数倍以上, 否则测到的是 FFT 的舍入噪声
+#define NOISE_SIGMA (3.0 * SAMPLE_SIZE / 1024)
+// 二次谐波峰值高出单个频点噪声有效值的 dB 数 (取半 dB, 避开整数裕量的边界)
+#define H2_OVER_FLOOR_DB 30.5
+// 噪声底估计允许的误差 (dB): 25% 分位数在数百个频点上的统计起伏约 0.5dB,
+// 加上裕量只能按整数 dB 设置
+#define MAX_FLOOR_ERR_DB 1.5
+
+static q31_t spectrum[BINS];
+static q31_t sorted[BINS];
+static uint16_t frame[SAMPLE_SIZE];
+
+static int compare_q31(const void *a, const void *b) {
+  const q31_t x = *(const q31_t *)a, y = *(const q31_t *)b;
+  return (x > y) - (x < y);
+}
+
+// 均值 0、方差 1 的高斯分布 (Box-Muller)
+static double gaussian(void) {
+  const double u = (test_random() + 1.0) / 2.0;
+  const double v = (test_random() + 1.0) / 2.0;
+  return sqrt(-2.0 * log(u + 1e-300)) * cos(2 * M_PI * v);
+}
+
+typedef enum {
+  SPECTRUM_RAYLEIGH,
+  SPECTRUM_WIDE,
+  SPECTRUM_SPARSE,
+  SPECTRUM_FLAT,
+  SPECTRUM_COUNT,
+} SpectrumKind;
+
+static const char *const SPECTRUM_NAMES[SPECTRUM_COUNT] = {
+    "rayleigh", "wide", "sparse", "flat"};
+
+static void make_spectrum(SpectrumKind kind, double scale) {
+  for (uint32_t k = 0; k < BINS; k++) {
+    double v;
+    switch (kind) {
+    case SPECTRUM_RAYLEIGH:
+      // 瑞利分布的噪声, 每 50 个频点一个大峰值 (基波、谐波)
+      v = scale * hypot(gaussian(), gaussian());
+      if (k % 50 == 7) {
+        v = scale * 1e4;
+      }
+      break;
+    case SPECTRUM_WIDE:
+      // 对数均匀分布于 [1, 2^30]
+      v = pow(2.0, 30.0 * (test_random() + 1.0) / 2.0);
+      break;
+    case SPECTRUM_SPARSE:
+      // 约 60% 为 0, 其余为小幅度
+      v = test_random() < 0.2 ? 0 : scale * (test_random() + 1.0);
+      break;
+    default:
+      v = scale;
+      break;
+    }
+    spectrum[k] = v < INT32_MAX ? (q31_t)v : INT32_MAX;
+  }
+}
+
+// 与排序结果比较若干个 rank
+static void check_selection(SpectrumKind kind, double scale) {
+  make_spectrum(kind, scale);
+  const uint32_t begin = 3, end = BINS - 1;
+  const uint32_t count = end - begin + 1;
+  memcpy(sorted, &spectrum[begin], count * sizeof(q31_t));
+  qsort(sorted, count, sizeof(q31_t), compare_q31);
+
+  static q31_t before[BINS];
+  memcpy(before, spectrum, sizeof(spectrum));
+  const uint32_t ranks[] = {0, count / 4, count / 2, count - 1};
+  for (uint32_t r = 0; r < sizeof(ranks) / sizeof(ranks[0]); r++) {
+    const q31_t expected = sorted[ranks[r]];
+    const q31_t got = select_magnitude(spectrum, begin, end, ranks[r]);
+    const double tolerance =
+        floor(expected / pow(2.0, NOISE_FLOOR_SUB_BITS + 1));
+    CHECK(fabs((double)got - expected) <= tolerance,
+          "%s scale %g rank %u: %d, sorted %d (tolerance %.0f)",
+          SPECTRUM_NAMES[kind], scale, ranks[r], got, expected, tolerance);
+  }
+  CHECK(memcmp(before, spectrum, sizeof(spectrum)) == 0,
+        "%s: spectrum modified by selection", SPECTRUM_NAMES[kind]);
+}
+
+// 已知噪声的一帧: 二次谐波峰值比单个频点噪声有效值高 H2_OVER_FLOOR_DB
+static void make_frame(void) {
+  // 采样量化为整数码值, 额外的噪声方差 1/12
+  const double sigma = sqrt(NOISE_SIGMA * NOISE_SIGMA + 1.0 / 12);
+  // 汉宁窗下整周期单音的峰值频点为 A/4, 噪声频点有效值为
+  // sigma * sqrt(sum(w^2)) / N = sigma * sqrt(3 / (8N)) (同一刻度)
+  const double floor_rms = sigma * sqrt(3.0 / (8.0 * SAMPLE_SIZE));
+  const double h2 = 4 * floor_rms * pow(10, H2_OVER_FLOOR_DB / 20);
+  test_random_seed(12345);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * TONE_CYCLES * n / SAMPLE_SIZE;
+    const double v = TONE_AMPLITUDE * sin(phase) + h2 * sin(2 * phase + 0.7) +
+                     NOISE_SIGMA * gaussian();
+    frame[n] = (uint16_t)lround(ADC_MIDPOINT + v);
+  }
+}
+
+// 逐个裕量分析, 返回仍能检出二次谐波的最大裕量 (dB)
+static int max_detecting_margin(FftPrecision precision) {
+  gAnalysisProfile.fft_precision = precision;
+  int best = -1;
+  for (uint8_t margin = MIN_NOISE_MARGIN_DB; margin <= MAX_NOISE_MARGIN_DB;
+       margin++) {
+    gAnalysisProfile.noise_margin_db = margin;
+    // 大点数时 FFT 原地覆盖采集缓冲区, 每次重新写入
+    memcpy(VALID_ADC_DATA, frame, sizeof(frame));
+    const AnalysisResult result = analyze_harmonics(VALID_ADC_DATA);
+    CHECK(result.thd >= 0, "margin %u: no fundamental", margin);
+    if (result.num_harmonics > 1 &&
+        result.normalized_harmonics_amplitudes[1] != 0) {
+      best = margin;
+    }
+  }
+  return best;
+}
+
+static void check_known_noise(FftPrecision precision, const char *name) {
+  make_frame();
+  const int margin = max_detecting_margin(precision);
+  // 检出条件为 H2 峰值 >= 噪声底估计 * 10^(裕量/20)
+  const double err_db = H2_OVER_FLOOR_DB - margin - 0.5;
+  printf("%s: H2 detected up to %d dB margin, floor error %+.1f dB\n", name,
+         margin, err_db);
+  CHECK(fabs(err_db) <= MAX_FLOOR_ERR_DB,
+        "%s: noise floor off by %.1f dB (H2 detected up to %d dB)", name,
+        err_db, margin);
+}
+
+int main(void) {
+  test_reset_peripherals();
+  const double scales[] = {1, 30, 1e5};
+  for (uint32_t kind = 0; kind < SPECTRUM_COUNT; kind++) {
+    for (uint32_t s = 0; s < 3; s++) {
+      test_random_seed(kind * 3 + s + 1);
+      check_selection((SpectrumKind)kind, scales[s]);
+    }
+  }
+
+  const uint8_t saved_margin = gAnalysisProfile.noise_margin_db;
+  check_known_noise(FFT_PRECISION_Q15, "Q15");
+  if (is_fft_config_supported(gAnalysisProfile.fft_engine,
+                              FFT_PRECISION_Q31)) {
+    check_known_noise(FFT_PRECISION_Q31, "Q31");
+  }
+  gAnalysisProfile.noise_margin_db = saved_margin;
+  gAnalysisProfile.fft_precision = FFT_PRECISION_Q15;
+  return test_finish("test_noise_floor");
+}
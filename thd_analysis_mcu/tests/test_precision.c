@@ -0,0 +1,110 @@
+// Q15 与 Q31 分析精度的比较: 不同输入电平下, 以双精度 DFT 对同一帧
+// (12 位量化后) 算出的谐波比与 THD 为参考, 检查两种精度的误差.
+// Q15 使用原地基4 FFT (与器件上相同的定点实现); Q31 的 arm_rfft_q31 由
+// 双精度替身实现, 误差只来自固件自身的预处理、加窗与幅度计算
+#include "analysis.h"
+#include "consts.h"
+#include "support.h"
+#include <math.h>
+
+// 一帧内的基波周期数 (整周期, 参考值不受泄漏影响)
+#define TONE_CYCLES 37
+// 二次、三次谐波相对基波的幅度 (dBc)
+#define H2_DBC -40.0
+#define H3_DBC -50.0
+
+typedef struct {
+  double level_dbfs;    // 基波电平
+  double max_h2_err_db; // 二次谐波比的误差上限 (dB), Q15 / Q31
+  double max_thd_err;   // THD 的相对误差上限, Q15 / Q31
+} LevelCase;
+
+// 误差上限比实测值留出约 2 倍余量. 最低电平接近直流/无信号检测的门限
+// (交流有效值约 22 码值, 即 -36 dBFS).
+// Q15 的检出阈值不低于 FFT 输出一个量化步长之上 noise_margin_db (默认
+// 12dB), 约 -72 dBFS: 基波 -24 dBFS 起三次谐波 (-74 dBFS) 低于阈值被
+// 计为 0, THD 只剩二次谐波, 偏低约 5%; Q31 仍能检出
+static const struct {
+  LevelCase q15;
+  LevelCase q31;
+} CASES[] = {
+    {{-1, 0.1, 0.01}, {-1, 0.05, 0.005}},
+    {{-12, 0.1, 0.01}, {-12, 0.05, 0.005}},
+    {{-24, 0.1, 0.1}, {-24, 0.05, 0.005}},
+    {{-32, 0.2, 0.15}, {-32, 0.05, 0.005}},
+};
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+// 生成一帧并返回参考的二次谐波比与 THD
+static void make_frame(double level_dbfs, double *h2_ratio, double *thd) {
+  static double x[SAMPLE_SIZE];
+  const double amplitude = (ADC_MIDPOINT - 1) * db_to_ratio(level_dbfs);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * TONE_CYCLES * n / SAMPLE_SIZE;
+    const double v = amplitude * (sin(phase) +
+                                  db_to_ratio(H2_DBC) * sin(2 * phase + 0.3) +
+                                  db_to_ratio(H3_DBC) * sin(3 * phase + 1.1));
+    const uint16_t code = (uint16_t)lround(ADC_MIDPOINT + v);
+    VALID_ADC_DATA[n] = code;
+    x[n] = code;
+  }
+  double re, im;
+  reference_dft_bin(x, NULL, SAMPLE_SIZE, TONE_CYCLES, &re, &im);
+  const double fundamental = hypot(re, im);
+  double harmonics_sq = 0;
+  for (uint32_t h = 2; h * TONE_CYCLES < SAMPLE_SIZE / 2; h++) {
+    reference_dft_bin(x, NULL, SAMPLE_SIZE, h * TONE_CYCLES, &re, &im);
+    const double ratio = hypot(re, im) / fundamental;
+    if (h == 2) {
+      *h2_ratio = ratio;
+    }
+    harmonics_sq += ratio * ratio;
+  }
+  *thd = sqrt(harmonics_sq);
+}
+
+static void run(FftPrecision precision, const LevelCase *c) {
+  const char *name = precision == FFT_PRECISION_Q31 ? "Q31" : "Q15";
+  double ref_h2 = 0, ref_thd = 0;
+  make_frame(c->level_dbfs, &ref_h2, &ref_thd);
+  gAnalysisProfile.fft_precision = precision;
+  const AnalysisResult result = analyze_harmonics(VALID_ADC_DATA);
+
+  CHECK(result.thd >= 0, "%s %.0f dBFS: thd error code %d", name,
+        c->level_dbfs, (int)result.thd);
+  CHECK(result.harmonic_indices[0] == TONE_CYCLES,
+        "%s %.0f dBFS: fundamental at bin %u", name, c->level_dbfs,
+        result.harmonic_indices[0]);
+  const double h2 =
+      (double)result.normalized_harmonics_amplitudes[1] / RATIO_SCALE;
+  const double thd = (double)result.thd / RATIO_SCALE;
+  const double h2_err_db = fabs(20 * log10(h2 / ref_h2));
+  const double thd_err = fabs(thd / ref_thd - 1);
+  printf("%s %6.0f dBFS: H2 %.5f%% (ref %.5f%%, %.3f dB), THD %.5f%% "
+         "(ref %.5f%%, %.2f%%)\n",
+         name, c->level_dbfs, 100 * h2, 100 * ref_h2, h2_err_db, 100 * thd,
+         100 * ref_thd, 100 * thd_err);
+  CHECK(h2_err_db <= c->max_h2_err_db, "%s %.0f dBFS: H2 off by %.3f dB", name,
+        c->level_dbfs, h2_err_db);
+  CHECK(thd_err <= c->max_thd_err, "%s %.0f dBFS: THD off by %.2f%%", name,
+        c->level_dbfs, 100 * thd_err);
+}
+
+int main(void) {
+  gAnalysisProfile.fft_engine = FFT_ENGINE_RADIX4;
+  gAnalysisProfile.average_frames = 1;
+  gAnalysisProfile.window = WINDOW_RECTANGULAR;
+  const bool q31_supported =
+      is_fft_config_supported(FFT_ENGINE_CMSIS, FFT_PRECISION_Q31);
+  for (uint32_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    run(FFT_PRECISION_Q15, &CASES[i].q15);
+    if (q31_supported) {
+      run(FFT_PRECISION_Q31, &CASES[i].q31);
+    }
+  }
+  if (!q31_supported) {
+    printf("Q31 not supported at SAMPLE_SIZE %u\n", SAMPLE_SIZE);
+  }
+  return test_finish("test_precision");
+}
@@ -0,0 +1,102 @@
+// 阶次跟踪重采样的测试: 一帧内周期数不是整数的信号 (基波加二次、三次
+// 谐波, THD 已知), 分别在关闭阶次跟踪 (矩形窗、汉宁窗) 和开启阶次跟踪
+// 时分析, 检查重采样后 THD 的误差及基波位于整周期数 M = floor(P) 处,
+// 并且误差明显小于不重采样时两种窗函数中较好的一种
+#include "analysis.h"
+#include "consts.h"
+#include "support.h"
+#include <math.h>
+
+// 二次、三次谐波相对基波的幅度 (dBc), 满量程时高于 Q15 的谐波检出阈值
+#define H2_DBC -26.0
+#define H3_DBC -34.0
+// 开启阶次跟踪后分析的帧数: 第一帧没有基波估计, 按设置的窗函数分析
+#define TRACKING_FRAMES 3
+
+typedef struct {
+  double periods;     // 一帧内的基波周期数 P
+  double max_thd_err; // 重采样后 THD 的相对误差上限
+} ResampleCase;
+
+// 误差上限比实测值留出约 2 倍余量. 三次插值在高频有衰减 (三次谐波
+// 约在 0.1~0.16 fs), THD 略偏低
+static const ResampleCase CASES[] = {
+    {37.4, 0.005},
+    {52.75, 0.005},
+};
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+static double true_thd(void) {
+  return hypot(db_to_ratio(H2_DBC), db_to_ratio(H3_DBC));
+}
+
+static void make_frame(double periods) {
+  const double amplitude = (ADC_MIDPOINT - 1) * db_to_ratio(-1);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * periods * n / SAMPLE_SIZE;
+    const double v = amplitude * (sin(phase) +
+                                  db_to_ratio(H2_DBC) * sin(2 * phase + 0.3) +
+                                  db_to_ratio(H3_DBC) * sin(3 * phase + 1.1));
+    VALID_ADC_DATA[n] = (uint16_t)lround(ADC_MIDPOINT + v);
+  }
+}
+
+// 分析 frames 帧 (同一信号), 返回最后一帧 THD 的相对误差.
+// 大点数时 FFT 在采集缓冲区上原地进行, 每帧重新生成采样
+static double analyze(double periods, uint32_t frames,
+                      AnalysisResult *result) {
+  for (uint32_t i = 0; i < frames; i++) {
+    make_frame(periods);
+    *result = analyze_harmonics(VALID_ADC_DATA);
+  }
+  return fabs((double)result->thd / RATIO_SCALE / true_thd() - 1);
+}
+
+// 分析一帧无信号的采样, 固件据此清除上一用例的基波估计
+static void forget_fundamental(void) {
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    VALID_ADC_DATA[n] = ADC_MIDPOINT;
+  }
+  analyze_harmonics(VALID_ADC_DATA);
+}
+
+static void run(const ResampleCase *c) {
+  AnalysisResult result;
+
+  forget_fundamental();
+  gAnalysisProfile.order_tracking = false;
+  gAnalysisProfile.window = WINDOW_RECTANGULAR;
+  const double rect_err = analyze(c->periods, 1, &result);
+  gAnalysisProfile.window = WINDOW_HANN;
+  const double hann_err = analyze(c->periods, 1, &result);
+
+  gAnalysisProfile.order_tracking = true;
+  const double tracked_err = analyze(c->periods, TRACKING_FRAMES, &result);
+  const uint32_t expected_bin = (uint32_t)c->periods;
+
+  printf("P %.2f: THD error rectangular %.2f%%, hann %.2f%%, "
+         "order tracking %.2f%% (fundamental bin %u)\n",
+         c->periods, 100 * rect_err, 100 * hann_err, 100 * tracked_err,
+         result.harmonic_indices[0]);
+  CHECK(result.thd >= 0, "P %.2f: thd error code %d", c->periods,
+        (int)result.thd);
+  CHECK(result.harmonic_indices[0] == expected_bin,
+        "P %.2f: fundamental at bin %u, expected %u", c->periods,
+        result.harmonic_indices[0], expected_bin);
+  CHECK(tracked_err <= c->max_thd_err, "P %.2f: THD off by %.2f%%",
+        c->periods, 100 * tracked_err);
+  CHECK(tracked_err * 4 < fmin(rect_err, hann_err),
+        "P %.2f: resampling does not beat windowing (%.2f%%)", c->periods,
+        100 * tracked_err);
+}
+
+int main(void) {
+  gAnalysisProfile.fft_engine = FFT_ENGINE_RADIX4;
+  gAnalysisProfile.fft_precision = FFT_PRECISION_Q15;
+  gAnalysisProfile.average_frames = 1;
+  for (uint32_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    run(&CASES[i]);
+  }
+  return test_finish("test_resample");
+}
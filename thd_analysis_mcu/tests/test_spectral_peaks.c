@@ -0,0 +1,94 @@
+// analysis.c 频谱峰值表的测试: 基波与两个谐波之外放入多于
+// SPECTRAL_PEAK_MAX 个已知频率与电平的间谐波 (其中一个紧邻二次谐波),
+// 检查峰值表按幅度从大到小列出最强的 SPECTRAL_PEAK_MAX 个间谐波,
+// 不含基波与谐波, 插值后的频率与相对基波的电平与生成时一致;
+// 只有基波时峰值表为空
+#include "analysis.h"
+#include "consts.h"
+#include "custom_init.h"
+#include "sampling.h"
+#include "support.h"
+#include <math.h>
+
+// 基波在第 37 个频点, 二次、三次谐波 -50/-60 dBc
+#define TONE_CYCLES 37.0
+#define TONE_DBFS -1.0
+#define H2_DBC -50.0
+#define H3_DBC -60.0
+// 间谐波落在频点之间四分之一处; 报告的电平取峰值频点的幅度,
+// 汉宁窗在此处的扇贝损失约 0.35 dB. 电平再低时 Q15 FFT 的舍入占主导,
+// 测的就不是峰值表了
+#define INTERHARMONICS 10
+#define INTERHARMONIC_FRACTION 0.25
+#define FIRST_DBC -30.0
+#define STEP_DB 2.0
+// 误差上限比实测值 (各点数下最差 0.009 频点, 0.44 dB) 留出余量
+#define MAX_FREQ_ERR_BINS 0.02
+#define MAX_LEVEL_ERR_DB 0.6
+
+// 间谐波所在的频点 (整数部分), 第二个紧邻二次谐波 (74) 的主瓣
+static const uint32_t interharmonic_bins[INTERHARMONICS] = {
+    52, 77, 90, 130, 160, 200, 240, 270, 310, 350};
+
+static uint16_t frame[SAMPLE_SIZE];
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+static double interharmonic_dbc(uint32_t i) { return FIRST_DBC - STEP_DB * i; }
+
+static void make_frame(bool with_interharmonics) {
+  const double amplitude = (ADC_MIDPOINT - 1) * db_to_ratio(TONE_DBFS);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * TONE_CYCLES * n / SAMPLE_SIZE;
+    double v = sin(phase) + db_to_ratio(H2_DBC) * sin(2 * phase + 0.3) +
+               db_to_ratio(H3_DBC) * sin(3 * phase + 1.1);
+    for (uint32_t i = 0; with_interharmonics && i < INTERHARMONICS; i++) {
+      const double cycles = interharmonic_bins[i] + INTERHARMONIC_FRACTION;
+      v += db_to_ratio(interharmonic_dbc(i)) *
+           sin(2 * M_PI * cycles * n / SAMPLE_SIZE + 0.7 * i);
+    }
+    frame[n] = (uint16_t)lround(ADC_MIDPOINT + amplitude * v);
+  }
+}
+
+int main(void) {
+  test_reset_peripherals();
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  const double bin_hz = get_sample_rate_hz() / SAMPLE_SIZE;
+
+  make_frame(false);
+  const AnalysisResult clean = analyze_harmonics(frame);
+  CHECK(clean.spectral_peaks.count == 0, "%u peaks without interharmonics",
+        clean.spectral_peaks.count);
+
+  make_frame(true);
+  const AnalysisResult result = analyze_harmonics(frame);
+  const SpectralPeakList *list = &result.spectral_peaks;
+  CHECK(list->count == SPECTRAL_PEAK_MAX, "%u peaks, expected %u",
+        list->count, SPECTRAL_PEAK_MAX);
+  double worst_freq = 0, worst_level = 0;
+  for (uint32_t i = 0; i < list->count && i < INTERHARMONICS; i++) {
+    // 电平各差 STEP_DB, 第 i 强的峰值即第 i 个间谐波
+    const SpectralPeak *peak = &list->peaks[i];
+    const double cycles = interharmonic_bins[i] + INTERHARMONIC_FRACTION;
+    const double freq_err = fabs(peak->freq_mhz / 1000.0 / bin_hz - cycles);
+    const double level_err = fabs(peak->level / 100.0 - interharmonic_dbc(i));
+    worst_freq = freq_err > worst_freq ? freq_err : worst_freq;
+    worst_level = level_err > worst_level ? level_err : worst_level;
+    CHECK(peak->index == interharmonic_bins[i],
+          "peak %u at bin %u, expected %u", i, peak->index,
+          interharmonic_bins[i]);
+    CHECK(freq_err <= MAX_FREQ_ERR_BINS, "peak %u off by %.3f bins", i,
+          freq_err);
+    CHECK(level_err <= MAX_LEVEL_ERR_DB, "peak %u: %.2f dBc, expected %.1f", i,
+          peak->level / 100.0, interharmonic_dbc(i));
+    CHECK(i == 0 || peak->level <= list->peaks[i - 1].level,
+          "peak %u louder than peak %u", i, i - 1);
+  }
+  printf("%u peaks, worst frequency error %.4f bins, level error %.3f dB\n",
+         list->count, worst_freq, worst_level);
+  // 谐波仍按谐波报告, 不受紧邻的间谐波影响
+  CHECK(result.harmonic_indices[1] == 2 * (uint32_t)TONE_CYCLES,
+        "H2 at bin %u", result.harmonic_indices[1]);
+  return test_finish("test_spectral_peaks");
+}
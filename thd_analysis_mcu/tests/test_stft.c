@@ -0,0 +1,283 @@
+// stft.c 短时频谱流的测试: 模拟的 ADC 与 DMA 循环写入环形缓冲区, 测试按
+// 主循环每 POLL_STEP 次转换轮询一次 stft_poll. 信号为幅度按行衰减的
+// 单音加二、三次谐波, 检查 (1) 每行各频点的幅度与双精度参考 (同一段采样
+// 加周期汉宁窗的 DFT) 相差不超过一档, 行的起点按跳步前进; (2) 基波位置与
+// THD 与生成时一致; (3) 行号、采样率与行数; (4) 满量程以下各电平的单音
+// 编码为 255 + 2 * dBFS; (5) 无信号或噪声时不报基波; (6) 轮询晚于环形
+// 缓冲区一圈时跳到最新的一行, 行号跳过的数目计入丢行
+#include "consts.h"
+#include "custom_init.h"
+#include "sampling.h"
+#include "sim_peripherals.h"
+#include "stft.h"
+#include "support.h"
+#include <math.h>
+#include <stdlib.h>
+
+// 模拟主循环一次轮询之间 ADC 转换的点数, 小于跳步
+#define POLL_STEP 16
+#define TEST_HOP 64
+#define TEST_ROWS 12
+// 基波在第 10.3 个频点, 二、三次谐波 -20/-30 dBc (THD 10.49%),
+// 幅度每个跳步衰减 2 dB: 行的起点错一个跳步时各频点差 4 档
+#define TONE_BIN 10.3
+#define TONE_DBFS -1.0
+#define H2_DBC -20.0
+#define H3_DBC -30.0
+#define DECAY_DB_PER_HOP 2.0
+#define EXPECTED_THD 1049
+// 只比较参考幅度不低于 -60dBFS 的频点, 更低处是 12 位量化与 Q15 FFT 的噪声
+#define MIN_COMPARED_LEVEL 135
+// 误差上限比实测值 (各行最差 0.61 档, 其中 0.5 档为取整; 0.001 频点;
+// THD 差 0.04%) 留出余量
+#define MAX_LEVEL_ERR 1.0
+#define MAX_FUNDAMENTAL_ERR_BINS 0.01
+#define MAX_THD_ERR 10
+
+typedef enum {
+  INPUT_TONE,   // 衰减的单音加谐波
+  INPUT_ONBIN,  // 第 16 个频点上恒定幅度的单音
+  INPUT_SILENT, // 中点
+  INPUT_NOISE,  // 均匀随机噪声
+} InputKind;
+
+typedef struct {
+  InputKind kind;
+  double dbfs;    // INPUT_ONBIN 的电平
+  uint32_t calls; // 已转换的点数
+} TestInput;
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+// 第 n 次转换的码值
+static uint16_t input_code(const TestInput *in, uint32_t n) {
+  double v = 0;
+  switch (in->kind) {
+  case INPUT_TONE: {
+    const double phase = 2 * M_PI * TONE_BIN * n / STFT_FFT_LEN;
+    const double envelope =
+        db_to_ratio(TONE_DBFS - DECAY_DB_PER_HOP * n / TEST_HOP);
+    v = envelope * (sin(phase) + db_to_ratio(H2_DBC) * sin(2 * phase + 0.4) +
+                    db_to_ratio(H3_DBC) * sin(3 * phase + 1.3));
+    break;
+  }
+  case INPUT_ONBIN:
+    v = db_to_ratio(in->dbfs) * sin(2 * M_PI * 16.0 * n / STFT_FFT_LEN + 0.2);
+    break;
+  case INPUT_SILENT:
+    break;
+  case INPUT_NOISE:
+    v = 0.1 * test_random();
+    break;
+  }
+  return (uint16_t)lround(ADC_MIDPOINT + (ADC_MIDPOINT - 1) * v);
+}
+
+static double test_input(uint32_t adc, uint32_t input_chan, double t,
+                         void *ctx) {
+  (void)adc;
+  (void)input_chan;
+  (void)t;
+  TestInput *in = ctx;
+  return input_code(in, in->calls++);
+}
+
+static void configure(uint16_t rows) {
+  test_reset_peripherals();
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+  gAcquisitionConfig.stft_hop = TEST_HOP;
+  gAcquisitionConfig.stft_rows = rows;
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+  apply_sampling_clock();
+}
+
+/**
+ * @brief 按主循环采集: DMA 完成中断随时处理, 每 POLL_STEP 次转换轮询一次,
+ * 直到输出完设定的行数
+ * @param first_poll 第一次轮询前转换的点数, 大于环形缓冲区时造成丢行
+ * @return 得到的行数
+ */
+static uint32_t capture(TestInput *in, uint32_t first_poll, StftRow *rows,
+                        uint32_t max_rows) {
+  in->calls = 0;
+  sampling_start();
+  uint32_t count = 0;
+  uint32_t next_poll = first_poll;
+  while (stft_running() && count < max_rows &&
+         in->calls < 4 * DECIMATION_RING_SAMPLES * TEST_ROWS) {
+    if (sim_capture_frame(test_input, in, next_poll - in->calls)) {
+      DL_ADC12_clearInterruptStatus(ADC0, DL_ADC12_INTERRUPT_DMA_DONE);
+      stft_on_dma_done();
+    }
+    if (in->calls < next_poll) {
+      continue;
+    }
+    next_poll = in->calls + POLL_STEP;
+    if (stft_poll(&rows[count])) {
+      count++;
+    }
+  }
+  stft_stop();
+  sampling_stop();
+  return count;
+}
+
+/**
+ * @brief 双精度参考: 从第 start 次转换起 STFT_FFT_LEN 点加周期汉宁窗,
+ * 第 k 点的幅度按行的编码 (255 为 0dBFS, 0.5dB 一档, 不取整)
+ */
+static double reference_level(const TestInput *in, uint32_t start,
+                              uint32_t k) {
+  double re = 0, im = 0;
+  for (uint32_t n = 0; n < STFT_FFT_LEN; n++) {
+    const double x =
+        ((double)input_code(in, start + n) - ADC_MIDPOINT) / ADC_MIDPOINT;
+    const double w = (1 - cos(2 * M_PI * n / STFT_FFT_LEN)) / 2;
+    const double phase = 2 * M_PI * k * n / STFT_FFT_LEN;
+    re += x * w * cos(phase);
+    im -= x * w * sin(phase);
+  }
+  // 满量程正弦在频点上的幅度为 STFT_FFT_LEN / 4
+  return 255 + 2 * 20 * log10(hypot(re, im) / (STFT_FFT_LEN / 4));
+}
+
+/**
+ * @brief 一行与参考相比最差的幅度差 (档)
+ * @param start 该行第一个采样的转换序号
+ */
+static double row_level_error(const TestInput *in, const StftRow *row,
+                              uint32_t start, uint32_t *worst_bin) {
+  double worst = 0;
+  *worst_bin = 0;
+  for (uint32_t k = 0; k < STFT_BINS; k++) {
+    const double expected = reference_level(in, start, k);
+    if (expected < MIN_COMPARED_LEVEL) {
+      continue;
+    }
+    const double err = fabs(row->levels[k] - expected);
+    if (err > worst) {
+      worst = err;
+      *worst_bin = k;
+    }
+  }
+  return worst;
+}
+
+static void check_tone_rows(void) {
+  configure(TEST_ROWS);
+  TestInput in = {.kind = INPUT_TONE};
+  StftRow rows[TEST_ROWS + 1];
+  const uint32_t count = capture(&in, POLL_STEP, rows, TEST_ROWS + 1);
+  CHECK(count == TEST_ROWS, "%u rows, expected %u", count, TEST_ROWS);
+  const uint32_t rate = (uint32_t)lround(get_sample_rate_hz());
+  double worst_level = 0, worst_freq = 0;
+  int32_t worst_thd = 0;
+  for (uint32_t r = 0; r < count; r++) {
+    const StftRow *row = &rows[r];
+    CHECK(row->seq == r, "row %u: seq %u", r, row->seq);
+    CHECK(row->sample_rate_hz == rate, "row %u: %u Hz, expected %u", r,
+          row->sample_rate_hz, rate);
+    uint32_t bin;
+    const double level_err =
+        row_level_error(&in, row, ADC_DISCARD_SAMPLES + r * TEST_HOP, &bin);
+    CHECK(level_err <= MAX_LEVEL_ERR, "row %u: bin %u off by %.2f steps", r,
+          bin, level_err);
+    const double freq_err = fabs(row->fundamental_q8 / 256.0 - TONE_BIN);
+    CHECK(freq_err <= MAX_FUNDAMENTAL_ERR_BINS,
+          "row %u: fundamental at bin %.3f, expected %.1f", r,
+          row->fundamental_q8 / 256.0, TONE_BIN);
+    const int32_t thd_err = abs((int32_t)row->thd - EXPECTED_THD);
+    CHECK(thd_err <= MAX_THD_ERR, "row %u: THD %.2f%%, expected %.2f%%", r,
+          row->thd / 100.0, EXPECTED_THD / 100.0);
+    worst_level = level_err > worst_level ? level_err : worst_level;
+    worst_freq = freq_err > worst_freq ? freq_err : worst_freq;
+    worst_thd = thd_err > worst_thd ? thd_err : worst_thd;
+  }
+  printf("%u rows: worst level error %.2f steps, fundamental %.4f bins, "
+         "THD %d (0.01%%)\n",
+         count, worst_level, worst_freq, worst_thd);
+}
+
+// 频点上的单音: 第 16 点编码为 255 + 2 * dBFS (四舍五入), 基波位置为 16
+static void check_encoding(double dbfs) {
+  configure(2);
+  TestInput in = {.kind = INPUT_ONBIN, .dbfs = dbfs};
+  StftRow rows[2];
+  const uint32_t count = capture(&in, POLL_STEP, rows, 2);
+  CHECK(count == 2, "%.0f dBFS: %u rows", dbfs, count);
+  for (uint32_t r = 0; r < count; r++) {
+    const int32_t expected = 255 + (int32_t)lround(2 * dbfs);
+    CHECK(abs(rows[r].levels[16] - expected) <= 1,
+          "%.0f dBFS: level %u, expected %d", dbfs, rows[r].levels[16],
+          expected);
+    CHECK(rows[r].fundamental_q8 == 16 * 256, "%.0f dBFS: fundamental %u",
+          dbfs, rows[r].fundamental_q8);
+  }
+}
+
+// 无信号 (各点功率为 0) 与噪声 (没有突出的频点): 不报基波
+static void check_no_fundamental(InputKind kind) {
+  const char *name = kind == INPUT_SILENT ? "silent" : "noise";
+  configure(TEST_ROWS);
+  TestInput in = {.kind = kind};
+  StftRow rows[TEST_ROWS];
+  const uint32_t count = capture(&in, POLL_STEP, rows, TEST_ROWS);
+  CHECK(count == TEST_ROWS, "%s: %u rows", name, count);
+  for (uint32_t r = 0; r < count; r++) {
+    CHECK(rows[r].thd == STFT_THD_NONE && rows[r].fundamental_q8 == 0,
+          "%s row %u: THD %u, fundamental %u", name, r, rows[r].thd,
+          rows[r].fundamental_q8);
+    if (kind == INPUT_SILENT) {
+      uint32_t nonzero = 0;
+      for (uint32_t k = 0; k < STFT_BINS; k++) {
+        nonzero += rows[r].levels[k] != 0;
+      }
+      CHECK(nonzero == 0, "silent row %u: %u bins above zero", r, nonzero);
+    }
+  }
+}
+
+// 第一次轮询晚于环形缓冲区写满一圈以上: 跳到最新的完整一行, 行号与
+// 丢行计数跳过相同的数目, 该行的数据仍与参考一致
+static void check_dropped(void) {
+  configure(2);
+  TestInput in = {.kind = INPUT_TONE};
+  StftRow rows[2];
+  const uint32_t before = stft_dropped_rows();
+  const uint32_t first_poll = 2 * DECIMATION_RING_SAMPLES;
+  const uint32_t count = capture(&in, first_poll, rows, 2);
+  CHECK(count == 2, "dropped: %u rows", count);
+  const uint32_t dropped = stft_dropped_rows() - before;
+  // 轮询时最新的完整一行
+  const uint32_t expected =
+      (first_poll - ADC_DISCARD_SAMPLES - STFT_FFT_LEN) / TEST_HOP;
+  printf("dropped: %u rows skipped (%u expected)\n", dropped, expected);
+  CHECK(dropped == expected, "dropped %u rows, expected %u", dropped,
+        expected);
+  for (uint32_t r = 0; r < count; r++) {
+    CHECK(rows[r].seq == expected + r, "dropped: row %u seq %u", r,
+          rows[r].seq);
+    uint32_t bin;
+    const double err = row_level_error(
+        &in, &rows[r], ADC_DISCARD_SAMPLES + rows[r].seq * TEST_HOP, &bin);
+    CHECK(err <= MAX_LEVEL_ERR, "dropped: row %u bin %u off by %.2f steps", r,
+          bin, err);
+  }
+}
+
+int main(void) {
+  if (!STFT_SUPPORTED) {
+    configure(TEST_ROWS);
+    CHECK(get_stft_hop() == 0, "STFT at SAMPLE_SIZE %u", SAMPLE_SIZE);
+    return test_finish("test_stft");
+  }
+  check_tone_rows();
+  check_encoding(0);
+  check_encoding(-6);
+  check_encoding(-20);
+  check_encoding(-40);
+  check_no_fundamental(INPUT_SILENT);
+  check_no_fundamental(INPUT_NOISE);
+  check_dropped();
+  return test_finish("test_stft");
+}
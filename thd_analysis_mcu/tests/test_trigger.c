@@ -0,0 +1,160 @@
+// trigger.c 电平触发的测试: 由模拟的 ADC (窗口比较器) 与 DMA 按固件的
+// 配置采集, 测试按主循环的中断处理调用 trigger_on_window_comp /
+// trigger_on_dma_done. 信号在环形缓冲区的指定位置越过触发电平, 检查
+// (1) 旋转后的一帧与信号逐点相同, 越过电平的采样位于第
+// trigger_pre_samples() 点, 包括预触发数据跨过缓冲区开头、触发后的传输
+// 跨过缓冲区末尾两种情形; (2) 一直不触发时按超时的圈数结束, 一帧按
+// 时间顺序排列
+#include "consts.h"
+#include "custom_init.h"
+#include "sampling.h"
+#include "sim_peripherals.h"
+#include "support.h"
+#include "trigger.h"
+#include <math.h>
+
+#define RING_SAMPLES (SAMPLE_SIZE + ADC_DISCARD_SAMPLES)
+// 正弦的周期为两圈环形缓冲区: 写满第一圈之后只越过电平一次,
+// 越过电平的位置可以放在一圈内的任意处
+#define TONE_PERIOD (2.0 * RING_SAMPLES)
+#define TONE_AMPLITUDE 1500.0
+// 超时测试的锯齿波, 始终低于触发电平
+#define SAWTOOTH_BASE 200
+#define SAWTOOTH_SPAN 1500
+#define SAWTOOTH_STEP 7
+#define TIMEOUT_LEVEL 3000
+// 每次中断之间的转换次数与一帧的中断次数上限, 防止配置错误时死循环
+#define MAX_CONVERSIONS (2 * RING_SAMPLES)
+#define MAX_INTERRUPTS 1000
+
+typedef struct {
+  bool sawtooth;
+  bool falling;
+  uint32_t crossing; // 越过电平后的第一个采样 (自启动起的转换序号)
+  uint32_t calls;    // 已转换的点数
+} TestSignal;
+
+// 第 n 次转换的码值 (整数, 模拟的 ADC 不再舍入)
+static uint16_t signal_code(const TestSignal *s, uint32_t n) {
+  if (s->sawtooth) {
+    return (uint16_t)(SAWTOOTH_BASE + n * SAWTOOTH_STEP % SAWTOOTH_SPAN);
+  }
+  // 第 crossing - 1 点在电平以下 (或以上) 约 2 个码值, 第 crossing 点越过
+  const double v = TONE_AMPLITUDE *
+                   sin(2 * M_PI * ((double)n - s->crossing + 0.5) / TONE_PERIOD);
+  return (uint16_t)lround(ADC_MIDPOINT + (s->falling ? -v : v));
+}
+
+static double test_signal(uint32_t adc, uint32_t input_chan, double t,
+                          void *ctx) {
+  (void)adc;
+  (void)input_chan;
+  (void)t;
+  TestSignal *s = ctx;
+  return signal_code(s, s->calls++);
+}
+
+static void configure(TriggerEdge edge, uint16_t level, uint8_t pre_percent) {
+  test_reset_peripherals();
+  gAcquisitionConfig.resolution = ADC_RESOLUTION_12BIT;
+  gAcquisitionConfig.trigger.edge = edge;
+  gAcquisitionConfig.trigger.level = level;
+  gAcquisitionConfig.trigger.pre_percent = pre_percent;
+  gAcquisitionConfig.trigger.timeout_ms = TRIGGER_MIN_TIMEOUT_MS;
+  CUSTOM_SYSCFG_DL_init(gADCCLKS);
+}
+
+// 按 main.c 的 ADC0 中断处理采集一帧, 采完后停止并按时间顺序排好
+static bool capture(TestSignal *s) {
+  s->calls = 0;
+  sampling_start();
+  for (uint32_t i = 0; i < MAX_INTERRUPTS; i++) {
+    if (!sim_capture_frame(test_signal, s, MAX_CONVERSIONS)) {
+      break;
+    }
+    switch (DL_ADC12_getPendingInterrupt(ADC0)) {
+    case DL_ADC12_IIDX_WINDOW_COMP_LOW:
+    case DL_ADC12_IIDX_WINDOW_COMP_HIGH:
+      trigger_on_window_comp();
+      break;
+    case DL_ADC12_IIDX_DMA_DONE:
+      DL_ADC12_clearInterruptStatus(ADC0, DL_ADC12_INTERRUPT_DMA_DONE);
+      if (trigger_on_dma_done()) {
+        sampling_stop();
+        sampling_normalize_frame(VALID_ADC_DATA);
+        return true;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  sampling_stop();
+  return false;
+}
+
+// 一帧与信号从 first 开始的采样逐点比较, 返回不同的点数
+static uint32_t frame_mismatches(const TestSignal *s, uint32_t first) {
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < SAMPLE_SIZE; i++) {
+    bad += VALID_ADC_DATA[i] != signal_code(s, first + i);
+  }
+  return bad;
+}
+
+/**
+ * @brief 信号在环形缓冲区第 offset 点越过触发电平 (写满第一圈之后)
+ */
+static void check_triggered(TriggerEdge edge, uint8_t pre_percent,
+                            uint32_t offset) {
+  const bool rising = edge == TRIGGER_EDGE_RISING;
+  configure(edge, ADC_MIDPOINT, pre_percent);
+  TestSignal s = {.falling = !rising, .crossing = RING_SAMPLES + offset};
+  const uint32_t pre = trigger_pre_samples();
+  const char *name = rising ? "rising" : "falling";
+  printf("%s, pre %u, crossing at ring offset %u\n", name, pre, offset);
+
+  CHECK(capture(&s), "%s offset %u: no frame", name, offset);
+  CHECK(trigger_last_frame_triggered(), "%s offset %u: timed out", name,
+        offset);
+  const uint32_t bad = frame_mismatches(&s, s.crossing - pre);
+  CHECK(bad == 0, "%s offset %u: %u samples differ from the signal", name,
+        offset, bad);
+  const int32_t before = VALID_ADC_DATA[pre - 1] - ADC_MIDPOINT;
+  const int32_t after = VALID_ADC_DATA[pre] - ADC_MIDPOINT;
+  CHECK(rising ? (before <= 0 && after > 0) : (before >= 0 && after < 0),
+        "%s offset %u: samples %d, %d around index %u", name, offset, before,
+        after, pre);
+}
+
+// 一直不越过电平: 写满第一圈后再等超时的圈数, 最后一圈即为一帧
+static void check_timeout(void) {
+  configure(TRIGGER_EDGE_RISING, TIMEOUT_LEVEL, 50);
+  TestSignal s = {.sawtooth = true};
+  const double wraps = ceil(TRIGGER_MIN_TIMEOUT_MS * get_sample_rate_hz() /
+                            1000.0 / RING_SAMPLES);
+  const uint32_t expected =
+      RING_SAMPLES * (1 + (wraps < 1 ? 1 : (uint32_t)wraps));
+
+  CHECK(capture(&s), "timeout: no frame");
+  printf("timeout: %u conversions (%u expected)\n", s.calls, expected);
+  CHECK(!trigger_last_frame_triggered(), "timeout: reported as triggered");
+  CHECK(s.calls == expected, "timeout after %u conversions, expected %u",
+        s.calls, expected);
+  const uint32_t bad = frame_mismatches(&s, s.calls - SAMPLE_SIZE);
+  CHECK(bad == 0, "timeout: %u samples out of order", bad);
+}
+
+int main(void) {
+  const uint32_t half = SAMPLE_SIZE / 2;
+  // 预触发数据跨过缓冲区开头
+  check_triggered(TRIGGER_EDGE_RISING, 50, half / 2);
+  // 触发后的传输跨过缓冲区末尾
+  check_triggered(TRIGGER_EDGE_RISING, 50, RING_SAMPLES - half / 2);
+  // 两者都不跨过 (丢弃区之内的余量)
+  check_triggered(TRIGGER_EDGE_RISING, 25, SAMPLE_SIZE / 4 + 16);
+  // 预触发百分比限制在 SAMPLE_SIZE - TRIGGER_SEARCH_SAMPLES, 下降沿
+  check_triggered(TRIGGER_EDGE_FALLING, 100, half + 1);
+  check_timeout();
+  return test_finish("test_trigger");
+}
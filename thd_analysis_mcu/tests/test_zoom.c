@@ -0,0 +1,91 @@
+// zoom.c 的测试: 一帧含基波与两个低电平谐波的信号, 在各细化倍数下
+// 检查基波的小数频点, 谐波相对基波的幅度比 (参考值为生成时的幅度),
+// 以及单音落在频点上与两频点正中时幅度一致 (扇贝损失已消除)
+#include "consts.h"
+#include "support.h"
+#include "zoom.h"
+#include <math.h>
+
+// 基波的周期数 (非整数) 与电平
+#define TONE_CYCLES 37.3
+#define TONE_DBFS -1.0
+// 二次、三次谐波相对基波的幅度 (dBc)
+#define H2_DBC -60.0
+#define H3_DBC -80.0
+
+// 误差上限比实测值留出约 2 倍以上余量. 谐波比的误差主要来自 256 点
+// Q15 FFT 的舍入 (细化前按抽取输出的最大值换算为 14 位, 低电平谐波只剩
+// 几位有效位)
+#define MAX_BIN_ERR 0.002
+#define MAX_H2_ERR_DB 0.5
+#define MAX_H3_ERR_DB 1.5
+#define MAX_SCALLOP_DB 0.01
+
+static uint32_t buffer[ZOOM_BUFFER_BYTES / sizeof(uint32_t)];
+static uint16_t frame[SAMPLE_SIZE];
+
+static double db_to_ratio(double db) { return pow(10, db / 20); }
+
+static void make_frame(double cycles, double h2_dbc, double h3_dbc) {
+  const double amplitude = (ADC_MIDPOINT - 1) * db_to_ratio(TONE_DBFS);
+  for (uint32_t n = 0; n < SAMPLE_SIZE; n++) {
+    const double phase = 2 * M_PI * cycles * n / SAMPLE_SIZE;
+    const double v = amplitude * (sin(phase) +
+                                  db_to_ratio(h2_dbc) * sin(2 * phase + 0.3) +
+                                  db_to_ratio(h3_dbc) * sin(3 * phase + 1.1));
+    frame[n] = (uint16_t)lround(ADC_MIDPOINT + v);
+  }
+}
+
+static bool zoom(uint8_t factor, double center, ZoomTone *tone) {
+  return zoom_tone(frame, false, 0, WINDOW_HANN, factor, center, 1, buffer,
+                   tone);
+}
+
+static void run(uint8_t factor) {
+  ZoomTone fundamental, h2, h3;
+  make_frame(TONE_CYCLES, H2_DBC, H3_DBC);
+  CHECK(zoom(factor, 37, &fundamental), "Z %u: no fundamental", factor);
+  CHECK(zoom(factor, 2 * fundamental.bins, &h2), "Z %u: no H2", factor);
+  CHECK(zoom(factor, 3 * fundamental.bins, &h3), "Z %u: no H3", factor);
+  const double bin_err = fabs(fundamental.bins - TONE_CYCLES);
+  const double h2_err =
+      fabs(20 * log10(h2.magnitude / fundamental.magnitude) - H2_DBC);
+  const double h3_err =
+      fabs(20 * log10(h3.magnitude / fundamental.magnitude) - H3_DBC);
+
+  // 落在频点上与两频点正中的单音
+  ZoomTone on_bin, mid_bin;
+  make_frame(37.0, -200, -200);
+  zoom(factor, 37, &on_bin);
+  make_frame(37.5, -200, -200);
+  zoom(factor, 37, &mid_bin);
+  const double scallop =
+      fabs(20 * log10(mid_bin.magnitude / on_bin.magnitude));
+
+  printf("Z %2u: bin error %.5f, H2 %.3f dB, H3 %.3f dB, scalloping %.4f "
+         "dB\n",
+         factor, bin_err, h2_err, h3_err, scallop);
+  CHECK(bin_err <= MAX_BIN_ERR, "Z %u: fundamental off by %.5f bins", factor,
+        bin_err);
+  CHECK(h2_err <= MAX_H2_ERR_DB, "Z %u: H2 off by %.3f dB", factor, h2_err);
+  CHECK(h3_err <= MAX_H3_ERR_DB, "Z %u: H3 off by %.3f dB", factor, h3_err);
+  CHECK(scallop <= MAX_SCALLOP_DB, "Z %u: scalloping %.4f dB", factor,
+        scallop);
+}
+
+int main(void) {
+  if (!ZOOM_SUPPORTED) {
+    CHECK(!is_zoom_factor_valid(ZOOM_MIN_FACTOR),
+          "zoom accepted at SAMPLE_SIZE %u", SAMPLE_SIZE);
+    return test_finish("test_zoom");
+  }
+  for (uint8_t factor = ZOOM_MIN_FACTOR; factor <= ZOOM_MAX_FACTOR;
+       factor *= 2) {
+    CHECK(is_zoom_factor_valid(factor), "Z %u rejected", factor);
+    run(factor);
+  }
+  CHECK(!is_zoom_factor_valid(ZOOM_MIN_FACTOR + 1), "Z %u accepted",
+        ZOOM_MIN_FACTOR + 1);
+  return test_finish("test_zoom");
+}
@@ -0,0 +1,239 @@
+#include "trigger.h"
+#include "custom_init.h"
+#include "sampling.h"
+#include "ti/driverlib/m0p/dl_core.h"
+#include "ti_msp_dl_config.h"
+#include <math.h>
+
+// 环形缓冲区为整个采集缓冲区, DMA 从 FIFO 每次搬运两点 (一个字)
+#define RING_SAMPLES (SAMPLE_SIZE + ADC_DISCARD_SAMPLES)
+#define RING_WORDS (RING_SAMPLES / 2)
+
+// 触发后多采 TRIGGER_SEARCH_SAMPLES 点 (向上取整到字), 丢弃区须容纳
+// 越过电平的采样在记录位置前后的偏差, 一帧才始终落在环形缓冲区内
+_Static_assert(ADC_DISCARD_SAMPLES >= 2 * TRIGGER_SEARCH_SAMPLES + 2,
+               "ADC_DISCARD_SAMPLES too small for trigger search window");
+_Static_assert(RING_SAMPLES % 2 == 0, "ring must hold whole DMA words");
+
+#define WINDOW_COMP_INTERRUPTS                                                 \
+  (DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH | DL_ADC12_INTERRUPT_WINDOW_COMP_LOW)
+
+typedef enum {
+  TRIGGER_PHASE_IDLE,     // 未等待触发
+  TRIGGER_PHASE_FILLING,  // 环形缓冲区尚未写满一圈, 预触发数据不完整
+  TRIGGER_PHASE_ARMING,   // 等待信号回到电平另一侧超过滞回
+  TRIGGER_PHASE_WAITING,  // 等待越过触发电平
+  TRIGGER_PHASE_POST,     // 已触发, 采集触发后的点数
+  TRIGGER_PHASE_CAPTURED  // 已触发的一帧采集完成, 等待旋转
+} TriggerPhase;
+
+static volatile TriggerPhase phase = TRIGGER_PHASE_IDLE;
+// 超时前还可等待的圈数
+static volatile uint32_t wraps_left = 0;
+// 触发后的传输跨过缓冲区末尾时, 回绕后还需写入的字数
+static volatile uint32_t post_words_left = 0;
+// 触发中断时 DMA 的写入位置 (采样点)
+static volatile uint32_t trigger_pos = 0;
+static bool last_triggered = false;
+
+static bool is_rising(void) {
+  return gAcquisitionConfig.trigger.edge == TRIGGER_EDGE_RISING;
+}
+
+// 滞回条件 (上升沿低于下阈值 / 下降沿高于上阈值) 对应的中断
+static uint32_t arm_interrupt(void) {
+  return is_rising() ? DL_ADC12_INTERRUPT_WINDOW_COMP_LOW
+                     : DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH;
+}
+
+// 越过触发电平对应的中断
+static uint32_t fire_interrupt(void) {
+  return is_rising() ? DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH
+                     : DL_ADC12_INTERRUPT_WINDOW_COMP_LOW;
+}
+
+// 只开启一个窗口比较器中断; 条件成立期间每次转换都会置位, 先清掉旧的
+static void wait_for(uint32_t interrupt) {
+  DL_ADC12_disableInterrupt(ADC12_0_INST, WINDOW_COMP_INTERRUPTS);
+  DL_ADC12_clearInterruptStatus(ADC12_0_INST, interrupt);
+  DL_ADC12_enableInterrupt(ADC12_0_INST, interrupt);
+}
+
+/**
+ * @brief 12 位码值换算成当前格式与分辨率下的 ADC 结果, 窗口比较器阈值
+ * 与缓冲区中的原始采样都是这个刻度 (硬件平均时为多出几位的无符号结果)
+ */
+static uint16_t code_to_raw(int32_t code) {
+  code = code < 0 ? 0 : (code > 4095 ? 4095 : code);
+  if (is_raw_data_signed()) {
+    return (uint16_t)(int16_t)((code - ADC_MIDPOINT) * PRE_FFT_SCALE);
+  }
+  const uint32_t extra = oversampling_extra_bits(get_oversampling_ratio());
+  return (uint16_t)(((uint32_t)code << extra) >>
+                    ADC_RESOLUTION_SHIFT(get_adc_resolution()));
+}
+
+// 原始采样按格式转成可比较大小的数值
+static int32_t raw_value(uint16_t raw) {
+  return is_raw_data_signed() ? (int32_t)(int16_t)raw : (int32_t)raw;
+}
+
+bool is_trigger_enabled(void) {
+  return gAcquisitionConfig.trigger.edge != TRIGGER_EDGE_NONE;
+}
+
+uint32_t trigger_pre_samples(void) {
+  // 触发后至少保留搜索窗口的点数, 否则搜索到的触发点可能超出环形缓冲区
+  uint32_t pre =
+      (uint32_t)SAMPLE_SIZE * gAcquisitionConfig.trigger.pre_percent / 100;
+  return pre > SAMPLE_SIZE - TRIGGER_SEARCH_SAMPLES
+             ? SAMPLE_SIZE - TRIGGER_SEARCH_SAMPLES
+             : pre;
+}
+
+bool trigger_last_frame_triggered(void) { return last_triggered; }
+
+void trigger_arm(void) {
+  const TriggerConfig *cfg = &gAcquisitionConfig.trigger;
+  const int32_t level = cfg->level;
+  // 上升沿: 低于 level - 滞回后, 高于 level 触发; 下降沿对称
+  const int32_t low = is_rising() ? level - TRIGGER_HYSTERESIS_CODES : level;
+  const int32_t high = is_rising() ? level : level + TRIGGER_HYSTERESIS_CODES;
+  DL_ADC12_configWinCompLowThld(ADC12_0_INST, code_to_raw(low));
+  DL_ADC12_configWinCompHighThld(ADC12_0_INST, code_to_raw(high));
+  DL_ADC12_disableInterrupt(ADC12_0_INST, WINDOW_COMP_INTERRUPTS);
+
+  // 超时按环形缓冲区的圈数计, 不足一圈按一圈
+  double wraps = cfg->timeout_ms * get_sample_rate_hz() / 1000.0 / RING_SAMPLES;
+  wraps_left = wraps < 1 ? 1 : (uint32_t)ceil(wraps);
+  post_words_left = 0;
+  last_triggered = false;
+  phase = TRIGGER_PHASE_FILLING;
+}
+
+void trigger_disarm(void) {
+  DL_ADC12_disableInterrupt(ADC12_0_INST, WINDOW_COMP_INTERRUPTS);
+  if (phase != TRIGGER_PHASE_CAPTURED) {
+    phase = TRIGGER_PHASE_IDLE;
+  }
+}
+
+void trigger_on_window_comp(void) {
+  DL_ADC12_clearInterruptStatus(ADC12_0_INST, WINDOW_COMP_INTERRUPTS);
+  if (phase == TRIGGER_PHASE_ARMING) {
+    phase = TRIGGER_PHASE_WAITING;
+    wait_for(fire_interrupt());
+    return;
+  }
+  DL_ADC12_disableInterrupt(ADC12_0_INST, WINDOW_COMP_INTERRUPTS);
+  if (phase != TRIGGER_PHASE_WAITING) {
+    return;
+  }
+
+  // 暂停 DMA 读出写入位置, 期间的采样暂存在 ADC FIFO 中
+  DL_DMA_disableChannel(DMA, DMA_CH0_CHAN_ID);
+  uint32_t pos_words =
+      (RING_WORDS - DL_DMA_getTransferSize(DMA, DMA_CH0_CHAN_ID)) % RING_WORDS;
+  uint32_t remaining = RING_WORDS - pos_words;
+  trigger_pos = pos_words * 2;
+
+  // 触发后还需 (一帧的剩余点数 + 搜索窗口) 个采样; 改为单次传输,
+  // 采够后 DMA 自行停止, 不会回绕覆盖触发点附近的数据
+  uint32_t words =
+      (SAMPLE_SIZE - trigger_pre_samples() + TRIGGER_SEARCH_SAMPLES + 1) / 2;
+  uint32_t first = words < remaining ? words : remaining;
+  post_words_left = words - first;
+  DL_DMA_setTransferMode(DMA, DMA_CH0_CHAN_ID, DL_DMA_SINGLE_TRANSFER_MODE);
+  DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID,
+                     (uint32_t)&gADCRealSamples[trigger_pos]);
+  DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, first);
+  // 暂停前可能恰好写满一圈, 那个完成中断不属于触发后的传输
+  DL_ADC12_clearInterruptStatus(ADC12_0_INST, DL_ADC12_INTERRUPT_DMA_DONE);
+  phase = TRIGGER_PHASE_POST;
+  DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+}
+
+bool trigger_on_dma_done(void) {
+  switch (phase) {
+  case TRIGGER_PHASE_FILLING:
+    // 写满一圈, 预触发数据已完整, 开始等待触发
+    phase = TRIGGER_PHASE_ARMING;
+    wait_for(arm_interrupt());
+    return false;
+
+  case TRIGGER_PHASE_ARMING:
+  case TRIGGER_PHASE_WAITING:
+    if (--wraps_left != 0) {
+      return false;
+    }
+    // 超时: 刚好写满一圈, 缓冲区已按时间顺序排列, 直接作为一帧
+    trigger_disarm();
+    return true;
+
+  case TRIGGER_PHASE_POST:
+    if (post_words_left != 0) {
+      // 回绕到缓冲区开头继续写入剩余的点数
+      DL_DMA_setDestAddr(DMA, DMA_CH0_CHAN_ID, (uint32_t)gADCRealSamples);
+      DL_DMA_setTransferSize(DMA, DMA_CH0_CHAN_ID, post_words_left);
+      post_words_left = 0;
+      DL_DMA_enableChannel(DMA, DMA_CH0_CHAN_ID);
+      return false;
+    }
+    phase = TRIGGER_PHASE_CAPTURED;
+    last_triggered = true;
+    return true;
+
+  default:
+    return true;
+  }
+}
+
+/**
+ * @brief 在记录的写入位置附近找到越过触发电平的采样, 取离记录位置最近的
+ * @return 越过电平后第一个采样在环形缓冲区中的位置, 找不到时为记录位置
+ */
+static uint32_t find_crossing(void) {
+  const int32_t level =
+      raw_value(code_to_raw(gAcquisitionConfig.trigger.level));
+  const bool rising = is_rising();
+  for (int32_t d = 0; d <= TRIGGER_SEARCH_SAMPLES; d++) {
+    for (int32_t sign = -1; sign <= 1; sign += 2) {
+      uint32_t j = (trigger_pos + RING_SAMPLES + sign * d) % RING_SAMPLES;
+      int32_t prev = raw_value(gADCRealSamples[(j + RING_SAMPLES - 1) %
+                                               RING_SAMPLES]);
+      int32_t cur = raw_value(gADCRealSamples[j]);
+      if (rising ? (prev <= level && cur > level)
+                 : (prev >= level && cur < level)) {
+        return j;
+      }
+    }
+  }
+  return trigger_pos;
+}
+
+static void reverse_samples(uint16_t *samples, uint32_t begin, uint32_t end) {
+  while (begin + 1 < end) {
+    uint16_t tmp = samples[begin];
+    samples[begin++] = samples[--end];
+    samples[end] = tmp;
+  }
+}
+
+void trigger_align_frame(void) {
+  if (phase != TRIGGER_PHASE_CAPTURED) {
+    return;
+  }
+  phase = TRIGGER_PHASE_IDLE;
+
+  // 一帧从触发点前 pre 点开始, 旋转到 VALID_ADC_DATA 开头;
+  // 三次反转实现原地循环左移, 不占额外 RAM
+  uint32_t start =
+      (find_crossing() + RING_SAMPLES - trigger_pre_samples()) % RING_SAMPLES;
+  uint32_t shift =
+      (start + RING_SAMPLES - ADC_DISCARD_SAMPLES) % RING_SAMPLES;
+  if (shift != 0) {
+    reverse_samples(gADCRealSamples, 0, shift);
+    reverse_samples(gADCRealSamples, shift, RING_SAMPLES);
+    reverse_samples(gADCRealSamples, 0, RING_SAMPLES);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "consts.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 触发电平的滞回 (12 位码值): 上升沿须先低于 level - 滞回才会再次触发,
+// 下降沿须先高于 level + 滞回, 避免噪声在电平附近反复触发
+#define TRIGGER_HYSTERESIS_CODES 32
+// 在触发中断记录的写入位置前后各搜索此点数, 找到真正越过电平的采样.
+// 写入位置与越过电平的时刻之间差着中断延迟和 ADC FIFO 中尚未搬运的采样
+#define TRIGGER_SEARCH_SAMPLES 16
+// 超时时间范围 (ms)
+#define TRIGGER_MIN_TIMEOUT_MS 10
+#define TRIGGER_MAX_TIMEOUT_MS 10000
+
+/**
+ * @brief 是否按电平触发采集
+ * @note 只用于 ADC0 单独采集 (与交织/双通道采集互斥, 由命令处理保证)
+ */
+bool is_trigger_enabled(void);
+
+/**
+ * @brief 开始一帧触发采集: 设置窗口比较器阈值, 清空触发状态
+ * @note 由 sampling_start 在启动转换前调用. DMA 此时循环写满整个采集缓冲区
+ * (含丢弃区), 写满一圈后预触发数据才完整, 之后才开始等待触发
+ */
+void trigger_arm(void);
+
+/**
+ * @brief 停止等待触发, 关闭窗口比较器中断
+ */
+void trigger_disarm(void);
+
+/**
+ * @brief ADC0 窗口比较器中断: 滞回条件满足后切换到等待越过电平,
+ * 越过电平时把 DMA 改为只再写入触发后所需的点数
+ */
+void trigger_on_window_comp(void);
+
+/**
+ * @brief ADC0 的 DMA 完成中断 (环形缓冲区写满一圈或触发后的传输结束)
+ * @return true 表示一帧采集完成 (已触发或超时), 可以停止转换
+ */
+bool trigger_on_dma_done(void);
+
+/**
+ * @brief 把环形缓冲区原地旋转成按时间顺序的一帧, 触发点位于
+ * VALID_ADC_DATA 的第 trigger_pre_samples() 点
+ * @note 在一帧采集完成后、任何处理之前调用; 超时的帧本来就是按顺序的,
+ * 不做处理
+ */
+void trigger_align_frame(void);
+
+// 一帧中触发点之前的采样数
+uint32_t trigger_pre_samples(void);
+
+// 最近一帧是否由触发结束 (false 表示超时或未开启触发)
+bool trigger_last_frame_triggered(void);
+
+#endif /* TRIGGER_H */
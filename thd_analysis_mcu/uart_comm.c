@@ -59,20 +59,37 @@ void UART_sendHarmonicsAnalysisResultBlocking(
     return;
   }
 
-  // 4
-  // 发送THD值
-  UART_sendDataBlocking((const uint8_t *)&result->thd, sizeof(float));
-
-  // 20
-  // 发送归一化谐波幅度数组
-  for (int i = 0; i < NUM_HARMONICS; i++) {
-    UART_sendDataBlocking((const uint8_t *)&result->normalized_harmonics_amplitudes[i],
-                          sizeof(float));
+  if (gResultFormat == RESULT_FORMAT_FIXED) {
+    // 4
+    // 发送THD值 (int32, 单位 0.001%)
+    UART_sendDataBlocking((const uint8_t *)&result->thd, sizeof(int32_t));
+
+    // 4 * num_harmonics
+    // 发送归一化谐波幅度数组 (uint32, 单位 0.001%)
+    for (int i = 0; i < result->num_harmonics; i++) {
+      UART_sendDataBlocking(
+          (const uint8_t *)&result->normalized_harmonics_amplitudes[i],
+          sizeof(uint32_t));
+    }
+  } else {
+    // 兼容格式: 只在发送时做一次定点到浮点的换算
+    // 4
+    // 发送THD值 (float, 单位 %)
+    float thd = (float)result->thd / (RATIO_SCALE / 100);
+    UART_sendDataBlocking((const uint8_t *)&thd, sizeof(float));
+
+    // 4 * num_harmonics
+    // 发送归一化谐波幅度数组 (float, Hn / H1)
+    for (int i = 0; i < result->num_harmonics; i++) {
+      float amplitude =
+          (float)result->normalized_harmonics_amplitudes[i] / RATIO_SCALE;
+      UART_sendDataBlocking((const uint8_t *)&amplitude, sizeof(float));
+    }
   }
 
-  // 20
+  // 4 * num_harmonics
   // 发送谐波索引数组
-  for (int i = 0; i < NUM_HARMONICS; i++) {
+  for (int i = 0; i < result->num_harmonics; i++) {
     UART_sendDataBlocking((const uint8_t *)&result->harmonic_indices[i],
                           sizeof(uint32_t));
   }
@@ -91,4 +108,110 @@ void UART_sendHarmonicsAnalysisResultBlocking(
 
   // UART_sendDataBlocking((uint8_t *)result, sizeof(HarmonicsAnalysisResult));
 }
+
+/**
+ * @brief 阻塞式发送双通道功率参数 (逐个字段发送)
+ * @param power 功率参数结构体指针
+ */
+void UART_sendPowerAnalysisBlocking(const PowerAnalysis *power) {
+  if (power == NULL) {
+    return;
+  }
+
+  if (gResultFormat == RESULT_FORMAT_FIXED) {
+    // 4 * 4
+    // 功率因数与位移功率因数 (int32, 单位 0.001%), 位移角 (int32, 0.01°),
+    // 时间偏移 (int32, ns)
+    UART_sendDataBlocking((const uint8_t *)&power->power_factor,
+                          sizeof(int32_t));
+    UART_sendDataBlocking((const uint8_t *)&power->displacement_power_factor,
+                          sizeof(int32_t));
+    UART_sendDataBlocking((const uint8_t *)&power->displacement_angle,
+                          sizeof(int32_t));
+    UART_sendDataBlocking((const uint8_t *)&power->phase_offset_ns,
+                          sizeof(int32_t));
+  } else {
+    // 4 * 4
+    // 兼容格式: 功率因数与位移功率因数 (float, 比值), 位移角 (float, °),
+    // 时间偏移 (float, us)
+    float values[4] = {
+        (float)power->power_factor / RATIO_SCALE,
+        (float)power->displacement_power_factor / RATIO_SCALE,
+        (float)power->displacement_angle / 100.0f,
+        (float)power->phase_offset_ns / 1000.0f,
+    };
+    UART_sendDataBlocking((const uint8_t *)values, sizeof(values));
+  }
+  // 1
+  // 发送有效标志
+  UART_sendDataBlocking((const uint8_t *)&power->valid, sizeof(bool));
+}
+/**
+ * @brief 阻塞式发送一条时域指标记录 (逐个字段发送)
+ * @param metrics 时域指标结构体指针
+ */
+void UART_sendTimeDomainMetricsBlocking(const TimeDomainMetrics *metrics) {
+  if (metrics == NULL) {
+    return;
+  }
+
+  // 扩展记录不区分结果格式, 始终为定点整数
+  // 4 * 2
+  // 均值与交流有效值 (uint32, 0.001 码值)
+  UART_sendDataBlocking((const uint8_t *)&metrics->mean, sizeof(uint32_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->ac_rms, sizeof(uint32_t));
+  // 2 * 2
+  // 最小与最大码值 (uint16)
+  UART_sendDataBlocking((const uint8_t *)&metrics->min, sizeof(uint16_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->max, sizeof(uint16_t));
+  // 4 * 2
+  // 峰值因数与占空比 (uint32, 0.001%)
+  UART_sendDataBlocking((const uint8_t *)&metrics->crest_factor,
+                        sizeof(uint32_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->duty_cycle,
+                        sizeof(uint32_t));
+  // 2 * 2
+  // 穿越次数与削顶点数 (uint16)
+  UART_sendDataBlocking((const uint8_t *)&metrics->zero_crossings,
+                        sizeof(uint16_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->clipped, sizeof(uint16_t));
+}
+
+/**
+ * @brief 阻塞式发送一条频谱指标记录 (逐个字段发送)
+ * @param metrics 频谱指标结构体指针
+ */
+void UART_sendSpectralMetricsBlocking(const SpectralMetrics *metrics) {
+  if (metrics == NULL) {
+    return;
+  }
+
+  // 4
+  // THD+N (uint32, 0.001%)
+  UART_sendDataBlocking((const uint8_t *)&metrics->thd_n, sizeof(uint32_t));
+  // 4 * 3
+  // SINAD 与 SNR (int32, 0.01dB), ENOB (int32, 0.01 位)
+  UART_sendDataBlocking((const uint8_t *)&metrics->sinad, sizeof(int32_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->snr, sizeof(int32_t));
+  UART_sendDataBlocking((const uint8_t *)&metrics->enob, sizeof(int32_t));
+}
+
+void UART_sendSpectralPeaksBlocking(const SpectralPeakList *list) {
+  if (list == NULL) {
+    return;
+  }
+
+  // 1
+  // 峰值个数
+  UART_sendDataBlocking(&list->count, 1);
+  // 8 * count
+  // 每个峰值: 频点 (uint16), 频率 (uint32, mHz), 幅度 (int16, 0.01dBc)
+  for (uint8_t i = 0; i < list->count; i++) {
+    const SpectralPeak *peak = &list->peaks[i];
+    UART_sendDataBlocking((const uint8_t *)&peak->index, sizeof(uint16_t));
+    UART_sendDataBlocking((const uint8_t *)&peak->freq_mhz, sizeof(uint32_t));
+    UART_sendDataBlocking((const uint8_t *)&peak->level, sizeof(int16_t));
+  }
+}
+
 /* 注意：阻塞式发送不需要等待函数，因为发送本身就是阻塞的 */
\ No newline at end of file
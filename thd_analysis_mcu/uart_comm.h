@@ -5,6 +5,40 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// 分析结果的发送格式
+typedef enum {
+  RESULT_FORMAT_FLOAT = 0, // 兼容格式: THD 与归一化幅度以 float 发送
+  RESULT_FORMAT_FIXED = 1  // 定点格式: THD 与归一化幅度以 0.001% 为单位的整数发送
+} ResultFormat;
+
+// 定点格式时在包头的谐波数量字节上置位此标志, 供上位机区分两种格式
+#define RESULT_FORMAT_FIXED_FLAG 0x80
+// 双通道数据包在包头的谐波数量字节上置位此标志, 包内依次为电压/电流原始采样、
+// 电压/电流分析结果和功率参数
+#define RESULT_DUAL_CHANNEL_FLAG 0x40
+// 多通道扫描的数据包在包头的采样点数高字节上置位此标志 (谐波数量字节已无空闲位,
+// SAMPLE_SIZE 不超过 4096), 包头后紧跟 1 字节 ADC0 输入通道号
+#define RESULT_SCAN_CHANNEL_FLAG 0x80
+
+// 开启扩展记录 (gResultExtensions 非 0) 时在包头的采样点数高字节上置位此标志,
+// 包尾前追加一个扩展块: [开启的部分 1B][其后长度 2B][各部分按位序排列]
+#define RESULT_EXTENDED_FLAG 0x40
+// 扩展块中的各部分 (gResultExtensions 的位)
+#define RESULT_EXT_TIME_DOMAIN 0x01 // 时域指标, 双通道时依次为电压、电流
+#define RESULT_EXT_SPECTRAL 0x02    // 频谱指标, 双通道时依次为电压、电流
+#define RESULT_EXT_PEAKS 0x04       // 非谐波峰值表, 双通道时依次为电压、电流
+#define RESULT_EXT_ALL \
+  (RESULT_EXT_TIME_DOMAIN | RESULT_EXT_SPECTRAL | RESULT_EXT_PEAKS)
+// 一条时域指标记录的字节数
+#define TIME_DOMAIN_RECORD_SIZE 24
+// 一条频谱指标记录的字节数
+#define SPECTRAL_RECORD_SIZE 16
+// 峰值表中一个峰值的字节数 (表头另有 1 字节个数)
+#define SPECTRAL_PEAK_RECORD_SIZE 8
+
+extern ResultFormat gResultFormat;
+extern uint8_t gResultExtensions;
+
 /**
  * @brief 阻塞式发送数据块
  * @param data 数据指针
@@ -25,4 +59,29 @@ void UART_sendStringBlocking(const char *str);
 void UART_sendHarmonicsAnalysisResultBlocking(
     const AnalysisResult *result);
 
+/**
+ * @brief 阻塞式发送双通道功率参数
+ * @param power 功率参数结构体指针
+ */
+void UART_sendPowerAnalysisBlocking(const PowerAnalysis *power);
+
+/**
+ * @brief 阻塞式发送一条时域指标记录 (TIME_DOMAIN_RECORD_SIZE 字节, 定点格式)
+ * @param metrics 时域指标结构体指针
+ */
+void UART_sendTimeDomainMetricsBlocking(const TimeDomainMetrics *metrics);
+
+/**
+ * @brief 阻塞式发送一条频谱指标记录 (SPECTRAL_RECORD_SIZE 字节, 定点格式)
+ * @param metrics 频谱指标结构体指针
+ */
+void UART_sendSpectralMetricsBlocking(const SpectralMetrics *metrics);
+
+/**
+ * @brief 阻塞式发送一个通道的非谐波峰值表
+ * (1 + count * SPECTRAL_PEAK_RECORD_SIZE 字节)
+ * @param list 峰值表结构体指针
+ */
+void UART_sendSpectralPeaksBlocking(const SpectralPeakList *list);
+
 #endif /* UART_COMM_H */
\ No newline at end of file
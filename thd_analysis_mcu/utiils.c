@@ -3,9 +3,11 @@
 #include "ti_msp_dl_config.h"
 #include "utils.h"
 
-// 能保持period_wanted= 5 的极限频率是 22.321kHz
+// 能保持period_wanted= 5 的极限频率: 12 位 22.321kHz, 10 位 26.042kHz,
+// 8 位 31.250kHz (采样窗口最短 1 个时钟)
 // adcclks上限未知 => 保持能保持period_wanted= 5 的极限频率下限未知
-uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted) {
+uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted,
+                           double conversion_time_ns) {
   if (signal_freq == 0) {
     signal_freq = 1;
   }
@@ -14,8 +16,8 @@ uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted) {
       (double)((uint32_t)1e9 / (uint32_t)signal_freq) / SAMPLE_SIZE *
       period_wanted;
 
-  volatile double sample_time_ns = total_time_ns > CONVERSION_TIME_NS
-                                       ? (total_time_ns - CONVERSION_TIME_NS)
+  volatile double sample_time_ns = total_time_ns > conversion_time_ns
+                                       ? (total_time_ns - conversion_time_ns)
                                        : 0;
 
   volatile uint16_t adcclks = (uint16_t)(sample_time_ns / CLK_CYCLE_NS);
@@ -27,7 +29,23 @@ uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted) {
   return adcclks;
 }
 
+double adc_conversion_time_ns(AdcResolution resolution) {
+  switch (resolution) {
+  case ADC_RESOLUTION_10BIT:
+    return CONVERSION_TIME_NS_10BIT;
+  case ADC_RESOLUTION_8BIT:
+    return CONVERSION_TIME_NS_8BIT;
+  default:
+    return CONVERSION_TIME_NS;
+  }
+}
+
 volatile unsigned int delay_times = 0;
+// SysTick 中断次数 (毫秒)
+static volatile uint32_t systick_ms = 0;
+
+// SysTick 重装周期 (syscfg 中配置为 1ms)
+#define SYSTICK_PERIOD_CYCLES (CPUCLK_FREQ / 1000)
 
 // 搭配滴答定时器实现的精确ms延时
 void delay_ms(unsigned int ms) {
@@ -36,7 +54,18 @@ void delay_ms(unsigned int ms) {
     ;
 }
 
+uint32_t get_cycle_count(void) {
+  uint32_t ms, val;
+  // 读取期间发生 SysTick 中断则重读, 保证两部分属于同一毫秒
+  do {
+    ms = systick_ms;
+    val = SysTick->VAL;
+  } while (ms != systick_ms);
+  return ms * SYSTICK_PERIOD_CYCLES + (SYSTICK_PERIOD_CYCLES - 1 - val);
+}
+
 void SysTick_Handler(void) {
+  systick_ms++;
   if (delay_times != 0) {
     delay_times--;
   }
@@ -4,8 +4,18 @@
 #include "ti/driverlib/m0p/dl_core.h"
 #include "ti_msp_dl_config.h"
 
-uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted);
+uint16_t calculate_adcclks(uint32_t signal_freq, double period_wanted,
+                           double conversion_time_ns);
+
+// 指定分辨率 (不能是 ADC_RESOLUTION_AUTO) 的转换时间
+double adc_conversion_time_ns(AdcResolution resolution);
 
 void delay_ms(unsigned int ms);
 
+/**
+ * @brief 读取自上电以来的 CPU 周期计数 (由 SysTick 毫秒计数和当前计数值拼成)
+ * @note 32 位计数约 134 秒回绕一次, 两次读数相减即可得到耗时
+ */
+uint32_t get_cycle_count(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "zoom.h"
+#include "fft.h"
+#include <math.h>
+#include <stdlib.h>
+
+// 帧尾之后补零多输出的点数: CIC 滤波器的冲激响应跨 ZOOM_CIC_ORDER 个
+// 抽取周期, 补零后帧尾的采样才完整计入
+#define FLUSH_OUTPUTS (ZOOM_CIC_ORDER - 1)
+// 抽取输出换算为 Q15 时最大值的有效位数 (细化 FFT 按块浮点缩放, 留一位余量)
+#define ZOOM_INPUT_BITS 14
+
+_Static_assert(SAMPLE_SIZE * ZOOM_MIN_FACTOR >= ZOOM_FFT_LEN,
+               "SAMPLE_SIZE too small for the zoom FFT");
+_Static_assert(2 * (ZOOM_FFT_LEN / ZOOM_MIN_FACTOR + FLUSH_OUTPUTS) <=
+                   ZOOM_FFT_LEN,
+               "decimated outputs must fit in the zoom FFT buffer");
+
+// 抽取滤波器增益的补偿系数 (增益的倒数), 按细化频谱的点 |k| 查表:
+// 搜索与找半幅点都不超出 +-ZOOM_FFT_LEN / 2. 系数只与细化倍数有关,
+// 倍数改变时重新生成, 免去逐点计算正弦与三次方.
+// 不支持细化时不会调用 zoom_tone, 只留一项
+#define DROOP_POINTS (ZOOM_RAM_BYTES / sizeof(float) + !ZOOM_SUPPORTED)
+static float droop_compensation[DROOP_POINTS];
+static uint8_t droop_factor = 0;
+
+static uint32_t log2_u32(uint32_t v) {
+  uint32_t n = 0;
+  while (v > 1) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+}
+
+bool is_zoom_factor_valid(uint8_t factor) {
+  if (factor == 0) {
+    return true;
+  }
+  return ZOOM_SUPPORTED && factor >= ZOOM_MIN_FACTOR &&
+         factor <= ZOOM_MAX_FACTOR && (factor & (factor - 1)) == 0;
+}
+
+// 与 analysis.c 的预处理同一刻度: 以中点为零、乘以 PRE_FFT_SCALE
+static inline int32_t centered_sample(uint16_t raw, bool is_signed) {
+  return is_signed ? (int32_t)(int16_t)raw
+                   : ((int32_t)raw - ADC_MIDPOINT) * PRE_FFT_SCALE;
+}
+
+/**
+ * @brief 去直流、加窗后乘以 exp(-j*2*pi*step*n) 下变频, 用 CIC 滤波器
+ * 按 ratio 抽取
+ * @param step_q32 下变频频率 (周期/采样, Q32)
+ * @param out 输出 outputs 个复数点 (实部/虚部交替), 已除以 CIC 增益
+ * ratio^ZOOM_CIC_ORDER, 刻度为采样乘以正余弦的 Q15 系数
+ * @note 积分器与梳状级按 32 位补码环绕运算: 只要输出 (输入乘以增益)
+ * 不超出 32 位, 积分器中途溢出在梳状级相减后抵消. 为此下变频的乘积
+ * (|v * c| < 2^30) 先按增益右移 (舍入), 输出小于 2^30. M0+ 上免去 64 位
+ * 加减与移位, 代价是增益大时输入只剩 30 - 阶数 * log2(ratio) 位
+ * (ratio = 64 时 12 位), 量化噪声仍远低于 Q15 幅度谱
+ */
+static void mix_and_decimate(const uint16_t *samples, bool is_signed,
+                             int32_t offset, const q15_t *half,
+                             uint32_t step_q32, uint32_t ratio,
+                             uint32_t outputs, int32_t *out) {
+  uint32_t integ_re[ZOOM_CIC_ORDER] = {0};
+  uint32_t integ_im[ZOOM_CIC_ORDER] = {0};
+  uint32_t comb_re[ZOOM_CIC_ORDER] = {0};
+  uint32_t comb_im[ZOOM_CIC_ORDER] = {0};
+  const uint32_t gain_shift = ZOOM_CIC_ORDER * log2_u32(ratio);
+  const int32_t rounding = gain_shift != 0 ? 1 << (gain_shift - 1) : 0;
+  uint32_t phase = 0;
+  uint32_t count = ratio;
+  uint32_t m = 0;
+
+  for (uint32_t n = 0; m < outputs; n++, phase += step_q32) {
+    int32_t v = 0;
+    if (n < SAMPLE_SIZE) {
+      v = centered_sample(samples[n], is_signed) - offset;
+      v = v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v);
+      if (half != NULL) {
+        uint32_t k = n < SAMPLE_SIZE / 2 ? n : SAMPLE_SIZE - 1 - n;
+        v = (v * half[k] + 0x4000) >> 15;
+      }
+    }
+    int32_t c, s;
+    fft_sin_cos_q15((phase + (1U << (31 - SAMPLE_SIZE_LOG2))) >>
+                        (32 - SAMPLE_SIZE_LOG2),
+                    &c, &s);
+    integ_re[0] += (uint32_t)((v * c + rounding) >> gain_shift);
+    integ_im[0] -= (uint32_t)((v * s + rounding) >> gain_shift);
+    for (uint32_t k = 1; k < ZOOM_CIC_ORDER; k++) {
+      integ_re[k] += integ_re[k - 1];
+      integ_im[k] += integ_im[k - 1];
+    }
+    if (--count != 0) {
+      continue;
+    }
+    count = ratio;
+
+    uint32_t re = integ_re[ZOOM_CIC_ORDER - 1];
+    uint32_t im = integ_im[ZOOM_CIC_ORDER - 1];
+    for (uint32_t k = 0; k < ZOOM_CIC_ORDER; k++) {
+      uint32_t delayed = comb_re[k];
+      comb_re[k] = re;
+      re -= delayed;
+      delayed = comb_im[k];
+      comb_im[k] = im;
+      im -= delayed;
+    }
+    out[2 * m] = (int32_t)re;
+    out[2 * m + 1] = (int32_t)im;
+    m++;
+  }
+}
+
+/**
+ * @brief 按细化倍数生成抽取滤波器增益的补偿表
+ * @note 抽取后的补零 DFT 为原频谱 (加窗后) 乘以 CIC 增益再除以 ratio;
+ * CIC 增益的直流部分 ratio^阶数 已在抽取时除去, 第 k 点其余部分为
+ * (sin(x * ratio) / (ratio * sin(x)))^阶数, x = pi * k / (Z * SAMPLE_SIZE).
+ * 搜索范围在第一个零点的一半以内, 增益不小于 (2/pi)^阶数
+ */
+static void update_droop_compensation(uint8_t factor, uint32_t ratio) {
+  if (factor == droop_factor) {
+    return;
+  }
+  droop_compensation[0] = 1.0f;
+  for (uint32_t k = 1; k < DROOP_POINTS; k++) {
+    const double x = PI * k / factor / SAMPLE_SIZE;
+    const double gain = sin(x * ratio) / (ratio * sin(x));
+    droop_compensation[k] = (float)pow(gain, -ZOOM_CIC_ORDER);
+  }
+  droop_factor = factor;
+}
+
+/**
+ * @brief 细化频谱第 k 点 (相对下变频中心, 可为负) 的幅度, 已补偿 CIC 增益
+ * @note 补偿后主瓣两侧对称, 不偏离中心
+ */
+static double bin_magnitude(const q15_t *spectrum, int32_t k) {
+  const uint32_t i = (uint32_t)k & (ZOOM_FFT_LEN - 1);
+  return hypot(spectrum[2 * i], spectrum[2 * i + 1]) *
+         droop_compensation[k < 0 ? -k : k];
+}
+
+/**
+ * @brief 从峰值向一侧找幅度降到一半的位置 (线性插值)
+ * @param dir -1 向低频, 1 向高频
+ * @return 小数位置 (细化频谱的点), 一直未降到一半时为搜索的终点
+ */
+static double half_magnitude_point(const q15_t *spectrum, int32_t peak,
+                                   double peak_mag, int32_t dir) {
+  const double half = peak_mag / 2;
+  double prev = peak_mag;
+  int32_t k = peak;
+  while (k + dir > -ZOOM_FFT_LEN / 2 && k + dir < ZOOM_FFT_LEN / 2) {
+    const double mag = bin_magnitude(spectrum, k + dir);
+    if (mag <= half) {
+      return k + dir * (prev - half) / (prev - mag);
+    }
+    prev = mag;
+    k += dir;
+  }
+  return k;
+}
+
+bool zoom_tone(const uint16_t *samples, bool is_signed, int32_t offset,
+               WindowType window, uint8_t factor, double center, double search,
+               void *buffer, ZoomTone *tone) {
+  // 抽取后一帧 ZOOM_FFT_LEN / Z 点, 补零到 ZOOM_FFT_LEN 点, 频谱间隔 1/Z 频点
+  const uint32_t ratio = SAMPLE_SIZE * factor / ZOOM_FFT_LEN;
+  const uint32_t outputs = ZOOM_FFT_LEN / factor + FLUSH_OUTPUTS;
+  // 抽取输出放在缓冲区末尾 (ZOOM_FFT_LEN 个字), 从前向后换算为 Q15 时
+  // 写入位置总在尚未读取的数据之前
+  q15_t *spectrum = (q15_t *)buffer;
+  int32_t *decimated = (int32_t *)buffer + ZOOM_FFT_LEN - 2 * outputs;
+
+  update_droop_compensation(factor, ratio);
+
+  const uint32_t step_q32 =
+      (uint32_t)llround(center / SAMPLE_SIZE * 4294967296.0);
+  mix_and_decimate(samples, is_signed, offset, gWindows[window].half_table,
+                   step_q32, ratio, outputs, decimated);
+
+  // 按最大值换算为 Q15, 其余补零
+  uint32_t peak = 0;
+  for (uint32_t i = 0; i < 2 * outputs; i++) {
+    uint32_t a = (uint32_t)abs(decimated[i]);
+    peak = a > peak ? a : peak;
+  }
+  if (peak == 0) {
+    return false;
+  }
+  const int32_t shift = (int32_t)log2_u32(peak) + 1 - ZOOM_INPUT_BITS;
+  for (uint32_t i = 0; i < 2 * outputs; i++) {
+    spectrum[i] = (q15_t)(shift >= 0 ? decimated[i] >> shift
+                                     : decimated[i] * (1 << -shift));
+  }
+  for (uint32_t i = 2 * outputs; i < 2 * ZOOM_FFT_LEN; i++) {
+    spectrum[i] = 0;
+  }
+  const uint32_t exponent = cfft_q15_inplace(spectrum, ZOOM_FFT_LEN);
+
+  // 搜索范围内的最大值, 相邻两点抛物线插值
+  const int32_t reach = (int32_t)(search * factor + 0.5);
+  int32_t best = 0;
+  double best_mag = 0;
+  for (int32_t k = -reach; k <= reach; k++) {
+    double mag = bin_magnitude(spectrum, k);
+    if (mag > best_mag) {
+      best_mag = mag;
+      best = k;
+    }
+  }
+  if (best_mag == 0) {
+    return false;
+  }
+  const double left = bin_magnitude(spectrum, best - 1);
+  const double right = bin_magnitude(spectrum, best + 1);
+  const double den = 2 * (2 * best_mag - left - right);
+  double d = den > 0 ? (right - left) / den : 0;
+  d = d > 0.5 ? 0.5 : (d < -0.5 ? -0.5 : d);
+  const double mag = best_mag - (left - right) * d / 4;
+
+  // 频率取主瓣两侧半幅点的中点: 主瓣对称, 平顶窗顶部平坦时也不受噪声影响
+  const double delta =
+      (half_magnitude_point(spectrum, best, best_mag, -1) +
+       half_magnitude_point(spectrum, best, best_mag, 1)) /
+      (2.0 * factor);
+
+  tone->bins = center + delta;
+  // 抽取输出带正余弦的 Q15 系数, 换算回采样刻度
+  tone->magnitude =
+      ldexp(mag, (int)exponent + shift - 15) * ratio / SAMPLE_SIZE;
+  return true;
+}
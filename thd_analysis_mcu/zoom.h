@@ -0,0 +1,69 @@
+#ifndef ZOOM_H
+#define ZOOM_H
+
+#include "arm_math.h"
+#include "consts.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 细化频谱 (zoom-FFT): 把一帧采样按某个单音的频率下变频到零频,
+// 用 CIC 滤波器抽取后补零做一次短的复数 FFT, 在该单音附近得到 1/Z 频点
+// 间隔的频谱. 与把整帧补零到 Z * SAMPLE_SIZE 点做 FFT 的效果相同,
+// 但只需 ZOOM_FFT_LEN 点的 FFT 和工作区
+
+// 细化 FFT 的点数 (复数)
+#define ZOOM_FFT_LEN 256
+// 细化倍数 Z 的范围 (2 的幂): 抽取后一帧 ZOOM_FFT_LEN / Z 点, 覆盖以该单音
+// 为中心的 ZOOM_FFT_LEN / Z 个频点; Z 过大时通带太窄, 相邻单音的混叠抑制不足
+#define ZOOM_MIN_FACTOR 4
+#define ZOOM_MAX_FACTOR 16
+// 抽取滤波器阶数: 混叠到中心附近的分量按 (偏离/通带宽度)^阶数 衰减
+#define ZOOM_CIC_ORDER 3
+// 细化需要的工作区 (字节): 复数 FFT 缓冲区, 抽取输出暂存在其后部
+#define ZOOM_BUFFER_BYTES (2 * ZOOM_FFT_LEN * sizeof(q15_t))
+// 大点数时 FFT 原地覆盖采集缓冲区, 分析时已没有时域采样, 不支持细化
+#define ZOOM_SUPPORTED (!SPECTRUM_IN_CAPTURE_BUFFER)
+// 一帧最多细化的单音数 (基波加 2 ~ ZOOM_MAX_TONES 次谐波, 命令 0x32 设置,
+// 默认只细化基波). 每个单音需一次 SAMPLE_SIZE 点的下变频与滤波和一次
+// ZOOM_FFT_LEN 点复数 FFT; 更高次的谐波幅度小, 扇贝损失对 THD 的影响
+// 可以忽略, 沿用幅度谱的值
+#define ZOOM_MAX_TONES 8
+// 抽取滤波器增益补偿表 (按细化频谱的点查表, 见 zoom.c) 占用的 RAM
+#if ZOOM_SUPPORTED
+#define ZOOM_RAM_BYTES (ZOOM_FFT_LEN / 2 * sizeof(float))
+#else
+#define ZOOM_RAM_BYTES 0
+#endif
+
+// 细化得到的单音
+typedef struct {
+  double bins;      // 小数频点
+  double magnitude; // 幅度, 与 Q15 路径幅度谱同一刻度 (加窗后 X/N)
+} ZoomTone;
+
+/**
+ * @brief 细化倍数是否可用
+ * @param factor 0 表示关闭, 否则为 ZOOM_MIN_FACTOR ~ ZOOM_MAX_FACTOR 的 2 的幂
+ */
+bool is_zoom_factor_valid(uint8_t factor);
+
+/**
+ * @brief 在 center 附近细化一帧的频谱, 找出 +-search 频点内最强的单音
+ * @param samples 一帧采样 (当前格式)
+ * @param is_signed 采样为有符号左对齐 (Q15) 格式
+ * @param offset 预处理时减去的直流偏置 (以中点为零、乘以 PRE_FFT_SCALE 的刻度)
+ * @param window 与幅度谱相同的窗函数
+ * @param factor 细化倍数 Z, 频谱间隔为 1/Z 频点
+ * @param center 下变频的中心 (小数频点)
+ * @param search 搜索范围 (频点), 不超过抽取后通带的一半
+ * @param buffer 工作区, 至少 ZOOM_BUFFER_BYTES 字节, 按 4 字节对齐
+ * @return false 表示范围内没有信号
+ * @note 幅度已按抽取滤波器在该频率处的增益补偿; 一次细化约为 SAMPLE_SIZE
+ * 点的复数下变频与滤波, 加一次 ZOOM_FFT_LEN 点的复数 FFT. 细化倍数改变
+ * 后的第一次调用还要重新生成增益补偿表
+ */
+bool zoom_tone(const uint16_t *samples, bool is_signed, int32_t offset,
+               WindowType window, uint8_t factor, double center, double search,
+               void *buffer, ZoomTone *tone);
+
+#endif /* ZOOM_H */